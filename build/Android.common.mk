@@ -81,6 +81,19 @@ $(info Enabling ART_USE_PORTABLE_COMPILER because WITH_ART_USE_PORTABLE_COMPILER
 ART_USE_PORTABLE_COMPILER := true
 endif
 
+#
+# Used to select the switch-based interpreter instead of the computed-goto one
+#
+ART_USE_SWITCH_INTERPRETER := false
+ifneq ($(wildcard art/USE_SWITCH_INTERPRETER),)
+$(info Enabling ART_USE_SWITCH_INTERPRETER because of existence of art/USE_SWITCH_INTERPRETER)
+ART_USE_SWITCH_INTERPRETER := true
+endif
+ifeq ($(WITH_ART_USE_SWITCH_INTERPRETER),true)
+$(info Enabling ART_USE_SWITCH_INTERPRETER because WITH_ART_USE_SWITCH_INTERPRETER=true)
+ART_USE_SWITCH_INTERPRETER := true
+endif
+
 LLVM_ROOT_PATH := external/llvm
 include $(LLVM_ROOT_PATH)/llvm.mk
 
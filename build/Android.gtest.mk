@@ -17,6 +17,8 @@
 LOCAL_PATH := art
 
 TEST_COMMON_SRC_FILES := \
+	compiler/dex/global_value_numbering_test.cc \
+	compiler/driver/compiled_method_cache_test.cc \
 	compiler/driver/compiler_driver_test.cc \
 	compiler/elf_writer_test.cc \
 	compiler/image_test.cc \
@@ -48,12 +50,16 @@ TEST_COMMON_SRC_FILES := \
 	runtime/indenter_test.cc \
 	runtime/indirect_reference_table_test.cc \
 	runtime/intern_table_test.cc \
+	runtime/interpreter/interpreter_test.cc \
 	runtime/jni_internal_test.cc \
 	runtime/mem_map_test.cc \
 	runtime/mirror/dex_cache_test.cc \
 	runtime/mirror/object_test.cc \
+	runtime/monitor_test.cc \
 	runtime/reference_table_test.cc \
+	runtime/reflection_test.cc \
 	runtime/runtime_test.cc \
+	runtime/thread_list_test.cc \
 	runtime/thread_pool_test.cc \
 	runtime/utils_test.cc \
 	runtime/verifier/method_verifier_test.cc \
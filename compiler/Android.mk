@@ -20,7 +20,14 @@ include art/build/Android.common.mk
 
 LIBART_COMPILER_SRC_FILES := \
 	compiled_method.cc \
+	dex/bounds_check_elimination.cc \
+	dex/escape_analysis.cc \
+	dex/global_value_numbering.cc \
+	dex/live_intervals.cc \
 	dex/local_value_numbering.cc \
+	dex/loop_invariant_code_motion.cc \
+	dex/memory_locations.cc \
+	dex/method_inliner.cc \
 	dex/arena_allocator.cc \
 	dex/arena_bit_vector.cc \
 	dex/quick/arm/assemble_arm.cc \
@@ -57,6 +64,7 @@ LIBART_COMPILER_SRC_FILES := \
 	dex/mir_analysis.cc \
 	dex/vreg_analysis.cc \
 	dex/ssa_transformation.cc \
+	driver/compiled_method_cache.cc \
 	driver/compiler_driver.cc \
 	driver/dex_compilation_unit.cc \
 	jni/portable/jni_compiler.cc \
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bounds_check_elimination.h"
+
+#include "dataflow_iterator-inl.h"
+
+namespace art {
+
+BoundsCheckElimination::BoundsCheckElimination(CompilationUnit* cu, MIRGraph* mir_graph)
+    : cu_(cu),
+      mir_graph_(mir_graph),
+      range_checks_eliminated_(0) {
+}
+
+void BoundsCheckElimination::Run() {
+  FindDefs();
+  AllNodesIterator iter(mir_graph_, false /* not iterative */);
+  for (BasicBlock* bb = iter.Next(); bb != NULL; bb = iter.Next()) {
+    if ((bb->block_type == kDead) || (bb->data_flow_info == NULL)) {
+      continue;
+    }
+    for (MIR* mir = bb->first_mir_insn; mir != NULL; mir = mir->next) {
+      int df_attributes = MIRGraph::oat_data_flow_attributes_[mir->dalvikInsn.opcode];
+      if (((df_attributes & DF_HAS_RANGE_CHKS) == 0) || (mir->ssa_rep == NULL) ||
+          ((mir->optimization_flags & MIR_IGNORE_RANGE_CHECK) != 0)) {
+        continue;
+      }
+      if (CanRemoveRangeCheck(bb, mir)) {
+        mir_graph_->IgnoreRangeCheck(mir);
+        range_checks_eliminated_++;
+      }
+    }
+  }
+}
+
+void BoundsCheckElimination::FindDefs() {
+  def_mirs_.assign(mir_graph_->GetNumSSARegs(), NULL);
+  def_blocks_.assign(mir_graph_->GetNumSSARegs(), NULL);
+  AllNodesIterator iter(mir_graph_, false /* not iterative */);
+  for (BasicBlock* bb = iter.Next(); bb != NULL; bb = iter.Next()) {
+    for (MIR* mir = bb->first_mir_insn; mir != NULL; mir = mir->next) {
+      if (mir->ssa_rep == NULL) {
+        continue;
+      }
+      for (int i = 0; i < mir->ssa_rep->num_defs; i++) {
+        int s_reg = mir->ssa_rep->defs[i];
+        if ((s_reg >= 0) && (static_cast<size_t>(s_reg) < def_mirs_.size())) {
+          def_mirs_[s_reg] = mir;
+          def_blocks_[s_reg] = bb;
+        }
+      }
+    }
+  }
+}
+
+int BoundsCheckElimination::ResolveMoves(int s_reg) const {
+  while ((s_reg >= 0) && (def_mirs_[s_reg] != NULL)) {
+    MIR* def = def_mirs_[s_reg];
+    switch (def->dalvikInsn.opcode) {
+      case Instruction::MOVE:
+      case Instruction::MOVE_FROM16:
+      case Instruction::MOVE_16:
+      case Instruction::MOVE_OBJECT:
+      case Instruction::MOVE_OBJECT_FROM16:
+      case Instruction::MOVE_OBJECT_16:
+        s_reg = def->ssa_rep->uses[0];
+        break;
+      default:
+        return s_reg;
+    }
+  }
+  return s_reg;
+}
+
+bool BoundsCheckElimination::IsLengthOf(int s_reg, int array) const {
+  MIR* def = (s_reg >= 0) ? def_mirs_[s_reg] : NULL;
+  return (def != NULL) && (def->dalvikInsn.opcode == Instruction::ARRAY_LENGTH) &&
+      (ResolveMoves(def->ssa_rep->uses[0]) == array);
+}
+
+bool BoundsCheckElimination::IsBelow(BasicBlock* bb, int s_reg, int array) const {
+  // Only the edge into a block with a single predecessor tells which way the branch went.
+  for (BasicBlock* child = bb; child->i_dom != NULL; child = child->i_dom) {
+    BasicBlock* branch_bb = child->i_dom;
+    MIR* branch = branch_bb->last_mir_insn;
+    if ((child->predecessors->Size() != 1) || (branch == NULL) || (branch->ssa_rep == NULL) ||
+        (branch_bb->taken == branch_bb->fall_through)) {
+      continue;
+    }
+    bool taken = (child == branch_bb->taken);
+    if (!taken && (child != branch_bb->fall_through)) {
+      continue;
+    }
+    int less;
+    int greater;
+    switch (branch->dalvikInsn.opcode) {
+      case Instruction::IF_LT:
+      case Instruction::IF_GE:
+        if (taken != (branch->dalvikInsn.opcode == Instruction::IF_LT)) {
+          continue;
+        }
+        less = branch->ssa_rep->uses[0];
+        greater = branch->ssa_rep->uses[1];
+        break;
+      case Instruction::IF_GT:
+      case Instruction::IF_LE:
+        if (taken != (branch->dalvikInsn.opcode == Instruction::IF_GT)) {
+          continue;
+        }
+        less = branch->ssa_rep->uses[1];
+        greater = branch->ssa_rep->uses[0];
+        break;
+      default:
+        continue;
+    }
+    if ((ResolveMoves(less) == s_reg) &&
+        ((array == INVALID_SREG) || IsLengthOf(ResolveMoves(greater), array))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool BoundsCheckElimination::IsNonNegative(int s_reg) {
+  std::set<int> assumed;
+  return IsNonNegativeAssuming(ResolveMoves(s_reg), &assumed);
+}
+
+/*
+ * Phis being proven are assumed non-negative while proving their operands, which makes this an
+ * induction over the loop's iterations: each phi starts out non-negative and stays so as long as
+ * every value flowing into it is, given that the phis were so far.
+ */
+bool BoundsCheckElimination::IsNonNegativeAssuming(int s_reg, std::set<int>* assumed) {
+  if (s_reg < 0) {
+    return false;
+  }
+  if (mir_graph_->IsConst(s_reg)) {
+    return mir_graph_->ConstantValue(s_reg) >= 0;
+  }
+  MIR* def = def_mirs_[s_reg];
+  if (def == NULL) {
+    return false;
+  }
+  int opcode = def->dalvikInsn.opcode;
+  switch (opcode) {
+    case Instruction::ARRAY_LENGTH:
+      return true;
+
+    case kMirOpPhi:
+      if (!assumed->insert(s_reg).second) {
+        return true;
+      }
+      for (int i = 0; i < def->ssa_rep->num_uses; i++) {
+        if (!IsNonNegativeAssuming(ResolveMoves(def->ssa_rep->uses[i]), assumed)) {
+          return false;
+        }
+      }
+      return true;
+
+    case Instruction::ADD_INT:
+    case Instruction::ADD_INT_2ADDR:
+    case Instruction::ADD_INT_LIT16:
+    case Instruction::ADD_INT_LIT8: {
+        // Adding one to a value known to be less than some int can't overflow.
+        int src;
+        if ((opcode == Instruction::ADD_INT_LIT16) || (opcode == Instruction::ADD_INT_LIT8)) {
+          if (static_cast<int32_t>(def->dalvikInsn.vC) != 1) {
+            return false;
+          }
+          src = def->ssa_rep->uses[0];
+        } else if (mir_graph_->IsConst(def->ssa_rep->uses[1]) &&
+                   (mir_graph_->ConstantValue(def->ssa_rep->uses[1]) == 1)) {
+          src = def->ssa_rep->uses[0];
+        } else if (mir_graph_->IsConst(def->ssa_rep->uses[0]) &&
+                   (mir_graph_->ConstantValue(def->ssa_rep->uses[0]) == 1)) {
+          src = def->ssa_rep->uses[1];
+        } else {
+          return false;
+        }
+        src = ResolveMoves(src);
+        return IsBelow(def_blocks_[s_reg], src, INVALID_SREG) &&
+            IsNonNegativeAssuming(src, assumed);
+      }
+
+    default:
+      return false;
+  }
+}
+
+bool BoundsCheckElimination::CanRemoveRangeCheck(BasicBlock* bb, MIR* mir) {
+  int array;
+  int index;
+  mir_graph_->GetRangeCheckOperands(mir, &array, &index);
+  array = ResolveMoves(array);
+  index = ResolveMoves(index);
+  return IsBelow(bb, index, array) && IsNonNegative(index);
+}
+
+}  // namespace art
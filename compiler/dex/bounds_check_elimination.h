@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_DEX_BOUNDS_CHECK_ELIMINATION_H_
+#define ART_COMPILER_DEX_BOUNDS_CHECK_ELIMINATION_H_
+
+#include <set>
+#include <vector>
+
+#include "compiler_internals.h"
+
+namespace art {
+
+/*
+ * Removes the range checks of array accesses whose index is known to lie within the array, as
+ * in the canonical counted loop
+ *
+ *   for (int i = 0; i < array.length; i++) { ... array[i] ... }
+ *
+ * An index is below the array's length when the access is dominated by a branch on the index
+ * being less than the length. An index is non-negative when it is a non-negative constant, an
+ * array length, or a phi all of whose operands are. A phi operand may also be the phi plus one,
+ * provided the addition is dominated by a branch on the phi being less than some value, so that
+ * it can't overflow. This covers induction variables counting up from zero, in loops of any
+ * shape and nesting.
+ *
+ * Values are followed through moves, but no other arithmetic is analyzed.
+ */
+class BoundsCheckElimination {
+ public:
+  BoundsCheckElimination(CompilationUnit* cu, MIRGraph* mir_graph);
+
+  void Run();
+
+  int GetRangeChecksEliminated() const {
+    return range_checks_eliminated_;
+  }
+
+ private:
+  void FindDefs();
+  // The SSA name a move of s_reg copies, recursively, or s_reg itself.
+  int ResolveMoves(int s_reg) const;
+
+  // Whether a branch dominating bb proves that s_reg is less than the length of array, or less
+  // than any value when array is INVALID_SREG.
+  bool IsBelow(BasicBlock* bb, int s_reg, int array) const;
+  bool IsLengthOf(int s_reg, int array) const;
+  bool IsNonNegative(int s_reg);
+  bool IsNonNegativeAssuming(int s_reg, std::set<int>* assumed);
+
+  bool CanRemoveRangeCheck(BasicBlock* bb, MIR* mir);
+
+  CompilationUnit* const cu_;
+  MIRGraph* const mir_graph_;
+
+  // The instruction defining each SSA name and its block, or NULL for the method's inputs.
+  std::vector<MIR*> def_mirs_;
+  std::vector<BasicBlock*> def_blocks_;
+
+  int range_checks_eliminated_;
+
+  DISALLOW_COPY_AND_ASSIGN(BoundsCheckElimination);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_DEX_BOUNDS_CHECK_ELIMINATION_H_
@@ -44,6 +44,8 @@ enum SpecialTargetRegister {
   kRet0,
   kRet1,
   kInvokeTgt,
+  kHiddenArg,       // Holds the interface method's dex method index for imt conflicts.
+  kHiddenFpArg,     // Copy of kHiddenArg for targets that pass it in an fp register.
   kCount
 };
 
@@ -407,6 +409,7 @@ enum OatBitMapKind {
   kBitMapNullCheck,
   kBitMapTmpBlockV,
   kBitMapPredecessors,
+  kBitMapLoopBlocks,
   kNumBitMapKinds
 };
 
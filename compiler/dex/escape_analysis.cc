@@ -0,0 +1,353 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "escape_analysis.h"
+
+#include "dataflow_iterator-inl.h"
+
+namespace art {
+
+static bool IsInstanceGet(Instruction::Code opcode) {
+  return (opcode >= Instruction::IGET) && (opcode <= Instruction::IGET_SHORT);
+}
+
+static bool IsInstancePut(Instruction::Code opcode) {
+  return (opcode >= Instruction::IPUT) && (opcode <= Instruction::IPUT_SHORT);
+}
+
+static bool IsArrayGet(Instruction::Code opcode) {
+  return (opcode >= Instruction::AGET) && (opcode <= Instruction::AGET_SHORT);
+}
+
+static bool IsArrayPut(Instruction::Code opcode) {
+  return (opcode >= Instruction::APUT) && (opcode <= Instruction::APUT_SHORT);
+}
+
+// Returns the type a load or store accesses, as the IGET of that type.
+static Instruction::Code GetAccessType(Instruction::Code opcode) {
+  int type;
+  if (IsInstanceGet(opcode)) {
+    type = opcode - Instruction::IGET;
+  } else if (IsInstancePut(opcode)) {
+    type = opcode - Instruction::IPUT;
+  } else if (IsArrayGet(opcode)) {
+    type = opcode - Instruction::AGET;
+  } else {
+    DCHECK(IsArrayPut(opcode));
+    type = opcode - Instruction::APUT;
+  }
+  return static_cast<Instruction::Code>(Instruction::IGET + type);
+}
+
+// Returns what reads a field's value from the register it was stored from. Stores of sub-word
+// fields keep the low bits of any int, which loads sign or zero extend.
+static Instruction::Code GetMoveForLoad(Instruction::Code opcode) {
+  switch (GetAccessType(opcode)) {
+    case Instruction::IGET_WIDE:
+      return Instruction::MOVE_WIDE;
+    case Instruction::IGET_OBJECT:
+      return Instruction::MOVE_OBJECT;
+    case Instruction::IGET_BOOLEAN:
+      return Instruction::AND_INT_LIT16;
+    case Instruction::IGET_BYTE:
+      return Instruction::INT_TO_BYTE;
+    case Instruction::IGET_CHAR:
+      return Instruction::INT_TO_CHAR;
+    case Instruction::IGET_SHORT:
+      return Instruction::INT_TO_SHORT;
+    default:
+      return Instruction::MOVE;
+  }
+}
+
+static bool UsesSReg(const MIR* mir, int s_reg) {
+  if (mir->ssa_rep == NULL) {
+    return false;
+  }
+  for (int i = 0; i < mir->ssa_rep->num_uses; i++) {
+    if (mir->ssa_rep->uses[i] == s_reg) {
+      return true;
+    }
+  }
+  return false;
+}
+
+EscapeAnalysis::EscapeAnalysis(CompilationUnit* cu, MIRGraph* mir_graph)
+    : cu_(cu),
+      mir_graph_(mir_graph),
+      memory_locations_(cu, mir_graph),
+      num_allocations_(0),
+      num_eliminated_(0) {
+}
+
+void EscapeAnalysis::Run() {
+  FindUses();
+  AllNodesIterator iter(mir_graph_, false /* not iterative */);
+  for (BasicBlock* bb = iter.Next(); bb != NULL; bb = iter.Next()) {
+    if ((bb->block_type == kDead) || (bb->data_flow_info == NULL)) {
+      continue;
+    }
+    for (MIR* mir = bb->first_mir_insn; mir != NULL; mir = mir->next) {
+      Instruction::Code opcode = mir->dalvikInsn.opcode;
+      if (((opcode != Instruction::NEW_INSTANCE) && (opcode != Instruction::NEW_ARRAY)) ||
+          (mir->ssa_rep == NULL) || (mir->ssa_rep->num_defs != 1)) {
+        continue;
+      }
+      num_allocations_++;
+      if (TryEliminate(bb, mir)) {
+        num_eliminated_++;
+      }
+    }
+  }
+}
+
+void EscapeAnalysis::FindUses() {
+  uses_.resize(mir_graph_->GetNumSSARegs());
+  AllNodesIterator iter(mir_graph_, false /* not iterative */);
+  for (BasicBlock* bb = iter.Next(); bb != NULL; bb = iter.Next()) {
+    if ((bb->block_type == kDead) || (bb->data_flow_info == NULL)) {
+      continue;
+    }
+    for (MIR* mir = bb->first_mir_insn; mir != NULL; mir = mir->next) {
+      if (mir->ssa_rep == NULL) {
+        continue;
+      }
+      for (int i = 0; i < mir->ssa_rep->num_uses; i++) {
+        uses_[mir->ssa_rep->uses[i]].push_back(mir);
+      }
+    }
+  }
+}
+
+bool EscapeAnalysis::IsFieldAccess(const MIR* mir, int s_reg) {
+  Instruction::Code opcode = mir->dalvikInsn.opcode;
+  bool is_put = IsInstancePut(opcode);
+  if (!is_put && !IsInstanceGet(opcode)) {
+    return false;
+  }
+  // The object is the last use. Storing the object itself lets it escape.
+  const SSARepresentation* ssa_rep = mir->ssa_rep;
+  if (ssa_rep->uses[ssa_rep->num_uses - 1] != s_reg) {
+    return false;
+  }
+  for (int i = 0; i < ssa_rep->num_uses - 1; i++) {
+    if (ssa_rep->uses[i] == s_reg) {
+      return false;
+    }
+  }
+  const MemoryLocations::FieldInfo& info =
+      memory_locations_.GetInstanceFieldInfo(mir->dalvikInsn.vC, is_put);
+  return info.fast_path && !info.is_volatile;
+}
+
+bool EscapeAnalysis::IsElementAccess(const MIR* mir, int s_reg, int length) {
+  Instruction::Code opcode = mir->dalvikInsn.opcode;
+  // Storing a reference checks that the array may hold it.
+  if ((!IsArrayGet(opcode) && !IsArrayPut(opcode)) || (opcode == Instruction::AGET_OBJECT) ||
+      (opcode == Instruction::APUT_OBJECT)) {
+    return false;
+  }
+  // The array and the index are the last uses.
+  const SSARepresentation* ssa_rep = mir->ssa_rep;
+  int s_index = ssa_rep->uses[ssa_rep->num_uses - 1];
+  if ((ssa_rep->uses[ssa_rep->num_uses - 2] != s_reg) || !mir_graph_->IsConst(s_index) ||
+      (mir_graph_->ConstantValue(s_index) < 0) || (mir_graph_->ConstantValue(s_index) >= length)) {
+    return false;
+  }
+  for (int i = 0; i < ssa_rep->num_uses - 2; i++) {
+    if (ssa_rep->uses[i] == s_reg) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool EscapeAnalysis::TryEliminate(BasicBlock* bb, MIR* allocation) {
+  int s_obj = allocation->ssa_rep->defs[0];
+  bool is_array = (allocation->dalvikInsn.opcode == Instruction::NEW_ARRAY);
+  uint32_t type_idx = allocation->dalvikInsn.vB;
+  int length = 0;
+  if (is_array) {
+    // An array must have a length known not to be negative, and be indexed with constants.
+    int s_length = allocation->ssa_rep->uses[0];
+    if (!mir_graph_->IsConst(s_length) || (mir_graph_->ConstantValue(s_length) < 0)) {
+      return false;
+    }
+    type_idx = allocation->dalvikInsn.vC;
+    length = mir_graph_->ConstantValue(s_length);
+  }
+  const std::vector<MIR*>& uses = uses_[s_obj];
+  for (size_t i = 0; i < uses.size(); i++) {
+    Instruction::Code opcode = uses[i]->dalvikInsn.opcode;
+    if ((static_cast<int>(opcode) != kMirOpNullCheck) &&
+        !(is_array ? ((opcode == Instruction::ARRAY_LENGTH) ||
+                      IsElementAccess(uses[i], s_obj, length)) :
+                     IsFieldAccess(uses[i], s_obj))) {
+      return false;
+    }
+  }
+  if (!cu_->compiler_driver->CanElideAllocation(cu_->method_idx, *cu_->dex_file, type_idx)) {
+    return false;
+  }
+  std::vector<Rewrite> rewrites;
+  if (!ScalarReplace(bb, allocation, length, &rewrites)) {
+    return false;
+  }
+  if (cu_->verbose) {
+    LOG(INFO) << "Replacing the " << (is_array ? "elements" : "fields")
+              << " of the object allocated at 0x" << std::hex << allocation->offset
+              << " with registers";
+  }
+  for (size_t i = 0; i < rewrites.size(); i++) {
+    Replace(rewrites[i]);
+  }
+  Rewrite null_object = {allocation, Instruction::CONST, INVALID_SREG, INVALID_SREG, 0};
+  Replace(null_object);
+  return true;
+}
+
+/*
+ * Walks the straight-line code following the allocation until every use of the object is found,
+ * noting the SSA name each Dalvik register holds and the value stored to each field or element,
+ * and decides what each use becomes. Fails when a use lies elsewhere, or a load's value is no
+ * longer held in the register it was stored from.
+ */
+bool EscapeAnalysis::ScalarReplace(BasicBlock* bb, MIR* allocation, int length,
+                                   std::vector<Rewrite>* rewrites) {
+  int s_obj = allocation->ssa_rep->defs[0];
+  size_t remaining = uses_[s_obj].size();
+  int num_vregs = cu_->num_dalvik_registers;
+  std::vector<int> current_ssa_map(num_vregs, INVALID_SREG);
+  SafeMap<int, StoredValue> fields;  // By field offset or element index.
+  BasicBlock* block = bb;
+  MIR* mir = allocation->next;
+  while (remaining != 0) {
+    if (mir == NULL) {
+      // Go on into the block only entered from this one, unless this one branches.
+      BasicBlock* next = block->fall_through;
+      if ((next == NULL) || (next->block_type != kDalvikByteCode) ||
+          (next->predecessors->Size() != 1) ||
+          ((block->taken != NULL) && (block->taken->block_type != kExceptionHandling))) {
+        return false;
+      }
+      block = next;
+      mir = block->first_mir_insn;
+      continue;
+    }
+    if (UsesSReg(mir, s_obj)) {
+      remaining--;
+      Instruction::Code opcode = mir->dalvikInsn.opcode;
+      const SSARepresentation* ssa_rep = mir->ssa_rep;
+      if (static_cast<int>(opcode) == kMirOpNullCheck) {
+        Rewrite rewrite = {mir, static_cast<Instruction::Code>(kMirOpNop), INVALID_SREG,
+                           INVALID_SREG, 0};
+        rewrites->push_back(rewrite);
+      } else if (opcode == Instruction::ARRAY_LENGTH) {
+        Rewrite rewrite = {mir, Instruction::CONST, INVALID_SREG, INVALID_SREG, length};
+        rewrites->push_back(rewrite);
+      } else if (IsInstancePut(opcode) || IsArrayPut(opcode)) {
+        bool wide = (GetAccessType(opcode) == Instruction::IGET_WIDE);
+        StoredValue value = {opcode, ssa_rep->uses[0], wide ? ssa_rep->uses[1] : INVALID_SREG};
+        fields.Overwrite(GetKey(mir), value);
+        // The store reads the value from its register, which holds it here.
+        current_ssa_map[mir_graph_->SRegToVReg(value.s_reg)] = value.s_reg;
+        if (wide) {
+          current_ssa_map[mir_graph_->SRegToVReg(value.s_reg_high)] = value.s_reg_high;
+        }
+        Rewrite rewrite = {mir, static_cast<Instruction::Code>(kMirOpNop), INVALID_SREG,
+                           INVALID_SREG, 0};
+        rewrites->push_back(rewrite);
+      } else {
+        bool wide = (GetAccessType(opcode) == Instruction::IGET_WIDE);
+        SafeMap<int, StoredValue>::iterator it = fields.find(GetKey(mir));
+        if (it == fields.end()) {
+          // Nothing stored yet, the field holds zero or null.
+          Rewrite rewrite = {mir, wide ? Instruction::CONST_WIDE_16 : Instruction::CONST,
+                             INVALID_SREG, INVALID_SREG, 0};
+          rewrites->push_back(rewrite);
+        } else {
+          const StoredValue& value = it->second;
+          if ((GetAccessType(value.opcode) != GetAccessType(opcode)) ||
+              (current_ssa_map[mir_graph_->SRegToVReg(value.s_reg)] != value.s_reg) ||
+              (wide &&
+               (current_ssa_map[mir_graph_->SRegToVReg(value.s_reg_high)] != value.s_reg_high))) {
+            return false;
+          }
+          Rewrite rewrite = {mir, GetMoveForLoad(opcode), value.s_reg, value.s_reg_high,
+                             (GetAccessType(opcode) == Instruction::IGET_BOOLEAN) ? 0xff : 0};
+          rewrites->push_back(rewrite);
+        }
+      }
+    }
+    // Note what each Dalvik register holds from here on.
+    if (mir->ssa_rep != NULL) {
+      for (int i = 0; i < mir->ssa_rep->num_defs; i++) {
+        int v_reg = mir_graph_->SRegToVReg(mir->ssa_rep->defs[i]);
+        if ((v_reg >= 0) && (v_reg < num_vregs)) {
+          current_ssa_map[v_reg] = mir->ssa_rep->defs[i];
+        }
+      }
+    }
+    mir = mir->next;
+  }
+  return true;
+}
+
+int EscapeAnalysis::GetKey(const MIR* mir) {
+  Instruction::Code opcode = mir->dalvikInsn.opcode;
+  if (IsArrayGet(opcode) || IsArrayPut(opcode)) {
+    return mir_graph_->ConstantValue(mir->ssa_rep->uses[mir->ssa_rep->num_uses - 1]);
+  }
+  return memory_locations_.GetInstanceFieldInfo(mir->dalvikInsn.vC, IsInstancePut(opcode)).offset;
+}
+
+void EscapeAnalysis::Replace(const Rewrite& rewrite) {
+  MIR* mir = rewrite.mir;
+  mir->dalvikInsn.opcode = rewrite.opcode;
+  if (rewrite.s_reg == INVALID_SREG) {
+    mir->dalvikInsn.vB = rewrite.literal;
+    mir->dalvikInsn.vC = 0;
+  } else {
+    mir->dalvikInsn.vB = mir_graph_->SRegToVReg(rewrite.s_reg);
+    mir->dalvikInsn.vC = rewrite.literal;
+  }
+  SSARepresentation* ssa_rep = mir->ssa_rep;
+  int num_uses = (rewrite.s_reg == INVALID_SREG) ? 0 :
+      ((rewrite.s_reg_high == INVALID_SREG) ? 1 : 2);
+  if (ssa_rep->num_uses < num_uses) {
+    ssa_rep->uses = static_cast<int*>(cu_->arena.Alloc(sizeof(int) * num_uses,
+                                                       ArenaAllocator::kAllocDFInfo));
+    ssa_rep->fp_use = static_cast<bool*>(cu_->arena.Alloc(sizeof(bool) * num_uses,
+                                                          ArenaAllocator::kAllocDFInfo));
+  }
+  ssa_rep->num_uses = num_uses;
+  if (num_uses > 0) {
+    ssa_rep->uses[0] = rewrite.s_reg;
+    ssa_rep->fp_use[0] = false;
+  }
+  if (num_uses > 1) {
+    ssa_rep->uses[1] = rewrite.s_reg_high;
+    ssa_rep->fp_use[1] = false;
+  }
+  // The check half generates the code when the halves aren't combined, from its own operands.
+  MIR* check_half = mir->meta.throw_insn;
+  if (check_half != NULL) {
+    check_half->dalvikInsn = mir->dalvikInsn;
+    check_half->dalvikInsn.opcode = static_cast<Instruction::Code>(kMirOpCheck);
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_DEX_ESCAPE_ANALYSIS_H_
+#define ART_COMPILER_DEX_ESCAPE_ANALYSIS_H_
+
+#include <vector>
+
+#include "compiler_internals.h"
+#include "memory_locations.h"
+
+namespace art {
+
+/*
+ * Removes new-instances and new-arrays whose object never escapes the method, replacing its
+ * fields or elements with the Dalvik registers holding their values (scalar replacement).
+ *
+ * An object doesn't escape when its SSA name is only read as the object of instance field loads
+ * and stores, or null checked. Constructors are calls, so only objects whose constructors the
+ * inliner replaced with their field stores qualify. An array must have a constant length, and
+ * may only have its length read or primitive elements loaded and stored at constant indices
+ * within it, so that none of them throws; aput-object would check the stored reference's type.
+ * Allocating must have no effect besides the object: its class needs no access or instantiation
+ * checks, is verified, has no finalizer, and is either initialized whenever the method runs or has
+ * no static initializer up its hierarchy.
+ *
+ * Fields can't be given registers of their own, as SSA names share the home location of their
+ * Dalvik register (see MIRGraph::SRegToVReg). Stores are removed, and each load becomes a move
+ * from the register the stored value was in, which must still hold it, or a constant zero when
+ * nothing was stored; reading an array's length becomes a constant too. The loads and stores must
+ * therefore follow the allocation in straight-line code: each block after the allocation's only
+ * entered from the one before it. Loads of sub-word fields truncate and extend the value instead
+ * of moving it, as storing and loading it would have. The allocation itself becomes a constant
+ * null, as the GC maps still hold its register to be a reference.
+ */
+class EscapeAnalysis {
+ public:
+  EscapeAnalysis(CompilationUnit* cu, MIRGraph* mir_graph);
+
+  void Run();
+
+  int GetNumAllocations() const {
+    return num_allocations_;
+  }
+
+  int GetNumEliminated() const {
+    return num_eliminated_;
+  }
+
+ private:
+  // An instruction to rewrite once the allocation is known not to escape.
+  struct Rewrite {
+    MIR* mir;
+    Instruction::Code opcode;
+    int s_reg;       // The value moved, or INVALID_SREG.
+    int s_reg_high;  // INVALID_SREG unless a wide value is moved.
+    int literal;     // vB of a constant, else vC, for the mask of a boolean load.
+  };
+
+  // The value last stored to a field of the object.
+  struct StoredValue {
+    Instruction::Code opcode;
+    int s_reg;
+    int s_reg_high;
+  };
+
+  void FindUses();
+  bool IsFieldAccess(const MIR* mir, int s_reg);
+  bool IsElementAccess(const MIR* mir, int s_reg, int length);
+  bool TryEliminate(BasicBlock* bb, MIR* allocation);
+  bool ScalarReplace(BasicBlock* bb, MIR* allocation, int length, std::vector<Rewrite>* rewrites);
+  // The field offset or element index a load or store accesses.
+  int GetKey(const MIR* mir);
+  void Replace(const Rewrite& rewrite);
+
+  CompilationUnit* const cu_;
+  MIRGraph* const mir_graph_;
+  MemoryLocations memory_locations_;
+
+  // The instructions using each SSA name, once per use.
+  std::vector<std::vector<MIR*> > uses_;
+
+  int num_allocations_;
+  int num_eliminated_;
+
+  DISALLOW_COPY_AND_ASSIGN(EscapeAnalysis);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_DEX_ESCAPE_ANALYSIS_H_
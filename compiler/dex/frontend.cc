@@ -83,6 +83,12 @@ static uint32_t kCompilerOptimizerDisableFlags = 0 |  // Disable specific optimi
   // (1 << kBBOpt) |
   // (1 << kMatch) |
   // (1 << kPromoteCompilerTemps) |
+  // (1 << kGlobalValueNumbering) |
+  // (1 << kLoopInvariantCodeMotion) |
+  // (1 << kBoundsCheckElimination) |
+  // (1 << kMethodInlining) |
+  // (1 << kLinearScanPromotion) |
+  // (1 << kEscapeAnalysis) |
   0;
 
 static uint32_t kCompilerDebugFlags = 0 |     // Enable debug/testing modes
@@ -151,8 +157,9 @@ static CompiledMethod* CompileMethod(CompilerDriver& compiler,
    */
 
   if (compiler_backend == kPortable) {
-    // Fused long branches not currently usseful in bitcode.
-    cu.disable_opt |= (1 << kBranchFusing);
+    // Fused long branches not currently usseful in bitcode, nor are the null checks left by
+    // inlining supported.
+    cu.disable_opt |= (1 << kBranchFusing) | (1 << kMethodInlining);
   }
 
   if (cu.instruction_set == kMips) {
@@ -167,7 +174,19 @@ static CompiledMethod* CompileMethod(CompilerDriver& compiler,
         (1 << kSafeOptimizations) |
         (1 << kBBOpt) |
         (1 << kMatch) |
-        (1 << kPromoteCompilerTemps));
+        (1 << kPromoteCompilerTemps) |
+        (1 << kGlobalValueNumbering) |
+        (1 << kLoopInvariantCodeMotion) |
+        (1 << kBoundsCheckElimination) |
+        (1 << kMethodInlining) |
+        (1 << kLinearScanPromotion) |
+        (1 << kEscapeAnalysis));
+  }
+
+  if (compiler.IsDebuggable()) {
+    // The vmap table names one Dalvik register per callee-save register, which the debugger
+    // reads and writes through. Registers sharing one would be invisible to it, or clobbered.
+    cu.disable_opt |= (1 << kLinearScanPromotion);
   }
 
   cu.mir_graph.reset(new MIRGraph(&cu, &cu.arena));
@@ -190,18 +209,36 @@ static CompiledMethod* CompileMethod(CompilerDriver& compiler,
   /* Do a code layout pass */
   cu.mir_graph->CodeLayout();
 
+  /* Replace calls to small methods with their code */
+  cu.mir_graph->InlineCalls();
+
   /* Perform SSA transformation for the whole method */
   cu.mir_graph->SSATransformation();
 
   /* Do constant propagation */
   cu.mir_graph->PropagateConstants();
 
+  /* Find loops, which weigh uses by nesting depth */
+  cu.mir_graph->FindLoops();
+
   /* Count uses */
   cu.mir_graph->MethodUseCount();
 
   /* Perform null check elimination */
   cu.mir_graph->NullCheckElimination();
 
+  /* Replace objects that never escape the method with registers */
+  cu.mir_graph->EliminateAllocations();
+
+  /* Remove checks and loads made redundant by dominating ones */
+  cu.mir_graph->GlobalRedundancyElimination();
+
+  /* Remove range checks of indices known to be within their arrays */
+  cu.mir_graph->EliminateBoundsChecks();
+
+  /* Move loop invariant computations out of loops */
+  cu.mir_graph->LoopInvariantCodeMotion();
+
   /* Combine basic blocks where possible */
   cu.mir_graph->BasicBlockCombine();
 
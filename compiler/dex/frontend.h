@@ -56,6 +56,12 @@ enum opt_control_vector {
   kMatch,
   kPromoteCompilerTemps,
   kBranchFusing,
+  kGlobalValueNumbering,
+  kLoopInvariantCodeMotion,
+  kBoundsCheckElimination,
+  kMethodInlining,
+  kLinearScanPromotion,
+  kEscapeAnalysis,
 };
 
 // Force code generation paths for testing.
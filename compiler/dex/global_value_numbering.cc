@@ -0,0 +1,471 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "global_value_numbering.h"
+
+#include <set>
+
+#include "dataflow_iterator-inl.h"
+
+namespace art {
+
+// Value numbers are 16 bits wide, and the largest ones are reserved. Stop numbering well before.
+static const size_t kMaxValues = 0xf000;
+// How many blocks to search for memory writes reaching a join before forgetting all memory.
+static const size_t kMaxBlocksToSearch = 512;
+
+GlobalValueNumbering::GlobalValueNumbering(CompilationUnit* cu, MIRGraph* mir_graph)
+    : cu_(cu),
+      mir_graph_(mir_graph),
+      value_numbering_(cu),
+      memory_locations_(cu, mir_graph),
+      null_checks_eliminated_(0),
+      range_checks_eliminated_(0),
+      loads_eliminated_(0) {
+}
+
+void GlobalValueNumbering::Run() {
+  block_writes_.resize(mir_graph_->GetNumBlocks());
+  AllNodesIterator iter(mir_graph_, false /* not iterative */);
+  for (BasicBlock* bb = iter.Next(); bb != NULL; bb = iter.Next()) {
+    ComputeBlockWrites(bb);
+  }
+  current_ssa_map_.resize(cu_->num_dalvik_registers);
+
+  // Walk the dominator tree depth first, giving each block a scope of its own.
+  std::vector<std::pair<BasicBlock*, ArenaBitVector::Iterator*> > work_stack;
+  BasicBlock* bb = mir_graph_->GetEntryBlock();
+  while (true) {
+    if (bb != NULL) {
+      null_checked_.OpenScope();
+      range_checked_.OpenScope();
+      available_values_.OpenScope();
+      memory_versions_.OpenScope();
+      VisitBlock(bb);
+      work_stack.push_back(
+          std::make_pair(bb, new (&cu_->arena) ArenaBitVector::Iterator(bb->i_dominated)));
+    }
+    if (work_stack.empty()) {
+      break;
+    }
+    int child_id = work_stack.back().second->Next();
+    if (child_id != -1) {
+      bb = mir_graph_->GetBasicBlock(child_id);
+    } else {
+      null_checked_.CloseScope();
+      range_checked_.CloseScope();
+      available_values_.CloseScope();
+      memory_versions_.CloseScope();
+      work_stack.pop_back();
+      bb = NULL;
+    }
+  }
+}
+
+void GlobalValueNumbering::ComputeBlockWrites(BasicBlock* bb) {
+  BlockWrites& writes = block_writes_[bb->id];
+  // Catch handlers are entered after code that threw, such as a partly run invoke, so they
+  // count as writing anything.
+  writes.heap = bb->catch_entry;
+  for (MIR* mir = bb->first_mir_insn; mir != NULL; mir = mir->next) {
+    uint32_t location;
+    if (memory_locations_.GetWrittenLocation(mir, &location)) {
+      if (location == MemoryLocations::kHeapLocation) {
+        writes.heap = true;
+      } else {
+        writes.locations.push_back(location);
+      }
+    }
+  }
+}
+
+void GlobalValueNumbering::WriteLocation(uint32_t location, const void* version) {
+  memory_versions_.Add(location, version);
+}
+
+void GlobalValueNumbering::ForgetMemoryWrittenBefore(BasicBlock* bb) {
+  if (bb->catch_entry) {
+    WriteLocation(MemoryLocations::kHeapLocation, bb);
+    return;
+  }
+  bool join = false;
+  GrowableArray<BasicBlock*>::Iterator iter(bb->predecessors);
+  for (BasicBlock* pred_bb = iter.Next(); pred_bb != NULL; pred_bb = iter.Next()) {
+    join |= (pred_bb != bb->i_dom);
+  }
+  if (!join) {
+    return;
+  }
+
+  // Everything dominating bb is known on entry to its immediate dominator's end. Collect what
+  // the blocks reaching bb without passing through its immediate dominator may write.
+  std::vector<bool> visited(mir_graph_->GetNumBlocks(), false);
+  std::vector<BasicBlock*> work_list;
+  if (bb->i_dom != NULL) {
+    visited[bb->i_dom->id] = true;
+  }
+  work_list.push_back(bb);
+  bool writes_heap = false;
+  std::set<uint32_t> locations;
+  size_t num_searched = 0;
+  // Start from bb's predecessors; bb itself is only searched if it's in a loop.
+  bool first = true;
+  while (!work_list.empty() && !writes_heap) {
+    BasicBlock* search_bb = work_list.back();
+    work_list.pop_back();
+    if (!first) {
+      if (visited[search_bb->id]) {
+        continue;
+      }
+      visited[search_bb->id] = true;
+      if (++num_searched > kMaxBlocksToSearch) {
+        writes_heap = true;
+        break;
+      }
+      const BlockWrites& writes = block_writes_[search_bb->id];
+      writes_heap |= writes.heap;
+      locations.insert(writes.locations.begin(), writes.locations.end());
+    }
+    first = false;
+    GrowableArray<BasicBlock*>::Iterator pred_iter(search_bb->predecessors);
+    for (BasicBlock* pred_bb = pred_iter.Next(); pred_bb != NULL; pred_bb = pred_iter.Next()) {
+      if (!visited[pred_bb->id]) {
+        work_list.push_back(pred_bb);
+      }
+    }
+  }
+  if (writes_heap) {
+    WriteLocation(MemoryLocations::kHeapLocation, bb);
+  } else {
+    for (std::set<uint32_t>::const_iterator it = locations.begin(); it != locations.end(); ++it) {
+      WriteLocation(*it, bb);
+    }
+  }
+}
+
+void GlobalValueNumbering::ComputeEntrySsaMap(BasicBlock* bb) {
+  int num_regs = cu_->num_dalvik_registers;
+  bool first = true;
+  GrowableArray<BasicBlock*>::Iterator iter(bb->predecessors);
+  for (BasicBlock* pred_bb = iter.Next(); pred_bb != NULL; pred_bb = iter.Next()) {
+    if ((pred_bb->data_flow_info == NULL) ||
+        (pred_bb->data_flow_info->vreg_to_ssa_map == NULL)) {
+      continue;  // Unreachable.
+    }
+    // The snapshot is of the Dalvik registers at the end of the predecessor.
+    const int* pred_map = pred_bb->data_flow_info->vreg_to_ssa_map;
+    for (int v_reg = 0; v_reg < num_regs; v_reg++) {
+      if (first) {
+        current_ssa_map_[v_reg] = pred_map[v_reg];
+      } else if (current_ssa_map_[v_reg] != pred_map[v_reg]) {
+        // Only a Phi, which would redefine the register, tells which one the register holds.
+        current_ssa_map_[v_reg] = INVALID_SREG;
+      }
+    }
+    first = false;
+  }
+  if (first) {
+    // No predecessors: the method's entry, where each register holds its initial SSA name.
+    for (int v_reg = 0; v_reg < num_regs; v_reg++) {
+      current_ssa_map_[v_reg] = (bb->block_type == kEntryBlock) ? v_reg : INVALID_SREG;
+    }
+  }
+}
+
+void GlobalValueNumbering::VisitBlock(BasicBlock* bb) {
+  if ((bb->block_type == kDead) || (bb->data_flow_info == NULL)) {
+    return;
+  }
+  ComputeEntrySsaMap(bb);
+  ForgetMemoryWrittenBefore(bb);
+
+  // A block only entered by a branch on whether a reference is null may know it isn't.
+  if (bb->predecessors->Size() == 1) {
+    BasicBlock* pred_bb = bb->predecessors->Get(0);
+    MIR* last_mir = pred_bb->last_mir_insn;
+    if ((last_mir != NULL) && (pred_bb->taken != pred_bb->fall_through)) {
+      Instruction::Code last_opcode = last_mir->dalvikInsn.opcode;
+      if (((last_opcode == Instruction::IF_EQZ) && (pred_bb->fall_through == bb)) ||
+          ((last_opcode == Instruction::IF_NEZ) && (pred_bb->taken == bb))) {
+        null_checked_.Add(value_numbering_.GetOperandValue(last_mir->ssa_rep->uses[0]),
+                          last_mir);
+      }
+    }
+  }
+
+  for (MIR* mir = bb->first_mir_insn; mir != NULL; mir = mir->next) {
+    if (mir->ssa_rep == NULL) {
+      continue;
+    }
+    if (value_numbering_.GetNumValues() >= kMaxValues) {
+      return;
+    }
+    EliminateChecks(mir);
+
+    uint32_t location = MemoryLocations::kHeapLocation;
+    bool writes = memory_locations_.GetWrittenLocation(mir, &location);
+    Instruction::Code opcode = mir->dalvikInsn.opcode;
+    switch (opcode) {
+      case Instruction::IGET:
+      case Instruction::IGET_WIDE:
+      case Instruction::IGET_OBJECT:
+      case Instruction::IGET_BOOLEAN:
+      case Instruction::IGET_BYTE:
+      case Instruction::IGET_CHAR:
+      case Instruction::IGET_SHORT: {
+          uint32_t read_location;
+          if (memory_locations_.GetReadLocation(mir, &read_location)) {
+            uint16_t base = value_numbering_.GetOperandValue(mir->ssa_rep->uses[0]);
+            HandleLoad(mir, LocalValueNumbering::BuildKey(opcode, base, read_location & 0xffff, 0),
+                       read_location, opcode == Instruction::IGET_WIDE);
+          }
+        }
+        break;
+
+      case Instruction::SGET:
+      case Instruction::SGET_WIDE:
+      case Instruction::SGET_OBJECT:
+      case Instruction::SGET_BOOLEAN:
+      case Instruction::SGET_BYTE:
+      case Instruction::SGET_CHAR:
+      case Instruction::SGET_SHORT: {
+          uint32_t read_location;
+          if (memory_locations_.GetReadLocation(mir, &read_location)) {
+            HandleLoad(mir, LocalValueNumbering::BuildKey(opcode, NO_VALUE,
+                                                          read_location & 0xffff, 0),
+                       read_location, opcode == Instruction::SGET_WIDE);
+          }
+        }
+        break;
+
+      case Instruction::AGET:
+      case Instruction::AGET_WIDE:
+      case Instruction::AGET_OBJECT:
+      case Instruction::AGET_BOOLEAN:
+      case Instruction::AGET_BYTE:
+      case Instruction::AGET_CHAR:
+      case Instruction::AGET_SHORT: {
+          uint16_t array = value_numbering_.GetOperandValue(mir->ssa_rep->uses[0]);
+          uint16_t index = value_numbering_.GetOperandValue(mir->ssa_rep->uses[1]);
+          HandleLoad(mir, LocalValueNumbering::BuildKey(opcode, array, index, 0),
+                     MemoryLocations::kArrayLocation, opcode == Instruction::AGET_WIDE);
+        }
+        break;
+
+      case Instruction::IPUT:
+      case Instruction::IPUT_WIDE:
+      case Instruction::IPUT_OBJECT: {
+          WriteLocation(location, mir);
+          if (location != MemoryLocations::kHeapLocation) {
+            bool wide = (opcode == Instruction::IPUT_WIDE);
+            uint16_t base = value_numbering_.GetOperandValue(mir->ssa_rep->uses[wide ? 2 : 1]);
+            Instruction::Code load_opcode = (opcode == Instruction::IPUT) ? Instruction::IGET :
+                (wide ? Instruction::IGET_WIDE : Instruction::IGET_OBJECT);
+            HandleStore(mir, LocalValueNumbering::BuildKey(load_opcode, base,
+                                                           location & 0xffff, 0),
+                        location, wide);
+          }
+          writes = false;
+        }
+        break;
+
+      case Instruction::SPUT:
+      case Instruction::SPUT_WIDE:
+      case Instruction::SPUT_OBJECT: {
+          WriteLocation(location, mir);
+          if (location != MemoryLocations::kHeapLocation) {
+            bool wide = (opcode == Instruction::SPUT_WIDE);
+            Instruction::Code load_opcode = (opcode == Instruction::SPUT) ? Instruction::SGET :
+                (wide ? Instruction::SGET_WIDE : Instruction::SGET_OBJECT);
+            HandleStore(mir, LocalValueNumbering::BuildKey(load_opcode, NO_VALUE,
+                                                           location & 0xffff, 0),
+                        location, wide);
+          }
+          writes = false;
+        }
+        break;
+
+      case Instruction::APUT:
+      case Instruction::APUT_WIDE:
+      case Instruction::APUT_OBJECT: {
+          WriteLocation(location, mir);
+          bool wide = (opcode == Instruction::APUT_WIDE);
+          int array_idx = wide ? 2 : 1;
+          uint16_t array = value_numbering_.GetOperandValue(mir->ssa_rep->uses[array_idx]);
+          uint16_t index = value_numbering_.GetOperandValue(mir->ssa_rep->uses[array_idx + 1]);
+          Instruction::Code load_opcode = (opcode == Instruction::APUT) ? Instruction::AGET :
+              (wide ? Instruction::AGET_WIDE : Instruction::AGET_OBJECT);
+          HandleStore(mir, LocalValueNumbering::BuildKey(load_opcode, array, index, 0),
+                      location, wide);
+          writes = false;
+        }
+        break;
+
+      case Instruction::IPUT_BOOLEAN:
+      case Instruction::IPUT_BYTE:
+      case Instruction::IPUT_CHAR:
+      case Instruction::IPUT_SHORT:
+      case Instruction::SPUT_BOOLEAN:
+      case Instruction::SPUT_BYTE:
+      case Instruction::SPUT_CHAR:
+      case Instruction::SPUT_SHORT:
+      case Instruction::APUT_BOOLEAN:
+      case Instruction::APUT_BYTE:
+      case Instruction::APUT_CHAR:
+      case Instruction::APUT_SHORT:
+        // Loads sign or zero extend what these truncate, so don't forward the stored value.
+        break;
+
+      default:
+        value_numbering_.GetValueNumber(mir);
+        if ((MIRGraph::oat_data_flow_attributes_[opcode] & DF_NON_NULL_DST) != 0) {
+          null_checked_.Add(value_numbering_.GetOperandValue(mir->ssa_rep->defs[0]), mir);
+        }
+        break;
+    }
+    if (writes) {
+      WriteLocation(location, mir);
+    }
+
+    for (int i = 0; i < mir->ssa_rep->num_defs; i++) {
+      int s_reg = mir->ssa_rep->defs[i];
+      current_ssa_map_[mir_graph_->SRegToVReg(s_reg)] = s_reg;
+    }
+  }
+}
+
+void GlobalValueNumbering::EliminateChecks(MIR* mir) {
+  int df_attributes = MIRGraph::oat_data_flow_attributes_[mir->dalvikInsn.opcode];
+  if ((df_attributes & DF_HAS_NR_CHKS) == 0) {
+    return;
+  }
+  if ((df_attributes & DF_HAS_NULL_CHKS) != 0) {
+    int src_idx;
+    if (df_attributes & DF_NULL_CHK_1) {
+      src_idx = 1;
+    } else if (df_attributes & DF_NULL_CHK_2) {
+      src_idx = 2;
+    } else {
+      src_idx = 0;
+    }
+    uint16_t value = value_numbering_.GetOperandValue(mir->ssa_rep->uses[src_idx]);
+    if (null_checked_.Lookup(value) != NULL) {
+      if ((mir->optimization_flags & MIR_IGNORE_NULL_CHECK) == 0) {
+        if (cu_->verbose) {
+          LOG(INFO) << "Removing null check for 0x" << std::hex << mir->offset;
+        }
+        mir->optimization_flags |= MIR_IGNORE_NULL_CHECK;
+        null_checks_eliminated_++;
+      }
+    } else {
+      null_checked_.Add(value, mir);
+    }
+  }
+  if ((df_attributes & DF_HAS_RANGE_CHKS) != 0) {
+    int array_s_reg;
+    int index_s_reg;
+    mir_graph_->GetRangeCheckOperands(mir, &array_s_reg, &index_s_reg);
+    uint16_t array = value_numbering_.GetOperandValue(array_s_reg);
+    uint16_t index = value_numbering_.GetOperandValue(index_s_reg);
+    uint32_t key = (static_cast<uint32_t>(array) << 16) | index;
+    if (range_checked_.Lookup(key) != NULL) {
+      if ((mir->optimization_flags & MIR_IGNORE_RANGE_CHECK) == 0) {
+        mir_graph_->IgnoreRangeCheck(mir);
+        range_checks_eliminated_++;
+      }
+    } else {
+      range_checked_.Add(key, mir);
+    }
+  }
+  // The check half of the instruction is the one generating the null check too.
+  if ((mir->meta.throw_insn != NULL) && ((mir->optimization_flags & MIR_IGNORE_NULL_CHECK) != 0)) {
+    mir->meta.throw_insn->optimization_flags |= MIR_IGNORE_NULL_CHECK;
+  }
+}
+
+void GlobalValueNumbering::HandleLoad(MIR* mir, uint64_t key, uint32_t location, bool wide) {
+  const void* heap_version = memory_versions_.Lookup(MemoryLocations::kHeapLocation);
+  const void* location_version = memory_versions_.Lookup(location);
+  AvailableValue* value = available_values_.Lookup(key);
+  if ((value != NULL) && (value->heap_version == heap_version) &&
+      (value->location_version == location_version) && IsCurrent(value->s_reg) &&
+      (!wide || IsCurrent(value->s_reg_high))) {
+    if (wide) {
+      value_numbering_.SetOperandValueWide(mir->ssa_rep->defs[0],
+                                           value_numbering_.GetOperandValueWide(value->s_reg));
+    } else {
+      value_numbering_.SetOperandValue(mir->ssa_rep->defs[0],
+                                       value_numbering_.GetOperandValue(value->s_reg));
+    }
+    ReplaceWithMove(mir, value);
+    loads_eliminated_++;
+  }
+  // Later loads may use the register this load defines.
+  value = static_cast<AvailableValue*>(cu_->arena.Alloc(sizeof(AvailableValue),
+                                                        ArenaAllocator::kAllocMisc));
+  value->s_reg = mir->ssa_rep->defs[0];
+  value->s_reg_high = wide ? mir->ssa_rep->defs[1] : INVALID_SREG;
+  value->heap_version = heap_version;
+  value->location_version = location_version;
+  available_values_.Add(key, value);
+}
+
+void GlobalValueNumbering::HandleStore(MIR* mir, uint64_t key, uint32_t location, bool wide) {
+  AvailableValue* value = static_cast<AvailableValue*>(
+      cu_->arena.Alloc(sizeof(AvailableValue), ArenaAllocator::kAllocMisc));
+  value->s_reg = mir->ssa_rep->uses[0];
+  value->s_reg_high = wide ? mir->ssa_rep->uses[1] : INVALID_SREG;
+  value->heap_version = memory_versions_.Lookup(MemoryLocations::kHeapLocation);
+  value->location_version = memory_versions_.Lookup(location);
+  available_values_.Add(key, value);
+}
+
+void GlobalValueNumbering::ReplaceWithMove(MIR* mir, const AvailableValue* value) {
+  Instruction::Code opcode = mir->dalvikInsn.opcode;
+  bool wide = (value->s_reg_high != INVALID_SREG);
+  Instruction::Code move_opcode;
+  if (wide) {
+    move_opcode = Instruction::MOVE_WIDE;
+  } else if ((opcode == Instruction::IGET_OBJECT) || (opcode == Instruction::SGET_OBJECT) ||
+             (opcode == Instruction::AGET_OBJECT)) {
+    move_opcode = Instruction::MOVE_OBJECT;
+  } else {
+    move_opcode = Instruction::MOVE;
+  }
+  if (cu_->verbose) {
+    LOG(INFO) << "Replacing redundant load at 0x" << std::hex << mir->offset << " with a move";
+  }
+  mir->dalvikInsn.opcode = move_opcode;
+  mir->dalvikInsn.vB = mir_graph_->SRegToVReg(value->s_reg);
+  mir->dalvikInsn.vC = 0;
+  SSARepresentation* ssa_rep = mir->ssa_rep;
+  int num_uses = wide ? 2 : 1;
+  if (ssa_rep->num_uses < num_uses) {
+    ssa_rep->uses = static_cast<int*>(cu_->arena.Alloc(sizeof(int) * num_uses,
+                                                       ArenaAllocator::kAllocDFInfo));
+    ssa_rep->fp_use = static_cast<bool*>(cu_->arena.Alloc(sizeof(bool) * num_uses,
+                                                          ArenaAllocator::kAllocDFInfo));
+  }
+  ssa_rep->num_uses = num_uses;
+  ssa_rep->uses[0] = value->s_reg;
+  ssa_rep->fp_use[0] = false;
+  if (wide) {
+    ssa_rep->uses[1] = value->s_reg_high;
+    ssa_rep->fp_use[1] = false;
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_DEX_GLOBAL_VALUE_NUMBERING_H_
+#define ART_COMPILER_DEX_GLOBAL_VALUE_NUMBERING_H_
+
+#include <vector>
+
+#include "compiler_internals.h"
+#include "local_value_numbering.h"
+#include "memory_locations.h"
+#include "utils/scoped_hashtable.h"
+
+namespace art {
+
+/*
+ * Value numbering over the whole method, visiting blocks in dominator tree order. Everything
+ * known on entry to a block was learned in the blocks dominating it, and is forgotten again when
+ * leaving the block's dominator subtree, so the tables holding it are scoped.
+ *
+ * Expressions are numbered as by LocalValueNumbering. On top of that, this pass removes:
+ *  - null checks of values already null checked by a dominating instruction,
+ *  - range checks of (array, index) pairs already range checked by a dominating instruction,
+ *  - field and array loads whose value a dominating load or store already holds in a Dalvik
+ *    register, which become moves.
+ *
+ * Loads from memory are only reused while nothing may have written the memory since. A block
+ * entered from other blocks than its immediate dominator, such as a loop header, forgets any
+ * memory written on the paths reaching it, and catch handlers forget all memory. A load is only
+ * replaced while the Dalvik register holding the earlier value hasn't been redefined, as the
+ * value lives nowhere else (see MIRGraph::SRegToVReg).
+ */
+class GlobalValueNumbering {
+ public:
+  GlobalValueNumbering(CompilationUnit* cu, MIRGraph* mir_graph);
+
+  void Run();
+
+  int GetNullChecksEliminated() const {
+    return null_checks_eliminated_;
+  }
+
+  int GetRangeChecksEliminated() const {
+    return range_checks_eliminated_;
+  }
+
+  int GetLoadsEliminated() const {
+    return loads_eliminated_;
+  }
+
+ private:
+  // A value held in a Dalvik register that a later load may reuse, and the versions of memory it
+  // was loaded from or stored to.
+  struct AvailableValue {
+    int s_reg;
+    int s_reg_high;  // INVALID_SREG unless wide.
+    const void* heap_version;
+    const void* location_version;
+  };
+
+  // The memory a block may write.
+  struct BlockWrites {
+    bool heap;
+    std::vector<uint32_t> locations;
+  };
+
+  void ComputeBlockWrites(BasicBlock* bb);
+  void ForgetMemoryWrittenBefore(BasicBlock* bb);
+  void WriteLocation(uint32_t location, const void* version);
+
+  void ComputeEntrySsaMap(BasicBlock* bb);
+  bool IsCurrent(int s_reg) const {
+    return current_ssa_map_[mir_graph_->SRegToVReg(s_reg)] == s_reg;
+  }
+
+  void VisitBlock(BasicBlock* bb);
+  void EliminateChecks(MIR* mir);
+  // Numbers the value mir loads from location, replacing the load with a move when possible.
+  void HandleLoad(MIR* mir, uint64_t key, uint32_t location, bool wide);
+  void HandleStore(MIR* mir, uint64_t key, uint32_t location, bool wide);
+  void ReplaceWithMove(MIR* mir, const AvailableValue* value);
+
+  CompilationUnit* const cu_;
+  MIRGraph* const mir_graph_;
+  LocalValueNumbering value_numbering_;
+  MemoryLocations memory_locations_;
+
+  // What dominating instructions established, by value number.
+  utils::ScopedHashtable<uint16_t, MIR*> null_checked_;
+  utils::ScopedHashtable<uint32_t, MIR*> range_checked_;
+  utils::ScopedHashtable<uint64_t, AvailableValue*> available_values_;
+  // The last write of each location, or NULL while unwritten.
+  utils::ScopedHashtable<uint32_t, const void*> memory_versions_;
+
+  std::vector<BlockWrites> block_writes_;
+  // The SSA name each Dalvik register holds at the current instruction, or INVALID_SREG.
+  std::vector<int> current_ssa_map_;
+
+  int null_checks_eliminated_;
+  int range_checks_eliminated_;
+  int loads_eliminated_;
+
+  DISALLOW_COPY_AND_ASSIGN(GlobalValueNumbering);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_DEX_GLOBAL_VALUE_NUMBERING_H_
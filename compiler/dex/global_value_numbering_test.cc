@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2011 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dex/global_value_numbering.h"
+
+#include "common_test.h"
+#include "dex/compiler_ir.h"
+#include "mirror/art_method-inl.h"
+#include "mirror/class-inl.h"
+#include "object_utils.h"
+
+namespace art {
+
+class GlobalValueNumberingTest : public CommonTest {
+ protected:
+  // Builds the SSA form of a ValueNumbering method, as the compiler does before running GVN.
+  void BuildGraph(CompilationUnit* cu, const char* name, const char* signature)
+      LOCKS_EXCLUDED(Locks::mutator_lock_) {
+    jobject class_loader;
+    const DexFile* dex_file;
+    const DexFile::CodeItem* code_item;
+    uint32_t access_flags;
+    uint16_t class_def_idx;
+    uint32_t method_idx;
+    {
+      ScopedObjectAccess soa(Thread::Current());
+      class_loader = LoadDex("ValueNumbering");
+      mirror::Class* klass = class_linker_->FindClass(
+          "LValueNumbering;", soa.Decode<mirror::ClassLoader*>(class_loader));
+      CHECK(klass != NULL);
+      mirror::ArtMethod* method = klass->FindVirtualMethod(name, signature);
+      CHECK(method != NULL) << name;
+      MethodHelper mh(method);
+      dex_file = &mh.GetDexFile();
+      code_item = mh.GetCodeItem();
+      access_flags = method->GetAccessFlags();
+      class_def_idx = klass->GetDexClassDefIndex();
+      method_idx = method->GetDexMethodIndex();
+    }
+    cu->compiler_driver = compiler_driver_.get();
+    cu->class_linker = class_linker_;
+    cu->instruction_set = compiler_driver_->GetInstructionSet();
+    cu->mir_graph.reset(new MIRGraph(cu, &cu->arena));
+    cu->mir_graph->InlineMethod(code_item, access_flags, kVirtual, class_def_idx, method_idx,
+                                class_loader, *dex_file);
+    cu->mir_graph->CodeLayout();
+    cu->mir_graph->SSATransformation();
+    cu->mir_graph->PropagateConstants();
+  }
+};
+
+TEST_F(GlobalValueNumberingTest, LoopBody) {
+  CompilationUnit cu(&compiler_driver_->GetArenaPool());
+  BuildGraph(&cu, "incrementAll", "()I");
+  GlobalValueNumbering gvn(&cu, cu.mir_graph.get());
+  gvn.Run();
+  // The second loads of values[i] and count become moves from value and c.
+  EXPECT_LE(2, gvn.GetLoadsEliminated());
+  // The loop condition's array-length checks values, and loading this.values checks this.
+  EXPECT_LE(2, gvn.GetNullChecksEliminated());
+  // Storing values[i] follows loading it.
+  EXPECT_LE(1, gvn.GetRangeChecksEliminated());
+}
+
+}  // namespace art
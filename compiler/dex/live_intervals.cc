@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "live_intervals.h"
+
+#include <algorithm>
+
+#include "dataflow_iterator-inl.h"
+
+namespace art {
+
+// Bound the liveness sets, of blocks times registers bits each.
+static const size_t kMaxLivenessBits = 4 * 1024 * 1024;
+
+static bool RangeStartsBefore(const LiveIntervals::Range& a, const LiveIntervals::Range& b) {
+  return a.start < b.start;
+}
+
+LiveIntervals::LiveIntervals(CompilationUnit* cu, MIRGraph* mir_graph)
+    : cu_(cu),
+      mir_graph_(mir_graph),
+      num_vregs_(cu->num_dalvik_registers),
+      last_position_(0) {
+}
+
+bool LiveIntervals::Compute() {
+  size_t num_blocks = mir_graph_->GetNumBlocks();
+  if (num_blocks * static_cast<size_t>(std::max(num_vregs_, 1)) > kMaxLivenessBits) {
+    return false;
+  }
+  NumberBlocks();
+  use_v_.resize(num_blocks, NULL);
+  def_v_.resize(num_blocks, NULL);
+  live_in_v_.resize(num_blocks, NULL);
+  live_out_v_.resize(num_blocks, NULL);
+  for (size_t i = 0; i < blocks_.size(); i++) {
+    ComputeLocalSets(blocks_[i]);
+  }
+  ComputeLiveOut();
+
+  live_end_.assign(num_vregs_, -1);
+  ranges_.resize(num_vregs_);
+  for (size_t i = 0; i < blocks_.size(); i++) {
+    BuildRanges(blocks_[i]);
+  }
+  // The ins are written on entry to the method, whether read later or not.
+  const DexFile::CodeItem* code_item = cu_->code_item;
+  for (int v_reg = code_item->registers_size_ - code_item->ins_size_; v_reg < num_vregs_;
+       v_reg++) {
+    AddRange(v_reg, 0, 0);
+  }
+  SortRanges();
+  return true;
+}
+
+void LiveIntervals::NumberBlocks() {
+  size_t num_blocks = mir_graph_->GetNumBlocks();
+  block_start_.resize(num_blocks, -1);
+  block_end_.resize(num_blocks, -1);
+  int position = 0;
+  PreOrderDfsIterator iter(mir_graph_, false /* not iterative */);
+  for (BasicBlock* bb = iter.Next(); bb != NULL; bb = iter.Next()) {
+    if ((bb->block_type == kDead) || (bb->data_flow_info == NULL)) {
+      continue;
+    }
+    blocks_.push_back(bb);
+    block_start_[bb->id] = position++;
+    for (MIR* mir = bb->first_mir_insn; mir != NULL; mir = mir->next) {
+      position++;
+    }
+    block_end_[bb->id] = position++;
+  }
+  last_position_ = position - 1;
+}
+
+void LiveIntervals::ComputeLocalSets(BasicBlock* bb) {
+  ArenaBitVector* use_v =
+      new (&cu_->arena) ArenaBitVector(&cu_->arena, num_vregs_, false, kBitMapUse);
+  ArenaBitVector* def_v =
+      new (&cu_->arena) ArenaBitVector(&cu_->arena, num_vregs_, false, kBitMapDef);
+  for (MIR* mir = bb->first_mir_insn; mir != NULL; mir = mir->next) {
+    if ((mir->ssa_rep == NULL) || (static_cast<int>(mir->dalvikInsn.opcode) == kMirOpPhi)) {
+      continue;
+    }
+    for (int i = 0; i < mir->ssa_rep->num_uses; i++) {
+      int v_reg = mir_graph_->SRegToVReg(mir->ssa_rep->uses[i]);
+      if ((v_reg >= 0) && !def_v->IsBitSet(v_reg)) {
+        use_v->SetBit(v_reg);
+      }
+    }
+    for (int i = 0; i < mir->ssa_rep->num_defs; i++) {
+      int v_reg = mir_graph_->SRegToVReg(mir->ssa_rep->defs[i]);
+      if (v_reg >= 0) {
+        def_v->SetBit(v_reg);
+      }
+    }
+  }
+  use_v_[bb->id] = use_v;
+  def_v_[bb->id] = def_v;
+  live_in_v_[bb->id] = new (&cu_->arena) ArenaBitVector(&cu_->arena, num_vregs_, false,
+                                                        kBitMapLiveIn);
+  live_out_v_[bb->id] = new (&cu_->arena) ArenaBitVector(&cu_->arena, num_vregs_, false,
+                                                         kBitMapLiveIn);
+}
+
+void LiveIntervals::ComputeLiveOut() {
+  ArenaBitVector* live_in =
+      new (&cu_->arena) ArenaBitVector(&cu_->arena, num_vregs_, false, kBitMapLiveIn);
+  std::vector<BasicBlock*> succs;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t i = blocks_.size(); i-- != 0;) {
+      BasicBlock* bb = blocks_[i];
+      succs.clear();
+      succs.push_back(bb->taken);
+      succs.push_back(bb->fall_through);
+      if (bb->successor_block_list.block_list_type != kNotUsed) {
+        GrowableArray<SuccessorBlockInfo*>::Iterator iter(bb->successor_block_list.blocks);
+        for (SuccessorBlockInfo* info = iter.Next(); info != NULL; info = iter.Next()) {
+          succs.push_back(info->block);
+        }
+      }
+      ArenaBitVector* live_out = live_out_v_[bb->id];
+      for (size_t j = 0; j < succs.size(); j++) {
+        if ((succs[j] != NULL) && (live_in_v_[succs[j]->id] != NULL)) {
+          live_out->Union(live_in_v_[succs[j]->id]);
+        }
+      }
+      live_in->Copy(live_out);
+      ArenaBitVector::Iterator def_iter(def_v_[bb->id]);
+      for (int v_reg = def_iter.Next(); v_reg != -1; v_reg = def_iter.Next()) {
+        live_in->ClearBit(v_reg);
+      }
+      live_in->Union(use_v_[bb->id]);
+      if (!live_in->Equal(live_in_v_[bb->id])) {
+        live_in_v_[bb->id]->Copy(live_in);
+        changed = true;
+      }
+    }
+  }
+}
+
+void LiveIntervals::BuildRanges(BasicBlock* bb) {
+  std::vector<int> live;
+  ArenaBitVector::Iterator out_iter(live_out_v_[bb->id]);
+  for (int v_reg = out_iter.Next(); v_reg != -1; v_reg = out_iter.Next()) {
+    live_end_[v_reg] = block_end_[bb->id];
+    live.push_back(v_reg);
+  }
+  // Walk back from the block's end, closing the range of each register at its definition.
+  int position = block_end_[bb->id];
+  for (MIR* mir = bb->last_mir_insn; mir != NULL; mir = mir->prev) {
+    position--;
+    if ((mir->ssa_rep == NULL) || (static_cast<int>(mir->dalvikInsn.opcode) == kMirOpPhi)) {
+      continue;
+    }
+    for (int i = 0; i < mir->ssa_rep->num_defs; i++) {
+      int v_reg = mir_graph_->SRegToVReg(mir->ssa_rep->defs[i]);
+      if (v_reg < 0) {
+        continue;
+      }
+      if (live_end_[v_reg] >= 0) {
+        AddRange(v_reg, position, live_end_[v_reg]);
+        live_end_[v_reg] = -1;
+      } else {
+        AddRange(v_reg, position, position);
+      }
+    }
+    for (int i = 0; i < mir->ssa_rep->num_uses; i++) {
+      int v_reg = mir_graph_->SRegToVReg(mir->ssa_rep->uses[i]);
+      if ((v_reg >= 0) && (live_end_[v_reg] < 0)) {
+        live_end_[v_reg] = position;
+        live.push_back(v_reg);
+      }
+    }
+  }
+  DCHECK_EQ(position, block_start_[bb->id] + 1);
+  for (size_t i = 0; i < live.size(); i++) {
+    int v_reg = live[i];
+    if (live_end_[v_reg] >= 0) {
+      AddRange(v_reg, block_start_[bb->id], live_end_[v_reg]);
+      live_end_[v_reg] = -1;
+    }
+  }
+}
+
+void LiveIntervals::AddRange(int v_reg, int start, int end) {
+  Range range = {start, end};
+  ranges_[v_reg].push_back(range);
+}
+
+void LiveIntervals::SortRanges() {
+  for (int v_reg = 0; v_reg < num_vregs_; v_reg++) {
+    std::vector<Range>& ranges = ranges_[v_reg];
+    if (ranges.empty()) {
+      continue;
+    }
+    std::sort(ranges.begin(), ranges.end(), RangeStartsBefore);
+    // Merge ranges that overlap or leave no position between them.
+    size_t last = 0;
+    for (size_t i = 1; i < ranges.size(); i++) {
+      if (ranges[i].start <= ranges[last].end + 1) {
+        ranges[last].end = std::max(ranges[last].end, ranges[i].end);
+      } else {
+        ranges[++last] = ranges[i];
+      }
+    }
+    ranges.resize(last + 1);
+  }
+}
+
+bool LiveIntervals::Intersect(const std::vector<Range>& a, const std::vector<Range>& b) {
+  size_t i = 0;
+  size_t j = 0;
+  while ((i < a.size()) && (j < b.size())) {
+    if (a[i].end < b[j].start) {
+      i++;
+    } else if (b[j].end < a[i].start) {
+      j++;
+    } else {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace art
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_DEX_LIVE_INTERVALS_H_
+#define ART_COMPILER_DEX_LIVE_INTERVALS_H_
+
+#include <vector>
+
+#include "compiler_internals.h"
+
+namespace art {
+
+/*
+ * The live intervals of the method's Dalvik registers, over positions numbering the MIRs of the
+ * reachable blocks in depth first order. It is the Dalvik registers that are live rather than
+ * SSA names, which have no location of their own (see MIRGraph::SRegToVReg), and phis are
+ * ignored.
+ *
+ * An interval is a sorted list of disjoint ranges, with lifetime holes between them where the
+ * register holds no value that is read later. A register is live from each definition through
+ * its last use, and the definitions and uses of an instruction all overlap at its position.
+ */
+class LiveIntervals {
+ public:
+  struct Range {
+    int start;
+    int end;  // Inclusive.
+  };
+
+  LiveIntervals(CompilationUnit* cu, MIRGraph* mir_graph);
+
+  // Returns false when the method is too large to analyze.
+  bool Compute();
+
+  const std::vector<Range>& GetRanges(int v_reg) const {
+    return ranges_[v_reg];
+  }
+
+  int GetLastPosition() const {
+    return last_position_;
+  }
+
+  static bool Intersect(const std::vector<Range>& a, const std::vector<Range>& b);
+
+ private:
+  void NumberBlocks();
+  void ComputeLocalSets(BasicBlock* bb);
+  void ComputeLiveOut();
+  void BuildRanges(BasicBlock* bb);
+  void AddRange(int v_reg, int start, int end);
+  void SortRanges();
+
+  CompilationUnit* const cu_;
+  MIRGraph* const mir_graph_;
+  const int num_vregs_;
+
+  // The blocks in linear order, and their first and last positions, by block id.
+  std::vector<BasicBlock*> blocks_;
+  std::vector<int> block_start_;
+  std::vector<int> block_end_;
+  int last_position_;
+
+  // Registers read before being written, written, and live on exit, by block id.
+  std::vector<ArenaBitVector*> use_v_;
+  std::vector<ArenaBitVector*> def_v_;
+  std::vector<ArenaBitVector*> live_in_v_;
+  std::vector<ArenaBitVector*> live_out_v_;
+
+  // The end of the range of each register being built, or -1.
+  std::vector<int> live_end_;
+  std::vector<std::vector<Range> > ranges_;
+
+  DISALLOW_COPY_AND_ASSIGN(LiveIntervals);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_DEX_LIVE_INTERVALS_H_
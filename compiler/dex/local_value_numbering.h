@@ -128,6 +128,10 @@ class LocalValueNumbering {
 
   uint16_t GetValueNumber(MIR* mir);
 
+  size_t GetNumValues() const {
+    return value_map_.size();
+  }
+
  private:
   CompilationUnit* const cu_;
   SregValueMap sreg_value_map_;
@@ -0,0 +1,381 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "loop_invariant_code_motion.h"
+
+#include "dataflow_iterator-inl.h"
+
+namespace art {
+
+// Returns the check half of a throwing instruction's work half, or NULL.
+static MIR* GetCheckHalf(MIR* mir) {
+  if (static_cast<int>(mir->dalvikInsn.opcode) >= kMirOpFirst) {
+    return NULL;
+  }
+  MIR* check = mir->meta.throw_insn;
+  if ((check == NULL) || (static_cast<int>(check->dalvikInsn.opcode) != kMirOpCheck) ||
+      (check->meta.throw_insn != mir)) {
+    return NULL;
+  }
+  return check;
+}
+
+static void GetSuccessors(BasicBlock* bb, std::vector<BasicBlock*>* successors) {
+  successors->clear();
+  if (bb->taken != NULL) {
+    successors->push_back(bb->taken);
+  }
+  if (bb->fall_through != NULL) {
+    successors->push_back(bb->fall_through);
+  }
+  if (bb->successor_block_list.block_list_type != kNotUsed) {
+    GrowableArray<SuccessorBlockInfo*>::Iterator iter(bb->successor_block_list.blocks);
+    for (SuccessorBlockInfo* info = iter.Next(); info != NULL; info = iter.Next()) {
+      successors->push_back(info->block);
+    }
+  }
+}
+
+LoopInvariantCodeMotion::LoopInvariantCodeMotion(CompilationUnit* cu, MIRGraph* mir_graph)
+    : cu_(cu),
+      mir_graph_(mir_graph),
+      memory_locations_(cu, mir_graph),
+      loop_(NULL),
+      loop_defs_(NULL),
+      writes_heap_(false),
+      insert_after_(NULL),
+      num_hoisted_(0) {
+}
+
+void LoopInvariantCodeMotion::Run() {
+  GrowableArray<LoopInfo*>* loops = mir_graph_->GetLoops();
+  if (loops->Size() == 0) {
+    return;
+  }
+  int num_ssa_regs = mir_graph_->GetNumSSARegs();
+  use_counts_.assign(num_ssa_regs, 0);
+  AllNodesIterator iter(mir_graph_, false /* not iterative */);
+  for (BasicBlock* bb = iter.Next(); bb != NULL; bb = iter.Next()) {
+    for (MIR* mir = bb->first_mir_insn; mir != NULL; mir = mir->next) {
+      if (mir->ssa_rep != NULL) {
+        for (int i = 0; i < mir->ssa_rep->num_uses; i++) {
+          use_counts_[mir->ssa_rep->uses[i]]++;
+        }
+      }
+    }
+  }
+  loop_defs_ = new (&cu_->arena) ArenaBitVector(&cu_->arena, num_ssa_regs,
+                                                false /* expandable */, kBitMapMisc);
+
+  // Nested loops come first, so what they hoist may be hoisted again out of the outer loops.
+  GrowableArray<LoopInfo*>::Iterator loop_iter(loops);
+  for (LoopInfo* loop = loop_iter.Next(); loop != NULL; loop = loop_iter.Next()) {
+    BasicBlock* preheader = FindPreheader(loop);
+    if (preheader != NULL) {
+      AnalyzeLoop(loop);
+      HoistInvariants(loop, preheader);
+    }
+  }
+}
+
+BasicBlock* LoopInvariantCodeMotion::FindPreheader(const LoopInfo* loop) {
+  BasicBlock* header = loop->header;
+  if (header->catch_entry) {
+    return NULL;
+  }
+  BasicBlock* preheader = NULL;
+  GrowableArray<BasicBlock*>::Iterator iter(header->predecessors);
+  for (BasicBlock* pred_bb = iter.Next(); pred_bb != NULL; pred_bb = iter.Next()) {
+    if (!loop->blocks->IsBitSet(pred_bb->id)) {
+      if (preheader != NULL) {
+        return NULL;
+      }
+      preheader = pred_bb;
+    }
+  }
+  // The preheader must only lead to the loop, so that what it runs is run by the loop.
+  if ((preheader == NULL) || (preheader->block_type != kDalvikByteCode) ||
+      (preheader->data_flow_info == NULL) ||
+      (preheader->data_flow_info->vreg_to_ssa_map == NULL) ||
+      (preheader->successor_block_list.block_list_type != kNotUsed) ||
+      !(((preheader->taken == header) && (preheader->fall_through == NULL)) ||
+        ((preheader->fall_through == header) && (preheader->taken == NULL)))) {
+    return NULL;
+  }
+  insert_after_ = preheader->last_mir_insn;
+  if ((insert_after_ != NULL) &&
+      (static_cast<int>(insert_after_->dalvikInsn.opcode) < kMirOpFirst) &&
+      ((Instruction::FlagsOf(insert_after_->dalvikInsn.opcode) & Instruction::kBranch) != 0)) {
+    // A backward goto tests for suspension, and the GC map there doesn't know hoisted values.
+    if (header->start_offset <= insert_after_->offset) {
+      return NULL;
+    }
+    insert_after_ = insert_after_->prev;
+  }
+  return preheader;
+}
+
+void LoopInvariantCodeMotion::AnalyzeLoop(const LoopInfo* loop) {
+  loop_ = loop;
+  loop_use_counts_.assign(mir_graph_->GetNumSSARegs(), 0);
+  loop_defs_->ClearAllBits();
+  loop_vreg_defs_.assign(cu_->num_dalvik_registers, 0);
+  loop_vreg_uses_.assign(cu_->num_dalvik_registers, kNoUses);
+  exiting_blocks_.clear();
+  writes_heap_ = false;
+  written_locations_.clear();
+
+  std::vector<BasicBlock*> successors;
+  ArenaBitVector::Iterator block_iter(loop->blocks);
+  for (int block_id = block_iter.Next(); block_id != -1; block_id = block_iter.Next()) {
+    BasicBlock* bb = mir_graph_->GetBasicBlock(block_id);
+    // Catch handlers are entered after code that threw, such as a partly run invoke.
+    writes_heap_ |= bb->catch_entry;
+    GetSuccessors(bb, &successors);
+    for (size_t i = 0; i < successors.size(); i++) {
+      if (!loop->blocks->IsBitSet(successors[i]->id)) {
+        exiting_blocks_.push_back(bb);
+        break;
+      }
+    }
+    for (MIR* mir = bb->first_mir_insn; mir != NULL; mir = mir->next) {
+      uint32_t location;
+      if (memory_locations_.GetWrittenLocation(mir, &location)) {
+        if (location == MemoryLocations::kHeapLocation) {
+          writes_heap_ = true;
+        } else {
+          written_locations_.insert(location);
+        }
+      }
+      if (mir->ssa_rep == NULL) {
+        continue;
+      }
+      for (int i = 0; i < mir->ssa_rep->num_uses; i++) {
+        int s_reg = mir->ssa_rep->uses[i];
+        loop_use_counts_[s_reg]++;
+        int v_reg = mir_graph_->SRegToVReg(s_reg);
+        if (v_reg >= 0) {
+          int& vreg_use = loop_vreg_uses_[v_reg];
+          vreg_use = ((vreg_use == kNoUses) || (vreg_use == s_reg)) ? s_reg : kManyUses;
+        }
+      }
+      for (int i = 0; i < mir->ssa_rep->num_defs; i++) {
+        int s_reg = mir->ssa_rep->defs[i];
+        loop_defs_->SetBit(s_reg);
+        int v_reg = mir_graph_->SRegToVReg(s_reg);
+        if (v_reg >= 0) {
+          loop_vreg_defs_[v_reg]++;
+        }
+      }
+    }
+  }
+}
+
+void LoopInvariantCodeMotion::HoistInvariants(const LoopInfo* loop, BasicBlock* preheader) {
+  // Visit the loop in dominator tree order, so that operands are hoisted before their uses.
+  // Loads may only move while they are the first thing to run in the loop, on the chain of
+  // blocks that always runs from the header on.
+  BasicBlock* chain_bb = loop->header;
+  std::vector<BasicBlock*> work_stack;
+  work_stack.push_back(loop->header);
+  while (!work_stack.empty()) {
+    BasicBlock* bb = work_stack.back();
+    work_stack.pop_back();
+    bool in_chain = (bb == chain_bb);
+    chain_bb = NULL;
+    MIR* next_mir;
+    for (MIR* mir = bb->first_mir_insn; mir != NULL; mir = next_mir) {
+      next_mir = mir->next;
+      int opcode = mir->dalvikInsn.opcode;
+      if (opcode == kMirOpCheck) {
+        // The work half heads the fall through block. Without catch handlers to branch to, the
+        // pair becomes a single instruction in the preheader.
+        MIR* work_half = mir->meta.throw_insn;
+        if ((bb->successor_block_list.block_list_type != kNotUsed) ||
+            (bb->fall_through == NULL) || (bb->fall_through->first_mir_insn != work_half) ||
+            !IsHoistable(work_half, in_chain)) {
+          in_chain = false;
+          continue;
+        }
+        Hoist(work_half, bb->fall_through, preheader);
+        mir->meta.original_opcode = work_half->dalvikInsn.opcode;
+        mir->dalvikInsn.opcode = static_cast<Instruction::Code>(kMirOpNop);
+        if ((bb->taken != NULL) && (bb->taken->block_type == kExceptionHandling)) {
+          bb->taken->block_type = kDead;
+          bb->taken = NULL;
+        }
+      } else if ((opcode == kMirOpPhi) || (opcode == kMirOpNop)) {
+        continue;
+      } else if (GetCheckHalf(mir) != NULL) {
+        // Considered with its check half already.
+        in_chain = false;
+      } else if (IsHoistable(mir, false)) {
+        Hoist(mir, bb, preheader);
+      } else if (!IsPure(mir) && ((opcode >= kMirOpFirst) ||
+                 ((Instruction::FlagsOf(mir->dalvikInsn.opcode) & Instruction::kUnconditional) ==
+                  0))) {
+        // Anything that may throw or write memory has to run before hoisted loads.
+        in_chain = false;
+      }
+    }
+    // The chain goes on into a block that only this one leads to.
+    if (in_chain && (bb->successor_block_list.block_list_type == kNotUsed) &&
+        ((bb->taken == NULL) != (bb->fall_through == NULL))) {
+      BasicBlock* next_bb = (bb->taken != NULL) ? bb->taken : bb->fall_through;
+      if ((next_bb != loop->header) && loop->blocks->IsBitSet(next_bb->id) &&
+          (next_bb->predecessors->Size() == 1)) {
+        chain_bb = next_bb;
+      }
+    }
+    if (bb->i_dominated == NULL) {
+      continue;
+    }
+    ArenaBitVector::Iterator child_iter(bb->i_dominated);
+    for (int child_id = child_iter.Next(); child_id != -1; child_id = child_iter.Next()) {
+      if (loop->blocks->IsBitSet(child_id)) {
+        work_stack.push_back(mir_graph_->GetBasicBlock(child_id));
+      }
+    }
+  }
+}
+
+bool LoopInvariantCodeMotion::IsPure(const MIR* mir) const {
+  Instruction::Code opcode = mir->dalvikInsn.opcode;
+  if (static_cast<int>(opcode) >= kMirOpFirst) {
+    return false;
+  }
+  switch (opcode) {
+    case Instruction::MOVE_RESULT:
+    case Instruction::MOVE_RESULT_WIDE:
+    case Instruction::MOVE_RESULT_OBJECT:
+    case Instruction::MOVE_EXCEPTION:
+      return false;
+    default:
+      break;
+  }
+  int flags = Instruction::FlagsOf(opcode);
+  int df_attributes = MIRGraph::oat_data_flow_attributes_[opcode];
+  return ((flags & (Instruction::kBranch | Instruction::kSwitch | Instruction::kThrow |
+                    Instruction::kReturn | Instruction::kInvoke)) == 0) &&
+      ((df_attributes & DF_DA) != 0) && ((df_attributes & DF_REF_A) == 0);
+}
+
+bool LoopInvariantCodeMotion::IsLoad(MIR* mir) {
+  uint32_t location;
+  switch (mir->dalvikInsn.opcode) {
+    case Instruction::ARRAY_LENGTH:
+      return true;
+
+    case Instruction::IGET:
+    case Instruction::IGET_WIDE:
+    case Instruction::IGET_BOOLEAN:
+    case Instruction::IGET_BYTE:
+    case Instruction::IGET_CHAR:
+    case Instruction::IGET_SHORT:
+    case Instruction::SGET:
+    case Instruction::SGET_WIDE:
+    case Instruction::SGET_BOOLEAN:
+    case Instruction::SGET_BYTE:
+    case Instruction::SGET_CHAR:
+    case Instruction::SGET_SHORT:
+    case Instruction::AGET:
+    case Instruction::AGET_WIDE:
+    case Instruction::AGET_BOOLEAN:
+    case Instruction::AGET_BYTE:
+    case Instruction::AGET_CHAR:
+    case Instruction::AGET_SHORT:
+      return memory_locations_.GetReadLocation(mir, &location) && !writes_heap_ &&
+          (written_locations_.find(location) == written_locations_.end());
+
+    default:
+      return false;
+  }
+}
+
+bool LoopInvariantCodeMotion::IsInvariant(MIR* mir) {
+  for (int i = 0; i < mir->ssa_rep->num_uses; i++) {
+    if (loop_defs_->IsBitSet(mir->ssa_rep->uses[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool LoopInvariantCodeMotion::CanHoistDef(int s_reg) {
+  int v_reg = mir_graph_->SRegToVReg(s_reg);
+  if ((v_reg < 0) || (loop_vreg_defs_[v_reg] != 1) ||
+      ((loop_vreg_uses_[v_reg] != kNoUses) && (loop_vreg_uses_[v_reg] != s_reg))) {
+    return false;
+  }
+  // Leaving the loop before the definition ran, the register held another value which must not
+  // be needed anymore.
+  for (size_t i = 0; i < exiting_blocks_.size(); i++) {
+    BasicBlockDataFlow* data_flow_info = exiting_blocks_[i]->data_flow_info;
+    if ((data_flow_info == NULL) || (data_flow_info->vreg_to_ssa_map == NULL)) {
+      return false;
+    }
+    int exit_s_reg = data_flow_info->vreg_to_ssa_map[v_reg];
+    if ((exit_s_reg != s_reg) && (use_counts_[exit_s_reg] != loop_use_counts_[exit_s_reg])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool LoopInvariantCodeMotion::IsHoistable(MIR* mir, bool in_chain) {
+  if ((mir->ssa_rep == NULL) || (mir->ssa_rep->num_defs == 0)) {
+    return false;
+  }
+  if (!IsPure(mir) && !(in_chain && IsLoad(mir))) {
+    return false;
+  }
+  if (!IsInvariant(mir)) {
+    return false;
+  }
+  for (int i = 0; i < mir->ssa_rep->num_defs; i++) {
+    if (!CanHoistDef(mir->ssa_rep->defs[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void LoopInvariantCodeMotion::Hoist(MIR* mir, BasicBlock* bb, BasicBlock* preheader) {
+  if (cu_->verbose) {
+    LOG(INFO) << "Hoisting 0x" << std::hex << mir->offset << " out of the loop at 0x"
+              << loop_->header->start_offset;
+  }
+  MIR* check_half = GetCheckHalf(mir);
+  if (check_half != NULL) {
+    mir->optimization_flags |= check_half->optimization_flags;
+    mir->meta.throw_insn = NULL;
+  }
+  mir_graph_->RemoveMIR(bb, mir);
+  if (insert_after_ == NULL) {
+    mir_graph_->PrependMIR(preheader, mir);
+  } else {
+    mir_graph_->InsertMIRAfter(preheader, insert_after_, mir);
+  }
+  insert_after_ = mir;
+  for (int i = 0; i < mir->ssa_rep->num_defs; i++) {
+    int s_reg = mir->ssa_rep->defs[i];
+    loop_defs_->ClearBit(s_reg);
+    preheader->data_flow_info->vreg_to_ssa_map[mir_graph_->SRegToVReg(s_reg)] = s_reg;
+  }
+  num_hoisted_++;
+}
+
+}  // namespace art
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_DEX_LOOP_INVARIANT_CODE_MOTION_H_
+#define ART_COMPILER_DEX_LOOP_INVARIANT_CODE_MOTION_H_
+
+#include <set>
+#include <vector>
+
+#include "compiler_internals.h"
+#include "memory_locations.h"
+
+namespace art {
+
+/*
+ * Moves computations whose operands don't change in a loop to the loop's preheader, the block
+ * entering the loop, visiting nested loops first so that their invariants may move further out.
+ *
+ * Instructions that neither throw nor have side effects may move from anywhere in the loop.
+ * Loads from memory the loop doesn't write, which may throw, only move when they run first on
+ * every entry to the loop, after nothing but instructions that moved already, so that they still
+ * throw in the same order. The preheader must be an existing block only entering the loop.
+ *
+ * Because a moved result stays in its Dalvik registers (see MIRGraph::SRegToVReg), an instruction
+ * only moves when it is the loop's only definition of its registers, the loop only reads its
+ * result from them, and no other value of them is read after the loop. Values that are
+ * references don't move, since the GC maps of the loop's safepoints wouldn't cover them.
+ */
+class LoopInvariantCodeMotion {
+ public:
+  LoopInvariantCodeMotion(CompilationUnit* cu, MIRGraph* mir_graph);
+
+  void Run();
+
+  int GetNumHoisted() const {
+    return num_hoisted_;
+  }
+
+ private:
+  // Uses of a Dalvik register in the loop reading no SSA name, or more than one.
+  static const int kNoUses = -1;
+  static const int kManyUses = -2;
+
+  BasicBlock* FindPreheader(const LoopInfo* loop);
+  void AnalyzeLoop(const LoopInfo* loop);
+  void HoistInvariants(const LoopInfo* loop, BasicBlock* preheader);
+
+  bool IsPure(const MIR* mir) const;
+  bool IsLoad(MIR* mir);
+  bool IsInvariant(MIR* mir);
+  bool CanHoistDef(int s_reg);
+  // Loads are only hoisted from the chain of blocks running first in the loop.
+  bool IsHoistable(MIR* mir, bool in_chain);
+  void Hoist(MIR* mir, BasicBlock* bb, BasicBlock* preheader);
+
+  CompilationUnit* const cu_;
+  MIRGraph* const mir_graph_;
+  MemoryLocations memory_locations_;
+
+  // Uses of each SSA name anywhere in the method.
+  std::vector<int> use_counts_;
+
+  // What the loop being visited defines, uses and writes.
+  const LoopInfo* loop_;
+  std::vector<int> loop_use_counts_;
+  ArenaBitVector* loop_defs_;        // SSA names defined in the loop and not hoisted.
+  std::vector<int> loop_vreg_defs_;  // Number of definitions of each Dalvik register.
+  std::vector<int> loop_vreg_uses_;  // The SSA name read from each Dalvik register.
+  std::vector<BasicBlock*> exiting_blocks_;
+  bool writes_heap_;
+  std::set<uint32_t> written_locations_;
+  MIR* insert_after_;                // Where to hoist to, or NULL for the preheader's head.
+
+  int num_hoisted_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopInvariantCodeMotion);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_DEX_LOOP_INVARIANT_CODE_MOTION_H_
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "memory_locations.h"
+
+namespace art {
+
+const MemoryLocations::FieldInfo& MemoryLocations::GetInstanceFieldInfo(
+    uint32_t field_idx, bool is_put) {
+  uint32_t key = (field_idx << 1) | (is_put ? 1 : 0);
+  SafeMap<uint32_t, FieldInfo>::iterator it = instance_fields_.find(key);
+  if (it == instance_fields_.end()) {
+    FieldInfo info;
+    info.fast_path = cu_->compiler_driver->ComputeInstanceFieldInfo(
+        field_idx, mir_graph_->GetCurrentDexCompilationUnit(), info.offset, info.is_volatile,
+        is_put);
+    info.is_referrers_class = false;
+    instance_fields_.Put(key, info);
+    it = instance_fields_.find(key);
+  }
+  return it->second;
+}
+
+const MemoryLocations::FieldInfo& MemoryLocations::GetStaticFieldInfo(
+    uint32_t field_idx, bool is_put) {
+  uint32_t key = (field_idx << 1) | (is_put ? 1 : 0);
+  SafeMap<uint32_t, FieldInfo>::iterator it = static_fields_.find(key);
+  if (it == static_fields_.end()) {
+    FieldInfo info;
+    int ssb_index;
+    info.fast_path = cu_->compiler_driver->ComputeStaticFieldInfo(
+        field_idx, mir_graph_->GetCurrentDexCompilationUnit(), info.offset, ssb_index,
+        info.is_referrers_class, info.is_volatile, is_put);
+    static_fields_.Put(key, info);
+    it = static_fields_.find(key);
+  }
+  return it->second;
+}
+
+bool MemoryLocations::GetReadLocation(MIR* mir, uint32_t* location) {
+  switch (mir->dalvikInsn.opcode) {
+    case Instruction::AGET:
+    case Instruction::AGET_WIDE:
+    case Instruction::AGET_OBJECT:
+    case Instruction::AGET_BOOLEAN:
+    case Instruction::AGET_BYTE:
+    case Instruction::AGET_CHAR:
+    case Instruction::AGET_SHORT:
+      *location = kArrayLocation;
+      return true;
+
+    case Instruction::IGET:
+    case Instruction::IGET_WIDE:
+    case Instruction::IGET_OBJECT:
+    case Instruction::IGET_BOOLEAN:
+    case Instruction::IGET_BYTE:
+    case Instruction::IGET_CHAR:
+    case Instruction::IGET_SHORT: {
+        const FieldInfo& info = GetInstanceFieldInfo(mir->dalvikInsn.vC, false);
+        *location = kInstanceFieldLocation | info.offset;
+        return info.fast_path && !info.is_volatile && (info.offset <= 0xffff);
+      }
+
+    case Instruction::SGET:
+    case Instruction::SGET_WIDE:
+    case Instruction::SGET_OBJECT:
+    case Instruction::SGET_BOOLEAN:
+    case Instruction::SGET_BYTE:
+    case Instruction::SGET_CHAR:
+    case Instruction::SGET_SHORT: {
+        const FieldInfo& info = GetStaticFieldInfo(mir->dalvikInsn.vB, false);
+        *location = kStaticFieldLocation | info.offset;
+        return info.fast_path && info.is_referrers_class && !info.is_volatile &&
+            (info.offset <= 0xffff);
+      }
+
+    default:
+      return false;
+  }
+}
+
+bool MemoryLocations::GetWrittenLocation(MIR* mir, uint32_t* location) {
+  switch (mir->dalvikInsn.opcode) {
+    case Instruction::INVOKE_STATIC:
+    case Instruction::INVOKE_STATIC_RANGE:
+    case Instruction::INVOKE_DIRECT:
+    case Instruction::INVOKE_DIRECT_RANGE:
+    case Instruction::INVOKE_VIRTUAL:
+    case Instruction::INVOKE_VIRTUAL_RANGE:
+    case Instruction::INVOKE_SUPER:
+    case Instruction::INVOKE_SUPER_RANGE:
+    case Instruction::INVOKE_INTERFACE:
+    case Instruction::INVOKE_INTERFACE_RANGE:
+    case Instruction::MONITOR_ENTER:
+    case Instruction::MONITOR_EXIT:
+    case Instruction::NEW_INSTANCE:  // May initialize the class.
+      *location = kHeapLocation;
+      return true;
+
+    case Instruction::APUT:
+    case Instruction::APUT_WIDE:
+    case Instruction::APUT_OBJECT:
+    case Instruction::APUT_BOOLEAN:
+    case Instruction::APUT_BYTE:
+    case Instruction::APUT_CHAR:
+    case Instruction::APUT_SHORT:
+    case Instruction::FILL_ARRAY_DATA:
+      *location = kArrayLocation;
+      return true;
+
+    case Instruction::IGET:
+    case Instruction::IGET_WIDE:
+    case Instruction::IGET_OBJECT:
+    case Instruction::IGET_BOOLEAN:
+    case Instruction::IGET_BYTE:
+    case Instruction::IGET_CHAR:
+    case Instruction::IGET_SHORT: {
+        // Volatile loads order later loads after them.
+        const FieldInfo& info = GetInstanceFieldInfo(mir->dalvikInsn.vC, false);
+        *location = kHeapLocation;
+        return !info.fast_path || info.is_volatile;
+      }
+
+    case Instruction::IPUT:
+    case Instruction::IPUT_WIDE:
+    case Instruction::IPUT_OBJECT:
+    case Instruction::IPUT_BOOLEAN:
+    case Instruction::IPUT_BYTE:
+    case Instruction::IPUT_CHAR:
+    case Instruction::IPUT_SHORT: {
+        const FieldInfo& info = GetInstanceFieldInfo(mir->dalvikInsn.vC, true);
+        if (!info.fast_path || info.is_volatile || info.offset > 0xffff) {
+          *location = kHeapLocation;
+        } else {
+          *location = kInstanceFieldLocation | info.offset;
+        }
+        return true;
+      }
+
+    case Instruction::SGET:
+    case Instruction::SGET_WIDE:
+    case Instruction::SGET_OBJECT:
+    case Instruction::SGET_BOOLEAN:
+    case Instruction::SGET_BYTE:
+    case Instruction::SGET_CHAR:
+    case Instruction::SGET_SHORT: {
+        // Only fields of the referrer's class are known not to initialize a class.
+        const FieldInfo& info = GetStaticFieldInfo(mir->dalvikInsn.vB, false);
+        *location = kHeapLocation;
+        return !info.fast_path || !info.is_referrers_class || info.is_volatile;
+      }
+
+    case Instruction::SPUT:
+    case Instruction::SPUT_WIDE:
+    case Instruction::SPUT_OBJECT:
+    case Instruction::SPUT_BOOLEAN:
+    case Instruction::SPUT_BYTE:
+    case Instruction::SPUT_CHAR:
+    case Instruction::SPUT_SHORT: {
+        const FieldInfo& info = GetStaticFieldInfo(mir->dalvikInsn.vB, true);
+        if (!info.fast_path || !info.is_referrers_class || info.is_volatile ||
+            info.offset > 0xffff) {
+          *location = kHeapLocation;
+        } else {
+          *location = kStaticFieldLocation | info.offset;
+        }
+        return true;
+      }
+
+    default:
+      return false;
+  }
+}
+
+}  // namespace art
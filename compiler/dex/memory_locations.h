@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_DEX_MEMORY_LOCATIONS_H_
+#define ART_COMPILER_DEX_MEMORY_LOCATIONS_H_
+
+#include "compiler_internals.h"
+#include "safe_map.h"
+
+namespace art {
+
+/*
+ * Tells which memory MIRs read and write, as far as the MIR optimizations tell locations apart.
+ * Instance fields are told apart by offset, static fields of the referrer's class by offset, and
+ * all arrays are one location. Writing to any other location writes the heap.
+ */
+class MemoryLocations {
+ public:
+  static const uint32_t kHeapLocation = 0;
+  static const uint32_t kArrayLocation = 1;
+  static const uint32_t kInstanceFieldLocation = 1 << 16;
+  static const uint32_t kStaticFieldLocation = 2 << 16;
+
+  struct FieldInfo {
+    bool fast_path;
+    bool is_volatile;
+    bool is_referrers_class;
+    int offset;
+  };
+
+  MemoryLocations(CompilationUnit* cu, MIRGraph* mir_graph) : cu_(cu), mir_graph_(mir_graph) {}
+
+  const FieldInfo& GetInstanceFieldInfo(uint32_t field_idx, bool is_put);
+  const FieldInfo& GetStaticFieldInfo(uint32_t field_idx, bool is_put);
+
+  // Returns whether mir is a load from a location other than the heap, and if so which.
+  bool GetReadLocation(MIR* mir, uint32_t* location);
+
+  // Returns whether mir may write memory, and if so which. Volatile loads and anything that may
+  // run other code, like invokes and class initialization, write the heap.
+  bool GetWrittenLocation(MIR* mir, uint32_t* location);
+
+ private:
+  CompilationUnit* const cu_;
+  MIRGraph* const mir_graph_;
+  // Keyed by field index and whether the field is written.
+  SafeMap<uint32_t, FieldInfo> instance_fields_;
+  SafeMap<uint32_t, FieldInfo> static_fields_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryLocations);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_DEX_MEMORY_LOCATIONS_H_
@@ -0,0 +1,399 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "method_inliner.h"
+
+#include "dataflow_iterator-inl.h"
+
+namespace art {
+
+// Bounds the constructors inlined for one call, which stores to all the fields they store to.
+static const size_t kMaxConstructorDepth = 8;
+static const size_t kMaxConstructorStores = 4;
+
+MethodInliner::MethodInliner(CompilationUnit* cu, MIRGraph* mir_graph)
+    : cu_(cu),
+      mir_graph_(mir_graph),
+      num_inlined_(0) {
+}
+
+void MethodInliner::Run() {
+  AllNodesIterator iter(mir_graph_, false /* not iterative */);
+  for (BasicBlock* bb = iter.Next(); bb != NULL; bb = iter.Next()) {
+    if (bb->block_type != kDalvikByteCode) {
+      continue;
+    }
+    for (MIR* mir = bb->first_mir_insn; mir != NULL; mir = mir->next) {
+      int opcode = mir->dalvikInsn.opcode;
+      if ((opcode < kMirOpFirst) && ((Instruction::FlagsOf(mir->dalvikInsn.opcode) &
+                                      Instruction::kInvoke) != 0) && TryInline(bb, mir)) {
+        num_inlined_++;
+      }
+    }
+  }
+}
+
+bool MethodInliner::TryInline(BasicBlock* bb, MIR* invoke) {
+  InvokeType type;
+  switch (invoke->dalvikInsn.opcode) {
+    case Instruction::INVOKE_STATIC:
+    case Instruction::INVOKE_STATIC_RANGE:
+      type = kStatic;
+      break;
+    case Instruction::INVOKE_DIRECT:
+    case Instruction::INVOKE_DIRECT_RANGE:
+      type = kDirect;
+      break;
+    case Instruction::INVOKE_VIRTUAL:
+    case Instruction::INVOKE_VIRTUAL_RANGE:
+      type = kVirtual;
+      break;
+    case Instruction::INVOKE_INTERFACE:
+    case Instruction::INVOKE_INTERFACE_RANGE:
+      type = kInterface;
+      break;
+    default:
+      return false;
+  }
+
+  // Find the one method the call may reach.
+  DexCompilationUnit* m_unit = mir_graph_->GetCurrentDexCompilationUnit();
+  if ((type == kDirect) && IsConstructor(invoke->dalvikInsn.vB)) {
+    return TryInlineConstructor(bb, invoke);
+  }
+  MethodReference target_method(m_unit->GetDexFile(), invoke->dalvikInsn.vB);
+  InvokeType sharp_type = type;
+  int vtable_idx;
+  uintptr_t direct_code;
+  uintptr_t direct_method;
+  if (!cu_->compiler_driver->ComputeInvokeInfo(m_unit, invoke->offset, sharp_type, target_method,
+                                               vtable_idx, direct_code, direct_method,
+                                               false /* update_stats */) ||
+      ((sharp_type != kStatic) && (sharp_type != kDirect)) ||
+      (target_method.dex_file != m_unit->GetDexFile())) {
+    return false;
+  }
+  const DexFile::CodeItem* code_item;
+  bool is_referrers_class;
+  if (!cu_->compiler_driver->ComputeInlinableMethod(m_unit, (type == kInterface) ? kVirtual : type,
+                                                    target_method.dex_method_index, code_item,
+                                                    is_referrers_class)) {
+    return false;
+  }
+  bool is_static = (type == kStatic);
+  if ((is_static && !is_referrers_class) || (code_item->tries_size_ != 0) ||
+      (code_item->ins_size_ != invoke->dalvikInsn.vA)) {
+    return false;
+  }
+
+  // Match the callee's code, one or two instructions long.
+  const uint16_t* insns = code_item->insns_;
+  const Instruction* first = Instruction::At(insns);
+  size_t size = first->SizeInCodeUnits();
+  const Instruction* second = NULL;
+  if (size < code_item->insns_size_in_code_units_) {
+    second = Instruction::At(insns + size);
+    size += second->SizeInCodeUnits();
+  }
+  if (size != code_item->insns_size_in_code_units_) {
+    return false;
+  }
+  uint32_t this_reg = code_item->registers_size_ - code_item->ins_size_;
+  MIR* move_result = mir_graph_->FindMoveResult(bb, invoke);
+  DecodedInstruction insn = invoke->dalvikInsn;
+  DecodedInstruction callee_insn(first);
+  if (second == NULL) {
+    if (callee_insn.opcode == Instruction::RETURN_VOID) {
+      // Only the receiver's null check remains of an empty method.
+      if (is_static) {
+        RemoveInvoke(bb, invoke);
+      } else {
+        insn.opcode = static_cast<Instruction::Code>(kMirOpNullCheck);
+        insn.vA = GetArgReg(code_item, invoke, this_reg);
+        ReplaceInvoke(invoke, insn);
+      }
+    } else if (is_static && ((callee_insn.opcode == Instruction::RETURN) ||
+                             (callee_insn.opcode == Instruction::RETURN_WIDE) ||
+                             (callee_insn.opcode == Instruction::RETURN_OBJECT))) {
+      int arg_reg = GetArgReg(code_item, invoke, callee_insn.vA);
+      if (arg_reg < 0) {
+        return false;
+      }
+      if (move_result == NULL) {
+        RemoveInvoke(bb, invoke);
+      } else {
+        insn.opcode = (callee_insn.opcode == Instruction::RETURN) ? Instruction::MOVE :
+            (callee_insn.opcode == Instruction::RETURN_WIDE) ? Instruction::MOVE_WIDE :
+            Instruction::MOVE_OBJECT;
+        insn.vA = move_result->dalvikInsn.vA;
+        insn.vB = arg_reg;
+        ReplaceInvoke(invoke, insn);
+        RemoveMoveResult(move_result);
+      }
+    } else {
+      return false;
+    }
+  } else {
+    DecodedInstruction return_insn(second);
+    int flags = Instruction::FlagsOf(return_insn.opcode);
+    if ((flags & Instruction::kReturn) == 0) {
+      return false;
+    }
+    switch (callee_insn.opcode) {
+      case Instruction::CONST:
+      case Instruction::CONST_4:
+      case Instruction::CONST_16:
+        if (!is_static || (return_insn.opcode == Instruction::RETURN_VOID) ||
+            (return_insn.vA != callee_insn.vA)) {
+          return false;
+        }
+        if (move_result == NULL) {
+          RemoveInvoke(bb, invoke);
+        } else {
+          insn.opcode = Instruction::CONST;
+          insn.vA = move_result->dalvikInsn.vA;
+          insn.vB = callee_insn.vB;
+          ReplaceInvoke(invoke, insn);
+          RemoveMoveResult(move_result);
+        }
+        break;
+
+      case Instruction::IGET:
+      case Instruction::IGET_WIDE:
+      case Instruction::IGET_OBJECT:
+      case Instruction::IGET_BOOLEAN:
+      case Instruction::IGET_BYTE:
+      case Instruction::IGET_CHAR:
+      case Instruction::IGET_SHORT: {
+          int field_offset;
+          bool is_volatile;
+          if (is_static || (callee_insn.vB != this_reg) || (move_result == NULL) ||
+              (return_insn.opcode == Instruction::RETURN_VOID) ||
+              (return_insn.vA != callee_insn.vA) ||
+              !cu_->compiler_driver->ComputeInstanceFieldInfo(callee_insn.vC, m_unit,
+                                                              field_offset, is_volatile, false)) {
+            return false;
+          }
+          insn.opcode = callee_insn.opcode;
+          insn.vA = move_result->dalvikInsn.vA;
+          insn.vB = GetArgReg(code_item, invoke, this_reg);
+          insn.vC = callee_insn.vC;
+          ReplaceInvoke(invoke, insn);
+          RemoveMoveResult(move_result);
+        }
+        break;
+
+      case Instruction::IPUT:
+      case Instruction::IPUT_WIDE:
+      case Instruction::IPUT_OBJECT:
+      case Instruction::IPUT_BOOLEAN:
+      case Instruction::IPUT_BYTE:
+      case Instruction::IPUT_CHAR:
+      case Instruction::IPUT_SHORT: {
+          int field_offset;
+          bool is_volatile;
+          int value_reg = GetArgReg(code_item, invoke, callee_insn.vA);
+          if (is_static || (callee_insn.vB != this_reg) || (value_reg < 0) ||
+              (return_insn.opcode != Instruction::RETURN_VOID) ||
+              !cu_->compiler_driver->ComputeInstanceFieldInfo(callee_insn.vC, m_unit,
+                                                              field_offset, is_volatile, true)) {
+            return false;
+          }
+          insn.opcode = callee_insn.opcode;
+          insn.vA = value_reg;
+          insn.vB = GetArgReg(code_item, invoke, this_reg);
+          insn.vC = callee_insn.vC;
+          ReplaceInvoke(invoke, insn);
+        }
+        break;
+
+      default:
+        return false;
+    }
+  }
+  if (cu_->verbose) {
+    LOG(INFO) << "Inlined " << PrettyMethod(target_method.dex_method_index,
+                                           *target_method.dex_file)
+              << " at 0x" << std::hex << invoke->offset;
+  }
+  return true;
+}
+
+bool MethodInliner::IsConstructor(uint32_t method_idx) const {
+  const DexFile* dex_file = mir_graph_->GetCurrentDexCompilationUnit()->GetDexFile();
+  return strcmp(dex_file->GetMethodName(dex_file->GetMethodId(method_idx)), "<init>") == 0;
+}
+
+bool MethodInliner::TryInlineConstructor(BasicBlock* bb, MIR* invoke) {
+  const DecodedInstruction& insn = invoke->dalvikInsn;
+  std::vector<int> arg_regs(insn.vA);
+  for (uint32_t i = 0; i < insn.vA; i++) {
+    arg_regs[i] = (Instruction::FormatOf(insn.opcode) == Instruction::k3rc) ? insn.vC + i :
+        insn.arg[i];
+  }
+  std::vector<DecodedInstruction> stores;
+  if (!CollectConstructorStores(insn.vB, arg_regs, 0, &stores) ||
+      !cu_->compiler_driver->CanInlineConstructor(mir_graph_->GetCurrentDexCompilationUnit(),
+                                                  insn.vB)) {
+    return false;
+  }
+  if (cu_->verbose) {
+    LOG(INFO) << "Inlined the constructors of "
+              << PrettyMethod(insn.vB, *mir_graph_->GetCurrentDexCompilationUnit()->GetDexFile())
+              << " at 0x" << std::hex << invoke->offset;
+  }
+  if (stores.empty()) {
+    DecodedInstruction null_check = insn;
+    null_check.opcode = static_cast<Instruction::Code>(kMirOpNullCheck);
+    null_check.vA = arg_regs[0];
+    ReplaceInvoke(invoke, null_check);
+    return true;
+  }
+  // The first store null checks the object for the others.
+  MIR* prev = invoke;
+  for (size_t i = 1; i < stores.size(); i++) {
+    MIR* store = static_cast<MIR*>(cu_->arena.Alloc(sizeof(MIR), ArenaAllocator::kAllocMIR));
+    *store = *invoke;
+    store->dalvikInsn = stores[i];
+    store->optimization_flags = MIR_IGNORE_NULL_CHECK;
+    store->meta.throw_insn = NULL;
+    mir_graph_->InsertMIRAfter(bb, prev, store);
+    prev = store;
+  }
+  ReplaceInvoke(invoke, stores[0]);
+  return true;
+}
+
+/*
+ * Appends the field stores of a constructor to stores, given the caller's register holding each
+ * of its ins. The constructor must call another constructor of the object, then store ins to its
+ * fields and return. The chain of constructors ends in Object.<init>, which runs no code but for
+ * finalizable objects.
+ */
+bool MethodInliner::CollectConstructorStores(uint32_t method_idx, const std::vector<int>& arg_regs,
+                                             size_t depth,
+                                             std::vector<DecodedInstruction>* stores) {
+  DexCompilationUnit* m_unit = mir_graph_->GetCurrentDexCompilationUnit();
+  const DexFile* dex_file = m_unit->GetDexFile();
+  const DexFile::MethodId& method_id = dex_file->GetMethodId(method_idx);
+  if (!IsConstructor(method_idx) || arg_regs.empty()) {
+    return false;
+  }
+  if (strcmp(dex_file->GetMethodDeclaringClassDescriptor(method_id), "Ljava/lang/Object;") == 0) {
+    return arg_regs.size() == 1;
+  }
+  const DexFile::CodeItem* code_item;
+  bool is_referrers_class;
+  if ((depth == kMaxConstructorDepth) ||
+      !cu_->compiler_driver->ComputeInlinableMethod(m_unit, kDirect, method_idx, code_item,
+                                                    is_referrers_class) ||
+      (code_item->tries_size_ != 0) || (code_item->ins_size_ != arg_regs.size())) {
+    return false;
+  }
+  uint32_t first_in = code_item->registers_size_ - code_item->ins_size_;
+  const uint16_t* insns = code_item->insns_;
+  const uint16_t* insns_end = insns + code_item->insns_size_in_code_units_;
+  const Instruction* inst = Instruction::At(insns);
+  DecodedInstruction super_insn(inst);
+  insns += inst->SizeInCodeUnits();
+  bool is_range = (super_insn.opcode == Instruction::INVOKE_DIRECT_RANGE);
+  if ((super_insn.opcode != Instruction::INVOKE_DIRECT) && !is_range) {
+    return false;
+  }
+  std::vector<int> super_arg_regs(super_insn.vA);
+  for (uint32_t i = 0; i < super_insn.vA; i++) {
+    uint32_t reg = is_range ? super_insn.vC + i : super_insn.arg[i];
+    if ((reg < first_in) || (reg >= code_item->registers_size_) ||
+        ((i == 0) && (reg != first_in))) {
+      return false;
+    }
+    super_arg_regs[i] = arg_regs[reg - first_in];
+  }
+  if (!CollectConstructorStores(super_insn.vB, super_arg_regs, depth + 1, stores)) {
+    return false;
+  }
+  while (insns < insns_end) {
+    inst = Instruction::At(insns);
+    DecodedInstruction store(inst);
+    insns += inst->SizeInCodeUnits();
+    if (store.opcode == Instruction::RETURN_VOID) {
+      return insns == insns_end;
+    }
+    int field_offset;
+    bool is_volatile;
+    uint32_t value_end = store.vA + ((store.opcode == Instruction::IPUT_WIDE) ? 2 : 1);
+    if ((store.opcode < Instruction::IPUT) || (store.opcode > Instruction::IPUT_SHORT) ||
+        (store.vB != first_in) || (store.vA < first_in) ||
+        (value_end > code_item->registers_size_) || (stores->size() == kMaxConstructorStores) ||
+        !cu_->compiler_driver->ComputeInstanceFieldInfo(store.vC, m_unit, field_offset,
+                                                        is_volatile, true)) {
+      return false;
+    }
+    store.vA = arg_regs[store.vA - first_in];
+    store.vB = arg_regs[0];
+    stores->push_back(store);
+  }
+  return false;
+}
+
+int MethodInliner::GetArgReg(const DexFile::CodeItem* code_item, const MIR* invoke,
+                             uint32_t reg) const {
+  uint32_t first_in = code_item->registers_size_ - code_item->ins_size_;
+  if ((reg < first_in) || (reg >= code_item->registers_size_)) {
+    return -1;
+  }
+  uint32_t arg = reg - first_in;
+  if (Instruction::FormatOf(invoke->dalvikInsn.opcode) == Instruction::k3rc) {
+    return invoke->dalvikInsn.vC + arg;
+  }
+  return invoke->dalvikInsn.arg[arg];
+}
+
+void MethodInliner::ReplaceInvoke(MIR* invoke, const DecodedInstruction& insn) {
+  invoke->dalvikInsn = insn;
+  // The check half of the call is the one generating code, from its own copy of the operands.
+  MIR* check_half = invoke->meta.throw_insn;
+  if (check_half != NULL) {
+    check_half->dalvikInsn = insn;
+    check_half->dalvikInsn.opcode = static_cast<Instruction::Code>(kMirOpCheck);
+  }
+}
+
+void MethodInliner::RemoveInvoke(BasicBlock* bb, MIR* invoke) {
+  Instruction::Code opcode = invoke->dalvikInsn.opcode;
+  MIR* check_half = invoke->meta.throw_insn;
+  invoke->meta.original_opcode = opcode;
+  invoke->dalvikInsn.opcode = static_cast<Instruction::Code>(kMirOpNop);
+  if (check_half == NULL) {
+    return;
+  }
+  check_half->meta.original_opcode = opcode;
+  check_half->dalvikInsn.opcode = static_cast<Instruction::Code>(kMirOpNop);
+  // Nothing is left to throw.
+  DCHECK_EQ(bb->predecessors->Size(), 1U);
+  BasicBlock* check_bb = bb->predecessors->Get(0);
+  if ((check_bb->taken != NULL) && (check_bb->taken->block_type == kExceptionHandling)) {
+    check_bb->taken->block_type = kDead;
+    check_bb->taken = NULL;
+  }
+}
+
+void MethodInliner::RemoveMoveResult(MIR* move_result) {
+  move_result->meta.original_opcode = move_result->dalvikInsn.opcode;
+  move_result->dalvikInsn.opcode = static_cast<Instruction::Code>(kMirOpNop);
+}
+
+}  // namespace art
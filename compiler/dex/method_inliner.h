@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_DEX_METHOD_INLINER_H_
+#define ART_COMPILER_DEX_METHOD_INLINER_H_
+
+#include <vector>
+
+#include "compiler_internals.h"
+
+namespace art {
+
+/*
+ * Replaces calls to small methods with the methods' code, before the SSA transformation. Static
+ * and direct calls are candidates, and so are virtual and interface calls the compiler driver
+ * sharpens into direct calls because the method or its class is final or the verifier knows the
+ * receiver's class.
+ *
+ * The callee's code replaces the call when it is no larger than the call itself:
+ *  - an empty method,
+ *  - a method returning a constant or one of its arguments,
+ *  - a getter or setter of a field of its receiver that the caller may access directly.
+ *
+ * A constructor call is replaced by the field stores of the chain of constructors it runs, down
+ * to Object.<init>, when each of them only calls the next and stores its arguments to fields of
+ * the object. This lets escape analysis remove the allocations of small objects.
+ *
+ * The frames of inlined methods can't be found by stack walks, so nothing inlined may throw
+ * from the callee. Instance methods may only fail on the receiver being null, which throws from
+ * the call in the caller either way, and static methods must be the caller's own, whose class is
+ * initialized already.
+ */
+class MethodInliner {
+ public:
+  MethodInliner(CompilationUnit* cu, MIRGraph* mir_graph);
+
+  void Run();
+
+  int GetNumInlined() const {
+    return num_inlined_;
+  }
+
+ private:
+  bool TryInline(BasicBlock* bb, MIR* invoke);
+  bool IsConstructor(uint32_t method_idx) const;
+  bool TryInlineConstructor(BasicBlock* bb, MIR* invoke);
+  bool CollectConstructorStores(uint32_t method_idx, const std::vector<int>& arg_regs,
+                                size_t depth, std::vector<DecodedInstruction>* stores);
+  // The caller's Dalvik register passed in the callee's register reg, or -1 if reg isn't an in.
+  int GetArgReg(const DexFile::CodeItem* code_item, const MIR* invoke, uint32_t reg) const;
+  void ReplaceInvoke(MIR* invoke, const DecodedInstruction& insn);
+  void RemoveInvoke(BasicBlock* bb, MIR* invoke);
+  void RemoveMoveResult(MIR* move_result);
+
+  CompilationUnit* const cu_;
+  MIRGraph* const mir_graph_;
+
+  int num_inlined_;
+
+  DISALLOW_COPY_AND_ASSIGN(MethodInliner);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_DEX_METHOD_INLINER_H_
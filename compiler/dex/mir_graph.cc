@@ -104,6 +104,7 @@ MIRGraph::MIRGraph(CompilationUnit* cu, ArenaAllocator* arena)
       def_count_(0),
       opcode_count_(NULL),
       num_ssa_regs_(0),
+      loops_(arena, 4, kGrowableArrayMisc),
       method_sreg_(0),
       attributes_(METHOD_IS_LEAF),  // Start with leaf assumption, change on encountering invoke.
       checkstats_(NULL),
@@ -877,6 +878,23 @@ void MIRGraph::InsertMIRAfter(BasicBlock* bb, MIR* current_mir, MIR* new_mir) {
   }
 }
 
+/* Unlink a MIR instruction from its basic block */
+void MIRGraph::RemoveMIR(BasicBlock* bb, MIR* mir) {
+  if (mir->prev == NULL) {
+    DCHECK_EQ(bb->first_mir_insn, mir);
+    bb->first_mir_insn = mir->next;
+  } else {
+    mir->prev->next = mir->next;
+  }
+  if (mir->next == NULL) {
+    DCHECK_EQ(bb->last_mir_insn, mir);
+    bb->last_mir_insn = mir->prev;
+  } else {
+    mir->next->prev = mir->prev;
+  }
+  mir->prev = mir->next = NULL;
+}
+
 char* MIRGraph::GetDalvikDisassembly(const MIR* mir) {
   DecodedInstruction insn = mir->dalvikInsn;
   std::string str;
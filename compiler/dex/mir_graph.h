@@ -250,6 +250,7 @@ struct MIR {
 };
 
 struct SuccessorBlockInfo;
+struct LoopInfo;
 
 struct BasicBlock {
   int id;
@@ -291,6 +292,18 @@ struct SuccessorBlockInfo {
   int key;
 };
 
+/*
+ * A natural loop: a header dominating all of the loop, and the blocks that reach a back edge to
+ * the header without passing through it. Loops sharing a header are merged into one.
+ */
+struct LoopInfo {
+  BasicBlock* header;
+  ArenaBitVector* blocks;               // Includes the blocks of nested loops.
+  LoopInfo* parent;                     // The innermost loop containing this one, or NULL.
+  GrowableArray<LoopInfo*>* children;   // The loops nested immediately inside this one.
+  int depth;                            // 1 for a loop not nested in any other.
+};
+
 /*
  * Whereas a SSA name describes a definition of a Dalvik vreg, the RegLocation describes
  * the type of an SSA name (and, can also be used by code generators to record where the
@@ -571,15 +584,38 @@ class MIRGraph {
 
   void BasicBlockCombine();
   void CodeLayout();
+  void InlineCalls();
   void DumpCheckStats();
   void PropagateConstants();
   MIR* FindMoveResult(BasicBlock* bb, MIR* mir);
+  /*
+   * The Dalvik register an SSA name is a version of. SSA names have no storage of their own:
+   * the code generators keep every SSA name of a Dalvik register in that register's home
+   * location, its frame slot or the physical register it was promoted to. Passes moving or
+   * reusing a value must therefore make sure no other version of its Dalvik register is written
+   * while the value is still read.
+   */
   int SRegToVReg(int ssa_reg) const;
+  // The SSA names of the array and the index an instruction with range checks reads.
+  void GetRangeCheckOperands(const MIR* mir, int* array_s_reg, int* index_s_reg) const;
+  // Drops the range check of an instruction, in both its halves.
+  void IgnoreRangeCheck(MIR* mir) const;
   void VerifyDataflow();
   void MethodUseCount();
   void SSATransformation();
   void CheckForDominanceFrontier(BasicBlock* dom_bb, const BasicBlock* succ_bb);
   void NullCheckElimination();
+  void EliminateAllocations();
+  void GlobalRedundancyElimination();
+  void EliminateBoundsChecks();
+  void FindLoops();
+  void LoopInvariantCodeMotion();
+
+  // The loops found by FindLoops(), nested loops before the loops containing them.
+  GrowableArray<LoopInfo*>* GetLoops() {
+    return &loops_;
+  }
+
   bool SetFp(int index, bool is_fp);
   bool SetCore(int index, bool is_core);
   bool SetRef(int index, bool is_ref);
@@ -588,6 +624,7 @@ class MIRGraph {
   void AppendMIR(BasicBlock* bb, MIR* mir);
   void PrependMIR(BasicBlock* bb, MIR* mir);
   void InsertMIRAfter(BasicBlock* bb, MIR* current_mir, MIR* new_mir);
+  void RemoveMIR(BasicBlock* bb, MIR* mir);
   char* GetDalvikDisassembly(const MIR* mir);
   void ReplaceSpecialChars(std::string& str);
   std::string GetSSAName(int ssa_reg);
@@ -671,6 +708,7 @@ class MIRGraph {
   bool ComputeBlockLiveIns(BasicBlock* bb);
   bool InsertPhiNodeOperands(BasicBlock* bb);
   bool ComputeDominanceFrontier(BasicBlock* bb);
+  void AddBackEdge(BasicBlock* latch, BasicBlock* header);
   void DoConstantPropogation(BasicBlock* bb);
   void CountChecks(BasicBlock* bb);
   bool CombineBlocks(BasicBlock* bb);
@@ -715,6 +753,7 @@ class MIRGraph {
   int* opcode_count_;                            // Dex opcode coverage stats.
   int num_ssa_regs_;                             // Number of names following SSA transformation.
   std::vector<BasicBlock*> extended_basic_blocks_;  // Heads of block "traces".
+  GrowableArray<LoopInfo*> loops_;
   int method_sreg_;
   unsigned int attributes_;
   Checkstats* checkstats_;
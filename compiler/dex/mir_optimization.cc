@@ -14,8 +14,13 @@
  * limitations under the License.
  */
 
+#include "bounds_check_elimination.h"
 #include "compiler_internals.h"
+#include "escape_analysis.h"
+#include "global_value_numbering.h"
+#include "loop_invariant_code_motion.h"
 #include "local_value_numbering.h"
+#include "method_inliner.h"
 #include "dataflow_iterator-inl.h"
 
 namespace art {
@@ -218,7 +223,9 @@ bool MIRGraph::BasicBlockOpt(BasicBlock* bb) {
   while (bb != NULL) {
     for (MIR* mir = bb->first_mir_insn; mir != NULL; mir = mir->next) {
       // TUNING: use the returned value number for CSE.
-      local_valnum.GetValueNumber(mir);
+      if (cu_->disable_opt & (1 << kGlobalValueNumbering)) {
+        local_valnum.GetValueNumber(mir);
+      }
       // Look for interesting opcodes, skip otherwise
       Instruction::Code opcode = mir->dalvikInsn.opcode;
       switch (opcode) {
@@ -777,6 +784,93 @@ void MIRGraph::NullCheckElimination() {
   }
 }
 
+void MIRGraph::EliminateAllocations() {
+  if (!(cu_->disable_opt & (1 << kEscapeAnalysis))) {
+    EscapeAnalysis escape_analysis(cu_, this);
+    escape_analysis.Run();
+    cu_->compiler_driver->RecordEliminatedAllocations(escape_analysis.GetNumEliminated(),
+                                                      escape_analysis.GetNumAllocations());
+    if (cu_->verbose && (escape_analysis.GetNumEliminated() != 0)) {
+      LOG(INFO) << PrettyMethod(cu_->method_idx, *cu_->dex_file) << ": escape analysis removed "
+                << escape_analysis.GetNumEliminated() << " of "
+                << escape_analysis.GetNumAllocations() << " allocations";
+    }
+  }
+  if (cu_->enable_debug & (1 << kDebugDumpCFG)) {
+    DumpCFG("/sdcard/4_post_ea_cfg/", false);
+  }
+}
+
+void MIRGraph::GlobalRedundancyElimination() {
+  if (!(cu_->disable_opt & (1 << kGlobalValueNumbering))) {
+    GlobalValueNumbering gvn(cu_, this);
+    gvn.Run();
+    if (cu_->verbose) {
+      LOG(INFO) << PrettyMethod(cu_->method_idx, *cu_->dex_file) << ": GVN removed "
+                << gvn.GetNullChecksEliminated() << " null checks, "
+                << gvn.GetRangeChecksEliminated() << " range checks and "
+                << gvn.GetLoadsEliminated() << " loads";
+    }
+  }
+  if (cu_->enable_debug & (1 << kDebugDumpCFG)) {
+    DumpCFG("/sdcard/4_post_gvn_cfg/", false);
+  }
+}
+
+void MIRGraph::GetRangeCheckOperands(const MIR* mir, int* array_s_reg, int* index_s_reg) const {
+  int df_attributes = oat_data_flow_attributes_[mir->dalvikInsn.opcode];
+  DCHECK_NE(df_attributes & DF_HAS_RANGE_CHKS, 0);
+  int index_idx;
+  if (df_attributes & DF_RANGE_CHK_1) {
+    index_idx = 1;
+  } else if (df_attributes & DF_RANGE_CHK_2) {
+    index_idx = 2;
+  } else {
+    index_idx = 3;
+  }
+  *array_s_reg = mir->ssa_rep->uses[index_idx - 1];
+  *index_s_reg = mir->ssa_rep->uses[index_idx];
+}
+
+void MIRGraph::IgnoreRangeCheck(MIR* mir) const {
+  if (cu_->verbose) {
+    LOG(INFO) << "Removing range check for 0x" << std::hex << mir->offset;
+  }
+  mir->optimization_flags |= MIR_IGNORE_RANGE_CHECK;
+  // The check half of the instruction is the one generating the checks.
+  if (mir->meta.throw_insn != NULL) {
+    mir->meta.throw_insn->optimization_flags |= MIR_IGNORE_RANGE_CHECK;
+  }
+}
+
+void MIRGraph::EliminateBoundsChecks() {
+  if (!(cu_->disable_opt & (1 << kBoundsCheckElimination))) {
+    BoundsCheckElimination bce(cu_, this);
+    bce.Run();
+    if (cu_->verbose && (bce.GetRangeChecksEliminated() != 0)) {
+      LOG(INFO) << PrettyMethod(cu_->method_idx, *cu_->dex_file) << ": BCE removed "
+                << bce.GetRangeChecksEliminated() << " range checks";
+    }
+  }
+  if (cu_->enable_debug & (1 << kDebugDumpCFG)) {
+    DumpCFG("/sdcard/4_post_bce_cfg/", false);
+  }
+}
+
+void MIRGraph::LoopInvariantCodeMotion() {
+  if (!(cu_->disable_opt & (1 << kLoopInvariantCodeMotion))) {
+    art::LoopInvariantCodeMotion licm(cu_, this);
+    licm.Run();
+    if (cu_->verbose && (licm.GetNumHoisted() != 0)) {
+      LOG(INFO) << PrettyMethod(cu_->method_idx, *cu_->dex_file) << ": LICM hoisted "
+                << licm.GetNumHoisted() << " instructions";
+    }
+  }
+  if (cu_->enable_debug & (1 << kDebugDumpCFG)) {
+    DumpCFG("/sdcard/4_post_licm_cfg/", false);
+  }
+}
+
 void MIRGraph::BasicBlockCombine() {
   PreOrderDfsIterator iter(this, false /* not iterative */);
   for (BasicBlock* bb = iter.Next(); bb != NULL; bb = iter.Next()) {
@@ -787,6 +881,17 @@ void MIRGraph::BasicBlockCombine() {
   }
 }
 
+void MIRGraph::InlineCalls() {
+  if (!(cu_->disable_opt & (1 << kMethodInlining))) {
+    MethodInliner inliner(cu_, this);
+    inliner.Run();
+    if (cu_->verbose && (inliner.GetNumInlined() != 0)) {
+      LOG(INFO) << PrettyMethod(cu_->method_idx, *cu_->dex_file) << ": inlined "
+                << inliner.GetNumInlined() << " calls";
+    }
+  }
+}
+
 void MIRGraph::CodeLayout() {
   if (cu_->enable_debug & (1 << kDebugVerifyDataflow)) {
     VerifyDataflow();
@@ -457,7 +457,8 @@ void ArmMir2Lir::GenFillArrayData(uint32_t table_offset, RegLocation rl_src) {
  * simple case - which we handle inline.  For monitor enter, the
  * simple case is thin lock, held by no-one.  For monitor exit,
  * the simple case is thin lock, held by the unlocking thread with
- * a recurse count of 0.
+ * a recurse count of 0.  Locks biased towards the current thread are
+ * also handled inline by adjusting the hold count with a plain store.
  *
  * A minor complication is that there is a field in the lock word
  * unrelated to locking: the hash state.  This field must be ignored, but
@@ -482,13 +483,34 @@ void ArmMir2Lir::GenMonitorEnter(int opt_flags, RegLocation rl_src) {
   OpIT(kCondEq, "");
   NewLIR4(kThumb2Strex, r1, r2, r0,
           mirror::Object::MonitorOffset().Int32Value() >> 2);
-  OpRegImm(kOpCmp, r1, 0);
-  OpIT(kCondNe, "T");
+  LIR* acquired = OpCmpImmBranch(kCondEq, r1, 0, NULL);
+  // Is the lock biased towards us (owner, bias and shape bits match) with room for another hold?
+  LoadWordDisp(r0, mirror::Object::MonitorOffset().Int32Value(), r1);
+  LoadWordDisp(rARM_SELF, Thread::ThinLockIdOffset().Int32Value(), r2);
+  OpRegImm(kOpLsl, r2, LW_LOCK_OWNER_SHIFT);
+  OpRegImm(kOpOr, r2, LW_BIAS_MASK << LW_BIAS_SHIFT);
+  OpRegRegReg(kOpXor, r3, r1, r2);
+  NewLIR3(kThumb2Bfc, r3, LW_HASH_STATE_SHIFT, LW_LOCK_OWNER_SHIFT - 1);
+  OpRegImm(kOpLsl, r3, 32 - LW_LOCK_COUNT_SHIFT);
+  LIR* not_biased = OpCmpImmBranch(kCondNe, r3, 0, NULL);
+  // The hold count is about to overflow if its top bits are all set.
+  OpRegRegImm(kOpAsr, r3, r1, LW_LOCK_COUNT_SHIFT + 1);
+  OpRegImm(kOpAdd, r3, 1);
+  LIR* count_overflow = OpCmpImmBranch(kCondEq, r3, 0, NULL);
+  OpRegImm(kOpAdd, r1, 1 << LW_LOCK_COUNT_SHIFT);
+  StoreWordDisp(r0, mirror::Object::MonitorOffset().Int32Value(), r1);
+  LIR* biased_acquired = OpUnconditionalBranch(NULL);
+  LIR* slow_path = NewLIR0(kPseudoTargetLabel);
+  not_biased->target = slow_path;
+  count_overflow->target = slow_path;
   // Go expensive route - artLockObjectFromCode(self, obj);
   LoadWordDisp(rARM_SELF, QUICK_ENTRYPOINT_OFFSET(pLockObject).Int32Value(), rARM_LR);
   ClobberCalleeSave();
   LIR* call_inst = OpReg(kOpBlx, rARM_LR);
   MarkSafepointPC(call_inst);
+  LIR* done = NewLIR0(kPseudoTargetLabel);
+  acquired->target = done;
+  biased_acquired->target = done;
   GenMemBarrier(kLoadLoad);
 }
 
@@ -513,13 +535,32 @@ void ArmMir2Lir::GenMonitorExit(int opt_flags, RegLocation rl_src) {
   OpRegImm(kOpLsl, r2, LW_LOCK_OWNER_SHIFT);
   NewLIR3(kThumb2Bfc, r1, LW_HASH_STATE_SHIFT, LW_LOCK_OWNER_SHIFT - 1);
   OpRegReg(kOpSub, r1, r2);
-  OpIT(kCondEq, "EE");
+  LIR* not_thin = OpCmpImmBranch(kCondNe, r1, 0, NULL);
   StoreWordDisp(r0, mirror::Object::MonitorOffset().Int32Value(), r3);
+  LIR* released = OpUnconditionalBranch(NULL);
+  not_thin->target = NewLIR0(kPseudoTargetLabel);
+  // Biased towards us with a non-zero hold count? Subtracting our owner bits leaves just the bias
+  // bit below the count field.
+  OpRegImm(kOpXor, r1, LW_BIAS_MASK << LW_BIAS_SHIFT);
+  OpRegRegImm(kOpLsl, r2, r1, 32 - LW_LOCK_COUNT_SHIFT);
+  LIR* not_biased = OpCmpImmBranch(kCondNe, r2, 0, NULL);
+  OpRegImm(kOpLsr, r1, LW_LOCK_COUNT_SHIFT);
+  LIR* not_held = OpCmpImmBranch(kCondEq, r1, 0, NULL);
+  LoadWordDisp(r0, mirror::Object::MonitorOffset().Int32Value(), r1);
+  OpRegImm(kOpSub, r1, 1 << LW_LOCK_COUNT_SHIFT);
+  StoreWordDisp(r0, mirror::Object::MonitorOffset().Int32Value(), r1);
+  LIR* biased_released = OpUnconditionalBranch(NULL);
+  LIR* slow_path = NewLIR0(kPseudoTargetLabel);
+  not_biased->target = slow_path;
+  not_held->target = slow_path;
   // Go expensive route - UnlockObjectFromCode(obj);
   LoadWordDisp(rARM_SELF, QUICK_ENTRYPOINT_OFFSET(pUnlockObject).Int32Value(), rARM_LR);
   ClobberCalleeSave();
   LIR* call_inst = OpReg(kOpBlx, rARM_LR);
   MarkSafepointPC(call_inst);
+  LIR* done = NewLIR0(kPseudoTargetLabel);
+  released->target = done;
+  biased_released->target = done;
   GenMemBarrier(kStoreLoad);
 }
 
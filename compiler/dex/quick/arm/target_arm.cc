@@ -74,6 +74,8 @@ int ArmMir2Lir::TargetReg(SpecialTargetRegister reg) {
     case kRet0: res = rARM_RET0; break;
     case kRet1: res = rARM_RET1; break;
     case kInvokeTgt: res = rARM_INVOKE_TGT; break;
+    case kHiddenArg: res = rARM_HIDDEN_ARG; break;
+    case kHiddenFpArg: res = INVALID_REG; break;
     case kCount: res = rARM_COUNT; break;
   }
   return res;
@@ -702,6 +704,7 @@ void ArmMir2Lir::LockCallTemps() {
   LockTemp(r1);
   LockTemp(r2);
   LockTemp(r3);
+  LockTemp(rARM_HIDDEN_ARG);
 }
 
 /* To be used when explicitly managing register use */
@@ -710,6 +713,7 @@ void ArmMir2Lir::FreeCallTemps() {
   FreeTemp(r1);
   FreeTemp(r2);
   FreeTemp(r3);
+  FreeTemp(rARM_HIDDEN_ARG);
 }
 
 int ArmMir2Lir::LoadHelper(ThreadOffset offset) {
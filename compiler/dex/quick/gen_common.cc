@@ -998,6 +998,7 @@ void Mir2Lir::GenInstanceofCallingHelper(bool needs_access_check, bool type_know
   LoadWordDisp(TargetReg(kArg0),  mirror::Object::ClassOffset().Int32Value(), TargetReg(kArg1));
   /* kArg0 is ref, kArg1 is ref->klass_, kArg2 is class */
   LIR* branchover = NULL;
+  LIR* cache_hit = NULL;
   if (type_known_final) {
     // rl_result == ref == null == 0.
     if (cu_->instruction_set == kThumb2) {
@@ -1011,32 +1012,23 @@ void Mir2Lir::GenInstanceofCallingHelper(bool needs_access_check, bool type_know
       LoadConstant(rl_result.low_reg, 1);     // eq case - load true
     }
   } else {
-    if (cu_->instruction_set == kThumb2) {
+    /* Uses branchovers */
+    LoadConstant(rl_result.low_reg, 1);     // assume true
+    if (!type_known_abstract) {
+      branchover = OpCmpBranch(kCondEq, TargetReg(kArg1), TargetReg(kArg2), NULL);
+    }
+    // Probe ref->klass_->type_check_cache_ [sets kArg3]
+    LoadWordDisp(TargetReg(kArg1), mirror::Class::TypeCheckCacheOffset().Int32Value(),
+                 TargetReg(kArg3));
+    cache_hit = OpCmpBranch(kCondEq, TargetReg(kArg3), TargetReg(kArg2), NULL);
+    if (cu_->instruction_set != kX86) {
       int r_tgt = LoadHelper(QUICK_ENTRYPOINT_OFFSET(pInstanceofNonTrivial));
-      if (!type_known_abstract) {
-      /* Uses conditional nullification */
-        OpRegReg(kOpCmp, TargetReg(kArg1), TargetReg(kArg2));  // Same?
-        OpIT(kCondEq, "EE");   // if-convert the test
-        LoadConstant(TargetReg(kArg0), 1);     // .eq case - load true
-      }
       OpRegCopy(TargetReg(kArg0), TargetReg(kArg2));    // .ne case - arg0 <= class
       OpReg(kOpBlx, r_tgt);    // .ne case: helper(class, ref->class)
       FreeTemp(r_tgt);
     } else {
-      if (!type_known_abstract) {
-        /* Uses branchovers */
-        LoadConstant(rl_result.low_reg, 1);     // assume true
-        branchover = OpCmpBranch(kCondEq, TargetReg(kArg1), TargetReg(kArg2), NULL);
-      }
-      if (cu_->instruction_set != kX86) {
-        int r_tgt = LoadHelper(QUICK_ENTRYPOINT_OFFSET(pInstanceofNonTrivial));
-        OpRegCopy(TargetReg(kArg0), TargetReg(kArg2));    // .ne case - arg0 <= class
-        OpReg(kOpBlx, r_tgt);    // .ne case: helper(class, ref->class)
-        FreeTemp(r_tgt);
-      } else {
-        OpRegCopy(TargetReg(kArg0), TargetReg(kArg2));
-        OpThreadMem(kOpBlx, QUICK_ENTRYPOINT_OFFSET(pInstanceofNonTrivial));
-      }
+      OpRegCopy(TargetReg(kArg0), TargetReg(kArg2));
+      OpThreadMem(kOpBlx, QUICK_ENTRYPOINT_OFFSET(pInstanceofNonTrivial));
     }
   }
   // TODO: only clobber when type isn't final?
@@ -1048,6 +1040,9 @@ void Mir2Lir::GenInstanceofCallingHelper(bool needs_access_check, bool type_know
   if (branchover != NULL) {
     branchover->target = target;
   }
+  if (cache_hit != NULL) {
+    cache_hit->target = target;
+  }
 }
 
 void Mir2Lir::GenInstanceof(uint32_t type_idx, RegLocation rl_dest, RegLocation rl_src) {
@@ -1135,6 +1130,10 @@ void Mir2Lir::GenCheckCast(uint32_t insn_idx, uint32_t type_idx, RegLocation rl_
   if (!type_known_abstract) {
     branch2 = OpCmpBranch(kCondEq, TargetReg(kArg1), class_reg, NULL);
   }
+  /* Probe object->klass_->type_check_cache_ before calling out */
+  LoadWordDisp(TargetReg(kArg1), mirror::Class::TypeCheckCacheOffset().Int32Value(),
+               TargetReg(kArg3));
+  LIR* branch3 = OpCmpBranch(kCondEq, TargetReg(kArg3), class_reg, NULL);
   CallRuntimeHelperRegReg(QUICK_ENTRYPOINT_OFFSET(pCheckCast), TargetReg(kArg1),
                           TargetReg(kArg2), true);
   /* branch target here */
@@ -1143,6 +1142,7 @@ void Mir2Lir::GenCheckCast(uint32_t insn_idx, uint32_t type_idx, RegLocation rl_
   if (branch2 != NULL) {
     branch2->target = target;
   }
+  branch3->target = target;
 }
 
 void Mir2Lir::GenLong3Addr(OpKind first_op, OpKind second_op, RegLocation rl_dest,
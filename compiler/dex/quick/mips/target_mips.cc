@@ -76,6 +76,8 @@ int MipsMir2Lir::TargetReg(SpecialTargetRegister reg) {
     case kRet0: res = rMIPS_RET0; break;
     case kRet1: res = rMIPS_RET1; break;
     case kInvokeTgt: res = rMIPS_INVOKE_TGT; break;
+    case kHiddenArg: res = rMIPS_HIDDEN_ARG; break;
+    case kHiddenFpArg: res = INVALID_REG; break;
     case kCount: res = rMIPS_COUNT; break;
   }
   return res;
@@ -410,6 +412,7 @@ void MipsMir2Lir::LockCallTemps() {
   LockTemp(rMIPS_ARG1);
   LockTemp(rMIPS_ARG2);
   LockTemp(rMIPS_ARG3);
+  LockTemp(rMIPS_HIDDEN_ARG);
 }
 
 /* To be used when explicitly managing register use */
@@ -418,6 +421,7 @@ void MipsMir2Lir::FreeCallTemps() {
   FreeTemp(rMIPS_ARG1);
   FreeTemp(rMIPS_ARG2);
   FreeTemp(rMIPS_ARG3);
+  FreeTemp(rMIPS_HIDDEN_ARG);
 }
 
 void MipsMir2Lir::GenMemBarrier(MemBarrierKind barrier_kind) {
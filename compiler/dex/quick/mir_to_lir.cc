@@ -680,6 +680,11 @@ void Mir2Lir::HandleExtendedMethodMIR(BasicBlock* bb, MIR* mir) {
     case kMirOpSelect:
       GenSelect(bb, mir);
       break;
+    case kMirOpNullCheck: {
+      RegLocation rl_obj = LoadValue(mir_graph_->GetSrc(mir, 0), kCoreReg);
+      GenNullCheck(rl_obj.s_reg_low, rl_obj.low_reg, mir->optimization_flags);
+      break;
+    }
     default:
       break;
   }
@@ -322,6 +322,7 @@ class Mir2Lir : public Backend {
     void ClobberSReg(int s_reg);
     int SRegToPMap(int s_reg);
     void RecordCorePromotion(int reg, int s_reg);
+    void RecordSharedCorePromotion(int reg, int s_reg);
     int AllocPreservedCoreReg(int s_reg);
     void RecordFpPromotion(int reg, int s_reg);
     int AllocPreservedSingle(int s_reg, bool even);
@@ -369,6 +370,8 @@ class Mir2Lir : public Backend {
     RegLocation EvalLoc(RegLocation loc, int reg_class, bool update);
     void CountRefs(RefCounts* core_counts, RefCounts* fp_counts);
     void DumpCounts(const RefCounts* arr, int size, const char* msg);
+    bool PromoteCoreRegsLinearScan(const RefCounts* core_regs, int num_regs,
+                                   int promotion_threshold);
     void DoPromotion();
     int VRegOffset(int v_reg);
     int SRegOffset(int s_reg);
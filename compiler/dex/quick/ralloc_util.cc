@@ -16,8 +16,12 @@
 
 /* This file contains register alloction support. */
 
+#include <algorithm>
+#include <vector>
+
 #include "dex/compiler_ir.h"
 #include "dex/compiler_internals.h"
+#include "dex/live_intervals.h"
 #include "mir_to_lir-inl.h"
 
 namespace art {
@@ -147,6 +151,19 @@ void Mir2Lir::RecordCorePromotion(int reg, int s_reg) {
   promotion_map_[p_map_idx].core_reg = reg;
 }
 
+/*
+ * Promote s_reg to a callee-save register already promoted to, spilled and named in the vmap
+ * table for another Dalvik register that is never live at the same time. The vmap table has
+ * no entry for s_reg's Dalvik register, so a debugger would read and write its stale home
+ * location instead: debuggable code doesn't share registers.
+ */
+void Mir2Lir::RecordSharedCorePromotion(int reg, int s_reg) {
+  int p_map_idx = SRegToPMap(s_reg);
+  DCHECK(GetRegInfo(reg)->in_use);
+  promotion_map_[p_map_idx].core_location = kLocPhysReg;
+  promotion_map_[p_map_idx].core_reg = reg;
+}
+
 /* Reserve a callee-save register.  Return -1 if none available */
 int Mir2Lir::AllocPreservedCoreReg(int s_reg) {
   int res = -1;
@@ -946,6 +963,142 @@ void Mir2Lir::DumpCounts(const RefCounts* arr, int size, const char* msg) {
   }
 }
 
+// How many of the most used Dalvik registers compete for callee-save registers in the linear scan.
+static const size_t kMaxScanIntervals = 256;
+
+// A Dalvik register competing for a callee-save core register in the linear scan.
+struct ScanInterval {
+  int s_reg;
+  int count;
+  const std::vector<LiveIntervals::Range>* ranges;
+  int reg;  // The callee-save register given, or -1.
+};
+
+static bool StartsBefore(const ScanInterval* a, const ScanInterval* b) {
+  int a_start = a->ranges->front().start;
+  int b_start = b->ranges->front().start;
+  return (a_start == b_start) ? (a->count > b->count) : (a_start < b_start);
+}
+
+/*
+ * Promote the most used Dalvik registers to callee-save core registers by a linear scan over
+ * their live intervals, so that registers never live at the same time may share one. This only
+ * chooses which Dalvik registers live in callee-save core registers: floating point registers
+ * are still promoted by use counts alone, and temps are still allocated locally within blocks.
+ *
+ * Intervals are visited in order of their start. When no callee-save register is free for an
+ * interval, it takes the one whose conflicting intervals are used least, if used less than it,
+ * and those stay in memory for the whole method. Intervals are not split, since every SSA name
+ * of a Dalvik register is kept in one home location.
+ *
+ * The GC maps come from the verifier, and the vmap table names a single Dalvik register for each
+ * callee-save register. A Dalvik register ever holding a reference therefore keeps its register
+ * to itself for the whole method, as do Method* and the compiler temps. Only the first Dalvik
+ * register given a shared register is in the vmap table, which is why the linear scan is disabled
+ * for debuggable code.  Returns false when the method is too large to analyze.
+ */
+bool Mir2Lir::PromoteCoreRegsLinearScan(const RefCounts* core_regs, int num_regs,
+                                        int promotion_threshold) {
+  LiveIntervals intervals(cu_, mir_graph_);
+  if (!intervals.Compute()) {
+    return false;
+  }
+  int dalvik_regs = cu_->num_dalvik_registers;
+  std::vector<bool> holds_ref(dalvik_regs, false);
+  for (int i = 0; i < mir_graph_->GetNumSSARegs(); i++) {
+    int v_reg = mir_graph_->SRegToVReg(i);
+    if ((v_reg >= 0) && mir_graph_->reg_location_[i].ref) {
+      holds_ref[v_reg] = true;
+    }
+  }
+  std::vector<LiveIntervals::Range> whole_method(1);
+  whole_method[0].start = 0;
+  whole_method[0].end = intervals.GetLastPosition();
+
+  std::vector<ScanInterval> candidates;
+  for (int i = 0; (i < num_regs) && (core_regs[i].count >= promotion_threshold) &&
+       (candidates.size() < kMaxScanIntervals); i++) {
+    int p_map_idx = SRegToPMap(core_regs[i].s_reg);
+    if (promotion_map_[p_map_idx].core_location == kLocPhysReg) {
+      continue;
+    }
+    ScanInterval candidate;
+    candidate.s_reg = core_regs[i].s_reg;
+    candidate.count = core_regs[i].count;
+    candidate.ranges = ((p_map_idx >= dalvik_regs) || holds_ref[p_map_idx]) ?
+        &whole_method : &intervals.GetRanges(p_map_idx);
+    candidate.reg = -1;
+    if (!candidate.ranges->empty()) {
+      candidates.push_back(candidate);
+    }
+  }
+  std::vector<ScanInterval*> order;
+  for (size_t i = 0; i < candidates.size(); i++) {
+    order.push_back(&candidates[i]);
+  }
+  std::sort(order.begin(), order.end(), StartsBefore);
+
+  // The free callee-save registers and the intervals given each, including ones taken back.
+  std::vector<int> regs;
+  RegisterInfo* pool = reg_pool_->core_regs;
+  for (int i = 0; i < reg_pool_->num_core_regs; i++) {
+    if (!pool[i].is_temp && !pool[i].in_use) {
+      regs.push_back(pool[i].reg);
+    }
+  }
+  std::vector<std::vector<ScanInterval*> > assigned(regs.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    ScanInterval* current = order[i];
+    int best = -1;
+    int best_weight = current->count;
+    for (size_t r = 0; r < regs.size(); r++) {
+      int weight = 0;
+      for (size_t j = 0; j < assigned[r].size(); j++) {
+        ScanInterval* other = assigned[r][j];
+        if ((other->reg == regs[r]) && LiveIntervals::Intersect(*current->ranges, *other->ranges)) {
+          weight += other->count;
+        }
+      }
+      if (weight < best_weight) {
+        best = r;
+        best_weight = weight;
+        if (weight == 0) {
+          break;
+        }
+      }
+    }
+    if (best < 0) {
+      continue;  // Stays in memory.
+    }
+    for (size_t j = 0; j < assigned[best].size(); j++) {
+      ScanInterval* other = assigned[best][j];
+      if ((other->reg == regs[best]) &&
+          LiveIntervals::Intersect(*current->ranges, *other->ranges)) {
+        other->reg = -1;
+      }
+    }
+    current->reg = regs[best];
+    assigned[best].push_back(current);
+  }
+
+  for (size_t r = 0; r < regs.size(); r++) {
+    bool shared = false;
+    for (size_t j = 0; j < assigned[r].size(); j++) {
+      ScanInterval* interval = assigned[r][j];
+      if (interval->reg != regs[r]) {
+        continue;
+      }
+      if (!shared) {
+        RecordCorePromotion(regs[r], interval->s_reg);
+        shared = true;
+      } else {
+        RecordSharedCorePromotion(regs[r], interval->s_reg);
+      }
+    }
+  }
+  return true;
+}
+
 /*
  * Note: some portions of this code required even if the kPromoteRegs
  * optimization is disabled.
@@ -967,8 +1120,9 @@ void Mir2Lir::DoPromotion() {
    * preference to fp doubles - which must be allocated sequential
    * physical single fp registers started with an even-numbered
    * reg.
-   * TUNING: replace with linear scan once we have the ability
-   * to describe register live ranges for GC.
+   * Core registers are promoted by linear scan over live intervals
+   * unless disabled, sharing callee-save registers among values that
+   * are never references.
    */
   RefCounts *core_regs =
       static_cast<RefCounts*>(arena_->Alloc(sizeof(RefCounts) * num_regs,
@@ -1026,15 +1180,18 @@ void Mir2Lir::DoPromotion() {
       }
     }
 
-    // Promote core regs
-    for (int i = 0; (i < num_regs) &&
-            (core_regs[i].count >= promotion_threshold); i++) {
-      int p_map_idx = SRegToPMap(core_regs[i].s_reg);
-      if (promotion_map_[p_map_idx].core_location !=
-          kLocPhysReg) {
-        int reg = AllocPreservedCoreReg(core_regs[i].s_reg);
-        if (reg < 0) {
-           break;  // No more left
+    // Promote core regs, by use counts alone if the linear scan is disabled or fails.
+    if ((cu_->disable_opt & (1 << kLinearScanPromotion)) ||
+        !PromoteCoreRegsLinearScan(core_regs, num_regs, promotion_threshold)) {
+      for (int i = 0; (i < num_regs) &&
+              (core_regs[i].count >= promotion_threshold); i++) {
+        int p_map_idx = SRegToPMap(core_regs[i].s_reg);
+        if (promotion_map_[p_map_idx].core_location !=
+            kLocPhysReg) {
+          int reg = AllocPreservedCoreReg(core_regs[i].s_reg);
+          if (reg < 0) {
+             break;  // No more left
+          }
         }
       }
     }
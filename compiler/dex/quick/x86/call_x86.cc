@@ -150,6 +150,10 @@ void X86Mir2Lir::GenFillArrayData(uint32_t table_offset, RegLocation rl_src) {
                           rX86_ARG1, true);
 }
 
+// Lock word bits that must match for a thin lock to be biased towards a given thread.
+static const int kBiasedOwnerMask =
+    ((1 << LW_LOCK_COUNT_SHIFT) - 1) & ~(LW_HASH_STATE_MASK << LW_HASH_STATE_SHIFT);
+
 void X86Mir2Lir::GenMonitorEnter(int opt_flags, RegLocation rl_src) {
   FlushAllRegs();
   LoadValueDirectFixed(rl_src, rCX);  // Get obj
@@ -162,9 +166,26 @@ void X86Mir2Lir::GenMonitorEnter(int opt_flags, RegLocation rl_src) {
   NewLIR2(kX86Xor32RR, rAX, rAX);
   NewLIR3(kX86LockCmpxchgMR, rCX, mirror::Object::MonitorOffset().Int32Value(), rDX);
   LIR* branch = NewLIR2(kX86Jcc8, 0, kX86CondEq);
+  // The failed cmpxchg left the lock word in eax. If the lock is biased towards us and the hold
+  // count has room, take another hold with a plain store.
+  OpRegImm(kOpOr, rDX, LW_BIAS_MASK << LW_BIAS_SHIFT);
+  OpRegCopy(rBX, rAX);
+  OpRegImm(kOpAnd, rBX, kBiasedOwnerMask);
+  LIR* not_biased = OpCmpBranch(kCondNe, rBX, rDX, NULL);
+  OpRegCopy(rBX, rAX);
+  OpRegImm(kOpAsr, rBX, LW_LOCK_COUNT_SHIFT + 1);
+  LIR* count_overflow = OpCmpImmBranch(kCondEq, rBX, -1, NULL);
+  OpRegImm(kOpAdd, rAX, 1 << LW_LOCK_COUNT_SHIFT);
+  NewLIR3(kX86Mov32MR, rCX, mirror::Object::MonitorOffset().Int32Value(), rAX);
+  LIR* branch2 = NewLIR1(kX86Jmp8, 0);
+  LIR* slow_path = NewLIR0(kPseudoTargetLabel);
+  not_biased->target = slow_path;
+  count_overflow->target = slow_path;
   // If lock is held, go the expensive route - artLockObjectFromCode(self, obj);
   CallRuntimeHelperReg(QUICK_ENTRYPOINT_OFFSET(pLockObject), rCX, true);
-  branch->target = NewLIR0(kPseudoTargetLabel);
+  LIR* done = NewLIR0(kPseudoTargetLabel);
+  branch->target = done;
+  branch2->target = done;
 }
 
 void X86Mir2Lir::GenMonitorExit(int opt_flags, RegLocation rl_src) {
@@ -182,9 +203,25 @@ void X86Mir2Lir::GenMonitorExit(int opt_flags, RegLocation rl_src) {
   NewLIR3(kX86Mov32MR, rAX, mirror::Object::MonitorOffset().Int32Value(), rCX);
   LIR* branch2 = NewLIR1(kX86Jmp8, 0);
   branch->target = NewLIR0(kPseudoTargetLabel);
+  // If the lock is biased towards us, subtracting our owner bits leaves the bias bit, and we hold
+  // it if the hold count is non-zero. Drop a hold with a plain store.
+  OpRegCopy(rBX, rCX);
+  OpRegImm(kOpAnd, rBX, kBiasedOwnerMask);
+  LIR* not_biased = OpCmpImmBranch(kCondNe, rBX, LW_BIAS_MASK << LW_BIAS_SHIFT, NULL);
+  OpRegImm(kOpLsr, rCX, LW_LOCK_COUNT_SHIFT);
+  LIR* not_held = OpCmpImmBranch(kCondEq, rCX, 0, NULL);
+  NewLIR3(kX86Mov32RM, rCX, rAX, mirror::Object::MonitorOffset().Int32Value());
+  OpRegImm(kOpSub, rCX, 1 << LW_LOCK_COUNT_SHIFT);
+  NewLIR3(kX86Mov32MR, rAX, mirror::Object::MonitorOffset().Int32Value(), rCX);
+  LIR* branch3 = NewLIR1(kX86Jmp8, 0);
+  LIR* slow_path = NewLIR0(kPseudoTargetLabel);
+  not_biased->target = slow_path;
+  not_held->target = slow_path;
   // Otherwise, go the expensive route - UnlockObjectFromCode(obj);
   CallRuntimeHelperReg(QUICK_ENTRYPOINT_OFFSET(pUnlockObject), rAX, true);
-  branch2->target = NewLIR0(kPseudoTargetLabel);
+  LIR* done = NewLIR0(kPseudoTargetLabel);
+  branch2->target = done;
+  branch3->target = done;
 }
 
 void X86Mir2Lir::GenMoveException(RegLocation rl_dest) {
@@ -85,6 +85,8 @@ int X86Mir2Lir::TargetReg(SpecialTargetRegister reg) {
     case kRet0: res = rX86_RET0; break;
     case kRet1: res = rX86_RET1; break;
     case kInvokeTgt: res = rX86_INVOKE_TGT; break;
+    case kHiddenArg: res = rX86_HIDDEN_ARG; break;
+    case kHiddenFpArg: res = rX86_HIDDEN_FP_ARG; break;
     case kCount: res = rX86_COUNT; break;
   }
   return res;
@@ -386,6 +388,7 @@ void X86Mir2Lir::LockCallTemps() {
   LockTemp(rX86_ARG1);
   LockTemp(rX86_ARG2);
   LockTemp(rX86_ARG3);
+  LockTemp(rX86_HIDDEN_FP_ARG);
 }
 
 /* To be used when explicitly managing register use */
@@ -394,6 +397,7 @@ void X86Mir2Lir::FreeCallTemps() {
   FreeTemp(rX86_ARG1);
   FreeTemp(rX86_ARG2);
   FreeTemp(rX86_ARG3);
+  FreeTemp(rX86_HIDDEN_FP_ARG);
 }
 
 void X86Mir2Lir::GenMemBarrier(MemBarrierKind barrier_kind) {
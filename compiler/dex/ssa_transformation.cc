@@ -672,6 +672,132 @@ void MIRGraph::DoDFSPreOrderSSARename(BasicBlock* block) {
 }
 
 /* Perform SSA transformation for the whole method */
+/* Add the blocks reaching latch without passing through header to the loop headed by header */
+void MIRGraph::AddBackEdge(BasicBlock* latch, BasicBlock* header) {
+  LoopInfo* loop = NULL;
+  GrowableArray<LoopInfo*>::Iterator loop_iter(&loops_);
+  for (LoopInfo* other = loop_iter.Next(); other != NULL; other = loop_iter.Next()) {
+    if (other->header == header) {
+      loop = other;
+      break;
+    }
+  }
+  if (loop == NULL) {
+    loop = static_cast<LoopInfo*>(arena_->Alloc(sizeof(LoopInfo), ArenaAllocator::kAllocMisc));
+    loop->header = header;
+    loop->blocks = new (arena_) ArenaBitVector(arena_, GetNumBlocks(), false /* expandable */,
+                                               kBitMapLoopBlocks);
+    loop->blocks->SetBit(header->id);
+    loop->parent = NULL;
+    loop->children = new (arena_) GrowableArray<LoopInfo*>(arena_, 2);
+    loop->depth = 1;
+    loops_.Insert(loop);
+  }
+  std::vector<BasicBlock*> work_stack;
+  if (!loop->blocks->IsBitSet(latch->id)) {
+    loop->blocks->SetBit(latch->id);
+    work_stack.push_back(latch);
+  }
+  while (!work_stack.empty()) {
+    BasicBlock* bb = work_stack.back();
+    work_stack.pop_back();
+    GrowableArray<BasicBlock*>::Iterator iter(bb->predecessors);
+    for (BasicBlock* pred_bb = iter.Next(); pred_bb != NULL; pred_bb = iter.Next()) {
+      // Unreachable predecessors have no dominators and aren't part of the loop.
+      if ((pred_bb->dominators != NULL) && !loop->blocks->IsBitSet(pred_bb->id)) {
+        loop->blocks->SetBit(pred_bb->id);
+        work_stack.push_back(pred_bb);
+      }
+    }
+  }
+}
+
+/*
+ * Find the natural loops from the back edges, an edge to a block dominating its source, and
+ * nest them by containment. Sets the nesting depth of each block, which weighs its uses for
+ * register promotion.
+ */
+void MIRGraph::FindLoops() {
+  loops_.Reset();
+  ReachableNodesIterator iter(this, false /* not iterative */);
+  for (BasicBlock* bb = iter.Next(); bb != NULL; bb = iter.Next()) {
+    bb->nesting_depth = 0;
+    std::vector<BasicBlock*> successors;
+    if (bb->taken != NULL) {
+      successors.push_back(bb->taken);
+    }
+    if (bb->fall_through != NULL) {
+      successors.push_back(bb->fall_through);
+    }
+    if (bb->successor_block_list.block_list_type != kNotUsed) {
+      GrowableArray<SuccessorBlockInfo*>::Iterator succ_iter(bb->successor_block_list.blocks);
+      for (SuccessorBlockInfo* info = succ_iter.Next(); info != NULL; info = succ_iter.Next()) {
+        successors.push_back(info->block);
+      }
+    }
+    for (size_t i = 0; i < successors.size(); i++) {
+      if (bb->dominators->IsBitSet(successors[i]->id)) {
+        AddBackEdge(bb, successors[i]);
+      }
+    }
+  }
+
+  // Natural loops with different headers are either disjoint or nested, so the parent of a loop
+  // is the smallest other loop containing its header.
+  size_t num_loops = loops_.Size();
+  std::vector<int> sizes(num_loops);
+  for (size_t i = 0; i < num_loops; i++) {
+    sizes[i] = loops_.Get(i)->blocks->NumSetBits();
+  }
+  for (size_t i = 0; i < num_loops; i++) {
+    LoopInfo* loop = loops_.Get(i);
+    int parent_size = 0;
+    for (size_t j = 0; j < num_loops; j++) {
+      LoopInfo* other = loops_.Get(j);
+      if ((j != i) && other->blocks->IsBitSet(loop->header->id) &&
+          ((loop->parent == NULL) || (sizes[j] < parent_size))) {
+        loop->parent = other;
+        parent_size = sizes[j];
+      }
+    }
+    if (loop->parent != NULL) {
+      loop->parent->children->Insert(loop);
+    }
+  }
+
+  // Order the loops by decreasing depth, so that nested loops come first.
+  std::vector<LoopInfo*> sorted_loops;
+  int max_depth = 0;
+  for (size_t i = 0; i < num_loops; i++) {
+    LoopInfo* loop = loops_.Get(i);
+    for (LoopInfo* parent = loop->parent; parent != NULL; parent = parent->parent) {
+      loop->depth++;
+    }
+    max_depth = std::max(max_depth, loop->depth);
+    ArenaBitVector::Iterator block_iter(loop->blocks);
+    for (int block_id = block_iter.Next(); block_id != -1; block_id = block_iter.Next()) {
+      BasicBlock* bb = GetBasicBlock(block_id);
+      bb->nesting_depth = std::max(static_cast<int>(bb->nesting_depth), loop->depth);
+    }
+  }
+  for (int depth = max_depth; depth > 0; depth--) {
+    for (size_t i = 0; i < num_loops; i++) {
+      if (loops_.Get(i)->depth == depth) {
+        sorted_loops.push_back(loops_.Get(i));
+      }
+    }
+  }
+  loops_.Reset();
+  for (size_t i = 0; i < sorted_loops.size(); i++) {
+    loops_.Insert(sorted_loops[i]);
+  }
+
+  if (cu_->verbose && (num_loops != 0)) {
+    LOG(INFO) << PrettyMethod(cu_->method_idx, *cu_->dex_file) << ": " << num_loops
+              << " loops, nested up to " << max_depth << " deep";
+  }
+}
+
 void MIRGraph::SSATransformation() {
   /* Compute the DFS order */
   ComputeDFSOrders();
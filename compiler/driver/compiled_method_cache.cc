@@ -0,0 +1,582 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compiled_method_cache.h"
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <ostream>
+#include <vector>
+
+#include "base/stringprintf.h"
+#include "base/unix_file/fd_file.h"
+#include "class_linker.h"
+#include "compiled_method.h"
+#include "dex_instruction.h"
+#include "gc/heap.h"
+#include "gc/space/image_space.h"
+#include "mirror/art_field-inl.h"
+#include "mirror/art_method-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/dex_cache-inl.h"
+#include "mirror/object_array-inl.h"
+#include "oat.h"
+#include "object_utils.h"
+#include "os.h"
+#include "runtime.h"
+#include "scoped_thread_state_change.h"
+#include "thread.h"
+#include "UniquePtr.h"
+#include "utils.h"
+#include "verifier/method_verifier.h"
+
+namespace art {
+
+// As many constructors as MethodInliner::CollectConstructorStores follows.
+static const size_t kMaxInlinedConstructors = 8;
+
+// Appends length-prefixed values to a string, for keys and entries.
+class CacheEncoder {
+ public:
+  explicit CacheEncoder(std::string* out) : out_(out) {}
+
+  void Add32(uint32_t value) {
+    out_->append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  void Add64(uint64_t value) {
+    out_->append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  void AddBytes(const void* data, size_t size) {
+    Add32(size);
+    out_->append(reinterpret_cast<const char*>(data), size);
+  }
+
+  void AddString(const char* s) {
+    AddBytes(s, strlen(s));
+  }
+
+  void AddString(const std::string& s) {
+    AddBytes(s.data(), s.size());
+  }
+
+  void AddBytes(const std::vector<uint8_t>& bytes) {
+    AddBytes(bytes.empty() ? NULL : &bytes[0], bytes.size());
+  }
+
+ private:
+  std::string* const out_;
+};
+
+// Reads back what a CacheEncoder wrote, failing rather than reading past the end.
+class CacheDecoder {
+ public:
+  explicit CacheDecoder(const std::string& in) : in_(in), pos_(0) {}
+
+  bool Read32(uint32_t* value) {
+    return Read(value, sizeof(*value));
+  }
+
+  bool Read64(uint64_t* value) {
+    return Read(value, sizeof(*value));
+  }
+
+  bool ReadString(std::string* s) {
+    uint32_t size;
+    if (!Read32(&size) || size > in_.size() - pos_) {
+      return false;
+    }
+    s->assign(in_, pos_, size);
+    pos_ += size;
+    return true;
+  }
+
+  bool ReadBytes(std::vector<uint8_t>* bytes) {
+    std::string s;
+    if (!ReadString(&s)) {
+      return false;
+    }
+    bytes->assign(s.begin(), s.end());
+    return true;
+  }
+
+  bool AtEnd() const {
+    return pos_ == in_.size();
+  }
+
+ private:
+  bool Read(void* value, size_t size) {
+    if (size > in_.size() - pos_) {
+      return false;
+    }
+    memcpy(value, in_.data() + pos_, size);
+    pos_ += size;
+    return true;
+  }
+
+  const std::string& in_;
+  size_t pos_;
+};
+
+// 64-bit FNV-1a.
+static uint64_t HashBytes(const std::string& bytes) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    hash = (hash ^ static_cast<uint8_t>(bytes[i])) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// Returns a checksum of the binary holding the compiler, so that entries from another build of
+// the compiler are never used.
+static uint32_t GetCompilerChecksum() {
+  Dl_info info;
+  if (dladdr(reinterpret_cast<void*>(&GetCompilerChecksum), &info) != 0 &&
+      info.dli_fname != NULL) {
+    UniquePtr<File> file(OS::OpenFileForReading(info.dli_fname));
+    if (file.get() != NULL) {
+      uLong adler = adler32(0L, Z_NULL, 0);
+      std::vector<uint8_t> buffer(64 * KB);
+      int64_t remaining = file->GetLength();
+      while (remaining > 0) {
+        size_t count = std::min<int64_t>(remaining, buffer.size());
+        if (!file->ReadFully(&buffer[0], count)) {
+          break;
+        }
+        adler = adler32(adler, &buffer[0], count);
+        remaining -= count;
+      }
+      if (remaining == 0) {
+        return adler;
+      }
+    }
+  }
+  // Without a checksum we can't tell compilers apart, so make sure nothing is ever hit.
+  LOG(WARNING) << "Unable to checksum the compiler; the compiled method cache will only miss";
+  return static_cast<uint32_t>(NanoTime());
+}
+
+CompiledMethodCache::CompiledMethodCache(const std::string& directory,
+                                         InstructionSet instruction_set, bool debuggable)
+    : directory_(directory),
+      instruction_set_(instruction_set),
+      fingerprints_lock_("compiled method cache fingerprints lock"),
+      hits_(0),
+      misses_(0),
+      insert_failures_(0),
+      stats_lock_("compiled method cache stats lock"),
+      saved_ns_(0),
+      lookup_ns_(0) {
+  CacheEncoder salt(&salt_);
+  salt.Add32(kMagic);
+  salt.Add32(kVersion);
+  salt.AddBytes(OatHeader::kOatVersion, sizeof(OatHeader::kOatVersion));
+  salt.Add32(GetCompilerChecksum());
+  salt.Add32(kIsDebugBuild);
+  salt.Add32(instruction_set);
+  salt.Add32(debuggable);
+  Runtime* runtime = Runtime::Current();
+  salt.Add32(runtime->GetCompilerFilter());
+  salt.Add32(runtime->GetHugeMethodThreshold());
+  salt.Add32(runtime->GetLargeMethodThreshold());
+  salt.Add32(runtime->GetSmallMethodThreshold());
+  salt.Add32(runtime->GetTinyMethodThreshold());
+  salt.Add32(runtime->GetNumDexMethodsThreshold());
+  // Code may call boot methods directly, so it depends on where the boot image puts them.
+  gc::space::ImageSpace* image_space = runtime->GetHeap()->GetImageSpace();
+  if (image_space != NULL) {
+    const ImageHeader& image_header = image_space->GetImageHeader();
+    salt.Add32(image_header.GetOatChecksum());
+    salt.Add32(reinterpret_cast<uintptr_t>(image_header.GetOatDataBegin()));
+  }
+  const std::vector<const DexFile*>& boot_class_path =
+      runtime->GetClassLinker()->GetBootClassPath();
+  for (size_t i = 0; i < boot_class_path.size(); ++i) {
+    salt.AddString(boot_class_path[i]->GetLocation());
+    salt.Add32(boot_class_path[i]->GetLocationChecksum());
+  }
+}
+
+uint64_t CompiledMethodCache::GetClassFingerprint(mirror::Class* klass) {
+  if (klass == NULL) {
+    return 0;
+  }
+  Thread* self = Thread::Current();
+  {
+    MutexLock mu(self, fingerprints_lock_);
+    SafeMap<const mirror::Class*, uint64_t>::const_iterator it = fingerprints_.find(klass);
+    if (it != fingerprints_.end()) {
+      return it->second;
+    }
+  }
+  std::string description;
+  CacheEncoder encoder(&description);
+  ClassHelper kh(klass);
+  encoder.AddString(kh.GetDescriptor());
+  if (klass->GetClassLoader() == NULL) {
+    // Boot classes can only change along with the boot class path, which is in the salt.
+  } else if (klass->IsArrayClass()) {
+    encoder.Add64(GetClassFingerprint(klass->GetComponentType()));
+  } else {
+    encoder.Add32(klass->GetStatus());
+    encoder.Add32(klass->GetAccessFlags());
+    encoder.Add32(klass->GetObjectSize());
+    encoder.Add64(GetClassFingerprint(klass->GetSuperClass()));
+    for (size_t i = 0; i < kh.NumDirectInterfaces(); ++i) {
+      encoder.Add64(GetClassFingerprint(kh.GetDirectInterface(i)));
+    }
+    for (size_t i = 0; i < klass->NumInstanceFields() + klass->NumStaticFields(); ++i) {
+      mirror::ArtField* field = (i < klass->NumInstanceFields())
+          ? klass->GetInstanceField(i)
+          : klass->GetStaticField(i - klass->NumInstanceFields());
+      FieldHelper fh(field);
+      encoder.AddString(fh.GetName());
+      encoder.AddString(fh.GetTypeDescriptor());
+      encoder.Add32(field->GetAccessFlags());
+      encoder.Add32(field->GetOffset().Uint32Value());
+    }
+    for (size_t i = 0; i < klass->NumDirectMethods(); ++i) {
+      mirror::ArtMethod* method = klass->GetDirectMethod(i);
+      MethodHelper mh(method);
+      encoder.AddString(mh.GetName());
+      encoder.AddString(mh.GetSignature());
+      encoder.Add32(method->GetAccessFlags());
+    }
+    mirror::ObjectArray<mirror::ArtMethod>* vtable = klass->GetVTable();
+    for (int32_t i = 0; vtable != NULL && i < vtable->GetLength(); ++i) {
+      mirror::ArtMethod* method = vtable->Get(i);
+      MethodHelper mh(method);
+      encoder.AddString(mh.GetDeclaringClassDescriptor());
+      encoder.AddString(mh.GetName());
+      encoder.AddString(mh.GetSignature());
+      encoder.Add32(method->GetAccessFlags());
+    }
+  }
+  uint64_t fingerprint = HashBytes(description);
+  MutexLock mu(self, fingerprints_lock_);
+  fingerprints_.Put(klass, fingerprint);
+  return fingerprint;
+}
+
+std::string CompiledMethodCache::ComputeKey(const DexFile& dex_file, uint32_t method_idx,
+                                            const DexFile::CodeItem* code_item,
+                                            uint32_t access_flags, InvokeType invoke_type,
+                                            jobject class_loader) {
+  DCHECK(code_item != NULL);
+  std::string key(salt_);
+  CacheEncoder encoder(&key);
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::DexCache* dex_cache = Runtime::Current()->GetClassLinker()->FindDexCache(dex_file);
+
+  // The method itself.
+  const DexFile::MethodId& method_id = dex_file.GetMethodId(method_idx);
+  encoder.AddString(dex_file.GetMethodDeclaringClassDescriptor(method_id));
+  encoder.AddString(dex_file.GetMethodName(method_id));
+  encoder.AddString(dex_file.GetMethodSignature(method_id));
+  encoder.Add32(access_flags);
+  encoder.Add32(invoke_type);
+  encoder.Add64(GetClassFingerprint(dex_cache->GetResolvedType(method_id.class_idx_)));
+
+  // Its code. The offset of the debug info changes with unrelated edits and isn't compiled.
+  encoder.Add32(code_item->registers_size_);
+  encoder.Add32(code_item->ins_size_);
+  encoder.Add32(code_item->outs_size_);
+  encoder.AddBytes(code_item->insns_, code_item->insns_size_in_code_units_ * sizeof(uint16_t));
+
+  // Everything the code refers to, by name.
+  class References {
+   public:
+    References(CompiledMethodCache* cache, CacheEncoder* encoder, const DexFile& dex_file,
+               mirror::DexCache* dex_cache, mirror::ClassLoader* class_loader)
+        : cache_(cache), encoder_(encoder), dex_file_(dex_file), dex_cache_(dex_cache),
+          class_loader_(class_loader) {}
+
+    void AddString(uint32_t string_idx) {
+      encoder_->AddString(dex_file_.StringDataByIdx(string_idx));
+    }
+
+    void AddType(uint32_t type_idx) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+      encoder_->AddString(dex_file_.StringByTypeIdx(type_idx));
+      encoder_->Add64(cache_->GetClassFingerprint(dex_cache_->GetResolvedType(type_idx)));
+    }
+
+    void AddField(uint32_t field_idx) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+      const DexFile::FieldId& field_id = dex_file_.GetFieldId(field_idx);
+      AddType(field_id.class_idx_);
+      encoder_->AddString(dex_file_.GetFieldName(field_id));
+      AddType(field_id.type_idx_);
+      mirror::ArtField* field = dex_cache_->GetResolvedField(field_idx);
+      if (field == NULL) {
+        encoder_->Add32(0);
+      } else {
+        encoder_->Add32(1);
+        encoder_->Add64(cache_->GetClassFingerprint(field->GetDeclaringClass()));
+        encoder_->Add32(field->GetAccessFlags());
+        encoder_->Add32(field->GetOffset().Uint32Value());
+      }
+    }
+
+    void AddMethod(uint32_t method_idx) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+      const DexFile::MethodId& method_id = dex_file_.GetMethodId(method_idx);
+      AddType(method_id.class_idx_);
+      encoder_->AddString(dex_file_.GetMethodName(method_id));
+      const DexFile::ProtoId& proto_id = dex_file_.GetMethodPrototype(method_id);
+      AddType(proto_id.return_type_idx_);
+      const DexFile::TypeList* parameters = dex_file_.GetProtoParameters(proto_id);
+      encoder_->Add32((parameters == NULL) ? 0 : parameters->Size());
+      for (size_t i = 0; parameters != NULL && i < parameters->Size(); ++i) {
+        AddType(parameters->GetTypeItem(i).type_idx_);
+      }
+      mirror::ArtMethod* method = dex_cache_->GetResolvedMethod(method_idx);
+      if (method == NULL || method->IsRuntimeMethod()) {
+        encoder_->Add32(0);
+      } else {
+        encoder_->Add32(1);
+        encoder_->Add64(cache_->GetClassFingerprint(method->GetDeclaringClass()));
+        encoder_->Add32(method->GetAccessFlags());
+        encoder_->Add32(method->GetMethodIndex());
+        AddInlinableCode(method);
+      }
+    }
+
+    // The verifier's more precise target of the virtual call at dex_pc, which may be called
+    // directly or inlined instead.
+    void AddDevirtualizedMethod(const MethodReference& caller, uint32_t dex_pc)
+        SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+      const MethodReference* target = verifier::MethodVerifier::GetDevirtMap(caller, dex_pc);
+      if (target == NULL) {
+        return;
+      }
+      ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+      mirror::ArtMethod* method =
+          class_linker->ResolveMethod(*target->dex_file, target->dex_method_index,
+                                      class_linker->FindDexCache(*target->dex_file),
+                                      class_loader_, NULL, kVirtual);
+      CHECK(method != NULL);
+      encoder_->Add32(dex_pc);
+      encoder_->Add64(cache_->GetClassFingerprint(method->GetDeclaringClass()));
+      encoder_->Add32(method->GetDexMethodIndex());
+      encoder_->Add32(method->GetAccessFlags());
+      AddInlinableCode(method);
+    }
+
+   private:
+    // Inlining copies the code of small application methods into their callers, and that of the
+    // constructors a constructor calls first along with it. Boot methods only change along with
+    // the boot class path, which is in the salt.
+    void AddInlinableCode(mirror::ArtMethod* method) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+      for (size_t i = 0; (method != NULL) && (i < kMaxInlinedConstructors); ++i) {
+        const DexFile::CodeItem* code_item = MethodHelper(method).GetCodeItem();
+        if (method->GetDeclaringClass()->GetClassLoader() == NULL || code_item == NULL) {
+          break;
+        }
+        encoder_->Add32(1);
+        encoder_->Add32(code_item->registers_size_);
+        encoder_->Add32(code_item->ins_size_);
+        encoder_->AddBytes(code_item->insns_,
+                           code_item->insns_size_in_code_units_ * sizeof(uint16_t));
+        method = (method->IsConstructor() && !method->IsStatic()) ?
+            GetCalledConstructor(method, code_item) : NULL;
+      }
+      encoder_->Add32(0);
+    }
+
+    // The constructor the constructor calls with its leading invoke-direct, or NULL.
+    mirror::ArtMethod* GetCalledConstructor(mirror::ArtMethod* constructor,
+                                            const DexFile::CodeItem* code_item)
+        SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+      if (code_item->insns_size_in_code_units_ == 0) {
+        return NULL;
+      }
+      const Instruction* inst = Instruction::At(code_item->insns_);
+      if (inst->Opcode() != Instruction::INVOKE_DIRECT &&
+          inst->Opcode() != Instruction::INVOKE_DIRECT_RANGE) {
+        return NULL;
+      }
+      mirror::ArtMethod* method =
+          Runtime::Current()->GetClassLinker()->ResolveMethod(inst->VRegB(), constructor,
+                                                              kDirect);
+      if (method == NULL) {
+        // Nor can the inliner resolve it.
+        Thread::Current()->ClearException();
+      }
+      return method;
+    }
+
+    CompiledMethodCache* const cache_;
+    CacheEncoder* const encoder_;
+    const DexFile& dex_file_;
+    mirror::DexCache* const dex_cache_;
+    mirror::ClassLoader* const class_loader_;
+  };
+  References references(this, &encoder, dex_file, dex_cache,
+                        soa.Decode<mirror::ClassLoader*>(class_loader));
+  const MethodReference method_ref(&dex_file, method_idx);
+
+  const uint16_t* insns = code_item->insns_;
+  const uint16_t* insns_end = insns + code_item->insns_size_in_code_units_;
+  for (const Instruction* inst = Instruction::At(insns);
+       reinterpret_cast<const uint16_t*>(inst) < insns_end; inst = inst->Next()) {
+    switch (inst->GetVerifyTypeArgumentB()) {
+      case Instruction::kVerifyRegBField:
+        references.AddField(inst->VRegB());
+        break;
+      case Instruction::kVerifyRegBMethod:
+        references.AddMethod(inst->VRegB());
+        references.AddDevirtualizedMethod(method_ref, inst->GetDexPc(insns));
+        break;
+      case Instruction::kVerifyRegBNewInstance:
+      case Instruction::kVerifyRegBType:
+        references.AddType(inst->VRegB());
+        break;
+      case Instruction::kVerifyRegBString:
+        references.AddString(inst->VRegB());
+        break;
+      default:
+        break;
+    }
+    switch (inst->GetVerifyTypeArgumentC()) {
+      case Instruction::kVerifyRegCField:
+        references.AddField(inst->VRegC());
+        break;
+      case Instruction::kVerifyRegCNewArray:
+      case Instruction::kVerifyRegCType:
+        references.AddType(inst->VRegC());
+        break;
+      default:
+        break;
+    }
+  }
+
+  // The try blocks and their handlers.
+  encoder.Add32(code_item->tries_size_);
+  for (size_t i = 0; i < code_item->tries_size_; ++i) {
+    const DexFile::TryItem* try_item = DexFile::GetTryItems(*code_item, i);
+    encoder.Add32(try_item->start_addr_);
+    encoder.Add32(try_item->insn_count_);
+    for (CatchHandlerIterator it(*code_item, *try_item); it.HasNext(); it.Next()) {
+      encoder.Add32(it.GetHandlerAddress());
+      if (it.GetHandlerTypeIndex() == DexFile::kDexNoIndex16) {
+        encoder.AddString("catch-all");
+      } else {
+        references.AddType(it.GetHandlerTypeIndex());
+      }
+    }
+  }
+  return key;
+}
+
+std::string CompiledMethodCache::GetEntryPath(const std::string& key) const {
+  return StringPrintf("%s/%016llx.cmc", directory_.c_str(),
+                      static_cast<unsigned long long>(HashBytes(key)));  // NOLINT(runtime/int)
+}
+
+CompiledMethod* CompiledMethodCache::Lookup(CompilerDriver& driver, const std::string& key) {
+  uint64_t start_ns = NanoTime();
+  CompiledMethod* method = NULL;
+  uint64_t compile_ns = 0;
+  UniquePtr<File> file(OS::OpenFileForReading(GetEntryPath(key).c_str()));
+  if (file.get() != NULL && file->GetLength() > 0) {
+    std::string entry(file->GetLength(), '\0');
+    std::string entry_key;
+    uint32_t frame_size_in_bytes;
+    uint32_t core_spill_mask;
+    uint32_t fp_spill_mask;
+    std::vector<uint8_t> code;
+    std::vector<uint8_t> mapping_table;
+    std::vector<uint8_t> vmap_table;
+    std::vector<uint8_t> gc_map;
+    CacheDecoder decoder(entry);
+    if (file->ReadFully(&entry[0], entry.size()) &&
+        decoder.ReadString(&entry_key) && entry_key == key &&
+        decoder.Read64(&compile_ns) &&
+        decoder.Read32(&frame_size_in_bytes) &&
+        decoder.Read32(&core_spill_mask) &&
+        decoder.Read32(&fp_spill_mask) &&
+        decoder.ReadBytes(&code) &&
+        decoder.ReadBytes(&mapping_table) &&
+        decoder.ReadBytes(&vmap_table) &&
+        decoder.ReadBytes(&gc_map) &&
+        decoder.AtEnd()) {
+      method = new CompiledMethod(driver, instruction_set_, code, frame_size_in_bytes,
+                                  core_spill_mask, fp_spill_mask, mapping_table, vmap_table,
+                                  gc_map);
+    }
+  }
+  uint64_t lookup_ns = NanoTime() - start_ns;
+  if (method == NULL) {
+    ++misses_;
+  } else {
+    ++hits_;
+  }
+  MutexLock mu(Thread::Current(), stats_lock_);
+  lookup_ns_ += lookup_ns;
+  if (method != NULL) {
+    saved_ns_ += compile_ns;
+  }
+  return method;
+}
+
+void CompiledMethodCache::Insert(const std::string& key, const CompiledMethod& method,
+                                 uint64_t compile_ns) {
+  std::string entry;
+  CacheEncoder encoder(&entry);
+  encoder.AddString(key);
+  encoder.Add64(compile_ns);
+  encoder.Add32(method.GetFrameSizeInBytes());
+  encoder.Add32(method.GetCoreSpillMask());
+  encoder.Add32(method.GetFpSpillMask());
+  encoder.AddBytes(method.GetCode());
+  encoder.AddBytes(method.GetMappingTable());
+  encoder.AddBytes(method.GetVmapTable());
+  encoder.AddBytes(method.GetGcMap());
+
+  // Write to a private file and rename it into place, so readers never see a partial entry.
+  std::string path(GetEntryPath(key));
+  std::string temp_path(StringPrintf("%s.%d.tmp", path.c_str(), GetTid()));
+  UniquePtr<File> file(OS::CreateEmptyFile(temp_path.c_str()));
+  if (file.get() == NULL) {
+    if (++insert_failures_ == 1) {
+      PLOG(WARNING) << "Failed to create compiled method cache entry " << temp_path
+                    << ", not logging further failures";
+    }
+    return;
+  }
+  bool written = file->WriteFully(entry.data(), entry.size()) && file->Close() == 0;
+  if (!written || rename(temp_path.c_str(), path.c_str()) != 0) {
+    if (++insert_failures_ == 1) {
+      PLOG(WARNING) << "Failed to write compiled method cache entry " << path
+                    << ", not logging further failures";
+    }
+    unlink(temp_path.c_str());
+  }
+}
+
+void CompiledMethodCache::DumpStats(std::ostream& os) const {
+  size_t hits = GetHits();
+  size_t lookups = hits + GetMisses();
+  MutexLock mu(Thread::Current(), stats_lock_);
+  os << "Compiled method cache: " << hits << " hits in " << lookups << " lookups ("
+     << StringPrintf("%.1f%%", (lookups == 0) ? 0.0 : 100.0 * hits / lookups) << "), saved "
+     << PrettyDuration(saved_ns_) << " of compilation, lookups took "
+     << PrettyDuration(lookup_ns_) << "\n";
+}
+
+}  // namespace art
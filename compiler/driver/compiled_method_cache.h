@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_DRIVER_COMPILED_METHOD_CACHE_H_
+#define ART_COMPILER_DRIVER_COMPILED_METHOD_CACHE_H_
+
+#include <iosfwd>
+#include <string>
+
+#include "atomic_integer.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "dex_file.h"
+#include "instruction_set.h"
+#include "invoke_type.h"
+#include "jni.h"
+#include "safe_map.h"
+
+namespace art {
+
+class CompiledMethod;
+class CompilerDriver;
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+// An on-disk cache of the code Quick compiles for methods of applications, so that recompiling an
+// application after a small update only compiles the methods it changed.
+//
+// An entry is keyed by everything the compiled code depends on:
+//  - the compiler itself, the compiler options, the instruction set and whether the application
+//    is debuggable,
+//  - the boot image and boot class path, which code may call into directly,
+//  - the method's signature, flags and code item, other than its debug info,
+//  - every string, type, field and method the code refers to, by name rather than by index, the
+//    code of the application methods it calls, which may be inlined, and
+//    the layout of every application class involved: fields and offsets, vtable, superclasses and
+//    interfaces, and status.
+// Entries store their full key, so a hash collision is a miss rather than wrong code.
+//
+// Images aren't cached because their code is patched with references into the image.
+class CompiledMethodCache {
+ public:
+  CompiledMethodCache(const std::string& directory, InstructionSet instruction_set,
+                      bool debuggable);
+
+  // Returns the key of the method, which is only meaningful to this cache.
+  std::string ComputeKey(const DexFile& dex_file, uint32_t method_idx,
+                         const DexFile::CodeItem* code_item, uint32_t access_flags,
+                         InvokeType invoke_type, jobject class_loader)
+      LOCKS_EXCLUDED(Locks::mutator_lock_, fingerprints_lock_);
+
+  // Returns the method cached under key, or NULL.
+  CompiledMethod* Lookup(CompilerDriver& driver, const std::string& key)
+      LOCKS_EXCLUDED(stats_lock_);
+
+  // Caches method under key, noting that compiling it took compile_ns.
+  void Insert(const std::string& key, const CompiledMethod& method, uint64_t compile_ns);
+
+  size_t GetHits() const {
+    return hits_.load();
+  }
+
+  size_t GetMisses() const {
+    return misses_.load();
+  }
+
+  // Reports the hit rate and how much compile time the hits saved.
+  void DumpStats(std::ostream& os) const LOCKS_EXCLUDED(stats_lock_);
+
+ private:
+  static const uint32_t kMagic = 0x434d4341;  // "ACMC"
+  // Changes whenever the format of entries or keys does.
+  static const uint32_t kVersion = 3;
+
+  std::string GetEntryPath(const std::string& key) const;
+
+  // Returns a fingerprint of what compiled code may rely on about klass, or 0 for NULL.
+  uint64_t GetClassFingerprint(mirror::Class* klass)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) LOCKS_EXCLUDED(fingerprints_lock_);
+
+  const std::string directory_;
+  const InstructionSet instruction_set_;
+  // The part of every key that doesn't depend on the method.
+  std::string salt_;
+
+  Mutex fingerprints_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  SafeMap<const mirror::Class*, uint64_t> fingerprints_ GUARDED_BY(fingerprints_lock_);
+
+  AtomicInteger hits_;
+  AtomicInteger misses_;
+  // Entries that couldn't be written, only the first of which is logged.
+  AtomicInteger insert_failures_;
+  mutable Mutex stats_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  // The compile time of the entries that were hit, and the time spent looking entries up.
+  uint64_t saved_ns_ GUARDED_BY(stats_lock_);
+  uint64_t lookup_ns_ GUARDED_BY(stats_lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(CompiledMethodCache);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_DRIVER_COMPILED_METHOD_CACHE_H_
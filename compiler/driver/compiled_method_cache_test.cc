@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "driver/compiled_method_cache.h"
+
+#include <sstream>
+#include <vector>
+
+#include "UniquePtr.h"
+#include "common_test.h"
+#include "compiled_method.h"
+#include "mirror/art_field-inl.h"
+#include "mirror/art_method-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/dex_cache-inl.h"
+#include "object_utils.h"
+#include "sirt_ref.h"
+
+namespace art {
+
+class CompiledMethodCacheTest : public CommonTest {
+ protected:
+  struct MethodInfo {
+    const DexFile* dex_file;
+    uint32_t method_idx;
+    const DexFile::CodeItem* code_item;
+    uint32_t access_flags;
+    InvokeType invoke_type;
+    jobject class_loader;
+  };
+
+  static mirror::ArtMethod* FindVirtualMethod(mirror::Class* klass, const char* name)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    for (size_t i = 0; i < klass->NumVirtualMethods(); ++i) {
+      mirror::ArtMethod* method = klass->GetVirtualMethod(i);
+      if (strcmp(MethodHelper(method).GetName(), name) == 0 &&
+          method->GetDeclaringClass() == klass) {
+        return method;
+      }
+    }
+    LOG(FATAL) << "Method not found: " << PrettyClass(klass) << "." << name;
+    return NULL;
+  }
+
+  static MethodInfo GetMethodInfo(mirror::ArtMethod* method, jobject class_loader)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    MethodHelper mh(method);
+    MethodInfo info;
+    info.dex_file = &mh.GetDexFile();
+    info.method_idx = method->GetDexMethodIndex();
+    info.code_item = mh.GetCodeItem();
+    info.access_flags = method->GetAccessFlags();
+    info.invoke_type = kVirtual;
+    info.class_loader = class_loader;
+    return info;
+  }
+
+  MethodInfo GetVirtualMethod(const char* descriptor, const char* name)
+      LOCKS_EXCLUDED(Locks::mutator_lock_) {
+    ScopedObjectAccess soa(Thread::Current());
+    mirror::Class* klass = class_linker_->FindSystemClass(descriptor);
+    CHECK(klass != NULL) << descriptor;
+    return GetMethodInfo(FindVirtualMethod(klass, name), NULL);
+  }
+
+  std::string ComputeKey(CompiledMethodCache& cache, const MethodInfo& info) {
+    return cache.ComputeKey(*info.dex_file, info.method_idx, info.code_item,
+                            info.access_flags, info.invoke_type, info.class_loader);
+  }
+
+  // Loads the Getters test class, resolving what getValueTwice refers to as the compiler's
+  // resolution pass would.
+  mirror::Class* LoadGetters(ScopedObjectAccess& soa, jobject* class_loader)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    *class_loader = LoadDex("Getters");
+    mirror::Class* klass =
+        class_linker_->FindClass("LGetters;", soa.Decode<mirror::ClassLoader*>(*class_loader));
+    CHECK(klass != NULL);
+    mirror::DexCache* dex_cache = klass->GetDexCache();
+    mirror::ArtMethod* get_value = FindVirtualMethod(klass, "getValue");
+    dex_cache->SetResolvedMethod(get_value->GetDexMethodIndex(), get_value);
+    mirror::ArtField* value = klass->GetInstanceField(0);
+    dex_cache->SetResolvedField(value->GetDexFieldIndex(), value);
+    return klass;
+  }
+};
+
+TEST_F(CompiledMethodCacheTest, ComputeKey) {
+  CompiledMethodCache cache(dalvik_cache_, kThumb2, false);
+  MethodInfo to_string = GetVirtualMethod("Ljava/lang/Object;", "toString");
+  MethodInfo hash_code = GetVirtualMethod("Ljava/lang/Object;", "hashCode");
+  std::string key(ComputeKey(cache, to_string));
+  EXPECT_FALSE(key.empty());
+  EXPECT_EQ(key, ComputeKey(cache, to_string));
+  EXPECT_NE(key, ComputeKey(cache, hash_code));
+
+  // Keys depend on the instruction set.
+  CompiledMethodCache x86_cache(dalvik_cache_, kX86, false);
+  EXPECT_NE(key, ComputeKey(x86_cache, to_string));
+
+  // And on whether the application is debuggable.
+  CompiledMethodCache debuggable_cache(dalvik_cache_, kThumb2, true);
+  EXPECT_NE(key, ComputeKey(debuggable_cache, to_string));
+}
+
+TEST_F(CompiledMethodCacheTest, FieldLayout) {
+  jobject class_loader;
+  MethodInfo get_value_twice;
+  mirror::ArtField* value;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    mirror::Class* klass = LoadGetters(soa, &class_loader);
+    get_value_twice = GetMethodInfo(FindVirtualMethod(klass, "getValueTwice"), class_loader);
+    value = klass->GetInstanceField(0);
+  }
+  std::string key;
+  {
+    CompiledMethodCache cache(dalvik_cache_, kThumb2, false);
+    key = ComputeKey(cache, get_value_twice);
+  }
+
+  // As if the next compile found another field before it.
+  MemberOffset offset(0);
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    offset = value->GetOffset();
+    value->SetOffset(MemberOffset(offset.Uint32Value() + sizeof(int32_t)));
+  }
+  {
+    CompiledMethodCache cache(dalvik_cache_, kThumb2, false);
+    EXPECT_NE(key, ComputeKey(cache, get_value_twice));
+  }
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    value->SetOffset(offset);
+  }
+  CompiledMethodCache cache(dalvik_cache_, kThumb2, false);
+  EXPECT_EQ(key, ComputeKey(cache, get_value_twice));
+}
+
+TEST_F(CompiledMethodCacheTest, MethodFlags) {
+  jobject class_loader;
+  MethodInfo get_value_twice;
+  mirror::ArtMethod* get_value;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    mirror::Class* klass = LoadGetters(soa, &class_loader);
+    get_value_twice = GetMethodInfo(FindVirtualMethod(klass, "getValueTwice"), class_loader);
+    get_value = FindVirtualMethod(klass, "getValue");
+  }
+  CompiledMethodCache cache(dalvik_cache_, kThumb2, false);
+  std::string key(ComputeKey(cache, get_value_twice));
+
+  // Calls to final methods may be made directly.
+  uint32_t access_flags;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    access_flags = get_value->GetAccessFlags();
+    get_value->SetAccessFlags(access_flags | kAccFinal);
+  }
+  EXPECT_NE(key, ComputeKey(cache, get_value_twice));
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    get_value->SetAccessFlags(access_flags);
+  }
+  EXPECT_EQ(key, ComputeKey(cache, get_value_twice));
+}
+
+TEST_F(CompiledMethodCacheTest, InlinedCalleeCode) {
+  jobject class_loader;
+  MethodInfo get_value_twice;
+  mirror::ArtMethod* get_value;
+  mirror::ArtMethod* get_zero;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    mirror::Class* klass = LoadGetters(soa, &class_loader);
+    get_value_twice = GetMethodInfo(FindVirtualMethod(klass, "getValueTwice"), class_loader);
+    get_value = FindVirtualMethod(klass, "getValue");
+    get_zero = FindVirtualMethod(klass, "getZero");
+  }
+  CompiledMethodCache cache(dalvik_cache_, kThumb2, false);
+  std::string key(ComputeKey(cache, get_value_twice));
+
+  // The callee may be inlined, so giving it another body changes the caller's key.
+  uint32_t code_item_offset;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    code_item_offset = get_value->GetCodeItemOffset();
+    get_value->SetCodeItemOffset(get_zero->GetCodeItemOffset());
+  }
+  EXPECT_NE(key, ComputeKey(cache, get_value_twice));
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    get_value->SetCodeItemOffset(code_item_offset);
+  }
+  EXPECT_EQ(key, ComputeKey(cache, get_value_twice));
+}
+
+TEST_F(CompiledMethodCacheTest, InlinedConstructorChain) {
+  jobject class_loader;
+  MethodInfo copy;
+  mirror::ArtMethod* init_int;
+  mirror::ArtMethod* get_zero;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    mirror::Class* klass = LoadGetters(soa, &class_loader);
+    copy = GetMethodInfo(FindVirtualMethod(klass, "copy"), class_loader);
+    mirror::ArtMethod* init = klass->FindDirectMethod("<init>", "()V");
+    klass->GetDexCache()->SetResolvedMethod(init->GetDexMethodIndex(), init);
+    init_int = klass->FindDirectMethod("<init>", "(I)V");
+    get_zero = FindVirtualMethod(klass, "getZero");
+  }
+  CompiledMethodCache cache(dalvik_cache_, kThumb2, false);
+  std::string key(ComputeKey(cache, copy));
+
+  // Getters() is inlined along with the Getters(int) it calls first, so giving the latter
+  // another body changes the key of copy.
+  uint32_t code_item_offset;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    code_item_offset = init_int->GetCodeItemOffset();
+    init_int->SetCodeItemOffset(get_zero->GetCodeItemOffset());
+  }
+  EXPECT_NE(key, ComputeKey(cache, copy));
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    init_int->SetCodeItemOffset(code_item_offset);
+  }
+  EXPECT_EQ(key, ComputeKey(cache, copy));
+}
+
+TEST_F(CompiledMethodCacheTest, InsertLookup) {
+  CompiledMethodCache cache(dalvik_cache_, kThumb2, false);
+  MethodInfo to_string = GetVirtualMethod("Ljava/lang/Object;", "toString");
+  MethodInfo hash_code = GetVirtualMethod("Ljava/lang/Object;", "hashCode");
+  std::string key(ComputeKey(cache, to_string));
+  std::string other_key(ComputeKey(cache, hash_code));
+
+  EXPECT_TRUE(cache.Lookup(*compiler_driver_, key) == NULL);
+  EXPECT_EQ(0U, cache.GetHits());
+  EXPECT_EQ(1U, cache.GetMisses());
+
+  std::vector<uint8_t> code;
+  for (uint8_t i = 0; i < 16; ++i) {
+    code.push_back(i);
+  }
+  std::vector<uint8_t> mapping_table(3, 1);
+  std::vector<uint8_t> vmap_table(5, 2);
+  std::vector<uint8_t> gc_map(7, 3);
+  CompiledMethod method(*compiler_driver_, kThumb2, code, 32, 0x4fe0, 0x10, mapping_table,
+                        vmap_table, gc_map);
+  cache.Insert(key, method, 1000);
+
+  UniquePtr<CompiledMethod> cached(cache.Lookup(*compiler_driver_, key));
+  ASSERT_TRUE(cached.get() != NULL);
+  EXPECT_EQ(1U, cache.GetHits());
+  EXPECT_EQ(kThumb2, cached->GetInstructionSet());
+  EXPECT_EQ(code, cached->GetCode());
+  EXPECT_EQ(32U, cached->GetFrameSizeInBytes());
+  EXPECT_EQ(0x4fe0U, cached->GetCoreSpillMask());
+  EXPECT_EQ(0x10U, cached->GetFpSpillMask());
+  EXPECT_EQ(mapping_table, cached->GetMappingTable());
+  EXPECT_EQ(vmap_table, cached->GetVmapTable());
+  EXPECT_EQ(gc_map, cached->GetGcMap());
+
+  EXPECT_TRUE(cache.Lookup(*compiler_driver_, other_key) == NULL);
+  EXPECT_EQ(1U, cache.GetHits());
+  EXPECT_EQ(2U, cache.GetMisses());
+
+  std::ostringstream oss;
+  cache.DumpStats(oss);
+  EXPECT_NE(std::string::npos, oss.str().find("1 hits in 3 lookups"));
+}
+
+}  // namespace art
@@ -19,12 +19,15 @@
 #define ATRACE_TAG ATRACE_TAG_DALVIK
 #include <utils/Trace.h>
 
+#include <algorithm>
 #include <vector>
 #include <unistd.h>
 
 #include "base/stl_util.h"
+#include "base/stringprintf.h"
 #include "base/timing_logger.h"
 #include "class_linker.h"
+#include "compiled_method_cache.h"
 #include "dex_compilation_unit.h"
 #include "dex_file-inl.h"
 #include "jni_internal.h"
@@ -76,8 +79,9 @@ class AOTCompilationStats {
         resolved_types_(0), unresolved_types_(0),
         resolved_instance_fields_(0), unresolved_instance_fields_(0),
         resolved_local_static_fields_(0), resolved_static_fields_(0), unresolved_static_fields_(0),
-        type_based_devirtualization_(0),
-        safe_casts_(0), not_safe_casts_(0) {
+        type_based_devirtualization_(0), class_hierarchy_devirtualization_(0),
+        safe_casts_(0), not_safe_casts_(0),
+        eliminated_allocations_(0), kept_allocations_(0) {
     for (size_t i = 0; i <= kMaxInvokeType; i++) {
       resolved_methods_[i] = 0;
       unresolved_methods_[i] = 0;
@@ -97,6 +101,8 @@ class AOTCompilationStats {
     DumpStat(resolved_local_static_fields_, resolved_static_fields_ + unresolved_static_fields_,
              "static fields local to a class");
     DumpStat(safe_casts_, not_safe_casts_, "check-casts removed based on type information");
+    DumpStat(eliminated_allocations_, kept_allocations_,
+             "new-instances removed by escape analysis");
     // Note, the code below subtracts the stat value so that when added to the stat value we have
     // 100% of samples. TODO: clean this up.
     DumpStat(type_based_devirtualization_,
@@ -104,6 +110,10 @@ class AOTCompilationStats {
              resolved_methods_[kInterface] + unresolved_methods_[kInterface] -
              type_based_devirtualization_,
              "virtual/interface calls made direct based on type information");
+    DumpStat(class_hierarchy_devirtualization_,
+             resolved_methods_[kVirtual] + unresolved_methods_[kVirtual] -
+             class_hierarchy_devirtualization_,
+             "virtual calls made direct as no loaded class overrides the method");
 
     for (size_t i = 0; i <= kMaxInvokeType; i++) {
       std::ostringstream oss;
@@ -201,6 +211,19 @@ class AOTCompilationStats {
     type_based_devirtualization_++;
   }
 
+  // Indicate how many new-instances of a method escape analysis removed and kept.
+  void EliminatedAllocations(size_t eliminated, size_t kept) {
+    STATS_LOCK();
+    eliminated_allocations_ += eliminated;
+    kept_allocations_ += kept;
+  }
+
+  // Indicate that class hierarchy analysis led to devirtualization.
+  void ClassHierarchyDevirtualization() {
+    STATS_LOCK();
+    class_hierarchy_devirtualization_++;
+  }
+
   // Indicate that a method of the given type was resolved at compile time.
   void ResolvedMethod(InvokeType type) {
     DCHECK_LE(type, kMaxInvokeType);
@@ -270,6 +293,7 @@ class AOTCompilationStats {
   size_t unresolved_static_fields_;
   // Type based devirtualization for invoke interface and virtual.
   size_t type_based_devirtualization_;
+  size_t class_hierarchy_devirtualization_;
 
   size_t resolved_methods_[kMaxInvokeType + 1];
   size_t unresolved_methods_[kMaxInvokeType + 1];
@@ -280,6 +304,9 @@ class AOTCompilationStats {
   size_t safe_casts_;
   size_t not_safe_casts_;
 
+  size_t eliminated_allocations_;
+  size_t kept_allocations_;
+
   DISALLOW_COPY_AND_ASSIGN(AOTCompilationStats);
 };
 
@@ -345,6 +372,7 @@ CompilerDriver::CompilerDriver(CompilerBackend compiler_backend, InstructionSet
       compiled_methods_lock_("compiled method lock"),
       image_(image),
       image_classes_(image_classes),
+      class_hierarchy_analyzed_(false),
       thread_count_(thread_count),
       start_ns_(0),
       stats_(new AOTCompilationStats),
@@ -355,7 +383,12 @@ CompilerDriver::CompilerDriver(CompilerBackend compiler_backend, InstructionSet
       jni_compiler_(NULL),
       compiler_enable_auto_elf_loading_(NULL),
       compiler_get_method_code_addr_(NULL),
-      support_boot_image_fixup_(true) {
+      support_boot_image_fixup_(true),
+      debuggable_(false),
+      dedupe_code_("dedupe code"),
+      dedupe_mapping_table_("dedupe mapping table"),
+      dedupe_vmap_table_("dedupe vmap table"),
+      dedupe_gc_map_("dedupe gc map") {
 
   CHECK_PTHREAD_CALL(pthread_key_create, (&tls_key_, NULL), "compiler tls key");
 
@@ -480,6 +513,11 @@ const std::vector<uint8_t>* CompilerDriver::CreateQuickResolutionTrampoline() co
                           QUICK_ENTRYPOINT_OFFSET(pQuickResolutionTrampoline));
 }
 
+const std::vector<uint8_t>* CompilerDriver::CreateQuickImtConflictTrampoline() const {
+  return CreateTrampoline(instruction_set_, kQuickAbi,
+                          QUICK_ENTRYPOINT_OFFSET(pQuickImtConflictTrampoline));
+}
+
 const std::vector<uint8_t>* CompilerDriver::CreateQuickToInterpreterBridge() const {
   return CreateTrampoline(instruction_set_, kQuickAbi,
                           QUICK_ENTRYPOINT_OFFSET(pQuickToInterpreterBridge));
@@ -494,9 +532,29 @@ void CompilerDriver::CompileAll(jobject class_loader,
   Compile(class_loader, dex_files, *thread_pool.get(), timings);
   if (dump_stats_) {
     stats_->Dump();
+    // Report how long compiler threads waited to deduplicate their output.
+    Thread* self = Thread::Current();
+    std::ostringstream oss;
+    dedupe_code_.DumpStats(self, oss);
+    dedupe_mapping_table_.DumpStats(self, oss);
+    dedupe_vmap_table_.DumpStats(self, oss);
+    dedupe_gc_map_.DumpStats(self, oss);
+    LOG(INFO) << oss.str();
+  }
+  if (compiled_method_cache_.get() != NULL) {
+    std::ostringstream oss;
+    compiled_method_cache_->DumpStats(oss);
+    LOG(INFO) << oss.str();
   }
 }
 
+void CompilerDriver::SetCompiledMethodCache(CompiledMethodCache* cache) {
+  // Image code is patched after compilation and other backends don't produce Quick code.
+  CHECK_EQ(compiler_backend_, kQuick);
+  CHECK(!image_);
+  compiled_method_cache_.reset(cache);
+}
+
 static DexToDexCompilationLevel GetDexToDexCompilationlevel(mirror::ClassLoader* class_loader,
                                                             const DexFile& dex_file,
                                                             const DexFile::ClassDef& class_def)
@@ -574,14 +632,6 @@ void CompilerDriver::CompileOne(const mirror::ArtMethod* method, base::TimingLog
   self->TransitionFromSuspendedToRunnable();
 }
 
-void CompilerDriver::Resolve(jobject class_loader, const std::vector<const DexFile*>& dex_files,
-                             ThreadPool& thread_pool, base::TimingLogger& timings) {
-  for (size_t i = 0; i != dex_files.size(); ++i) {
-    const DexFile* dex_file = dex_files[i];
-    CHECK(dex_file != NULL);
-    ResolveDexFile(class_loader, *dex_file, thread_pool, timings);
-  }
-}
 
 void CompilerDriver::PreCompile(jobject class_loader, const std::vector<const DexFile*>& dex_files,
                                 ThreadPool& thread_pool, base::TimingLogger& timings) {
@@ -594,6 +644,8 @@ void CompilerDriver::PreCompile(jobject class_loader, const std::vector<const De
   InitializeClasses(class_loader, dex_files, thread_pool, timings);
 
   UpdateImageClasses(timings);
+
+  AnalyzeClassHierarchy(timings);
 }
 
 bool CompilerDriver::IsImageClass(const char* descriptor) const {
@@ -774,6 +826,54 @@ void CompilerDriver::UpdateImageClasses(base::TimingLogger& timings) {
   }
 }
 
+bool CompilerDriver::RecordOverriddenMethods(mirror::Class* klass, void* arg) {
+  MethodSet* overridden_methods = reinterpret_cast<MethodSet*>(arg);
+  if (klass->IsInterface() || !klass->HasSuperClass() || klass->GetVTable() == NULL ||
+      klass->GetSuperClass()->GetVTable() == NULL) {
+    return true;
+  }
+  mirror::ObjectArray<mirror::ArtMethod>* vtable = klass->GetVTable();
+  mirror::ObjectArray<mirror::ArtMethod>* super_vtable = klass->GetSuperClass()->GetVTable();
+  int32_t length = std::min(vtable->GetLength(), super_vtable->GetLength());
+  for (int32_t i = 0; i < length; ++i) {
+    mirror::ArtMethod* super_method = super_vtable->Get(i);
+    if (vtable->Get(i) != super_method) {
+      overridden_methods->insert(
+          MethodReference(super_method->GetDeclaringClass()->GetDexCache()->GetDexFile(),
+                          super_method->GetDexMethodIndex()));
+    }
+  }
+  return true;
+}
+
+void CompilerDriver::AnalyzeClassHierarchy(base::TimingLogger& timings) {
+  // The runtime only redispatches from quick code, and only finds the flags of image methods.
+  if (IsImage() && compiler_backend_ == kQuick) {
+    timings.NewSplit("AnalyzeClassHierarchy");
+    ScopedObjectAccess soa(Thread::Current());
+    // A class overriding a method overrides it in every superclass up to the one declaring it,
+    // whose vtables all hold the method at the same index.
+    Runtime::Current()->GetClassLinker()->VisitClasses(RecordOverriddenMethods,
+                                                       &overridden_methods_);
+    class_hierarchy_analyzed_ = true;
+  }
+}
+
+bool CompilerDriver::HasSingleImplementation(mirror::ArtMethod* method) {
+  // Native methods keep their native method where others keep the code the runtime's redispatch
+  // trampoline enters them through.
+  if (!class_hierarchy_analyzed_ || method->IsDirect() || method->IsAbstract() ||
+      method->IsFinal() || method->IsNative() || method->GetDeclaringClass()->IsInterface()) {
+    return false;
+  }
+  MethodHelper mh(method);
+  if (!IsImageClass(mh.GetDeclaringClassDescriptor())) {
+    return false;
+  }
+  MethodReference ref(&mh.GetDexFile(), method->GetDexMethodIndex());
+  return overridden_methods_.find(ref) == overridden_methods_.end();
+}
+
 bool CompilerDriver::CanAssumeTypeIsPresentInDexCache(const DexFile& dex_file,
                                                       uint32_t type_idx) {
   if (IsImage() && IsImageClass(dex_file.GetTypeDescriptor(dex_file.GetTypeId(type_idx)))) {
@@ -886,6 +986,37 @@ bool CompilerDriver::CanAccessInstantiableTypeWithoutChecks(uint32_t referrer_id
   return result;
 }
 
+bool CompilerDriver::CanElideAllocation(uint32_t referrer_idx, const DexFile& dex_file,
+                                        uint32_t type_idx) {
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::DexCache* dex_cache = Runtime::Current()->GetClassLinker()->FindDexCache(dex_file);
+  mirror::Class* resolved_class = dex_cache->GetResolvedType(type_idx);
+  const DexFile::MethodId& method_id = dex_file.GetMethodId(referrer_idx);
+  mirror::Class* referrer_class = dex_cache->GetResolvedType(method_id.class_idx_);
+  if ((resolved_class == NULL) || (referrer_class == NULL) ||
+      !referrer_class->CanAccess(resolved_class) || !resolved_class->IsInstantiable() ||
+      !resolved_class->IsVerified() || resolved_class->IsFinalizable() ||
+      resolved_class->IsReferenceClass() || resolved_class->IsClassClass()) {
+    return false;
+  }
+  // Allocating initializes the class. The referrer's methods only run once its class and
+  // superclasses are initialized, or while its own thread initializes them.
+  if (referrer_class->IsSubClass(resolved_class)) {
+    return true;
+  }
+  for (mirror::Class* klass = resolved_class; klass != NULL; klass = klass->GetSuperClass()) {
+    if (klass->FindDeclaredDirectMethod("<clinit>", "()V") != NULL) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void CompilerDriver::RecordEliminatedAllocations(size_t eliminated, size_t allocations) {
+  DCHECK_LE(eliminated, allocations);
+  stats_->EliminatedAllocations(eliminated, allocations - eliminated);
+}
+
 static mirror::Class* ComputeCompilingMethodsClass(ScopedObjectAccess& soa,
                                                    mirror::DexCache* dex_cache,
                                                    const DexCompilationUnit* mUnit)
@@ -1262,6 +1393,25 @@ bool CompilerDriver::ComputeInvokeInfo(const DexCompilationUnit* mUnit, const ui
             }
           }
         }
+        const bool kEnableClassHierarchyBasedSharpening = true;
+        if (kEnableClassHierarchyBasedSharpening && (invoke_type == kVirtual) &&
+            HasSingleImplementation(resolved_method) &&
+            (referrer_class->GetDexCache()->GetResolvedMethod(target_method.dex_method_index) ==
+             resolved_method)) {
+          // Sharpen a virtual call into a direct call when no class loaded in the image
+          // overrides the target. The call loads the method and its code from the dex cache, so
+          // that its entry point may dispatch on the receiver if a class loaded later overrides
+          // it. Every writer of the flag sets the same bit, and nothing else writes the access
+          // flags of methods while compiling.
+          resolved_method->SetSingleImplementation();
+          if (update_stats) {
+            stats_->ResolvedMethod(invoke_type);
+            stats_->VirtualMadeDirect(invoke_type);
+            stats_->ClassHierarchyDevirtualization();
+          }
+          invoke_type = kDirect;
+          return true;
+        }
         if (invoke_type == kSuper) {
           // Unsharpened super calls are suspicious so go slow-path.
         } else {
@@ -1271,6 +1421,8 @@ bool CompilerDriver::ComputeInvokeInfo(const DexCompilationUnit* mUnit, const ui
           }
           if (invoke_type == kVirtual || invoke_type == kSuper) {
             vtable_idx = resolved_method->GetMethodIndex();
+          } else if (invoke_type == kInterface) {
+            vtable_idx = resolved_method->GetDexMethodIndex();
           }
           GetCodeAndMethodForDirectCall(invoke_type, invoke_type, referrer_class, resolved_method,
                                         direct_code, direct_method, update_stats);
@@ -1289,6 +1441,85 @@ bool CompilerDriver::ComputeInvokeInfo(const DexCompilationUnit* mUnit, const ui
   return false;  // Incomplete knowledge needs slow path.
 }
 
+bool CompilerDriver::ComputeInlinableMethod(const DexCompilationUnit* mUnit,
+                                            InvokeType invoke_type, uint32_t method_idx,
+                                            const DexFile::CodeItem*& code_item,
+                                            bool& is_referrers_class) {
+  ScopedObjectAccess soa(Thread::Current());
+  code_item = NULL;
+  is_referrers_class = false;
+  mirror::ArtMethod* resolved_method =
+      ComputeMethodReferencedFromCompilingMethod(soa, mUnit, method_idx, invoke_type);
+  if (resolved_method == NULL) {
+    // Clean up any exception left by method/invoke_type resolution
+    if (soa.Self()->IsExceptionPending()) {
+      soa.Self()->ClearException();
+    }
+    return false;
+  }
+  mirror::Class* methods_class = resolved_method->GetDeclaringClass();
+  if (resolved_method->IsNative() || resolved_method->IsAbstract() ||
+      resolved_method->IsSynchronized() || resolved_method->IsSingleImplementation() ||
+      (methods_class->GetDexCache()->GetDexFile() != mUnit->GetDexFile())) {
+    return false;
+  }
+  code_item = mUnit->GetDexFile()->GetCodeItem(resolved_method->GetCodeItemOffset());
+  if (code_item == NULL) {
+    return false;
+  }
+  mirror::Class* referrer_class =
+      ComputeCompilingMethodsClass(soa, methods_class->GetDexCache(), mUnit);
+  if (soa.Self()->IsExceptionPending()) {
+    soa.Self()->ClearException();
+  }
+  is_referrers_class = (referrer_class == methods_class);
+  return true;
+}
+
+bool CompilerDriver::CanInlineConstructor(const DexCompilationUnit* mUnit, uint32_t method_idx) {
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::ArtMethod* resolved_method =
+      ComputeMethodReferencedFromCompilingMethod(soa, mUnit, method_idx, kDirect);
+  if (resolved_method == NULL) {
+    if (soa.Self()->IsExceptionPending()) {
+      soa.Self()->ClearException();
+    }
+    return false;
+  }
+  mirror::Class* methods_class = resolved_method->GetDeclaringClass();
+  // The verifier only lets constructors run on objects new-instance just allocated, of the
+  // constructor's class, except that a constructor runs its superclass's on its own receiver,
+  // which may be of any subclass of its class.
+  mirror::Class* object_class = methods_class;
+  if (mUnit->IsConstructor()) {
+    mirror::Class* referrer_class =
+        ComputeCompilingMethodsClass(soa, methods_class->GetDexCache(), mUnit);
+    if (soa.Self()->IsExceptionPending()) {
+      soa.Self()->ClearException();
+    }
+    if (referrer_class == NULL) {
+      return false;
+    }
+    if (referrer_class->IsSubClass(methods_class)) {
+      if (!referrer_class->IsFinal()) {
+        return false;
+      }
+      object_class = referrer_class;
+    }
+  }
+  if (object_class->IsFinalizable()) {
+    return false;
+  }
+  for (mirror::Class* klass = methods_class; klass != NULL; klass = klass->GetSuperClass()) {
+    for (size_t i = 0; i < klass->NumInstanceFields(); i++) {
+      if (klass->GetInstanceField(i)->IsFinal()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 bool CompilerDriver::IsSafeCast(const MethodReference& mr, uint32_t dex_pc) {
   bool result = verifier::MethodVerifier::IsSafeCast(mr, dex_pc);
   if (result) {
@@ -1333,20 +1564,24 @@ void CompilerDriver::AddMethodPatch(const DexFile* dex_file,
                                                    literal_offset));
 }
 
+// Runs a callback for work units drawn from all dex files through one shared queue, so that a
+// phase has no barrier between dex files. Units are handed out most expensive first, in chunks
+// that shrink as the remaining work does, which keeps every worker busy until close to the end.
 class ParallelCompilationManager {
  public:
-  typedef void Callback(const ParallelCompilationManager* manager, size_t index);
+  typedef void Callback(const ParallelCompilationManager* manager, const DexFile& dex_file,
+                        size_t index);
 
   ParallelCompilationManager(ClassLinker* class_linker,
                              jobject class_loader,
                              CompilerDriver* compiler,
-                             const DexFile* dex_file,
+                             const std::vector<const DexFile*>& dex_files,
                              ThreadPool& thread_pool)
     : index_(0),
       class_linker_(class_linker),
       class_loader_(class_loader),
       compiler_(compiler),
-      dex_file_(dex_file),
+      dex_files_(dex_files),
       thread_pool_(&thread_pool) {}
 
   ClassLinker* GetClassLinker() const {
@@ -1363,21 +1598,89 @@ class ParallelCompilationManager {
     return compiler_;
   }
 
-  const DexFile* GetDexFile() const {
-    CHECK(dex_file_ != NULL);
-    return dex_file_;
+  // Runs callback for every class def of every dex file and returns the worker utilization.
+  double ForAllClassDefs(Callback callback, size_t work_units) {
+    units_.clear();
+    for (size_t i = 0; i != dex_files_.size(); ++i) {
+      const DexFile* dex_file = dex_files_[i];
+      CHECK(dex_file != NULL);
+      for (size_t class_def_index = 0; class_def_index < dex_file->NumClassDefs();
+           ++class_def_index) {
+        units_.push_back(WorkUnit(dex_file, class_def_index,
+                                  EstimateClassCost(*dex_file, class_def_index)));
+      }
+    }
+    return ForAll(callback, work_units);
+  }
+
+  // Runs callback for every type id of every dex file and returns the worker utilization.
+  double ForAllTypeIds(Callback callback, size_t work_units) {
+    units_.clear();
+    for (size_t i = 0; i != dex_files_.size(); ++i) {
+      const DexFile* dex_file = dex_files_[i];
+      CHECK(dex_file != NULL);
+      for (size_t type_idx = 0; type_idx < dex_file->NumTypeIds(); ++type_idx) {
+        units_.push_back(WorkUnit(dex_file, type_idx, 1));
+      }
+    }
+    return ForAll(callback, work_units);
+  }
+
+ private:
+  // Chunks each worker claims on average; more gives better balance and more contention.
+  static const size_t kChunksPerWorker = 4;
+
+  struct WorkUnit {
+    WorkUnit(const DexFile* dex_file, uint32_t index, uint32_t cost)
+        : dex_file(dex_file), index(index), cost(cost) {}
+
+    const DexFile* dex_file;
+    uint32_t index;
+    uint32_t cost;
+  };
+
+  static bool MoreExpensive(const WorkUnit& lhs, const WorkUnit& rhs) {
+    return lhs.cost > rhs.cost;
+  }
+
+  // The cost of a class is taken to be the size of its code, plus one for every method.
+  static uint32_t EstimateClassCost(const DexFile& dex_file, size_t class_def_index) {
+    const byte* class_data = dex_file.GetClassData(dex_file.GetClassDef(class_def_index));
+    uint32_t cost = 1;
+    if (class_data == NULL) {
+      return cost;
+    }
+    ClassDataItemIterator it(dex_file, class_data);
+    while (it.HasNextStaticField() || it.HasNextInstanceField()) {
+      it.Next();
+    }
+    while (it.HasNextDirectMethod() || it.HasNextVirtualMethod()) {
+      const DexFile::CodeItem* code_item = it.GetMethodCodeItem();
+      cost += 1 + ((code_item != NULL) ? code_item->insns_size_in_code_units_ : 0);
+      it.Next();
+    }
+    return cost;
   }
 
-  void ForAll(size_t begin, size_t end, Callback callback, size_t work_units) {
+  double ForAll(Callback callback, size_t work_units) {
     Thread* self = Thread::Current();
     self->AssertNoPendingException();
     CHECK_GT(work_units, 0U);
 
-    std::vector<ForAllClosure*> closures(work_units);
-    index_ = begin;
+    // A stable sort keeps the dex file order for units of equal cost.
+    std::stable_sort(units_.begin(), units_.end(), MoreExpensive);
+    cost_prefix_.resize(units_.size() + 1);
+    cost_prefix_[0] = 0;
+    for (size_t i = 0; i < units_.size(); ++i) {
+      cost_prefix_[i + 1] = cost_prefix_[i] + units_[i].cost;
+    }
+    index_ = 0;
+    work_units_ = work_units;
+    busy_ns_.assign(work_units, 0);
+
+    uint64_t start_ns = NanoTime();
     for (size_t i = 0; i < work_units; ++i) {
-      closures[i] = new ForAllClosure(this, end, callback);
-      thread_pool_->AddTask(self, closures[i]);
+      thread_pool_->AddTask(self, new ForAllClosure(this, i, callback));
     }
     thread_pool_->StartWorkers(self);
 
@@ -1387,29 +1690,58 @@ class ParallelCompilationManager {
 
     // Wait for all the worker threads to finish.
     thread_pool_->Wait(self, true, false);
+
+    uint64_t total_ns = (NanoTime() - start_ns) * work_units;
+    uint64_t busy_ns = 0;
+    for (size_t i = 0; i < work_units; ++i) {
+      busy_ns += busy_ns_[i];
+    }
+    return (total_ns == 0) ? 1.0 : static_cast<double>(busy_ns) / total_ns;
   }
 
-  size_t NextIndex() {
-    return index_.fetch_add(1);
+  // Claims the next units [*begin, *end), returning false when none are left. A chunk covers
+  // about 1 / (kChunksPerWorker * work_units) of the remaining cost but at least one unit.
+  bool NextChunk(size_t* begin, size_t* end) {
+    const size_t num_units = units_.size();
+    while (true) {
+      size_t start = index_.load();
+      if (start >= num_units) {
+        return false;
+      }
+      uint64_t remaining = cost_prefix_[num_units] - cost_prefix_[start];
+      uint64_t target = cost_prefix_[start] +
+          std::max<uint64_t>(remaining / (kChunksPerWorker * work_units_), 1);
+      // The first prefix past the target ends the chunk one unit later than we want.
+      size_t stop = std::upper_bound(cost_prefix_.begin() + start + 1, cost_prefix_.end(),
+                                     target) - cost_prefix_.begin() - 1;
+      stop = std::max(stop, start + 1);
+      if (index_.compare_and_swap(start, stop)) {
+        *begin = start;
+        *end = stop;
+        return true;
+      }
+    }
   }
 
- private:
   class ForAllClosure : public Task {
    public:
-    ForAllClosure(ParallelCompilationManager* manager, size_t end, Callback* callback)
+    ForAllClosure(ParallelCompilationManager* manager, size_t worker, Callback* callback)
         : manager_(manager),
-          end_(end),
+          worker_(worker),
           callback_(callback) {}
 
     virtual void Run(Thread* self) {
-      while (true) {
-        const size_t index = manager_->NextIndex();
-        if (UNLIKELY(index >= end_)) {
-          break;
+      uint64_t start_ns = NanoTime();
+      size_t begin;
+      size_t end;
+      while (manager_->NextChunk(&begin, &end)) {
+        for (size_t i = begin; i < end; ++i) {
+          const WorkUnit& unit = manager_->units_[i];
+          callback_(manager_, *unit.dex_file, unit.index);
+          self->AssertNoPendingException();
         }
-        callback_(manager_, index);
-        self->AssertNoPendingException();
       }
+      manager_->busy_ns_[worker_] = NanoTime() - start_ns;
     }
 
     virtual void Finalize() {
@@ -1418,7 +1750,7 @@ class ParallelCompilationManager {
 
    private:
     ParallelCompilationManager* const manager_;
-    const size_t end_;
+    const size_t worker_;
     const Callback* const callback_;
   };
 
@@ -1426,12 +1758,25 @@ class ParallelCompilationManager {
   ClassLinker* const class_linker_;
   const jobject class_loader_;
   CompilerDriver* const compiler_;
-  const DexFile* const dex_file_;
+  const std::vector<const DexFile*>& dex_files_;
   ThreadPool* const thread_pool_;
+  // The units of the current ForAll, most expensive first, and the running sums of their costs.
+  std::vector<WorkUnit> units_;
+  std::vector<uint64_t> cost_prefix_;
+  size_t work_units_;
+  // How long each worker of the current ForAll spent running units, indexed by worker.
+  std::vector<uint64_t> busy_ns_;
 
   DISALLOW_COPY_AND_ASSIGN(ParallelCompilationManager);
 };
 
+// Sets the label of the current split to name with the worker utilization of its ForAll.
+static void LabelPhase(base::TimingLogger& timings, const char* name, double utilization) {
+  // TODO: strdup memory leak.
+  timings.SetSplitLabel(strdup(StringPrintf("%s (%.0f%% worker utilization)", name,
+                                            utilization * 100.0).c_str()));
+}
+
 // Return true if the class should be skipped during compilation.
 //
 // The first case where we skip is for redundant class definitions in
@@ -1474,12 +1819,11 @@ static bool SkipClass(jobject class_loader, const DexFile& dex_file, mirror::Cla
 }
 
 static void ResolveClassFieldsAndMethods(const ParallelCompilationManager* manager,
-                                         size_t class_def_index)
+                                         const DexFile& dex_file, size_t class_def_index)
     LOCKS_EXCLUDED(Locks::mutator_lock_) {
   ATRACE_CALL();
   Thread* self = Thread::Current();
   jobject jclass_loader = manager->GetClassLoader();
-  const DexFile& dex_file = *manager->GetDexFile();
   ClassLinker* class_linker = manager->GetClassLinker();
 
   // If an instance field is final then we need to have a barrier on the return, static final
@@ -1580,12 +1924,12 @@ static void ResolveClassFieldsAndMethods(const ParallelCompilationManager* manag
   }
 }
 
-static void ResolveType(const ParallelCompilationManager* manager, size_t type_idx)
+static void ResolveType(const ParallelCompilationManager* manager, const DexFile& dex_file,
+                        size_t type_idx)
     LOCKS_EXCLUDED(Locks::mutator_lock_) {
   // Class derived values are more complicated, they require the linker and loader.
   ScopedObjectAccess soa(Thread::Current());
   ClassLinker* class_linker = manager->GetClassLinker();
-  const DexFile& dex_file = *manager->GetDexFile();
   mirror::DexCache* dex_cache = class_linker->FindDexCache(dex_file);
   mirror::ClassLoader* class_loader = soa.Decode<mirror::ClassLoader*>(manager->GetClassLoader());
   mirror::Class* klass = class_linker->ResolveType(dex_file, type_idx, dex_cache, class_loader);
@@ -1603,41 +1947,31 @@ static void ResolveType(const ParallelCompilationManager* manager, size_t type_i
   }
 }
 
-void CompilerDriver::ResolveDexFile(jobject class_loader, const DexFile& dex_file,
-                                    ThreadPool& thread_pool, base::TimingLogger& timings) {
+void CompilerDriver::Resolve(jobject class_loader, const std::vector<const DexFile*>& dex_files,
+                             ThreadPool& thread_pool, base::TimingLogger& timings) {
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
 
   // TODO: we could resolve strings here, although the string table is largely filled with class
   //       and method names.
 
-  ParallelCompilationManager context(class_linker, class_loader, this, &dex_file, thread_pool);
+  ParallelCompilationManager context(class_linker, class_loader, this, dex_files, thread_pool);
   if (IsImage()) {
     // For images we resolve all types, such as array, whereas for applications just those with
     // classdefs are resolved by ResolveClassFieldsAndMethods.
-    // TODO: strdup memory leak.
-    timings.NewSplit(strdup(("Resolve " + dex_file.GetLocation() + " Types").c_str()));
-    context.ForAll(0, dex_file.NumTypeIds(), ResolveType, thread_count_);
+    timings.NewSplit("Resolve Types");
+    LabelPhase(timings, "Resolve Types", context.ForAllTypeIds(ResolveType, thread_count_));
   }
 
-  // TODO: strdup memory leak.
-  timings.NewSplit(strdup(("Resolve " + dex_file.GetLocation() + " MethodsAndFields").c_str()));
-  context.ForAll(0, dex_file.NumClassDefs(), ResolveClassFieldsAndMethods, thread_count_);
-}
-
-void CompilerDriver::Verify(jobject class_loader, const std::vector<const DexFile*>& dex_files,
-                            ThreadPool& thread_pool, base::TimingLogger& timings) {
-  for (size_t i = 0; i != dex_files.size(); ++i) {
-    const DexFile* dex_file = dex_files[i];
-    CHECK(dex_file != NULL);
-    VerifyDexFile(class_loader, *dex_file, thread_pool, timings);
-  }
+  timings.NewSplit("Resolve MethodsAndFields");
+  LabelPhase(timings, "Resolve MethodsAndFields",
+             context.ForAllClassDefs(ResolveClassFieldsAndMethods, thread_count_));
 }
 
-static void VerifyClass(const ParallelCompilationManager* manager, size_t class_def_index)
+static void VerifyClass(const ParallelCompilationManager* manager, const DexFile& dex_file,
+                        size_t class_def_index)
     LOCKS_EXCLUDED(Locks::mutator_lock_) {
   ATRACE_CALL();
   ScopedObjectAccess soa(Thread::Current());
-  const DexFile& dex_file = *manager->GetDexFile();
   const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
   const char* descriptor = dex_file.GetClassDescriptor(class_def);
   ClassLinker* class_linker = manager->GetClassLinker();
@@ -1678,13 +2012,12 @@ static void VerifyClass(const ParallelCompilationManager* manager, size_t class_
   soa.Self()->AssertNoPendingException();
 }
 
-void CompilerDriver::VerifyDexFile(jobject class_loader, const DexFile& dex_file,
-                                   ThreadPool& thread_pool, base::TimingLogger& timings) {
-  // TODO: strdup memory leak.
-  timings.NewSplit(strdup(("Verify " + dex_file.GetLocation()).c_str()));
+void CompilerDriver::Verify(jobject class_loader, const std::vector<const DexFile*>& dex_files,
+                            ThreadPool& thread_pool, base::TimingLogger& timings) {
+  timings.NewSplit("Verify");
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-  ParallelCompilationManager context(class_linker, class_loader, this, &dex_file, thread_pool);
-  context.ForAll(0, dex_file.NumClassDefs(), VerifyClass, thread_count_);
+  ParallelCompilationManager context(class_linker, class_loader, this, dex_files, thread_pool);
+  LabelPhase(timings, "Verify", context.ForAllClassDefs(VerifyClass, thread_count_));
 }
 
 static const char* class_initializer_black_list[] = {
@@ -2105,11 +2438,11 @@ static const char* class_initializer_black_list[] = {
   "Lorg/apache/http/conn/util/InetAddressUtils;",  // Calls regex.Pattern.compile -..-> regex.Pattern.compileImpl.
 };
 
-static void InitializeClass(const ParallelCompilationManager* manager, size_t class_def_index)
+static void InitializeClass(const ParallelCompilationManager* manager, const DexFile& dex_file,
+                            size_t class_def_index)
     LOCKS_EXCLUDED(Locks::mutator_lock_) {
   ATRACE_CALL();
   jobject jclass_loader = manager->GetClassLoader();
-  const DexFile& dex_file = *manager->GetDexFile();
   const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
   const char* descriptor = dex_file.GetClassDescriptor(class_def);
   ClassLinker* class_linker = manager->GetClassLinker();
@@ -2176,17 +2509,17 @@ static void InitializeClass(const ParallelCompilationManager* manager, size_t cl
       }
     }
     // Record the final class status if necessary.
-    ClassReference ref(manager->GetDexFile(), class_def_index);
+    ClassReference ref(&dex_file, class_def_index);
     manager->GetCompiler()->RecordClassStatus(ref, klass->GetStatus());
   }
   // Clear any class not found or verification exceptions.
   soa.Self()->ClearException();
 }
 
-void CompilerDriver::InitializeClasses(jobject jni_class_loader, const DexFile& dex_file,
+void CompilerDriver::InitializeClasses(jobject jni_class_loader,
+                                       const std::vector<const DexFile*>& dex_files,
                                        ThreadPool& thread_pool, base::TimingLogger& timings) {
-  // TODO: strdup memory leak.
-  timings.NewSplit(strdup(("InitializeNoClinit " + dex_file.GetLocation()).c_str()));
+  timings.NewSplit("InitializeNoClinit");
 #ifndef NDEBUG
   // Sanity check blacklist descriptors.
   if (IsImage()) {
@@ -2197,33 +2530,25 @@ void CompilerDriver::InitializeClasses(jobject jni_class_loader, const DexFile&
   }
 #endif
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-  ParallelCompilationManager context(class_linker, jni_class_loader, this, &dex_file, thread_pool);
-  context.ForAll(0, dex_file.NumClassDefs(), InitializeClass, thread_count_);
-}
-
-void CompilerDriver::InitializeClasses(jobject class_loader,
-                                       const std::vector<const DexFile*>& dex_files,
-                                       ThreadPool& thread_pool, base::TimingLogger& timings) {
-  for (size_t i = 0; i != dex_files.size(); ++i) {
-    const DexFile* dex_file = dex_files[i];
-    CHECK(dex_file != NULL);
-    InitializeClasses(class_loader, *dex_file, thread_pool, timings);
-  }
+  ParallelCompilationManager context(class_linker, jni_class_loader, this, dex_files,
+                                     thread_pool);
+  LabelPhase(timings, "InitializeNoClinit",
+             context.ForAllClassDefs(InitializeClass, thread_count_));
 }
 
 void CompilerDriver::Compile(jobject class_loader, const std::vector<const DexFile*>& dex_files,
                        ThreadPool& thread_pool, base::TimingLogger& timings) {
-  for (size_t i = 0; i != dex_files.size(); ++i) {
-    const DexFile* dex_file = dex_files[i];
-    CHECK(dex_file != NULL);
-    CompileDexFile(class_loader, *dex_file, thread_pool, timings);
-  }
+  timings.NewSplit("Compile");
+  ParallelCompilationManager context(Runtime::Current()->GetClassLinker(), class_loader, this,
+                                     dex_files, thread_pool);
+  LabelPhase(timings, "Compile",
+             context.ForAllClassDefs(CompilerDriver::CompileClass, thread_count_));
 }
 
-void CompilerDriver::CompileClass(const ParallelCompilationManager* manager, size_t class_def_index) {
+void CompilerDriver::CompileClass(const ParallelCompilationManager* manager,
+                                  const DexFile& dex_file, size_t class_def_index) {
   ATRACE_CALL();
   jobject jclass_loader = manager->GetClassLoader();
-  const DexFile& dex_file = *manager->GetDexFile();
   const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
   ClassLinker* class_linker = manager->GetClassLinker();
   if (SkipClass(class_linker, jclass_loader, dex_file, class_def)) {
@@ -2291,15 +2616,6 @@ void CompilerDriver::CompileClass(const ParallelCompilationManager* manager, siz
   DCHECK(!it.HasNext());
 }
 
-void CompilerDriver::CompileDexFile(jobject class_loader, const DexFile& dex_file,
-                                    ThreadPool& thread_pool, base::TimingLogger& timings) {
-  // TODO: strdup memory leak.
-  timings.NewSplit(strdup(("Compile " + dex_file.GetLocation()).c_str()));
-  ParallelCompilationManager context(Runtime::Current()->GetClassLinker(), class_loader, this,
-                                     &dex_file, thread_pool);
-  context.ForAll(0, dex_file.NumClassDefs(), CompilerDriver::CompileClass, thread_count_);
-}
-
 void CompilerDriver::CompileMethod(const DexFile::CodeItem* code_item, uint32_t access_flags,
                                    InvokeType invoke_type, uint16_t class_def_idx,
                                    uint32_t method_idx, jobject class_loader,
@@ -2316,7 +2632,15 @@ void CompilerDriver::CompileMethod(const DexFile::CodeItem* code_item, uint32_t
     MethodReference method_ref(&dex_file, method_idx);
     bool compile = verifier::MethodVerifier::IsCandidateForCompilation(method_ref, access_flags);
 
-    if (compile) {
+    std::string cache_key;
+    if (compile && compiled_method_cache_.get() != NULL) {
+      cache_key = compiled_method_cache_->ComputeKey(dex_file, method_idx, code_item,
+                                                     access_flags, invoke_type, class_loader);
+      compiled_method = compiled_method_cache_->Lookup(*this, cache_key);
+    }
+
+    if (compile && compiled_method == NULL) {
+      uint64_t compile_start_ns = NanoTime();
       CompilerFn compiler = compiler_;
 #ifdef ART_SEA_IR_MODE
       bool use_sea = Runtime::Current()->IsSeaIRMode();
@@ -2330,7 +2654,11 @@ void CompilerDriver::CompileMethod(const DexFile::CodeItem* code_item, uint32_t
       // NOTE: if compiler declines to compile this method, it will return NULL.
       compiled_method = (*compiler)(*this, code_item, access_flags, invoke_type, class_def_idx,
                                     method_idx, class_loader, dex_file);
-    } else if (dex_to_dex_compilation_level != kDontDexToDexCompile) {
+      if (compiled_method != NULL && compiled_method_cache_.get() != NULL) {
+        compiled_method_cache_->Insert(cache_key, *compiled_method,
+                                       NanoTime() - compile_start_ns);
+      }
+    } else if (!compile && dex_to_dex_compilation_level != kDontDexToDexCompile) {
       // TODO: add a mode to disable DEX-to-DEX compilation ?
       (*dex_to_dex_compiler_)(*this, code_item, access_flags,
                               invoke_type, class_def_idx,
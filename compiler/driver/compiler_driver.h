@@ -39,6 +39,7 @@
 namespace art {
 
 class AOTCompilationStats;
+class CompiledMethodCache;
 class ParallelCompilationManager;
 class DexCompilationUnit;
 class OatWriter;
@@ -136,6 +137,8 @@ class CompilerDriver {
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
   const std::vector<uint8_t>* CreateQuickResolutionTrampoline() const
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  const std::vector<uint8_t>* CreateQuickImtConflictTrampoline() const
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
   const std::vector<uint8_t>* CreateQuickToInterpreterBridge() const
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
@@ -169,6 +172,14 @@ class CompilerDriver {
                                               uint32_t type_idx)
      LOCKS_EXCLUDED(Locks::mutator_lock_);
 
+  // Can an allocation of the type be left out when the object never escapes? Only if allocating
+  // needs no checks and initializes nothing, and the object has no finalizer.
+  bool CanElideAllocation(uint32_t referrer_idx, const DexFile& dex_file, uint32_t type_idx)
+     LOCKS_EXCLUDED(Locks::mutator_lock_);
+
+  // Records how many of a method's new-instances escape analysis removed.
+  void RecordEliminatedAllocations(size_t eliminated, size_t allocations);
+
   // Can we fast path instance field access? Computes field's offset and volatility.
   bool ComputeInstanceFieldInfo(uint32_t field_idx, const DexCompilationUnit* mUnit,
                                 int& field_offset, bool& is_volatile, bool is_put)
@@ -188,6 +199,21 @@ class CompilerDriver {
                          uintptr_t& direct_code, uintptr_t& direct_method, bool update_stats)
       LOCKS_EXCLUDED(Locks::mutator_lock_);
 
+  // Can a call to the method be replaced by its code? Finds the code of the method the call
+  // resolves to, unless it is native, abstract or synchronized or its code isn't in the referrer's
+  // dex file, and whether the method is within the referrer's class. Methods called directly on
+  // the strength of the class hierarchy stay calls, since a class loaded later may override them.
+  bool ComputeInlinableMethod(const DexCompilationUnit* mUnit, InvokeType invoke_type,
+                              uint32_t method_idx, const DexFile::CodeItem*& code_item,
+                              bool& is_referrers_class)
+      LOCKS_EXCLUDED(Locks::mutator_lock_);
+
+  // Can a call to the constructor be replaced by the field stores of its chain of constructors?
+  // Only if the object can't be finalizable, as Object.<init> registers finalizable objects, and
+  // the classes whose constructors run have no final fields, which need a barrier once stored.
+  bool CanInlineConstructor(const DexCompilationUnit* mUnit, uint32_t method_idx)
+      LOCKS_EXCLUDED(Locks::mutator_lock_);
+
   bool IsSafeCast(const MethodReference& mr, uint32_t dex_pc);
 
   // Record patch information for later fix up.
@@ -218,6 +244,24 @@ class CompilerDriver {
     support_boot_image_fixup_ = support_boot_image_fixup;
   }
 
+  // Is the code for an application a debugger may attach to, and so read and write the Dalvik
+  // registers of its frames through the vmap tables?
+  bool IsDebuggable() const {
+    return debuggable_;
+  }
+
+  void SetDebuggable(bool debuggable) {
+    debuggable_ = debuggable;
+  }
+
+  // Reuses code from and adds code to cache, which the driver takes ownership of. Only Quick
+  // compilation of applications can be cached.
+  void SetCompiledMethodCache(CompiledMethodCache* cache);
+
+  CompiledMethodCache* GetCompiledMethodCache() const {
+    return compiled_method_cache_.get();
+  }
+
   ArenaPool& GetArenaPool() {
     return arena_pool_;
   }
@@ -336,34 +380,37 @@ class CompilerDriver {
   // Attempt to resolve all type, methods, fields, and strings
   // referenced from code in the dex file following PathClassLoader
   // ordering semantics.
+  //
+  // Each phase runs the classes of all dex files through one queue of the thread pool.
   void Resolve(jobject class_loader, const std::vector<const DexFile*>& dex_files,
                ThreadPool& thread_pool, base::TimingLogger& timings)
       LOCKS_EXCLUDED(Locks::mutator_lock_);
-  void ResolveDexFile(jobject class_loader, const DexFile& dex_file,
-                      ThreadPool& thread_pool, base::TimingLogger& timings)
-      LOCKS_EXCLUDED(Locks::mutator_lock_);
 
   void Verify(jobject class_loader, const std::vector<const DexFile*>& dex_files,
-              ThreadPool& thread_pool, base::TimingLogger& timings);
-  void VerifyDexFile(jobject class_loader, const DexFile& dex_file,
-                     ThreadPool& thread_pool, base::TimingLogger& timings)
+              ThreadPool& thread_pool, base::TimingLogger& timings)
       LOCKS_EXCLUDED(Locks::mutator_lock_);
 
   void InitializeClasses(jobject class_loader, const std::vector<const DexFile*>& dex_files,
                          ThreadPool& thread_pool, base::TimingLogger& timings)
-      LOCKS_EXCLUDED(Locks::mutator_lock_);
-  void InitializeClasses(jobject class_loader, const DexFile& dex_file,
-                         ThreadPool& thread_pool, base::TimingLogger& timings)
       LOCKS_EXCLUDED(Locks::mutator_lock_, compiled_classes_lock_);
 
   void UpdateImageClasses(base::TimingLogger& timings);
+
+  // Class hierarchy analysis for the image: records the virtual methods overridden by a class
+  // loaded when compiling it.
+  void AnalyzeClassHierarchy(base::TimingLogger& timings)
+      LOCKS_EXCLUDED(Locks::mutator_lock_);
+  static bool RecordOverriddenMethods(mirror::Class* klass, void* arg)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  // Can calls of the virtual method be direct? Only for methods of image classes, so that the
+  // runtime finds their kAccSingleImplementation flag when a class overriding them is loaded.
+  bool HasSingleImplementation(mirror::ArtMethod* method)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
   static void FindClinitImageClassesCallback(mirror::Object* object, void* arg)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
   void Compile(jobject class_loader, const std::vector<const DexFile*>& dex_files,
-               ThreadPool& thread_pool, base::TimingLogger& timings);
-  void CompileDexFile(jobject class_loader, const DexFile& dex_file,
-                      ThreadPool& thread_pool, base::TimingLogger& timings)
+               ThreadPool& thread_pool, base::TimingLogger& timings)
       LOCKS_EXCLUDED(Locks::mutator_lock_);
   void CompileMethod(const DexFile::CodeItem* code_item, uint32_t access_flags,
                      InvokeType invoke_type, uint16_t class_def_idx, uint32_t method_idx,
@@ -371,7 +418,8 @@ class CompilerDriver {
                      DexToDexCompilationLevel dex_to_dex_compilation_level)
       LOCKS_EXCLUDED(compiled_methods_lock_);
 
-  static void CompileClass(const ParallelCompilationManager* context, size_t class_def_index)
+  static void CompileClass(const ParallelCompilationManager* context, const DexFile& dex_file,
+                           size_t class_def_index)
       LOCKS_EXCLUDED(Locks::mutator_lock_);
 
   std::vector<const PatchInformation*> code_to_patch_;
@@ -402,6 +450,11 @@ class CompilerDriver {
   // included in the image.
   UniquePtr<DescriptorSet> image_classes_;
 
+  // Virtual methods a class loaded when compiling the image overrides, found before compiling.
+  typedef std::set<MethodReference, MethodReferenceComparator> MethodSet;
+  MethodSet overridden_methods_;
+  bool class_hierarchy_analyzed_;
+
   size_t thread_count_;
   uint64_t start_ns_;
 
@@ -454,6 +507,10 @@ class CompilerDriver {
 
   bool support_boot_image_fixup_;
 
+  bool debuggable_;
+
+  UniquePtr<CompiledMethodCache> compiled_method_cache_;
+
   // DeDuplication data structures, these own the corresponding byte arrays.
   class DedupeHashFunc {
    public:
@@ -475,10 +532,13 @@ class CompilerDriver {
       return hash;
     }
   };
-  DedupeSet<std::vector<uint8_t>, size_t, DedupeHashFunc> dedupe_code_;
-  DedupeSet<std::vector<uint8_t>, size_t, DedupeHashFunc> dedupe_mapping_table_;
-  DedupeSet<std::vector<uint8_t>, size_t, DedupeHashFunc> dedupe_vmap_table_;
-  DedupeSet<std::vector<uint8_t>, size_t, DedupeHashFunc> dedupe_gc_map_;
+  // Every compiler thread adds to these, so they are sharded to keep their locks uncontended.
+  static const size_t kDedupeShards = 16;
+  typedef DedupeSet<std::vector<uint8_t>, size_t, DedupeHashFunc, kDedupeShards> DedupeByteArraySet;
+  DedupeByteArraySet dedupe_code_;
+  DedupeByteArraySet dedupe_mapping_table_;
+  DedupeByteArraySet dedupe_vmap_table_;
+  DedupeByteArraySet dedupe_gc_map_;
 
   DISALLOW_COPY_AND_ASSIGN(CompilerDriver);
 };
@@ -103,6 +103,8 @@ bool ImageWriter::Write(const std::string& image_filename,
 
   quick_resolution_trampoline_offset_ =
       oat_file_->GetOatHeader().GetQuickResolutionTrampolineOffset();
+  quick_imt_conflict_trampoline_offset_ =
+      oat_file_->GetOatHeader().GetQuickImtConflictTrampolineOffset();
   quick_to_interpreter_bridge_offset_ =
       oat_file_->GetOatHeader().GetQuickToInterpreterBridgeOffset();
   {
@@ -295,6 +297,8 @@ void ImageWriter::PruneNonImageClasses() {
 
 bool ImageWriter::NonImageClassesVisitor(Class* klass, void* arg) {
   NonImageClasses* context = reinterpret_cast<NonImageClasses*>(arg);
+  // Cached type check results could otherwise keep pruned classes alive.
+  klass->SetTypeCheckCache(NULL);
   if (!context->image_writer->IsImageClass(klass)) {
     context->non_image_classes->insert(ClassHelper(klass).GetDescriptor());
   }
@@ -387,6 +391,8 @@ ObjectArray<Object>* ImageWriter::CreateImageRoots() const {
                   ObjectArray<Object>::Alloc(self, object_array_class,
                                              ImageHeader::kImageRootsMax));
   image_roots->Set(ImageHeader::kResolutionMethod, runtime->GetResolutionMethod());
+  image_roots->Set(ImageHeader::kImtConflictMethod, runtime->GetImtConflictMethod());
+  image_roots->Set(ImageHeader::kDefaultImt, runtime->GetDefaultImt());
   image_roots->Set(ImageHeader::kCalleeSaveMethod,
                    runtime->GetCalleeSaveMethod(Runtime::kSaveAll));
   image_roots->Set(ImageHeader::kRefsOnlySaveMethod,
@@ -524,6 +530,9 @@ void ImageWriter::FixupMethod(const ArtMethod* orig, ArtMethod* copy) {
 #else
     copy->SetEntryPointFromCompiledCode(GetOatAddress(quick_resolution_trampoline_offset_));
 #endif
+  } else if (UNLIKELY(orig == Runtime::Current()->GetImtConflictMethod())) {
+    // Only quick code dispatches through the imt and can reach the imt conflict method.
+    copy->SetEntryPointFromCompiledCode(GetOatAddress(quick_imt_conflict_trampoline_offset_));
   } else {
     // We assume all methods have code. If they don't currently then we set them to the use the
     // resolution trampoline. Abstract methods never have code and so we need to make sure their
@@ -32,6 +32,7 @@
 #include "scoped_thread_state_change.h"
 #include "thread.h"
 #include "UniquePtr.h"
+#include "utils.h"
 
 extern "C" JNIEXPORT jint JNICALL Java_MyClassNatives_bar(JNIEnv*, jobject, jint count) {
   return count + 1;
@@ -774,4 +775,63 @@ TEST_F(JniCompilerTest, UpcallArgumentTypeChecking_Static) {
   check_jni_abort_catcher.Check("bad arguments passed to void MyClassNatives.staticMethodThatShouldTakeClass(int, java.lang.Class)");
 }
 
+jint Java_MyClassNatives_fooSII_native(JNIEnv*, jclass, jint x, jint y) {
+  EXPECT_EQ(kNative, Thread::Current()->GetState());
+  return x + y;
+}
+
+jint Java_MyClassNatives_fooSII_fast(JNIEnv*, jclass, jint x, jint y) {
+  // A fast native method runs Runnable, holding its share of the mutator lock.
+  EXPECT_EQ(kRunnable, Thread::Current()->GetState());
+  return x + y;
+}
+
+TEST_F(JniCompilerTest, FastNativeMethod) {
+  TEST_DISABLED_FOR_PORTABLE();
+  SetUpForTest(true, "fooSII", "(II)I",
+               reinterpret_cast<void*>(&Java_MyClassNatives_fooSII_native));
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::ArtMethod* method = soa.DecodeMethod(jmethod_);
+  EXPECT_FALSE(method->IsFastNative());
+  EXPECT_EQ(3, env_->CallStaticIntMethod(jklass_, jmethod_, 1, 2));
+
+  // A leading '!' on the signature registers a fast native method.
+  JNINativeMethod fast_methods[] = {
+      { "fooSII", "!(II)I", reinterpret_cast<void*>(&Java_MyClassNatives_fooSII_fast) } };
+  ASSERT_EQ(JNI_OK, env_->RegisterNatives(jklass_, fast_methods, 1));
+  EXPECT_TRUE(method->IsFastNative());
+  EXPECT_EQ(7, env_->CallStaticIntMethod(jklass_, jmethod_, 3, 4));
+  EXPECT_EQ(kRunnable, Thread::Current()->GetState());
+
+  // Registering it again without the '!' makes it a regular native method.
+  JNINativeMethod methods[] = {
+      { "fooSII", "(II)I", reinterpret_cast<void*>(&Java_MyClassNatives_fooSII_native) } };
+  ASSERT_EQ(JNI_OK, env_->RegisterNatives(jklass_, methods, 1));
+  EXPECT_FALSE(method->IsFastNative());
+  EXPECT_EQ(11, env_->CallStaticIntMethod(jklass_, jmethod_, 5, 6));
+}
+
+TEST_F(JniCompilerTest, DISABLED_FastNativeCallBenchmark) {
+  TEST_DISABLED_FOR_PORTABLE();
+  static const size_t kIterations = 100000;
+  SetUpForTest(true, "fooSII", "(II)I",
+               reinterpret_cast<void*>(&Java_MyClassNatives_fooSII_native));
+  uint64_t start = NanoTime();
+  for (size_t i = 0; i < kIterations; ++i) {
+    env_->CallStaticIntMethod(jklass_, jmethod_, 1, 2);
+  }
+  uint64_t native_ns = (NanoTime() - start) / kIterations;
+
+  JNINativeMethod fast_methods[] = {
+      { "fooSII", "!(II)I", reinterpret_cast<void*>(&Java_MyClassNatives_fooSII_fast) } };
+  ASSERT_EQ(JNI_OK, env_->RegisterNatives(jklass_, fast_methods, 1));
+  start = NanoTime();
+  for (size_t i = 0; i < kIterations; ++i) {
+    env_->CallStaticIntMethod(jklass_, jmethod_, 1, 2);
+  }
+  uint64_t fast_ns = (NanoTime() - start) / kIterations;
+
+  LOG(INFO) << "Static native call: regular " << native_ns << "ns, fast " << fast_ns << "ns";
+}
+
 }  // namespace art
@@ -171,7 +171,8 @@ CompiledMethod* ArtJniCompileMethodInternal(CompilerDriver& compiler,
   // 6. Call into appropriate JniMethodStart passing Thread* so that transition out of Runnable
   //    can occur. The result is the saved JNI local state that is restored by the exit call. We
   //    abuse the JNI calling convention here, that is guaranteed to support passing 2 pointer
-  //    arguments.
+  //    arguments. Methods are registered as fast natives after they are compiled, so it is
+  //    JniMethodStart that decides to stay Runnable for them.
   ThreadOffset jni_start = is_synchronized ? QUICK_ENTRYPOINT_OFFSET(pJniMethodStartSynchronized)
                                            : QUICK_ENTRYPOINT_OFFSET(pJniMethodStart);
   main_jni_conv->ResetIterator(FrameOffset(main_out_arg_size));
@@ -104,6 +104,7 @@ TEST_F(OatTest, WriteRead) {
   ASSERT_TRUE(oat_file.get() != NULL);
   const OatHeader& oat_header = oat_file->GetOatHeader();
   ASSERT_TRUE(oat_header.IsValid());
+  ASSERT_FALSE(oat_header.IsDebuggable());
   ASSERT_EQ(2U, oat_header.GetDexFileCount());  // core and conscrypt
   ASSERT_EQ(42U, oat_header.GetImageFileLocationOatChecksum());
   ASSERT_EQ(4096U, oat_header.GetImageFileLocationOatDataBegin());
@@ -143,7 +144,7 @@ TEST_F(OatTest, WriteRead) {
 TEST_F(OatTest, OatHeaderSizeCheck) {
   // If this test is failing and you have to update these constants,
   // it is time to update OatHeader::kOatVersion
-  EXPECT_EQ(64U, sizeof(OatHeader));
+  EXPECT_EQ(68U, sizeof(OatHeader));
   EXPECT_EQ(28U, sizeof(OatMethodOffsets));
 }
 
@@ -154,6 +155,7 @@ TEST_F(OatTest, OatHeaderIsValid) {
     uint32_t image_file_location_oat_begin = 0;
     const std::string image_file_location;
     OatHeader oat_header(instruction_set,
+                         false,
                          &dex_files,
                          image_file_location_oat_checksum,
                          image_file_location_oat_begin,
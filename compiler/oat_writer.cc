@@ -57,6 +57,7 @@ OatWriter::OatWriter(const std::vector<const DexFile*>& dex_files,
     size_portable_resolution_trampoline_(0),
     size_portable_to_interpreter_bridge_(0),
     size_quick_resolution_trampoline_(0),
+    size_quick_imt_conflict_trampoline_(0),
     size_quick_to_interpreter_bridge_(0),
     size_trampoline_alignment_(0),
     size_code_size_(0),
@@ -93,6 +94,7 @@ OatWriter::~OatWriter() {
 size_t OatWriter::InitOatHeader() {
   // create the OatHeader
   oat_header_ = new OatHeader(compiler_driver_->GetInstructionSet(),
+                              compiler_driver_->IsDebuggable(),
                               dex_files_,
                               image_file_location_oat_checksum_,
                               image_file_location_oat_begin_,
@@ -192,6 +194,7 @@ size_t OatWriter::InitOatCode(size_t offset) {
     DO_TRAMPOLINE(portable_resolution_trampoline_, PortableResolutionTrampoline);
     DO_TRAMPOLINE(portable_to_interpreter_bridge_, PortableToInterpreterBridge);
     DO_TRAMPOLINE(quick_resolution_trampoline_, QuickResolutionTrampoline);
+    DO_TRAMPOLINE(quick_imt_conflict_trampoline_, QuickImtConflictTrampoline);
     DO_TRAMPOLINE(quick_to_interpreter_bridge_, QuickToInterpreterBridge);
 
     #undef DO_TRAMPOLINE
@@ -202,6 +205,7 @@ size_t OatWriter::InitOatCode(size_t offset) {
     oat_header_->SetPortableResolutionTrampolineOffset(0);
     oat_header_->SetPortableToInterpreterBridgeOffset(0);
     oat_header_->SetQuickResolutionTrampolineOffset(0);
+    oat_header_->SetQuickImtConflictTrampolineOffset(0);
     oat_header_->SetQuickToInterpreterBridgeOffset(0);
   }
   return offset;
@@ -478,6 +482,7 @@ bool OatWriter::Write(OutputStream& out) {
     DO_STAT(size_portable_resolution_trampoline_);
     DO_STAT(size_portable_to_interpreter_bridge_);
     DO_STAT(size_quick_resolution_trampoline_);
+    DO_STAT(size_quick_imt_conflict_trampoline_);
     DO_STAT(size_quick_to_interpreter_bridge_);
     DO_STAT(size_trampoline_alignment_);
     DO_STAT(size_code_size_);
@@ -573,6 +578,7 @@ size_t OatWriter::WriteCode(OutputStream& out, const size_t file_offset) {
     DO_TRAMPOLINE(portable_resolution_trampoline_);
     DO_TRAMPOLINE(portable_to_interpreter_bridge_);
     DO_TRAMPOLINE(quick_resolution_trampoline_);
+    DO_TRAMPOLINE(quick_imt_conflict_trampoline_);
     DO_TRAMPOLINE(quick_to_interpreter_bridge_);
     #undef DO_TRAMPOLINE
   }
@@ -17,15 +17,23 @@
 #ifndef ART_COMPILER_UTILS_DEDUPE_SET_H_
 #define ART_COMPILER_UTILS_DEDUPE_SET_H_
 
+#include <ostream>
 #include <set>
+#include <string>
 
 #include "base/mutex.h"
 #include "base/stl_util.h"
+#include "base/stringprintf.h"
+#include "utils.h"
+#include "UniquePtr.h"
 
 namespace art {
 
 // A simple data structure to handle hashed deduplication. Add is thread safe.
-template <typename Key, typename HashType, typename HashFunc>
+//
+// Keys are spread over kShard shards by hash, each with its own lock, so that threads adding
+// different keys rarely wait for each other. Keys are hashed before taking any lock.
+template <typename Key, typename HashType, typename HashFunc, HashType kShard = 1>
 class DedupeSet {
   typedef std::pair<HashType, Key*> HashedKey;
 
@@ -33,7 +41,7 @@ class DedupeSet {
    public:
     bool operator()(const HashedKey& a, const HashedKey& b) const {
       if (a.first < b.first) return true;
-      if (a.first > b.first) return true;
+      if (a.first > b.first) return false;
       return *a.second < *b.second;
     }
   };
@@ -41,39 +49,101 @@ class DedupeSet {
   typedef std::set<HashedKey, Comparator> Keys;
 
  public:
-  typedef typename Keys::iterator iterator;
-  typedef typename Keys::const_iterator const_iterator;
-  typedef typename Keys::size_type size_type;
-  typedef typename Keys::value_type value_type;
+  explicit DedupeSet(const char* set_name) : name_(set_name) {
+    for (HashType i = 0; i < kShard; ++i) {
+      lock_names_[i] = StringPrintf("%s lock %d", set_name, static_cast<int>(i));
+      shards_[i].lock.reset(new Mutex(lock_names_[i].c_str()));
+      shards_[i].adds = 0;
+      shards_[i].contended_adds = 0;
+      shards_[i].wait_ns = 0;
+    }
+  }
 
-  iterator begin() { return keys_.begin(); }
-  const_iterator begin() const { return keys_.begin(); }
-  iterator end() { return keys_.end(); }
-  const_iterator end() const { return keys_.end(); }
+  ~DedupeSet() {
+    for (HashType i = 0; i < kShard; ++i) {
+      STLDeleteValues(&shards_[i].keys);
+    }
+  }
 
   Key* Add(Thread* self, const Key& key) {
-    HashType hash = HashFunc()(key);
-    HashedKey hashed_key(hash, const_cast<Key*>(&key));
-    MutexLock lock(self, lock_);
-    auto it = keys_.find(hashed_key);
-    if (it != keys_.end()) {
-      return it->second;
+    HashType raw_hash = HashFunc()(key);
+    HashType shard_hash = raw_hash / kShard;
+    HashType shard_bin = raw_hash % kShard;
+    HashedKey hashed_key(shard_hash, const_cast<Key*>(&key));
+    Shard& shard = shards_[shard_bin];
+    uint64_t wait_start_ns = 0;
+    if (!shard.lock->ExclusiveTryLock(self)) {
+      wait_start_ns = NanoTime();
+      shard.lock->ExclusiveLock(self);
+    }
+    ++shard.adds;
+    if (wait_start_ns != 0) {
+      ++shard.contended_adds;
+      shard.wait_ns += NanoTime() - wait_start_ns;
+    }
+    Key* result;
+    typename Keys::iterator it = shard.keys.find(hashed_key);
+    if (it != shard.keys.end()) {
+      result = it->second;
+    } else {
+      result = new Key(key);
+      hashed_key.second = result;
+      shard.keys.insert(hashed_key);
+    }
+    shard.lock->ExclusiveUnlock(self);
+    return result;
+  }
+
+  size_t Size(Thread* self) const {
+    size_t size = 0;
+    for (HashType i = 0; i < kShard; ++i) {
+      MutexLock lock(self, *shards_[i].lock);
+      size += shards_[i].keys.size();
     }
-    hashed_key.second = new Key(key);
-    keys_.insert(hashed_key);
-    return hashed_key.second;
+    return size;
   }
 
-  DedupeSet() : lock_("dedupe lock") {
+  // Returns the total time threads waited for the locks of the shards.
+  uint64_t GetWaitNs(Thread* self) const {
+    uint64_t wait_ns = 0;
+    for (HashType i = 0; i < kShard; ++i) {
+      MutexLock lock(self, *shards_[i].lock);
+      wait_ns += shards_[i].wait_ns;
+    }
+    return wait_ns;
   }
 
-  ~DedupeSet() {
-    STLDeleteValues(&keys_);
+  // Reports how many adds found their shard's lock held and how long they waited for it.
+  void DumpStats(Thread* self, std::ostream& os) const {
+    uint64_t adds = 0;
+    uint64_t contended_adds = 0;
+    uint64_t wait_ns = 0;
+    size_t size = 0;
+    for (HashType i = 0; i < kShard; ++i) {
+      MutexLock lock(self, *shards_[i].lock);
+      adds += shards_[i].adds;
+      contended_adds += shards_[i].contended_adds;
+      wait_ns += shards_[i].wait_ns;
+      size += shards_[i].keys.size();
+    }
+    os << name_ << ": " << size << " unique of " << adds << " added, " << contended_adds
+       << " waited " << PrettyDuration(wait_ns) << " for " << kShard << " shard locks\n";
   }
 
  private:
-  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
-  Keys keys_;
+  struct Shard {
+    UniquePtr<Mutex> lock;
+    Keys keys;
+    // Statistics, guarded by lock.
+    uint64_t adds;
+    uint64_t contended_adds;
+    uint64_t wait_ns;
+  };
+
+  const std::string name_;
+  std::string lock_names_[kShard];
+  Shard shards_[kShard];
+
   DISALLOW_COPY_AND_ASSIGN(DedupeSet);
 };
 
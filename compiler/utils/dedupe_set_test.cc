@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <pthread.h>
+
 #include "common_test.h"
 #include "dedupe_set.h"
 
@@ -35,10 +37,47 @@ class DedupeHashFunc {
     return hash;
   }
 };
+
+typedef std::vector<uint8_t> ByteArray;
+
+// Adds arrays that differ in their last bytes from many threads at once, and returns how long the
+// threads waited for the locks of set.
+template <size_t kShard>
+static uint64_t TimeContendedAdds() {
+  static const size_t kThreads = 4;
+  static const size_t kAddsPerThread = 20000;
+  typedef DedupeSet<ByteArray, size_t, DedupeHashFunc, kShard> Set;
+
+  class Adder {
+   public:
+    static void* Run(void* arg) {
+      Set* set = reinterpret_cast<Set*>(arg);
+      ByteArray array(16, 0);
+      for (size_t i = 0; i < kAddsPerThread; ++i) {
+        array[14] = i >> 8;
+        array[15] = i;
+        CHECK(set->Add(NULL, array) != NULL);
+      }
+      return NULL;
+    }
+  };
+
+  Set set("benchmark");
+  pthread_t threads[kThreads];
+  for (size_t i = 0; i < kThreads; ++i) {
+    CHECK_PTHREAD_CALL(pthread_create, (&threads[i], NULL, &Adder::Run, &set), "adder");
+  }
+  for (size_t i = 0; i < kThreads; ++i) {
+    CHECK_PTHREAD_CALL(pthread_join, (threads[i], NULL), "adder");
+  }
+  // Every thread added the same arrays.
+  CHECK_EQ(kAddsPerThread, set.Size(NULL));
+  return set.GetWaitNs(NULL);
+}
+
 TEST_F(DedupeSetTest, Test) {
   Thread* self = Thread::Current();
-  typedef std::vector<uint8_t> ByteArray;
-  DedupeSet<ByteArray, size_t, DedupeHashFunc> deduplicator;
+  DedupeSet<ByteArray, size_t, DedupeHashFunc> deduplicator("test");
   ByteArray* array1;
   {
     ByteArray test1;
@@ -73,6 +112,33 @@ TEST_F(DedupeSetTest, Test) {
     ASSERT_NE(array3, &test1);
     ASSERT_EQ(test1, *array3);
   }
+  ASSERT_EQ(2U, deduplicator.Size(self));
+}
+
+TEST_F(DedupeSetTest, Shards) {
+  Thread* self = Thread::Current();
+  DedupeSet<ByteArray, size_t, DedupeHashFunc, 7> deduplicator("test");
+  std::vector<ByteArray*> added;
+  for (size_t i = 0; i < 100; ++i) {
+    ByteArray array(3, 0);
+    array[0] = i;
+    added.push_back(deduplicator.Add(self, array));
+    ASSERT_EQ(array, *added.back());
+  }
+  EXPECT_EQ(100U, deduplicator.Size(self));
+  for (size_t i = 0; i < 100; ++i) {
+    ByteArray array(3, 0);
+    array[0] = i;
+    EXPECT_EQ(added[i], deduplicator.Add(self, array));
+  }
+  EXPECT_EQ(100U, deduplicator.Size(self));
+}
+
+TEST_F(DedupeSetTest, DISABLED_ContentionBenchmark) {
+  uint64_t single_lock_wait_ns = TimeContendedAdds<1>();
+  uint64_t sharded_wait_ns = TimeContendedAdds<16>();
+  LOG(INFO) << "Dedupe lock wait: single lock " << PrettyDuration(single_lock_wait_ns)
+            << ", 16 shards " << PrettyDuration(sharded_wait_ns);
 }
 
 }  // namespace art
@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <valgrind.h>
 
 #include <fstream>
@@ -31,6 +32,7 @@
 #include "base/unix_file/fd_file.h"
 #include "class_linker.h"
 #include "dex_file-inl.h"
+#include "driver/compiled_method_cache.h"
 #include "driver/compiler_driver.h"
 #include "elf_fixup.h"
 #include "elf_stripper.h"
@@ -140,6 +142,16 @@ static void Usage(const char* fmt, ...) {
   UsageError("");
   UsageError("  --dump-timing: display a breakdown of where time was spent");
   UsageError("");
+  UsageError("  --dump-stats: display compilation statistics, including how long compiler");
+  UsageError("      threads waited for each other to deduplicate compiled code.");
+  UsageError("");
+  UsageError("  --compiled-method-cache=<directory>: reuses the code earlier runs compiled for");
+  UsageError("      unchanged methods, caching it in an existing directory. Ignored for images.");
+  UsageError("      Example: --compiled-method-cache=/data/local/tmp/cmc");
+  UsageError("");
+  UsageError("  --debuggable: compile for an application a debugger may attach to, keeping");
+  UsageError("      every Dalvik register the debugger may read or write in its own location.");
+  UsageError("");
   UsageError("  --runtime-arg <argument>: used to specify various arguments for the runtime,");
   UsageError("      such as initial heap size, maximum heap size, and verbose output.");
   UsageError("      Use a separate --runtime-arg switch for each argument.");
@@ -230,9 +242,11 @@ class Dex2Oat {
                                       const std::vector<const DexFile*>& dex_files,
                                       File* oat_file,
                                       const std::string& bitcode_filename,
+                                      const std::string& compiled_method_cache_directory,
                                       bool image,
                                       UniquePtr<CompilerDriver::DescriptorSet>& image_classes,
                                       bool dump_stats,
+                                      bool debuggable,
                                       base::TimingLogger& timings) {
     // SirtRef and ClassLoader creation needs to come after Runtime::Create
     jobject class_loader = NULL;
@@ -263,6 +277,22 @@ class Dex2Oat {
       driver->SetBitcodeFileName(bitcode_filename);
     }
 
+    driver->SetDebuggable(debuggable);
+
+    if (!compiled_method_cache_directory.empty()) {
+      if (compiler_backend_ != kQuick || image) {
+        LOG(WARNING) << "Ignoring --compiled-method-cache, which only applies to applications "
+                     << "compiled with the Quick backend";
+      } else if (access(compiled_method_cache_directory.c_str(), R_OK | W_OK | X_OK) != 0) {
+        // Check once here rather than failing to write every method's entry.
+        PLOG(WARNING) << "Ignoring --compiled-method-cache, unable to use directory "
+                      << compiled_method_cache_directory;
+      } else {
+        driver->SetCompiledMethodCache(new CompiledMethodCache(compiled_method_cache_directory,
+                                                               instruction_set_, debuggable));
+      }
+    }
+
     driver->CompileAll(class_loader, dex_files, timings);
 
     timings.NewSplit("dex2oat OatWriter");
@@ -585,6 +615,7 @@ static int dex2oat(int argc, char** argv) {
   std::string oat_location;
   int oat_fd = -1;
   std::string bitcode_filename;
+  std::string compiled_method_cache_directory;
   const char* image_classes_zip_filename = NULL;
   const char* image_classes_filename = NULL;
   std::string image_filename;
@@ -610,6 +641,7 @@ static int dex2oat(int argc, char** argv) {
 #endif
   bool is_host = false;
   bool dump_stats = kIsDebugBuild;
+  bool debuggable = false;
   bool dump_timing = false;
   bool dump_slow_timing = kIsDebugBuild;
   bool watch_dog_enabled = !kIsTargetBuild;
@@ -701,6 +733,13 @@ static int dex2oat(int argc, char** argv) {
       runtime_args.push_back(argv[i]);
     } else if (option == "--dump-timing") {
       dump_timing = true;
+    } else if (option == "--dump-stats") {
+      dump_stats = true;
+    } else if (option.starts_with("--compiled-method-cache=")) {
+      compiled_method_cache_directory =
+          option.substr(strlen("--compiled-method-cache=")).data();
+    } else if (option == "--debuggable") {
+      debuggable = true;
     } else {
       Usage("Unknown argument %s", option.data());
     }
@@ -958,9 +997,11 @@ static int dex2oat(int argc, char** argv) {
                                                                   dex_files,
                                                                   oat_file.get(),
                                                                   bitcode_filename,
+                                                                  compiled_method_cache_directory,
                                                                   image,
                                                                   image_classes,
                                                                   dump_stats,
+                                                                  debuggable,
                                                                   timings));
 
   if (compiler.get() == NULL) {
@@ -63,7 +63,11 @@ LIBART_COMMON_SRC_FILES := \
 	indirect_reference_table.cc \
 	instrumentation.cc \
 	intern_table.cc \
+	interpreter/inline_cache.cc \
 	interpreter/interpreter.cc \
+	interpreter/interpreter_common.cc \
+	interpreter/interpreter_goto_table_impl.cc \
+	interpreter/interpreter_switch_impl.cc \
 	jdwp/jdwp_event.cc \
 	jdwp/jdwp_expand_buf.cc \
 	jdwp/jdwp_handler.cc \
@@ -240,6 +244,7 @@ LIBART_ENUM_OPERATOR_OUT_HEADER_FILES := \
 	gc/heap.h \
 	indirect_reference_table.h \
 	instruction_set.h \
+	interpreter/interpreter.h \
 	invoke_type.h \
 	jdwp/jdwp.h \
 	jdwp/jdwp_constants.h \
@@ -253,6 +258,9 @@ LIBART_CFLAGS :=
 ifeq ($(ART_USE_PORTABLE_COMPILER),true)
   LIBART_CFLAGS += -DART_USE_PORTABLE_COMPILER=1
 endif
+ifeq ($(ART_USE_SWITCH_INTERPRETER),true)
+  LIBART_CFLAGS += -DART_USE_SWITCH_INTERPRETER=1
+endif
 
 # $(1): target or host
 # $(2): ndebug or debug
@@ -30,4 +30,22 @@
 // Offset of field Method::entry_point_from_compiled_code_
 #define METHOD_CODE_OFFSET 40
 
+// Offset of field Method::dex_cache_resolved_methods_
+#define METHOD_DEX_CACHE_METHODS_OFFSET 16
+
+// Offset of field Method::method_index_
+#define METHOD_INDEX_OFFSET 68
+
+// Offset of field Method::native_method_
+#define METHOD_NATIVE_METHOD_OFFSET 72
+
+// Offset of field Object::klass_
+#define OBJECT_CLASS_OFFSET 0
+
+// Offset of field Class::vtable_
+#define CLASS_VTABLE_OFFSET 60
+
+// Offset of the data within an ObjectArray.
+#define OBJECT_ARRAY_DATA_OFFSET 12
+
 #endif  // ART_RUNTIME_ASM_SUPPORT_H_
@@ -19,6 +19,8 @@
 
 #include "mutex.h"
 
+#include <algorithm>
+
 #define ATRACE_TAG ATRACE_TAG_DALVIK
 
 #include "cutils/atomic-inline.h"
@@ -76,6 +78,65 @@ static inline uint64_t SafeGetTid(const Thread* self) {
   }
 }
 
+// Spins on a contended mutex before the contender blocks in the kernel. Pauses back off
+// exponentially and their total is bounded by the spin limit of the mutex, which grows when
+// spinning acquires the mutex and shrinks when the contender has to block anyway. Spinning stops
+// early once other contenders are asleep, a sign that the owner holds the mutex for longer than a
+// spin or has been descheduled.
+class AdaptiveSpin {
+ public:
+  AdaptiveSpin(BaseMutex* mutex, const Thread* self)
+      : mutex_(mutex), self_(self), limit_(mutex->spin_limit_), spins_(0), backoff_(1),
+        blocked_(false), owner_tid_(0), start_nano_time_(0) {
+  }
+
+  ~AdaptiveSpin() {
+    if (spins_ != 0) {
+      mutex_->AdaptSpinLimit(limit_, !blocked_);
+      if (kLogLockContentions && !blocked_) {
+        mutex_->RecordSpinAcquisition(SafeGetTid(self_), owner_tid_,
+                                      NanoTime() - start_nano_time_);
+      }
+    }
+  }
+
+  // Returns true if the contender should pause and retry rather than block, given the number of
+  // contenders already blocked.
+  bool ShouldSpin(int32_t num_sleepers) {
+    if (spins_ < limit_ && num_sleepers == 0) {
+      return true;
+    }
+    blocked_ = true;
+    return false;
+  }
+
+  void Pause(uint64_t owner_tid) {
+    if (kLogLockContentions && spins_ == 0) {
+      owner_tid_ = owner_tid;
+      start_nano_time_ = NanoTime();
+    }
+    for (uint32_t i = 0; i < backoff_; ++i) {
+      SpinPause();
+    }
+    spins_ += backoff_;
+    backoff_ = std::min(backoff_ * 2, kMaxBackoff);
+  }
+
+ private:
+  static const uint32_t kMaxBackoff = 64;
+
+  BaseMutex* const mutex_;
+  const Thread* const self_;
+  const uint32_t limit_;
+  uint32_t spins_;
+  uint32_t backoff_;
+  bool blocked_;
+  uint64_t owner_tid_;
+  uint64_t start_nano_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(AdaptiveSpin);
+};
+
 static inline void CheckUnattachedThread(LockLevel level) NO_THREAD_SAFETY_ANALYSIS {
   // The check below enumerates the cases where we expect not to be able to sanity check locks
   // on a thread. Lock checking is disabled to avoid deadlock when checking shutdown lock.
@@ -135,11 +196,15 @@ inline void ReaderWriterMutex::SharedLock(Thread* self) {
   DCHECK(self == NULL || self == Thread::Current());
 #if ART_USE_FUTEXES
   bool done = false;
+  AdaptiveSpin spin(this, self);
   do {
     int32_t cur_state = state_;
     if (LIKELY(cur_state >= 0)) {
       // Add as an extra reader.
       done = android_atomic_acquire_cas(cur_state, cur_state + 1, &state_) == 0;
+    } else if (spin.ShouldSpin(num_pending_readers_ + num_pending_writers_)) {
+      // Owner holds it exclusively, give it a chance to release it.
+      spin.Pause(GetExclusiveOwnerTid());
     } else {
       // Owner holds it exclusively, hang up.
       ScopedContentionRecorder scr(this, GetExclusiveOwnerTid(), SafeGetTid(self));
@@ -185,6 +250,18 @@ inline void ReaderWriterMutex::SharedUnlock(Thread* self) {
 #endif
 }
 
+inline void ReaderWriterMutex::TransitionFromSuspendedToRunnable(Thread* self) {
+  DCHECK_EQ(this, Locks::mutator_lock_);
+  RegisterAsLocked(self);
+  AssertSharedHeld(self);
+}
+
+inline void ReaderWriterMutex::TransitionFromRunnableToSuspended(Thread* self) {
+  DCHECK_EQ(this, Locks::mutator_lock_);
+  AssertSharedHeld(self);
+  RegisterAsUnlocked(self);
+}
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_BASE_MUTEX_INL_H_
@@ -18,6 +18,9 @@
 
 #include <errno.h>
 #include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
 
 #include "atomic.h"
 #include "base/logging.h"
@@ -120,7 +123,62 @@ class ScopedAllMutexesLock {
   const BaseMutex* const mutex_;
 };
 
-BaseMutex::BaseMutex(const char* name, LockLevel level) : level_(level), name_(name) {
+// Contention of all the mutexes of one lock level, dumpable via SIGQUIT.
+struct LevelContentionData {
+  // Number of times mutexes of the level have been contended.
+  AtomicInteger contention_count;
+  // Number of contended acquisitions that spinning completed without blocking.
+  AtomicInteger spin_acquisition_count;
+  // Sum of time waited by all contenders in ns.
+  volatile uint64_t wait_time;
+  LevelContentionData() : wait_time(0) {}
+};
+static struct LevelContentionData level_contention_data[kLevelContentionDataSize];
+
+// Atomically adds value to *addr.
+static void AtomicAddToWaitTime(volatile uint64_t* addr, uint64_t value) {
+  uint64_t new_val, old_val;
+  volatile int64_t* iaddr = reinterpret_cast<volatile int64_t*>(addr);
+  volatile const int64_t* caddr = const_cast<volatile const int64_t*>(iaddr);
+  do {
+    old_val = static_cast<uint64_t>(QuasiAtomic::Read64(caddr));
+    new_val = old_val + value;
+  } while (!QuasiAtomic::Cas64(static_cast<int64_t>(old_val), static_cast<int64_t>(new_val), iaddr));
+}
+
+// Bounds of the spin limit of mutexes of a level. Locks guarding short critical sections, such as
+// the thread list, class table, intern table and dex cache locks, are worth spinning on for
+// longer. Monitors spin themselves, and the mutator lock is held exclusively for whole pauses so
+// spinning on it only burns CPU.
+static const uint32_t kMinSpins = 16;
+static uint32_t MaxSpins(LockLevel level) {
+  switch (level) {
+    case kThreadSuspendCountLock:
+    case kAllocSpaceLock:
+    case kDefaultMutexLevel:
+    case kClassLinkerClassesLock:
+    case kThreadListLock:
+      return 4096;
+    case kMonitorLock:
+    case kMutatorLock:
+    case kZygoteCreationLock:
+      return 0;
+    default:
+      return 512;
+  }
+}
+
+// Spinning can't help when the owner needs our processor to release the mutex.
+static uint32_t InitialSpinLimit(LockLevel level) {
+  static int num_processors = 0;
+  if (num_processors == 0) {
+    num_processors = sysconf(_SC_NPROCESSORS_CONF);
+  }
+  return (num_processors > 1) ? MaxSpins(level) / 4 : 0;
+}
+
+BaseMutex::BaseMutex(const char* name, LockLevel level)
+    : level_(level), name_(name), spin_limit_(InitialSpinLimit(level)) {
   if (kLogLockContentions) {
     ScopedAllMutexesLock mu(this);
     std::set<BaseMutex*>** all_mutexes_ptr = &all_mutex_data->all_mutexes;
@@ -166,6 +224,7 @@ void BaseMutex::DumpAll(std::ostream& os) {
         os << "\n";
       }
     }
+    DumpLevelContention(os);
   }
 }
 
@@ -194,14 +253,41 @@ void BaseMutex::CheckSafeToWait(Thread* self) {
 
 inline void BaseMutex::ContentionLogData::AddToWaitTime(uint64_t value) {
   if (kLogLockContentions) {
-    // Atomically add value to wait_time.
-    uint64_t new_val, old_val;
-    volatile int64_t* addr = reinterpret_cast<volatile int64_t*>(&wait_time);
-    volatile const int64_t* caddr = const_cast<volatile const int64_t*>(addr);
-    do {
-      old_val = static_cast<uint64_t>(QuasiAtomic::Read64(caddr));
-      new_val = old_val + value;
-    } while (!QuasiAtomic::Cas64(static_cast<int64_t>(old_val), static_cast<int64_t>(new_val), addr));
+    AtomicAddToWaitTime(&wait_time, value);
+  }
+}
+
+void BaseMutex::AdaptSpinLimit(uint32_t limit, bool acquired_by_spinning) {
+  uint32_t max_spins = MaxSpins(level_);
+  if (acquired_by_spinning) {
+    // The mutex was held briefly; spin for longer next time.
+    spin_limit_ = std::min(limit * 2, max_spins);
+  } else {
+    spin_limit_ = std::max(limit / 2, std::min(kMinSpins, max_spins));
+  }
+}
+
+void BaseMutex::RecordSpinAcquisition(uint64_t blocked_tid, uint64_t owner_tid,
+                                      uint64_t nano_time_spun) {
+  if (kLogLockContentions) {
+    ++level_contention_data[level_].spin_acquisition_count;
+    RecordContention(blocked_tid, owner_tid, nano_time_spun);
+  }
+}
+
+void BaseMutex::DumpLevelContention(std::ostream& os) {
+  if (kLogLockContentions) {
+    os << "(Contention by lock level)\n";
+    for (int i = 0; i < kLockLevelCount; ++i) {
+      const LevelContentionData& data = level_contention_data[i];
+      uint32_t contention_count = data.contention_count;
+      if (contention_count != 0) {
+        uint32_t spin_acquisition_count = data.spin_acquisition_count;
+        os << LockLevel(i) << ": contended " << contention_count << " times, "
+           << spin_acquisition_count << " acquired by spinning, total wait "
+           << PrettyDuration(data.wait_time) << "\n";
+      }
+    }
   }
 }
 
@@ -212,6 +298,9 @@ void BaseMutex::RecordContention(uint64_t blocked_tid,
     ContentionLogData* data = contetion_log_data_;
     ++(data->contention_count);
     data->AddToWaitTime(nano_time_blocked);
+    LevelContentionData* level_data = &level_contention_data[level_];
+    ++(level_data->contention_count);
+    AtomicAddToWaitTime(&level_data->wait_time, nano_time_blocked);
     ContentionLogEntry* log = data->contention_log;
     // This code is intentionally racy as it is only used for diagnostics.
     uint32_t slot = data->cur_content_log_entry;
@@ -344,11 +433,15 @@ void Mutex::ExclusiveLock(Thread* self) {
   if (!recursive_ || !IsExclusiveHeld(self)) {
 #if ART_USE_FUTEXES
     bool done = false;
+    AdaptiveSpin spin(this, self);
     do {
       int32_t cur_state = state_;
       if (cur_state == 0) {
         // Change state from 0 to 1.
         done = android_atomic_acquire_cas(0, 1, &state_) == 0;
+      } else if (spin.ShouldSpin(num_contenders_)) {
+        // Failed to acquire, give the owner a chance to release it.
+        spin.Pause(GetExclusiveOwnerTid());
       } else {
         // Failed to acquire, hang up.
         ScopedContentionRecorder scr(this, SafeGetTid(self), GetExclusiveOwnerTid());
@@ -547,11 +640,15 @@ void ReaderWriterMutex::ExclusiveLock(Thread* self) {
   AssertNotExclusiveHeld(self);
 #if ART_USE_FUTEXES
   bool done = false;
+  AdaptiveSpin spin(this, self);
   do {
     int32_t cur_state = state_;
     if (cur_state == 0) {
       // Change state from 0 to -1.
       done = android_atomic_acquire_cas(0, -1, &state_) == 0;
+    } else if (spin.ShouldSpin(num_pending_readers_ + num_pending_writers_)) {
+      // Failed to acquire, give the owner or readers a chance to release it.
+      spin.Pause(GetExclusiveOwnerTid());
     } else {
       // Failed to acquire, hang up.
       ScopedContentionRecorder scr(this, SafeGetTid(self), GetExclusiveOwnerTid());
@@ -61,6 +61,18 @@ const bool kLogLockContentions = false;
 const size_t kContentionLogSize = 64;
 const size_t kContentionLogDataSize = kLogLockContentions ? 1 : 0;
 const size_t kAllMutexDataSize = kLogLockContentions ? 1 : 0;
+const size_t kLevelContentionDataSize = kLogLockContentions ? kLockLevelCount : 0;
+
+// Tells the processor that we are in a spin-wait loop.
+static inline void SpinPause() {
+#if defined(__i386__) || defined(__x86_64__)
+  __asm__ __volatile__("pause" : : : "memory");
+#elif defined(__ARM_ARCH_7A__)
+  __asm__ __volatile__("yield" : : : "memory");
+#else
+  __asm__ __volatile__("" : : : "memory");
+#endif
+}
 
 // Base class for all Mutex implementations
 class BaseMutex {
@@ -85,14 +97,24 @@ class BaseMutex {
   void RegisterAsUnlocked(Thread* self);
   void CheckSafeToWait(Thread* self);
 
+  friend class AdaptiveSpin;
   friend class ScopedContentionRecorder;
 
   void RecordContention(uint64_t blocked_tid, uint64_t owner_tid, uint64_t nano_time_blocked);
+  void RecordSpinAcquisition(uint64_t blocked_tid, uint64_t owner_tid, uint64_t nano_time_spun);
   void DumpContention(std::ostream& os) const;
+  static void DumpLevelContention(std::ostream& os);
+
+  // Grows the spin limit after a contender acquired the mutex by spinning from a limit of limit,
+  // shrinks it after a contender had to block anyway.
+  void AdaptSpinLimit(uint32_t limit, bool acquired_by_spinning);
 
   const LockLevel level_;  // Support for lock hierarchy.
   const char* const name_;
 
+  // How many times a contender pauses before blocking in the kernel, see AdaptiveSpin.
+  volatile uint32_t spin_limit_;
+
   // A log entry that records contention but makes no guarantee that either tid will be held live.
   struct ContentionLogEntry {
     ContentionLogEntry() : blocked_tid(0), owner_tid(0) {}
@@ -251,6 +273,12 @@ class LOCKABLE ReaderWriterMutex : public BaseMutex {
   void SharedUnlock(Thread* self) UNLOCK_FUNCTION() ALWAYS_INLINE;
   void ReaderUnlock(Thread* self) UNLOCK_FUNCTION() { SharedUnlock(self); }
 
+  // Record a share of the mutator_lock_ implied by a thread entering or leaving the Runnable state.
+  // Runnable threads don't touch the lock word, so an exclusive owner must first wait for all
+  // other threads to leave Runnable, see ThreadList::SuspendAll.
+  void TransitionFromSuspendedToRunnable(Thread* self) SHARED_LOCK_FUNCTION() ALWAYS_INLINE;
+  void TransitionFromRunnableToSuspended(Thread* self) UNLOCK_FUNCTION() ALWAYS_INLINE;
+
   // Is the current thread the exclusive holder of the ReaderWriterMutex.
   bool IsExclusiveHeld(const Thread* self) const;
 
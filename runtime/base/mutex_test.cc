@@ -17,6 +17,7 @@
 #include "mutex.h"
 
 #include "common_test.h"
+#include "utils.h"
 
 namespace art {
 
@@ -170,4 +171,70 @@ TEST_F(MutexTest, SharedTryLockUnlock) {
   SharedTryLockUnlockTest();
 }
 
+// Threads repeatedly taking a mutex for a very short critical section, which is what spinning
+// before blocking is for.
+static const size_t kContendingThreads = 4;
+
+struct ContendedCounter {
+  explicit ContendedCounter(size_t iterations)
+      : mu("test mutex"), rw_mu("test rwmutex"), iterations(iterations), count(0) {}
+
+  static void* MutexCallback(void* arg) NO_THREAD_SAFETY_ANALYSIS {
+    ContendedCounter* state = reinterpret_cast<ContendedCounter*>(arg);
+    for (size_t i = 0; i < state->iterations; ++i) {
+      state->mu.Lock(NULL);
+      ++state->count;
+      state->mu.Unlock(NULL);
+    }
+    return NULL;
+  }
+
+  static void* ReaderWriterMutexCallback(void* arg) NO_THREAD_SAFETY_ANALYSIS {
+    ContendedCounter* state = reinterpret_cast<ContendedCounter*>(arg);
+    for (size_t i = 0; i < state->iterations; ++i) {
+      state->rw_mu.ExclusiveLock(NULL);
+      ++state->count;
+      state->rw_mu.ExclusiveUnlock(NULL);
+    }
+    return NULL;
+  }
+
+  // Runs callback on kContendingThreads threads, returning the elapsed time in nanoseconds.
+  uint64_t Run(void* (*callback)(void*)) {
+    pthread_t pthreads[kContendingThreads];
+    uint64_t start = NanoTime();
+    for (size_t i = 0; i < kContendingThreads; ++i) {
+      CHECK_EQ(0, pthread_create(&pthreads[i], NULL, callback, this));
+    }
+    for (size_t i = 0; i < kContendingThreads; ++i) {
+      CHECK_EQ(0, pthread_join(pthreads[i], NULL));
+    }
+    return NanoTime() - start;
+  }
+
+  Mutex mu;
+  ReaderWriterMutex rw_mu;
+  const size_t iterations;
+  size_t count;
+};
+
+TEST_F(MutexTest, ContendedLock) {
+  ContendedCounter state(1000);
+  state.Run(ContendedCounter::MutexCallback);
+  EXPECT_EQ(kContendingThreads * state.iterations, state.count);
+  state.Run(ContendedCounter::ReaderWriterMutexCallback);
+  EXPECT_EQ(2 * kContendingThreads * state.iterations, state.count);
+}
+
+TEST_F(MutexTest, DISABLED_ContendedLockBenchmark) {
+  ContendedCounter state(100000);
+  uint64_t mutex_ns = state.Run(ContendedCounter::MutexCallback);
+  EXPECT_EQ(kContendingThreads * state.iterations, state.count);
+  uint64_t rw_mutex_ns = state.Run(ContendedCounter::ReaderWriterMutexCallback);
+  EXPECT_EQ(2 * kContendingThreads * state.iterations, state.count);
+  LOG(INFO) << kContendingThreads << " threads incrementing under a mutex: "
+            << PrettyDuration(mutex_ns) << ", under a reader writer mutex: "
+            << PrettyDuration(rw_mutex_ns);
+}
+
 }  // namespace art
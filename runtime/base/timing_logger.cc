@@ -153,6 +153,12 @@ void TimingLogger::NewSplit(const char* new_split_label) {
   current_split_->TailInsertSplit(new_split_label);
 }
 
+void TimingLogger::SetSplitLabel(const char* label) {
+  CHECK(current_split_ != NULL) << "Renaming a non-existent split to " << label;
+  DCHECK(label != NULL);
+  current_split_->label_ = label;
+}
+
 uint64_t TimingLogger::GetTotalNs() const {
   uint64_t total_ns = 0;
   for (base::TimingLogger::SplitTimingsIterator it = splits_.begin(), end = splits_.end();
@@ -89,6 +89,9 @@ class TimingLogger {
   // Ends the current split and records the end time.
   void EndSplit();
 
+  // Renames the current split, for details that are only known once its work is done.
+  void SetSplitLabel(const char* label);
+
   uint64_t GetTotalNs() const;
 
   void Dump(std::ostream& os) const;
@@ -61,6 +61,24 @@ TEST_F(TimingLoggerTest, StartNewEnd) {
   EXPECT_STREQ(splits[2].second, split3name);
 }
 
+TEST_F(TimingLoggerTest, SetSplitLabel) {
+  const char* split1name = "First Split";
+  const char* split1label = "First Split (done)";
+  const char* split2name = "Second Split";
+  base::TimingLogger timings("SetSplitLabel", true, false);
+
+  timings.StartSplit(split1name);
+  timings.SetSplitLabel(split1label);
+  timings.NewSplit(split2name);  // Ends split1.
+  timings.EndSplit();  // Ends split2.
+
+  const base::TimingLogger::SplitTimings& splits = timings.GetSplits();
+
+  EXPECT_EQ(2U, splits.size());
+  EXPECT_STREQ(splits[0].second, split1label);
+  EXPECT_STREQ(splits[1].second, split2name);
+}
+
 TEST_F(TimingLoggerTest, StartNewEndNested) {
   const char* split1name = "First Split";
   const char* split2name = "Second Split";
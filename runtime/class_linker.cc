@@ -32,6 +32,7 @@
 #include "base/stl_util.h"
 #include "base/unix_file/fd_file.h"
 #include "class_linker-inl.h"
+#include "cutils/atomic-inline.h"
 #include "debugger.h"
 #include "dex_file-inl.h"
 #include "gc/accounting/card_table-inl.h"
@@ -184,6 +185,8 @@ ClassLinker* ClassLinker::CreateFromImage(InternTable* intern_table) {
   return class_linker.release();
 }
 
+constexpr size_t ClassLinker::kImtSize;
+
 ClassLinker::ClassLinker(InternTable* intern_table)
     // dex_lock_ is recursive as it may be used in stack dumping.
     : dex_lock_("ClassLinker dex lock", kDefaultMutexLevel),
@@ -196,7 +199,8 @@ ClassLinker::ClassLinker(InternTable* intern_table)
       class_table_dirty_(false),
       intern_table_(intern_table),
       portable_resolution_trampoline_(NULL),
-      quick_resolution_trampoline_(NULL) {
+      quick_resolution_trampoline_(NULL),
+      quick_imt_conflict_trampoline_(NULL) {
   CHECK_EQ(arraysize(class_roots_descriptors_), size_t(kClassRootsMax));
 }
 
@@ -320,6 +324,12 @@ void ClassLinker::InitFromCompiler(const std::vector<const DexFile*>& boot_class
   object_array_art_field->SetComponentType(java_lang_reflect_ArtField.get());
   SetClassRoot(kJavaLangReflectArtFieldArrayClass, object_array_art_field.get());
 
+  // Create the imt conflict method and the default imt. Every non-interface class linked from here
+  // on, including the array classes above when FindSystemClass finishes them, points at one.
+  Runtime* runtime = Runtime::Current();
+  runtime->SetImtConflictMethod(runtime->CreateImtConflictMethod());
+  runtime->SetDefaultImt(runtime->CreateDefaultImt(this));
+
   // Setup boot_class_path_ and register class_path now that we can use AllocObjectArray to create
   // DexCache instances. Needs to be after String, Field, Method arrays since AllocDexCache uses
   // these roots.
@@ -588,6 +598,10 @@ bool ClassLinker::GenerateOatFile(const std::string& dex_filename,
   }
   const char* oat_compiler_filter_option = oat_compiler_filter_string.c_str();
 
+  // A debugger may attach to this process, so the code must keep the Dalvik registers it reads
+  // where the vmap tables say they are. NULL ends the arguments early otherwise.
+  const char* debuggable_option = Dbg::IsJdwpConfigured() ? "--debuggable" : NULL;
+
   // fork and exec dex2oat
   pid_t pid = fork();
   if (pid == 0) {
@@ -609,7 +623,8 @@ bool ClassLinker::GenerateOatFile(const std::string& dex_filename,
                        << " " << boot_image_option
                        << " " << dex_file_option
                        << " " << oat_fd_option
-                       << " " << oat_location_option;
+                       << " " << oat_location_option
+                       << ((debuggable_option != NULL) ? " --debuggable" : "");
 
     execl(dex2oat, dex2oat,
           "--runtime-arg", "-Xms64m",
@@ -624,6 +639,7 @@ bool ClassLinker::GenerateOatFile(const std::string& dex_filename,
           dex_file_option,
           oat_fd_option,
           oat_location_option,
+          debuggable_option,
           NULL);
 
     PLOG(FATAL) << "execl(" << dex2oat << ") failed";
@@ -717,6 +733,12 @@ const DexFile* ClassLinker::FindDexFileInOatLocation(const std::string& dex_loca
                        << ", found " << actual_image_oat_offset;
     return NULL;
   }
+
+  if (Dbg::IsJdwpConfigured() && !oat_file->GetOatHeader().IsDebuggable()) {
+    VLOG(class_linker) << "Failed to find oat file at " << oat_location
+                       << " that was compiled for debugging";
+    return NULL;
+  }
   const OatFile::OatDexFile* oat_dex_file = oat_file->GetOatDexFile(dex_location, &dex_location_checksum);
   if (oat_dex_file == NULL) {
     VLOG(class_linker) << "Failed to find oat file at " << oat_location << " containing " << dex_location;
@@ -870,7 +892,11 @@ bool ClassLinker::VerifyOatFileChecksums(const OatFile* oat_file,
   }
   bool dex_check = dex_location_checksum == oat_dex_file->GetDexFileLocationChecksum();
 
-  if (image_check && dex_check) {
+  // A debugger reads Dalvik registers where the vmap tables say they are, which only code
+  // compiled with --debuggable guarantees.
+  bool debuggable_check = !Dbg::IsJdwpConfigured() || oat_file->GetOatHeader().IsDebuggable();
+
+  if (image_check && dex_check && debuggable_check) {
     return true;
   }
 
@@ -889,6 +915,10 @@ bool ClassLinker::VerifyOatFileChecksums(const OatFile* oat_file,
                  << ") with " << dex_location
                  << " (" << std::hex << dex_location_checksum << ")";
   }
+  if (!debuggable_check) {
+    LOG(WARNING) << "oat file " << oat_file->GetLocation()
+                 << " was not compiled for debugging";
+  }
   return false;
 }
 
@@ -1023,6 +1053,7 @@ void ClassLinker::InitFromImage() {
   CHECK(oat_file.GetOatHeader().GetImageFileLocation().empty());
   portable_resolution_trampoline_ = oat_file.GetOatHeader().GetPortableResolutionTrampoline();
   quick_resolution_trampoline_ = oat_file.GetOatHeader().GetQuickResolutionTrampoline();
+  quick_imt_conflict_trampoline_ = oat_file.GetOatHeader().GetQuickImtConflictTrampoline();
   mirror::Object* dex_caches_object = space->GetImageHeader().GetImageRoot(ImageHeader::kDexCaches);
   mirror::ObjectArray<mirror::DexCache>* dex_caches =
       dex_caches_object->AsObjectArray<mirror::DexCache>();
@@ -2137,6 +2168,8 @@ mirror::Class* ClassLinker::CreateArrayClass(const char* descriptor,
   // (remember not to free them for arrays).
   CHECK(array_iftable_ != NULL);
   new_class->SetIfTable(array_iftable_);
+  // Arrays only implement marker interfaces so they share the default imt.
+  new_class->SetImTable(Runtime::Current()->GetDefaultImt());
 
   // Inherit access flags from the component type.
   int access_flags = new_class->GetComponentType()->GetAccessFlags();
@@ -3393,11 +3426,74 @@ bool ClassLinker::LinkMethods(SirtRef<mirror::Class>& klass,
   return true;
 }
 
+// Open addressing table from method name hash to method index used while linking so that finding
+// overriding and implementing methods is linear rather than quadratic in the number of methods.
+// Entries only share a name hash, callers still need to compare names and signatures.
+class LinkMethodHashTable {
+ public:
+  explicit LinkMethodHashTable(size_t num_entries)
+      : mask_(RoundUpToPowerOfTwo(num_entries * 2) - 1), entries_(mask_ + 1) {
+  }
+
+  void Add(size_t name_hash, uint32_t index) {
+    size_t pos = name_hash & mask_;
+    while (entries_[pos].index != kInvalidIndex) {
+      pos = (pos + 1) & mask_;
+    }
+    entries_[pos].name_hash = name_hash;
+    entries_[pos].index = index;
+  }
+
+  // Returns the first probe position for name_hash, to be passed to Next.
+  size_t Start(size_t name_hash) const {
+    return name_hash & mask_;
+  }
+
+  // Returns the next method index added with name_hash, advancing *pos, or kInvalidIndex once the
+  // probe sequence is exhausted.
+  uint32_t Next(size_t name_hash, size_t* pos) const {
+    while (true) {
+      const Entry& entry = entries_[*pos];
+      if (entry.index == kInvalidIndex) {
+        return kInvalidIndex;
+      }
+      *pos = (*pos + 1) & mask_;
+      if (entry.name_hash == name_hash) {
+        return entry.index;
+      }
+    }
+  }
+
+  static constexpr uint32_t kInvalidIndex = 0xFFFFFFFF;
+
+ private:
+  static size_t RoundUpToPowerOfTwo(size_t x) {
+    size_t result = 1;
+    while (result < x) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  struct Entry {
+    Entry() : name_hash(0), index(kInvalidIndex) {}
+    size_t name_hash;
+    uint32_t index;
+  };
+
+  const size_t mask_;
+  std::vector<Entry> entries_;
+};
+
+constexpr uint32_t LinkMethodHashTable::kInvalidIndex;
+
 bool ClassLinker::LinkVirtualMethods(SirtRef<mirror::Class>& klass) {
   Thread* self = Thread::Current();
   if (klass->HasSuperClass()) {
-    uint32_t max_count = klass->NumVirtualMethods() + klass->GetSuperClass()->GetVTable()->GetLength();
-    size_t actual_count = klass->GetSuperClass()->GetVTable()->GetLength();
+    const size_t num_virtual_methods = klass->NumVirtualMethods();
+    const size_t super_vtable_length = klass->GetSuperClass()->GetVTable()->GetLength();
+    uint32_t max_count = num_virtual_methods + super_vtable_length;
+    size_t actual_count = super_vtable_length;
     CHECK_LE(actual_count, max_count);
     // TODO: do not assign to the vtable field until it is fully constructed.
     SirtRef<mirror::ObjectArray<mirror::ArtMethod> >
@@ -3406,16 +3502,29 @@ bool ClassLinker::LinkVirtualMethods(SirtRef<mirror::Class>& klass) {
       CHECK(self->IsExceptionPending());  // OOME.
       return false;
     }
-    // See if any of our virtual methods override the superclass.
+    // See if any of our virtual methods override the superclass. Hash our methods by name and
+    // make a single pass over the superclass vtable, each local method overrides the first
+    // accessible superclass method with the same name and signature.
     MethodHelper local_mh(NULL, this);
     MethodHelper super_mh(NULL, this);
-    for (size_t i = 0; i < klass->NumVirtualMethods(); ++i) {
-      mirror::ArtMethod* local_method = klass->GetVirtualMethodDuringLinking(i);
-      local_mh.ChangeMethod(local_method);
-      size_t j = 0;
-      for (; j < actual_count; ++j) {
-        mirror::ArtMethod* super_method = vtable->Get(j);
-        super_mh.ChangeMethod(super_method);
+    LinkMethodHashTable local_methods(num_virtual_methods);
+    for (size_t i = 0; i < num_virtual_methods; ++i) {
+      local_mh.ChangeMethod(klass->GetVirtualMethodDuringLinking(i));
+      local_methods.Add(Hash(local_mh.GetName()), i);
+    }
+    std::vector<bool> overrides(num_virtual_methods, false);
+    for (size_t j = 0; j < super_vtable_length; ++j) {
+      mirror::ArtMethod* super_method = vtable->Get(j);
+      super_mh.ChangeMethod(super_method);
+      size_t name_hash = Hash(super_mh.GetName());
+      size_t pos = local_methods.Start(name_hash);
+      for (uint32_t i = local_methods.Next(name_hash, &pos);
+           i != LinkMethodHashTable::kInvalidIndex; i = local_methods.Next(name_hash, &pos)) {
+        if (overrides[i]) {
+          continue;
+        }
+        mirror::ArtMethod* local_method = klass->GetVirtualMethodDuringLinking(i);
+        local_mh.ChangeMethod(local_method);
         if (local_mh.HasSameNameAndSignature(&super_mh)) {
           if (klass->CanAccessMember(super_method->GetDeclaringClass(), super_method->GetAccessFlags())) {
             if (super_method->IsFinal()) {
@@ -3424,8 +3533,21 @@ bool ClassLinker::LinkVirtualMethods(SirtRef<mirror::Class>& klass) {
                                 super_mh.GetDeclaringClassDescriptor());
               return false;
             }
+            if (UNLIKELY(super_method->IsSingleImplementation()) &&
+                !Runtime::Current()->IsCompiler()) {
+              // The boot image calls super_method directly where it was called virtually. Enter
+              // it through the redispatch trampoline from now on, dispatching those calls on
+              // their receiver, before any instance of klass may reach them. The trampoline
+              // reads the code it enters super_method through, so that must be stored first.
+              super_method->SetRedispatched();
+              super_method->SetEntryPointFromRedispatch(
+                  super_method->GetEntryPointFromCompiledCode());
+              ANDROID_MEMBAR_STORE();
+              super_method->SetEntryPointFromCompiledCode(GetQuickRedispatchTrampoline());
+            }
             vtable->Set(j, local_method);
             local_method->SetMethodIndex(j);
+            overrides[i] = true;
             break;
           } else {
             LOG(WARNING) << "Before Android 4.1, method " << PrettyMethod(local_method)
@@ -3434,8 +3556,11 @@ bool ClassLinker::LinkVirtualMethods(SirtRef<mirror::Class>& klass) {
           }
         }
       }
-      if (j == actual_count) {
+    }
+    for (size_t i = 0; i < num_virtual_methods; ++i) {
+      if (!overrides[i]) {
         // Not overriding, append.
+        mirror::ArtMethod* local_method = klass->GetVirtualMethodDuringLinking(i);
         vtable->Set(actual_count, local_method);
         local_method->SetMethodIndex(actual_count);
         actual_count += 1;
@@ -3494,10 +3619,14 @@ bool ClassLinker::LinkInterfaceMethods(SirtRef<mirror::Class>& klass,
     mirror::Class* interface = interfaces == NULL ? kh.GetDirectInterface(i) : interfaces->Get(i);
     ifcount += interface->GetIfTableCount();
   }
+  Runtime* runtime = Runtime::Current();
   if (ifcount == 0) {
     // Class implements no interfaces.
     DCHECK_EQ(klass->GetIfTableCount(), 0);
     DCHECK(klass->GetIfTable() == NULL);
+    if (!klass->IsInterface()) {
+      klass->SetImTable(runtime->GetDefaultImt());
+    }
     return true;
   }
   if (ifcount == super_ifcount) {
@@ -3513,6 +3642,7 @@ bool ClassLinker::LinkInterfaceMethods(SirtRef<mirror::Class>& klass,
     if (!has_non_marker_interface) {
       // Class just inherits marker interfaces from parent so recycle parent's iftable.
       klass->SetIfTable(super_iftable);
+      klass->SetImTable(runtime->GetDefaultImt());
       return true;
     }
   }
@@ -3587,9 +3717,26 @@ bool ClassLinker::LinkInterfaceMethods(SirtRef<mirror::Class>& klass,
   if (klass->IsInterface()) {
     return true;
   }
+  // Build the imt alongside the iftable method arrays. Slots are picked by the interface method's
+  // dex method index, which is also what compiled code uses to index the table.
+  SirtRef<mirror::ObjectArray<mirror::ArtMethod> >
+      imtable(self, AllocArtMethodArray(self, kImtSize));
+  if (UNLIKELY(imtable.get() == NULL)) {
+    CHECK(self->IsExceptionPending());  // OOME.
+    return false;
+  }
+  bool imtable_changed = false;
   std::vector<mirror::ArtMethod*> miranda_list;
   MethodHelper vtable_mh(NULL, this);
   MethodHelper interface_mh(NULL, this);
+  // Hash the vtable by method name once rather than scanning it for every interface method.
+  mirror::ObjectArray<mirror::ArtMethod>* vtable = klass->GetVTableDuringLinking();
+  const size_t vtable_length = vtable->GetLength();
+  LinkMethodHashTable vtable_methods(vtable_length);
+  for (size_t k = 0; k < vtable_length; ++k) {
+    vtable_mh.ChangeMethod(vtable->Get(k));
+    vtable_methods.Add(Hash(vtable_mh.GetName()), k);
+  }
   for (size_t i = 0; i < ifcount; ++i) {
     mirror::Class* interface = iftable->GetInterface(i);
     size_t num_methods = interface->NumVirtualMethods();
@@ -3601,35 +3748,42 @@ bool ClassLinker::LinkInterfaceMethods(SirtRef<mirror::Class>& klass,
         return false;
       }
       iftable->SetMethodArray(i, method_array);
-      mirror::ObjectArray<mirror::ArtMethod>* vtable = klass->GetVTableDuringLinking();
       for (size_t j = 0; j < num_methods; ++j) {
         mirror::ArtMethod* interface_method = interface->GetVirtualMethod(j);
         interface_mh.ChangeMethod(interface_method);
-        int32_t k;
         // For each method listed in the interface's method list, find the
         // matching method in our class's method list.  We want to favor the
-        // subclass over the superclass, which just requires walking
-        // back from the end of the vtable.  (This only matters if the
+        // subclass over the superclass, which just requires picking the
+        // match with the highest vtable index.  (This only matters if the
         // superclass defines a private method and this class redefines
         // it -- otherwise it would use the same vtable slot.  In .dex files
         // those don't end up in the virtual method table, so it shouldn't
-        // matter which direction we go.  We walk it backward anyway.)
-        for (k = vtable->GetLength() - 1; k >= 0; --k) {
-          mirror::ArtMethod* vtable_method = vtable->Get(k);
-          vtable_mh.ChangeMethod(vtable_method);
+        // matter which one we pick.  We favor the subclass anyway.)
+        mirror::ArtMethod* vtable_method = NULL;
+        uint32_t vtable_index = 0;
+        size_t name_hash = Hash(interface_mh.GetName());
+        size_t pos = vtable_methods.Start(name_hash);
+        for (uint32_t k = vtable_methods.Next(name_hash, &pos);
+             k != LinkMethodHashTable::kInvalidIndex; k = vtable_methods.Next(name_hash, &pos)) {
+          if (vtable_method != NULL && k < vtable_index) {
+            continue;
+          }
+          vtable_mh.ChangeMethod(vtable->Get(k));
           if (interface_mh.HasSameNameAndSignature(&vtable_mh)) {
-            if (!vtable_method->IsAbstract() && !vtable_method->IsPublic()) {
-              ThrowIllegalAccessError(klass.get(),
-                                      "Method '%s' implementing interface method '%s' is not public",
-                                      PrettyMethod(vtable_method).c_str(),
-                                      PrettyMethod(interface_method).c_str());
-              return false;
-            }
-            method_array->Set(j, vtable_method);
-            break;
+            vtable_method = vtable->Get(k);
+            vtable_index = k;
           }
         }
-        if (k < 0) {
+        if (vtable_method != NULL) {
+          if (!vtable_method->IsAbstract() && !vtable_method->IsPublic()) {
+            ThrowIllegalAccessError(klass.get(),
+                                    "Method '%s' implementing interface method '%s' is not public",
+                                    PrettyMethod(vtable_method).c_str(),
+                                    PrettyMethod(interface_method).c_str());
+            return false;
+          }
+          method_array->Set(j, vtable_method);
+        } else {
           SirtRef<mirror::ArtMethod> miranda_method(self, NULL);
           for (size_t mir = 0; mir < miranda_list.size(); mir++) {
             mirror::ArtMethod* mir_method = miranda_list[mir];
@@ -3654,9 +3808,33 @@ bool ClassLinker::LinkInterfaceMethods(SirtRef<mirror::Class>& klass,
           }
           method_array->Set(j, miranda_method.get());
         }
+        // Place the implementation in its imt slot. A slot shared by interface methods with
+        // different implementations becomes a conflict resolved by the conflict trampoline.
+        mirror::ArtMethod* implementation = method_array->Get(j);
+        uint32_t imt_index = interface_method->GetDexMethodIndex() % kImtSize;
+        mirror::ArtMethod* imt_method = imtable->Get(imt_index);
+        if (imt_method == NULL) {
+          imtable->Set(imt_index, implementation);
+          imtable_changed = true;
+        } else if (imt_method != implementation) {
+          imtable->Set(imt_index, runtime->GetImtConflictMethod());
+        }
       }
     }
   }
+  if (imtable_changed) {
+    // Fill in empty entries in the imt with the conflict method.
+    mirror::ArtMethod* imt_conflict_method = runtime->GetImtConflictMethod();
+    for (size_t i = 0; i < kImtSize; ++i) {
+      if (imtable->Get(i) == NULL) {
+        imtable->Set(i, imt_conflict_method);
+      }
+    }
+    klass->SetImTable(imtable.get());
+  } else {
+    // Only marker interfaces were added.
+    klass->SetImTable(runtime->GetDefaultImt());
+  }
   if (!miranda_list.empty()) {
     int old_method_count = klass->NumVirtualMethods();
     int new_method_count = old_method_count + miranda_list.size();
@@ -3694,7 +3872,7 @@ bool ClassLinker::LinkInterfaceMethods(SirtRef<mirror::Class>& klass,
     klass->SetVTable(vtable.get());
   }
 
-  mirror::ObjectArray<mirror::ArtMethod>* vtable = klass->GetVTableDuringLinking();
+  vtable = klass->GetVTableDuringLinking();
   for (int i = 0; i < vtable->GetLength(); ++i) {
     CHECK(vtable->Get(i) != NULL);
   }
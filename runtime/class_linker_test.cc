@@ -496,9 +496,11 @@ struct ClassOffsets : public CheckOffsets<mirror::Class> {
     offsets.push_back(CheckOffset(OFFSETOF_MEMBER(mirror::Class, direct_methods_),                "directMethods"));
     offsets.push_back(CheckOffset(OFFSETOF_MEMBER(mirror::Class, ifields_),                       "iFields"));
     offsets.push_back(CheckOffset(OFFSETOF_MEMBER(mirror::Class, iftable_),                       "ifTable"));
+    offsets.push_back(CheckOffset(OFFSETOF_MEMBER(mirror::Class, imtable_),                       "imTable"));
     offsets.push_back(CheckOffset(OFFSETOF_MEMBER(mirror::Class, name_),                          "name"));
     offsets.push_back(CheckOffset(OFFSETOF_MEMBER(mirror::Class, sfields_),                       "sFields"));
     offsets.push_back(CheckOffset(OFFSETOF_MEMBER(mirror::Class, super_class_),                   "superClass"));
+    offsets.push_back(CheckOffset(OFFSETOF_MEMBER(mirror::Class, type_check_cache_),              "typeCheckCache"));
     offsets.push_back(CheckOffset(OFFSETOF_MEMBER(mirror::Class, verify_error_class_),            "verifyErrorClass"));
     offsets.push_back(CheckOffset(OFFSETOF_MEMBER(mirror::Class, virtual_methods_),               "virtualMethods"));
     offsets.push_back(CheckOffset(OFFSETOF_MEMBER(mirror::Class, vtable_),                        "vtable"));
@@ -756,6 +758,30 @@ TEST_F(ClassLinkerTest, LibCore) {
   AssertDexFile(java_lang_dex_file_, NULL);
 }
 
+TEST_F(ClassLinkerTest, DISABLED_LinkLibCoreBenchmark) {
+  // Linking the methods of a class looks up each virtual method of its superclass and interfaces
+  // by name and signature, which dominates for classes with large vtables.
+  ScopedObjectAccess soa(Thread::Current());
+  const DexFile* dex_file = java_lang_dex_file_;
+  size_t num_linked = 0;
+  uint64_t start = NanoTime();
+  for (size_t i = 0; i < dex_file->NumClassDefs(); i++) {
+    const char* descriptor = dex_file->GetClassDescriptor(dex_file->GetClassDef(i));
+    if (class_linker_->LookupClass(descriptor, NULL) != NULL) {
+      continue;  // Linked while starting the runtime, or as another class's superclass.
+    }
+    if (class_linker_->FindSystemClass(descriptor) != NULL) {
+      num_linked++;
+    } else {
+      soa.Self()->ClearException();
+    }
+  }
+  uint64_t elapsed = NanoTime() - start;
+  EXPECT_NE(0U, num_linked);
+  LOG(INFO) << "Loading and linking " << num_linked << " core classes and their supertypes: "
+            << PrettyDuration(elapsed);
+}
+
 // The first reference array element must be a multiple of 4 bytes from the
 // start of the object
 TEST_F(ClassLinkerTest, ValidateObjectArrayElementsOffset) {
@@ -971,6 +997,20 @@ TEST_F(ClassLinkerTest, Interfaces) {
   EXPECT_EQ(Aj1, A->FindVirtualMethodForVirtualOrInterface(Jj1));
   EXPECT_EQ(Aj2, A->FindVirtualMethodForVirtualOrInterface(Jj2));
 
+  // Interfaces have no imt, implementing classes dispatch through it to the implementation or,
+  // where interface methods share a slot, to the conflict method.
+  EXPECT_TRUE(I->GetImTable() == NULL);
+  mirror::ObjectArray<mirror::ArtMethod>* imtable = A->GetImTable();
+  ASSERT_TRUE(imtable != NULL);
+  EXPECT_EQ(static_cast<int32_t>(ClassLinker::kImtSize), imtable->GetLength());
+  mirror::ArtMethod* conflict_method = Runtime::Current()->GetImtConflictMethod();
+  mirror::ArtMethod* imt_Ai = imtable->Get(Ii->GetDexMethodIndex() % ClassLinker::kImtSize);
+  mirror::ArtMethod* imt_Aj1 = imtable->Get(Jj1->GetDexMethodIndex() % ClassLinker::kImtSize);
+  mirror::ArtMethod* imt_Aj2 = imtable->Get(Jj2->GetDexMethodIndex() % ClassLinker::kImtSize);
+  EXPECT_TRUE(imt_Ai == Ai || imt_Ai == conflict_method);
+  EXPECT_TRUE(imt_Aj1 == Aj1 || imt_Aj1 == conflict_method);
+  EXPECT_TRUE(imt_Aj2 == Aj2 || imt_Aj2 == conflict_method);
+
   mirror::ArtField* Afoo = A->FindStaticField("foo", "Ljava/lang/String;");
   mirror::ArtField* Bfoo = B->FindStaticField("foo", "Ljava/lang/String;");
   mirror::ArtField* Jfoo = J->FindStaticField("foo", "Ljava/lang/String;");
@@ -323,8 +323,7 @@ static inline void CheckReferenceResult(mirror::Object* o, Thread* self)
 static inline void CheckSuspend(Thread* thread) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
   for (;;) {
     if (thread->ReadFlag(kCheckpointRequest)) {
-      thread->RunCheckpointFunction();
-      thread->AtomicClearFlag(kCheckpointRequest);
+      thread->RunCheckpointAtSafepoint();
     } else if (thread->ReadFlag(kSuspendRequest)) {
       thread->FullSuspendCheck();
     } else {
@@ -393,6 +392,23 @@ static inline const void* GetResolutionTrampoline(ClassLinker* class_linker) {
 #endif
 }
 
+static inline const void* GetQuickImtConflictTrampoline(ClassLinker* class_linker) {
+  return class_linker->GetQuickImtConflictTrampoline();
+}
+
+// Return address of the entry point of a method compiled code may call directly in place of a
+// virtual call, once overridden. Only the quick backend makes such calls.
+extern "C" void art_quick_redispatch_trampoline(mirror::ArtMethod*);
+static inline const void* GetQuickRedispatchTrampoline() {
+  return reinterpret_cast<void*>(art_quick_redispatch_trampoline);
+}
+
+// Return address of imt conflict trampoline stub. Only the quick backend dispatches through the
+// imt, the portable backend never calls the imt conflict method.
+static inline const void* GetImtConflictTrampoline(ClassLinker* class_linker) {
+  return GetQuickImtConflictTrampoline(class_linker);
+}
+
 extern "C" void art_portable_proxy_invoke_handler();
 static inline const void* GetPortableProxyInvokeHandler() {
   return reinterpret_cast<void*>(art_portable_proxy_invoke_handler);
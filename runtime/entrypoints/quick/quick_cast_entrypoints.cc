@@ -28,7 +28,8 @@ extern "C" uint32_t artIsAssignableFromCode(const mirror::Class* klass,
     SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
   DCHECK(klass != NULL);
   DCHECK(ref_class != NULL);
-  return klass->IsAssignableFrom(ref_class) ? 1 : 0;
+  return const_cast<mirror::Class*>(klass)->IsAssignableFromCached(
+      const_cast<mirror::Class*>(ref_class)) ? 1 : 0;
 }
 
 // Check whether it is safe to cast one class to the other, throw exception and return -1 on failure
@@ -37,7 +38,7 @@ extern "C" int artCheckCastFromCode(mirror::Class* src_type, mirror::Class* dest
     SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
   DCHECK(src_type->IsClass()) << PrettyClass(src_type);
   DCHECK(dest_type->IsClass()) << PrettyClass(dest_type);
-  if (LIKELY(dest_type->IsAssignableFrom(src_type))) {
+  if (LIKELY(dest_type->IsAssignableFromCached(src_type))) {
     return 0;  // Success
   } else {
     FinishCalleeSaveFrameSetup(self, sp, Runtime::kRefsOnly);
@@ -56,7 +57,7 @@ extern "C" int artCanPutArrayElementFromCode(const mirror::Object* element,
   // element can't be NULL as we catch this is screened in runtime_support
   mirror::Class* element_class = element->GetClass();
   mirror::Class* component_type = array_class->GetComponentType();
-  if (LIKELY(component_type->IsAssignableFrom(element_class))) {
+  if (LIKELY(component_type->IsAssignableFromCached(element_class))) {
     return 0;  // Success
   } else {
     FinishCalleeSaveFrameSetup(self, sp, Runtime::kRefsOnly);
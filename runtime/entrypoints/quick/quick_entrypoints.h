@@ -117,6 +117,7 @@ struct PACKED(4) QuickEntryPoints {
 
   // Invocation
   void (*pQuickResolutionTrampoline)(mirror::ArtMethod*);
+  void (*pQuickImtConflictTrampoline)(mirror::ArtMethod*);
   void (*pQuickToInterpreterBridge)(mirror::ArtMethod*);
   void (*pInvokeDirectTrampolineWithAccessCheck)(uint32_t, void*);
   void (*pInvokeInterfaceTrampoline)(uint32_t, void*);
@@ -512,10 +512,34 @@ extern "C" const void* artQuickResolutionTrampoline(mirror::ArtMethod* called,
     }
     dex_method_idx = (is_range) ? instr->VRegB_3rc() : instr->VRegB_35c();
 
-  } else {
+  } else if (called->IsStatic()) {
     invoke_type = kStatic;
     dex_file = &MethodHelper(called).GetDexFile();
     dex_method_idx = called->GetDexMethodIndex();
+  } else {
+    // A method compiled code calls directly, overridden since, whose receiver's vtable didn't
+    // hold it (see art_quick_redispatch_trampoline). Dispatch calls compiled from invoke-virtual
+    // on the receiver; calls from the invoke stub, whose Method* is NULL, and invoke-super enter
+    // called itself.
+    DCHECK(called->IsRedispatched()) << PrettyMethod(called);
+    invoke_type = kSuper;
+    if (caller != NULL && !caller->IsRuntimeMethod()) {
+      uint32_t dex_pc = caller->ToDexPc(QuickArgumentVisitor::GetCallingPc(sp));
+      const DexFile::CodeItem* code = MethodHelper(caller).GetCodeItem();
+      const Instruction* instr = Instruction::At(&code->insns_[dex_pc]);
+      switch (instr->Opcode()) {
+        case Instruction::INVOKE_VIRTUAL:
+        case Instruction::INVOKE_VIRTUAL_RANGE:
+        case Instruction::INVOKE_INTERFACE:
+        case Instruction::INVOKE_INTERFACE_RANGE:
+          invoke_type = kVirtual;
+          break;
+        default:
+          break;
+      }
+    }
+    dex_file = &MethodHelper(called).GetDexFile();
+    dex_method_idx = called->GetDexMethodIndex();
   }
   uint32_t shorty_len;
   const char* shorty =
@@ -554,6 +578,10 @@ extern "C" const void* artQuickResolutionTrampoline(mirror::ArtMethod* called,
     } else {
       DCHECK(called_class->IsErroneous());
     }
+    if (UNLIKELY(code != NULL && called->IsRedispatched())) {
+      // Its entry point leads back here.
+      code = called->GetEntryPointFromRedispatch();
+    }
   }
   CHECK_EQ(code == NULL, thread->IsExceptionPending());
 #ifdef MOVING_GARBAGE_COLLECTOR
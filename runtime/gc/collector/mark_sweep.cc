@@ -191,6 +191,12 @@ void MarkSweep::ProcessReferences(Thread* self) {
                     &finalizer_reference_list_, &phantom_reference_list_);
 }
 
+void MarkSweep::DeflateMonitors() {
+  base::TimingLogger::ScopedSplit split("DeflateMonitors", &timings_);
+  size_t deflated = Runtime::Current()->GetMonitorList()->DeflateMonitors();
+  VLOG(monitor) << "MarkSweep deflated " << deflated << " monitors";
+}
+
 bool MarkSweep::HandleDirtyObjectsPhase() {
   base::TimingLogger::ScopedSplit split("HandleDirtyObjectsPhase", &timings_);
   Thread* self = Thread::Current();
@@ -208,6 +214,8 @@ bool MarkSweep::HandleDirtyObjectsPhase() {
 
   ProcessReferences(self);
 
+  DeflateMonitors();
+
   // Only need to do this if we have the card mark verification on, and only during concurrent GC.
   if (GetHeap()->verify_missing_card_marks_ || GetHeap()->verify_pre_gc_heap_||
       GetHeap()->verify_post_gc_heap_) {
@@ -291,6 +299,7 @@ void MarkSweep::ReclaimPhase() {
 
   if (!IsConcurrent()) {
     ProcessReferences(self);
+    DeflateMonitors();
   }
 
   {
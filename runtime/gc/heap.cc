@@ -46,6 +46,7 @@
 #include "mirror/object.h"
 #include "mirror/object-inl.h"
 #include "mirror/object_array-inl.h"
+#include "monitor.h"
 #include "object_utils.h"
 #include "os.h"
 #include "ScopedLocalRef.h"
@@ -588,6 +589,9 @@ mirror::Object* Heap::AllocObject(Thread* self, mirror::Class* c, size_t byte_co
 
   if (LIKELY(obj != NULL)) {
     obj->SetClass(c);
+    if (UNLIKELY(Monitor::UseBiasedLocking())) {
+      obj->SetField32(mirror::Object::MonitorOffset(), Monitor::GetInitialLockWord(c), false);
+    }
 
     // Record allocation after since we want to use the atomic add for the atomic fence to guard
     // the SetClass since we do not want the class to appear NULL in another thread.
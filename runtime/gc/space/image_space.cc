@@ -21,6 +21,7 @@
 
 #include "base/stl_util.h"
 #include "base/unix_file/fd_file.h"
+#include "debugger.h"
 #include "gc/accounting/space_bitmap-inl.h"
 #include "mirror/art_method.h"
 #include "mirror/class-inl.h"
@@ -80,6 +81,10 @@ static bool GenerateImage(const std::string& image_file_name) {
 
   arg_vector.push_back(StringPrintf("--base=0x%x", ART_BASE_ADDRESS));
 
+  if (Dbg::IsJdwpConfigured()) {
+    arg_vector.push_back("--debuggable");
+  }
+
   if (kIsTargetBuild) {
     arg_vector.push_back("--image-classes-zip=/system/framework/framework.jar");
     arg_vector.push_back("--image-classes=preloaded-classes");
@@ -132,8 +137,15 @@ static bool GenerateImage(const std::string& image_file_name) {
 
 ImageSpace* ImageSpace::Create(const std::string& original_image_file_name) {
   if (OS::FileExists(original_image_file_name.c_str())) {
-    // If the /system file exists, it should be up-to-date, don't try to generate
-    return space::ImageSpace::Init(original_image_file_name, false);
+    // If the /system file exists, it should be up-to-date, don't try to generate. A debugger
+    // needs code compiled with --debuggable though, so fall back to the dalvik-cache otherwise.
+    space::ImageSpace* image_space = space::ImageSpace::Init(original_image_file_name, false);
+    if (image_space == NULL || !Dbg::IsJdwpConfigured() ||
+        image_space->oat_file_->GetOatHeader().IsDebuggable()) {
+      return image_space;
+    }
+    LOG(WARNING) << "Image " << original_image_file_name << " was not compiled for debugging";
+    delete image_space;
   }
   // If the /system file didn't exist, we need to use one from the dalvik-cache.
   // If the cache file exists, try to open, but if it fails, regenerate.
@@ -213,6 +225,10 @@ ImageSpace* ImageSpace::Init(const std::string& image_file_name, bool validate_o
   Runtime* runtime = Runtime::Current();
   mirror::Object* resolution_method = image_header.GetImageRoot(ImageHeader::kResolutionMethod);
   runtime->SetResolutionMethod(down_cast<mirror::ArtMethod*>(resolution_method));
+  mirror::Object* imt_conflict_method = image_header.GetImageRoot(ImageHeader::kImtConflictMethod);
+  runtime->SetImtConflictMethod(down_cast<mirror::ArtMethod*>(imt_conflict_method));
+  mirror::Object* default_imt = image_header.GetImageRoot(ImageHeader::kDefaultImt);
+  runtime->SetDefaultImt(down_cast<mirror::ObjectArray<mirror::ArtMethod>*>(default_imt));
 
   mirror::Object* callee_save_method = image_header.GetImageRoot(ImageHeader::kCalleeSaveMethod);
   runtime->SetCalleeSaveMethod(down_cast<mirror::ArtMethod*>(callee_save_method), Runtime::kSaveAll);
@@ -273,6 +289,11 @@ OatFile* ImageSpace::OpenOatFile() const {
 
 bool ImageSpace::ValidateOatFile() const {
   CHECK(oat_file_.get() != NULL);
+  if (Dbg::IsJdwpConfigured() && !oat_file_->GetOatHeader().IsDebuggable()) {
+    LOG(WARNING) << "ValidateOatFile found oat file " << oat_file_->GetLocation()
+                 << " that was not compiled for debugging";
+    return false;
+  }
   for (const OatFile::OatDexFile* oat_dex_file : oat_file_->GetOatDexFiles()) {
     const std::string& dex_file_location = oat_dex_file->GetDexFileLocation();
     uint32_t dex_file_location_checksum;
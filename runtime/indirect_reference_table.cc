@@ -15,6 +15,9 @@
  */
 
 #include "indirect_reference_table.h"
+
+#include "cutils/atomic.h"
+#include "cutils/atomic-inline.h"
 #include "jni_internal.h"
 #include "reference_table.h"
 #include "runtime.h"
@@ -35,35 +38,57 @@ static void AbortMaybe() {
 }
 
 IndirectReferenceTable::IndirectReferenceTable(size_t initialCount,
-                                               size_t maxCount, IndirectRefKind desiredKind) {
+                                               size_t maxCount, IndirectRefKind desiredKind,
+                                               uint32_t stripe) {
   CHECK_GT(initialCount, 0U);
   CHECK_LE(initialCount, maxCount);
+  CHECK_LE(maxCount, 65536U);
   CHECK_NE(desiredKind, kSirtOrInvalid);
+  CHECK_LT(stripe, 4U);
 
-  table_ = reinterpret_cast<const mirror::Object**>(malloc(initialCount * sizeof(const mirror::Object*)));
-  CHECK(table_ != NULL);
-  memset(table_, 0xd1, initialCount * sizeof(const mirror::Object*));
-
-  slot_data_ = reinterpret_cast<IndirectRefSlot*>(calloc(initialCount, sizeof(IndirectRefSlot)));
-  CHECK(slot_data_ != NULL);
+  size_t num_chunks = RoundUp(maxCount, kChunkSize) / kChunkSize;
+  chunks_ = reinterpret_cast<Chunk**>(calloc(num_chunks, sizeof(Chunk*)));
+  CHECK(chunks_ != NULL);
 
   segment_state_.all = IRT_FIRST_SEGMENT;
-  alloc_entries_ = initialCount;
+  alloc_entries_ = 0;
   max_entries_ = maxCount;
   kind_ = desiredKind;
+  stripe_ = stripe;
+  last_hole_index_ = 0;
+  Reserve(initialCount);
 }
 
 IndirectReferenceTable::~IndirectReferenceTable() {
-  free(table_);
-  free(slot_data_);
-  table_ = NULL;
-  slot_data_ = NULL;
+  for (size_t i = 0; i < alloc_entries_; i += kChunkSize) {
+    free(chunks_[i >> kChunkShift]);
+  }
+  free(chunks_);
+  chunks_ = NULL;
   alloc_entries_ = max_entries_ = -1;
 }
 
+void IndirectReferenceTable::Reserve(size_t count) {
+  // chunks_ only has room for max_entries_ rounded up to whole chunks.
+  CHECK_LE(count, max_entries_);
+  while (alloc_entries_ < count) {
+    // Chunks start out zeroed, which the slot serial numbers rely on.
+    Chunk* chunk = reinterpret_cast<Chunk*>(calloc(1, sizeof(Chunk)));
+    if (chunk == NULL) {
+      LOG(FATAL) << "JNI ERROR (app bug): unable to expand "
+                 << kind_ << " table (from "
+                 << alloc_entries_ << " to " << (alloc_entries_ + kChunkSize)
+                 << ", max=" << max_entries_ << ")\n"
+                 << MutatorLockedDumpable<IndirectReferenceTable>(*this);
+    }
+    chunks_[alloc_entries_ >> kChunkShift] = chunk;
+    alloc_entries_ += kChunkSize;
+  }
+}
+
 // Make sure that the entry at "idx" is correctly paired with "iref".
 bool IndirectReferenceTable::CheckEntry(const char* what, IndirectRef iref, int idx) const {
-  const mirror::Object* obj = table_[idx];
+  const mirror::Object* obj = Entry(idx);
   IndirectRef checkRef = ToIndirectRef(obj, idx);
   if (UNLIKELY(checkRef != iref)) {
     LOG(ERROR) << "JNI ERROR (app bug): attempt to " << what
@@ -83,63 +108,48 @@ IndirectRef IndirectReferenceTable::Add(uint32_t cookie, const mirror::Object* o
   DCHECK(obj != NULL);
   // TODO: stronger sanity check on the object (such as in heap)
   DCHECK_ALIGNED(reinterpret_cast<uintptr_t>(obj), 8);
-  DCHECK(table_ != NULL);
-  DCHECK_LE(alloc_entries_, max_entries_);
+  DCHECK(chunks_ != NULL);
   DCHECK_GE(segment_state_.parts.numHoles, prevState.parts.numHoles);
 
-  if (topIndex == alloc_entries_) {
-    // reached end of allocated space; did we hit buffer max?
-    if (topIndex == max_entries_) {
+  int numHoles = segment_state_.parts.numHoles - prevState.parts.numHoles;
+  if (numHoles == 0) {
+    // No hole to fill; did we hit buffer max? The last chunk may go past it.
+    if (topIndex >= max_entries_) {
       LOG(FATAL) << "JNI ERROR (app bug): " << kind_ << " table overflow "
                  << "(max=" << max_entries_ << ")\n"
                  << MutatorLockedDumpable<IndirectReferenceTable>(*this);
     }
-
-    size_t newSize = alloc_entries_ * 2;
-    if (newSize > max_entries_) {
-      newSize = max_entries_;
+    if (topIndex == alloc_entries_) {
+      // Reached end of allocated space; add another chunk, the existing entries stay put.
+      Reserve(alloc_entries_ + 1);
     }
-    DCHECK_GT(newSize, alloc_entries_);
-
-    table_ = reinterpret_cast<const mirror::Object**>(realloc(table_, newSize * sizeof(const mirror::Object*)));
-    slot_data_ = reinterpret_cast<IndirectRefSlot*>(realloc(slot_data_,
-                                                            newSize * sizeof(IndirectRefSlot)));
-    if (table_ == NULL || slot_data_ == NULL) {
-      LOG(FATAL) << "JNI ERROR (app bug): unable to expand "
-                 << kind_ << " table (from "
-                 << alloc_entries_ << " to " << newSize
-                 << ", max=" << max_entries_ << ")\n"
-                 << MutatorLockedDumpable<IndirectReferenceTable>(*this);
-    }
-
-    // Clear the newly-allocated slot_data_ elements.
-    memset(slot_data_ + alloc_entries_, 0, (newSize - alloc_entries_) * sizeof(IndirectRefSlot));
-
-    alloc_entries_ = newSize;
   }
 
   // We know there's enough room in the table.  Now we just need to find
   // the right spot.  If there's a hole, find it and fill it; otherwise,
   // add to the end of the list.
   IndirectRef result;
-  int numHoles = segment_state_.parts.numHoles - prevState.parts.numHoles;
   if (numHoles > 0) {
     DCHECK_GT(topIndex, 1U);
-    // Find the first hole; likely to be near the end of the list.
-    const mirror::Object** pScan = &table_[topIndex - 1];
-    DCHECK(*pScan != NULL);
-    while (*--pScan != NULL) {
-      DCHECK_GE(pScan, table_ + prevState.parts.topIndex);
+    size_t bottomIndex = prevState.parts.topIndex;
+    size_t holeIndex = last_hole_index_;
+    if (holeIndex < bottomIndex || holeIndex >= topIndex || Entry(holeIndex) != NULL) {
+      // Find the first hole; likely to be near the end of the list.
+      holeIndex = topIndex - 1;
+      DCHECK(Entry(holeIndex) != NULL);
+      while (Entry(--holeIndex) != NULL) {
+        DCHECK_GT(holeIndex, bottomIndex);
+      }
     }
-    UpdateSlotAdd(obj, pScan - table_);
-    result = ToIndirectRef(obj, pScan - table_);
-    *pScan = obj;
+    UpdateSlotAdd(obj, holeIndex);
+    result = ToIndirectRef(obj, holeIndex);
+    Entry(holeIndex) = obj;
     segment_state_.parts.numHoles--;
   } else {
     // Add to the end.
     UpdateSlotAdd(obj, topIndex);
     result = ToIndirectRef(obj, topIndex);
-    table_[topIndex++] = obj;
+    Entry(topIndex++) = obj;
     segment_state_.parts.topIndex = topIndex;
   }
   if (false) {
@@ -181,7 +191,7 @@ bool IndirectReferenceTable::GetChecked(IndirectRef iref) const {
     return false;
   }
 
-  if (UNLIKELY(table_[idx] == NULL)) {
+  if (UNLIKELY(Entry(idx) == NULL)) {
     LOG(ERROR) << "JNI ERROR (app bug): accessed deleted " << kind_ << " " << iref;
     AbortMaybe();
     return false;
@@ -194,9 +204,10 @@ bool IndirectReferenceTable::GetChecked(IndirectRef iref) const {
   return true;
 }
 
-static int Find(mirror::Object* direct_pointer, int bottomIndex, int topIndex, const mirror::Object** table) {
+int IndirectReferenceTable::Find(mirror::Object* direct_pointer, int bottomIndex,
+                                 int topIndex) const {
   for (int i = bottomIndex; i < topIndex; ++i) {
-    if (table[i] == direct_pointer) {
+    if (Entry(i) == direct_pointer) {
       return i;
     }
   }
@@ -204,7 +215,7 @@ static int Find(mirror::Object* direct_pointer, int bottomIndex, int topIndex, c
 }
 
 bool IndirectReferenceTable::ContainsDirectPointer(mirror::Object* direct_pointer) const {
-  return Find(direct_pointer, 0, segment_state_.parts.topIndex, table_) != -1;
+  return Find(direct_pointer, 0, segment_state_.parts.topIndex) != -1;
 }
 
 // Removes an object. We extract the table offset bits from "iref"
@@ -221,8 +232,7 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
   int topIndex = segment_state_.parts.topIndex;
   int bottomIndex = prevState.parts.topIndex;
 
-  DCHECK(table_ != NULL);
-  DCHECK_LE(alloc_entries_, max_entries_);
+  DCHECK(chunks_ != NULL);
   DCHECK_GE(segment_state_.parts.numHoles, prevState.parts.numHoles);
 
   int idx = ExtractIndex(iref);
@@ -235,7 +245,7 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
   }
   if (GetIndirectRefKind(iref) == kSirtOrInvalid && vm->work_around_app_jni_bugs) {
     mirror::Object* direct_pointer = reinterpret_cast<mirror::Object*>(iref);
-    idx = Find(direct_pointer, bottomIndex, topIndex, table_);
+    idx = Find(direct_pointer, bottomIndex, topIndex);
     if (idx == -1) {
       LOG(WARNING) << "Trying to work around app JNI bugs, but didn't find " << iref << " in table!";
       return false;
@@ -262,15 +272,15 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
       return false;
     }
 
-    table_[idx] = NULL;
+    Entry(idx) = NULL;
     int numHoles = segment_state_.parts.numHoles - prevState.parts.numHoles;
     if (numHoles != 0) {
       while (--topIndex > bottomIndex && numHoles != 0) {
         if (false) {
           LOG(INFO) << "+++ checking for hole at " << topIndex-1
-                    << " (cookie=" << cookie << ") val=" << table_[topIndex - 1];
+                    << " (cookie=" << cookie << ") val=" << Entry(topIndex - 1);
         }
-        if (table_[topIndex-1] != NULL) {
+        if (Entry(topIndex - 1) != NULL) {
           break;
         }
         if (false) {
@@ -290,7 +300,7 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
     // Not the top-most entry.  This creates a hole.  We NULL out the
     // entry to prevent somebody from deleting it twice and screwing up
     // the hole count.
-    if (table_[idx] == NULL) {
+    if (Entry(idx) == NULL) {
       LOG(INFO) << "--- WEIRD: removing null entry " << idx;
       return false;
     }
@@ -298,7 +308,8 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
       return false;
     }
 
-    table_[idx] = NULL;
+    Entry(idx) = NULL;
+    last_hole_index_ = idx;
     segment_state_.parts.numHoles++;
     if (false) {
       LOG(INFO) << "+++ left hole at " << idx << ", holes=" << segment_state_.parts.numHoles;
@@ -316,14 +327,103 @@ void IndirectReferenceTable::VisitRoots(RootVisitor* visitor, void* arg) {
 
 void IndirectReferenceTable::Dump(std::ostream& os) const {
   os << kind_ << " table dump:\n";
-  std::vector<const mirror::Object*> entries(table_, table_ + Capacity());
-  // Remove NULLs.
-  for (int i = entries.size() - 1; i >= 0; --i) {
-    if (entries[i] == NULL) {
-      entries.erase(entries.begin() + i);
+  std::vector<const mirror::Object*> entries;
+  AppendEntries(&entries);
+  ReferenceTable::Dump(os, entries);
+}
+
+void IndirectReferenceTable::AppendEntries(std::vector<const mirror::Object*>* entries) const {
+  for (size_t i = 0; i < Capacity(); ++i) {
+    // Skip NULLs.
+    if (Entry(i) != NULL) {
+      entries->push_back(Entry(i));
     }
   }
+}
+
+StripedIndirectReferenceTable::Stripe::Stripe(size_t initialCount, size_t maxCount,
+                                              IndirectRefKind kind, uint32_t stripe)
+    : lock("JNI global reference table lock"),
+      table(initialCount, maxCount, kind, stripe) {
+}
+
+StripedIndirectReferenceTable::StripedIndirectReferenceTable(size_t initialCount,
+                                                             size_t maxCount,
+                                                             IndirectRefKind kind)
+    : size_(0), max_entries_(maxCount), kind_(kind) {
+  // Every stripe may grow to the overall maximum; the total is checked in Add.
+  size_t stripeInitialCount = std::max<size_t>(initialCount / kStripes, 1);
+  for (size_t i = 0; i < kStripes; ++i) {
+    stripes_[i] = new Stripe(stripeInitialCount, maxCount, kind, i);
+  }
+}
+
+StripedIndirectReferenceTable::~StripedIndirectReferenceTable() {
+  for (size_t i = 0; i < kStripes; ++i) {
+    delete stripes_[i];
+  }
+}
+
+IndirectRef StripedIndirectReferenceTable::Add(Thread* self, const mirror::Object* obj) {
+  if (static_cast<size_t>(android_atomic_inc(&size_)) >= max_entries_) {
+    android_atomic_dec(&size_);
+    LOG(FATAL) << "JNI ERROR (app bug): " << kind_ << " table overflow "
+               << "(max=" << max_entries_ << ")\n"
+               << MutatorLockedDumpable<StripedIndirectReferenceTable>(*this);
+  }
+  // Threads stay on one stripe so that a thread's add and remove pairs don't bounce locks.
+  Stripe* stripe = stripes_[static_cast<uint32_t>(self->GetTid()) % kStripes];
+  WriterMutexLock mu(self, stripe->lock);
+  return stripe->table.Add(IRT_FIRST_SEGMENT, obj);
+}
+
+bool StripedIndirectReferenceTable::Remove(Thread* self, IndirectRef iref) {
+  if (UNLIKELY(GetIndirectRefKind(iref) == kSirtOrInvalid)) {
+    // Not one of ours, so the stripe bits mean nothing; let every stripe look for it.
+    for (size_t i = 0; i < kStripes; ++i) {
+      WriterMutexLock mu(self, stripes_[i]->lock);
+      if (stripes_[i]->table.Remove(IRT_FIRST_SEGMENT, iref)) {
+        android_atomic_dec(&size_);
+        return true;
+      }
+    }
+    return false;
+  }
+  Stripe* stripe = stripes_[IndirectReferenceTable::ExtractStripe(iref)];
+  WriterMutexLock mu(self, stripe->lock);
+  if (!stripe->table.Remove(IRT_FIRST_SEGMENT, iref)) {
+    return false;
+  }
+  android_atomic_dec(&size_);
+  return true;
+}
+
+size_t StripedIndirectReferenceTable::Capacity(Thread* self) const {
+  size_t capacity = 0;
+  for (size_t i = 0; i < kStripes; ++i) {
+    ReaderMutexLock mu(self, stripes_[i]->lock);
+    capacity += stripes_[i]->table.Capacity();
+  }
+  return capacity;
+}
+
+void StripedIndirectReferenceTable::Dump(std::ostream& os) const {
+  Thread* self = Thread::Current();
+  os << kind_ << " table dump:\n";
+  std::vector<const mirror::Object*> entries;
+  for (size_t i = 0; i < kStripes; ++i) {
+    ReaderMutexLock mu(self, stripes_[i]->lock);
+    stripes_[i]->table.AppendEntries(&entries);
+  }
   ReferenceTable::Dump(os, entries);
 }
 
+void StripedIndirectReferenceTable::VisitRoots(RootVisitor* visitor, void* arg) {
+  Thread* self = Thread::Current();
+  for (size_t i = 0; i < kStripes; ++i) {
+    ReaderMutexLock mu(self, stripes_[i]->lock);
+    stripes_[i]->table.VisitRoots(visitor, arg);
+  }
+}
+
 }  // namespace art
@@ -21,8 +21,10 @@
 
 #include <iosfwd>
 #include <string>
+#include <vector>
 
 #include "base/logging.h"
+#include "base/mutex.h"
 #include "offsets.h"
 #include "root_visitor.h"
 
@@ -71,7 +73,8 @@ class Object;
  * To make everything fit nicely in 32-bit integers, the maximum size of
  * the table is capped at 64K.
  *
- * None of the table functions are synchronized.
+ * None of the table functions are synchronized.  StripedIndirectReferenceTable
+ * below spreads global references over several locked tables.
  */
 
 /*
@@ -81,9 +84,10 @@ class Object;
  * We need a 16-bit table index and a 2-bit reference type (global, local,
  * weak global).  Real object pointers will have zeroes in the low 2 or 3
  * bits (4- or 8-byte alignment), so it's useful to put the ref type
- * in the low bits and reserve zero as an invalid value.
+ * in the low bits and reserve zero as an invalid value.  Bits 18 and 19
+ * hold the stripe number of references from striped tables.
  *
- * The remaining 14 bits can be used to detect stale indirect references.
+ * The remaining 12 bits can be used to detect stale indirect references.
  * For example, if objects don't move, we can use a hash of the original
  * Object* to make sure the entry hasn't been re-used.  (If the Object*
  * we find there doesn't match because of heap movement, we could do a
@@ -144,10 +148,9 @@ static const uint32_t IRT_FIRST_SEGMENT = 0;
  * most-recently-added entry).  For JNI local references, the common
  * operations are adding a new entry and removing an entire table segment.
  *
- * If "alloc_entries_" is not equal to "max_entries_", the table may expand
- * when entries are added, which means the memory may move.  If you want
- * to keep pointers into "table" rather than offsets, you must use a
- * fixed-size table.
+ * The table is stored in fixed-size chunks that are allocated as the table
+ * grows and kept until it is destroyed.  Growing never copies entries, so
+ * pointers to entries stay valid and adding is O(1) even when it grows.
  *
  * If we delete entries from the middle of the list, we will be left with
  * "holes".  We track the number of holes so that, when adding new elements,
@@ -181,20 +184,17 @@ static const uint32_t IRT_FIRST_SEGMENT = 0;
  * stale references aren't possible (though we may be able to get similar
  * benefits with other approaches).
  *
- * TODO: consider a "lastDeleteIndex" for quick hole-filling when an
- * add immediately follows a delete; must invalidate after segment pop
- * (which could increase the cost/complexity of method call/return).
- * Might be worth only using it for JNI globals.
+ * The index of the most recent hole is remembered so that an add that
+ * follows a delete fills it without scanning.  Any null entry between the
+ * bottom and top of the current segment is a hole, so the hint needs no
+ * invalidation when segments are popped; it is simply checked before use.
  *
  * TODO: may want completely different add/remove algorithms for global
  * and local refs to improve performance.  A large circular buffer might
  * reduce the amortized cost of adding global references.
  *
- * TODO: if we can guarantee that the underlying storage doesn't move,
- * e.g. by using oversized mmap regions to handle expanding tables, we may
- * be able to avoid having to synchronize lookups.  Might make sense to
- * add a "synchronized lookup" call that takes the mutex as an argument,
- * and either locks or doesn't lock based on internal details.
+ * TODO: now that the underlying storage doesn't move we may be able to
+ * avoid having to synchronize lookups.
  */
 union IRTSegmentState {
   uint32_t          all;
@@ -204,9 +204,11 @@ union IRTSegmentState {
   } parts;
 };
 
+class IndirectReferenceTable;
+
 class IrtIterator {
  public:
-  explicit IrtIterator(const mirror::Object** table, size_t i, size_t capacity)
+  IrtIterator(const IndirectReferenceTable* table, size_t i, size_t capacity)
       : table_(table), i_(i), capacity_(capacity) {
     SkipNullsAndTombstones();
   }
@@ -217,23 +219,16 @@ class IrtIterator {
     return *this;
   }
 
-  const mirror::Object** operator*() {
-    return &table_[i_];
-  }
+  inline const mirror::Object** operator*();
 
   bool equals(const IrtIterator& rhs) const {
     return (i_ == rhs.i_ && table_ == rhs.table_);
   }
 
  private:
-  void SkipNullsAndTombstones() {
-    // We skip NULLs and tombstones. Clients don't want to see implementation details.
-    while (i_ < capacity_ && (table_[i_] == NULL || table_[i_] == kClearedJniWeakGlobal)) {
-      ++i_;
-    }
-  }
+  inline void SkipNullsAndTombstones();
 
-  const mirror::Object** table_;
+  const IndirectReferenceTable* table_;
   size_t i_;
   size_t capacity_;
 };
@@ -248,7 +243,9 @@ bool inline operator!=(const IrtIterator& lhs, const IrtIterator& rhs) {
 
 class IndirectReferenceTable {
  public:
-  IndirectReferenceTable(size_t initialCount, size_t maxCount, IndirectRefKind kind);
+  // Stripe is ORed into the references handed out, see StripedIndirectReferenceTable.
+  IndirectReferenceTable(size_t initialCount, size_t maxCount, IndirectRefKind kind,
+                         uint32_t stripe = 0);
 
   ~IndirectReferenceTable();
 
@@ -270,7 +267,7 @@ class IndirectReferenceTable {
     if (!GetChecked(iref)) {
       return kInvalidIndirectRefObject;
     }
-    return table_[ExtractIndex(iref)];
+    return Entry(ExtractIndex(iref));
   }
 
   // TODO: remove when we remove work_around_app_jni_bugs support.
@@ -300,11 +297,11 @@ class IndirectReferenceTable {
   }
 
   IrtIterator begin() {
-    return IrtIterator(table_, 0, Capacity());
+    return IrtIterator(this, 0, Capacity());
   }
 
   IrtIterator end() {
-    return IrtIterator(table_, Capacity(), Capacity());
+    return IrtIterator(this, Capacity(), Capacity());
   }
 
   void VisitRoots(RootVisitor* visitor, void* arg);
@@ -317,11 +314,44 @@ class IndirectReferenceTable {
     segment_state_.all = new_state;
   }
 
+  /*
+   * Starts a new segment (a local reference frame) on top of the current one
+   * and returns the cookie to pass to Add, Remove and PopFrame.  Neither
+   * pushing nor popping touches the entries.
+   */
+  uint32_t PushFrame() const {
+    return segment_state_.all;
+  }
+
+  /*
+   * Discards every entry added since the PushFrame that returned cookie.
+   */
+  void PopFrame(uint32_t cookie) {
+    segment_state_.all = cookie;
+  }
+
   static Offset SegmentStateOffset() {
     return Offset(OFFSETOF_MEMBER(IndirectReferenceTable, segment_state_));
   }
 
+  /*
+   * Extract the stripe number from an indirect reference.
+   */
+  static uint32_t ExtractStripe(IndirectRef iref) {
+    uint32_t uref = (uint32_t) iref;
+    return (uref >> 18) & 0x3;
+  }
+
  private:
+  static const size_t kChunkShift = 6;
+  static const size_t kChunkSize = 1 << kChunkShift;
+
+  // The entries and their extended debugging info.
+  struct Chunk {
+    const mirror::Object* entries[kChunkSize];
+    IndirectRefSlot slot_data[kChunkSize];
+  };
+
   /*
    * Extract the table index from an indirect reference.
    */
@@ -330,14 +360,31 @@ class IndirectReferenceTable {
     return (uref >> 2) & 0xffff;
   }
 
+  const mirror::Object*& Entry(size_t index) const {
+    return chunks_[index >> kChunkShift]->entries[index & (kChunkSize - 1)];
+  }
+
+  IndirectRefSlot& Slot(size_t index) const {
+    return chunks_[index >> kChunkShift]->slot_data[index & (kChunkSize - 1)];
+  }
+
+  // Allocates chunks until there is room for at least count entries.
+  void Reserve(size_t count);
+
+  // Returns the index of direct_pointer between bottomIndex and topIndex, or -1.
+  int Find(mirror::Object* direct_pointer, int bottomIndex, int topIndex) const;
+
+  // Appends the non-null entries to entries, for dumping.
+  void AppendEntries(std::vector<const mirror::Object*>* entries) const;
+
   /*
    * The object pointer itself is subject to relocation in some GC
    * implementations, so we shouldn't really be using it here.
    */
   IndirectRef ToIndirectRef(const mirror::Object* /*o*/, uint32_t tableIndex) const {
     DCHECK_LT(tableIndex, 65536U);
-    uint32_t serialChunk = slot_data_[tableIndex].serial;
-    uint32_t uref = serialChunk << 20 | (tableIndex << 2) | kind_;
+    uint32_t serialChunk = Slot(tableIndex).serial;
+    uint32_t uref = serialChunk << 20 | stripe_ << 18 | (tableIndex << 2) | kind_;
     return (IndirectRef) uref;
   }
 
@@ -348,11 +395,9 @@ class IndirectReferenceTable {
    * this slot.
    */
   void UpdateSlotAdd(const mirror::Object* obj, int slot) {
-    if (slot_data_ != NULL) {
-      IndirectRefSlot* pSlot = &slot_data_[slot];
-      pSlot->serial++;
-      pSlot->previous[pSlot->serial % kIRTPrevCount] = obj;
-    }
+    IndirectRefSlot* pSlot = &Slot(slot);
+    pSlot->serial++;
+    pSlot->previous[pSlot->serial % kIRTPrevCount] = obj;
   }
 
   /* extra debugging checks */
@@ -362,16 +407,82 @@ class IndirectReferenceTable {
   /* semi-public - read/write by jni down calls */
   IRTSegmentState segment_state_;
 
-  /* bottom of the stack */
-  const mirror::Object** table_;
+  /* the chunks holding the entries, max_entries_ rounded up to whole chunks */
+  Chunk** chunks_;
   /* bit mask, ORed into all irefs */
   IndirectRefKind kind_;
-  /* extended debugging info */
-  IndirectRefSlot* slot_data_;
+  /* stripe number, ORed into all irefs */
+  uint32_t stripe_;
+  /* index of the most recently made hole, may be stale */
+  size_t last_hole_index_;
   /* #of entries we have space for */
   size_t alloc_entries_;
   /* max #of entries allowed */
   size_t max_entries_;
+
+  friend class IrtIterator;
+  friend class StripedIndirectReferenceTable;
+};
+
+inline const mirror::Object** IrtIterator::operator*() {
+  return &table_->Entry(i_);
+}
+
+inline void IrtIterator::SkipNullsAndTombstones() {
+  // We skip NULLs and tombstones. Clients don't want to see implementation details.
+  while (i_ < capacity_ &&
+         (table_->Entry(i_) == NULL || table_->Entry(i_) == kClearedJniWeakGlobal)) {
+    ++i_;
+  }
+}
+
+/*
+ * Global references spread over several tables, each with its own lock, so
+ * that threads adding and removing global references concurrently rarely
+ * contend.  A thread adds to the stripe picked by its tid, and the stripe
+ * number is encoded in the references so that any thread can find the entry
+ * again.  The maximum number of entries applies to all stripes together.
+ */
+class StripedIndirectReferenceTable {
+ public:
+  static const size_t kStripes = 4;
+
+  StripedIndirectReferenceTable(size_t initialCount, size_t maxCount, IndirectRefKind kind);
+  ~StripedIndirectReferenceTable();
+
+  IndirectRef Add(Thread* self, const mirror::Object* obj)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  const mirror::Object* Get(Thread* self, IndirectRef iref) const {
+    Stripe* stripe = stripes_[IndirectReferenceTable::ExtractStripe(iref)];
+    ReaderMutexLock mu(self, stripe->lock);
+    return stripe->table.Get(iref);
+  }
+
+  bool Remove(Thread* self, IndirectRef iref);
+
+  // The number of entries in all stripes, including holes.
+  size_t Capacity(Thread* self) const;
+
+  void Dump(std::ostream& os) const SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  void VisitRoots(RootVisitor* visitor, void* arg);
+
+ private:
+  struct Stripe {
+    Stripe(size_t initialCount, size_t maxCount, IndirectRefKind kind, uint32_t stripe);
+
+    ReaderWriterMutex lock DEFAULT_MUTEX_ACQUIRED_AFTER;
+    IndirectReferenceTable table GUARDED_BY(lock);
+  };
+
+  Stripe* stripes_[kStripes];
+  // Entries in all stripes, checked against max_entries_ as entries are added.
+  volatile int32_t size_;
+  const size_t max_entries_;
+  const IndirectRefKind kind_;
+
+  DISALLOW_COPY_AND_ASSIGN(StripedIndirectReferenceTable);
 };
 
 }  // namespace art
@@ -249,4 +249,156 @@ TEST_F(IndirectReferenceTableTest, BasicTest) {
   CheckDump(&irt, 0, 0);
 }
 
+TEST_F(IndirectReferenceTableTest, GrowthDoesNotMoveEntries) {
+  ScopedObjectAccess soa(Thread::Current());
+  static const size_t kTableInitial = 4;
+  static const size_t kTableMax = 1000;
+  IndirectReferenceTable irt(kTableInitial, kTableMax, kLocal);
+
+  mirror::Class* c = class_linker_->FindSystemClass("Ljava/lang/Object;");
+  ASSERT_TRUE(c != NULL);
+  mirror::Object* obj0 = c->AllocObject(soa.Self());
+  ASSERT_TRUE(obj0 != NULL);
+
+  const uint32_t cookie = IRT_FIRST_SEGMENT;
+  IndirectRef first = irt.Add(cookie, obj0);
+  const mirror::Object** first_entry = *irt.begin();
+  IndirectRef refs[kTableMax - 1];
+  for (size_t i = 0; i < kTableMax - 1; ++i) {
+    refs[i] = irt.Add(cookie, obj0);
+    ASSERT_TRUE(refs[i] != NULL) << "Failed adding " << i;
+  }
+  EXPECT_EQ(kTableMax, irt.Capacity());
+  EXPECT_EQ(first_entry, *irt.begin());
+  EXPECT_EQ(obj0, irt.Get(first));
+  EXPECT_EQ(obj0, irt.Get(refs[kTableMax - 2]));
+  CheckDump(&irt, kTableMax, 1);
+
+  for (size_t i = kTableMax - 1; i > 0; --i) {
+    ASSERT_TRUE(irt.Remove(cookie, refs[i - 1])) << "failed removing " << i;
+  }
+  ASSERT_TRUE(irt.Remove(cookie, first));
+  EXPECT_EQ(0U, irt.Capacity());
+}
+
+TEST_F(IndirectReferenceTableTest, FullTableReusesHoles) {
+  ScopedObjectAccess soa(Thread::Current());
+  // Not a multiple of the chunk size, so the last chunk has room past the maximum.
+  static const size_t kTableMax = 100;
+  IndirectReferenceTable irt(1, kTableMax, kLocal);
+
+  mirror::Class* c = class_linker_->FindSystemClass("Ljava/lang/Object;");
+  ASSERT_TRUE(c != NULL);
+  mirror::Object* obj0 = c->AllocObject(soa.Self());
+  ASSERT_TRUE(obj0 != NULL);
+
+  const uint32_t cookie = IRT_FIRST_SEGMENT;
+  IndirectRef refs[kTableMax];
+  for (size_t i = 0; i < kTableMax; ++i) {
+    refs[i] = irt.Add(cookie, obj0);
+    ASSERT_TRUE(refs[i] != NULL) << "Failed adding " << i;
+  }
+  EXPECT_EQ(kTableMax, irt.Capacity());
+
+  // A full table still fills its holes.
+  ASSERT_TRUE(irt.Remove(cookie, refs[kTableMax / 2]));
+  refs[kTableMax / 2] = irt.Add(cookie, obj0);
+  ASSERT_TRUE(refs[kTableMax / 2] != NULL);
+  EXPECT_EQ(kTableMax, irt.Capacity());
+  EXPECT_EQ(obj0, irt.Get(refs[kTableMax / 2]));
+
+  for (size_t i = kTableMax; i > 0; --i) {
+    ASSERT_TRUE(irt.Remove(cookie, refs[i - 1])) << "failed removing " << i;
+  }
+  EXPECT_EQ(0U, irt.Capacity());
+}
+
+TEST_F(IndirectReferenceTableTest, HoleReuse) {
+  ScopedObjectAccess soa(Thread::Current());
+  IndirectReferenceTable irt(10, 100, kGlobal);
+
+  mirror::Class* c = class_linker_->FindSystemClass("Ljava/lang/Object;");
+  ASSERT_TRUE(c != NULL);
+  mirror::Object* obj0 = c->AllocObject(soa.Self());
+  ASSERT_TRUE(obj0 != NULL);
+  mirror::Object* obj1 = c->AllocObject(soa.Self());
+  ASSERT_TRUE(obj1 != NULL);
+
+  const uint32_t cookie = IRT_FIRST_SEGMENT;
+  IndirectRef refs[5];
+  for (size_t i = 0; i < 5; ++i) {
+    refs[i] = irt.Add(cookie, obj0);
+  }
+  // Deleting from the middle leaves holes that later adds fill before growing the table.
+  ASSERT_TRUE(irt.Remove(cookie, refs[1]));
+  ASSERT_TRUE(irt.Remove(cookie, refs[3]));
+  EXPECT_EQ(5U, irt.Capacity());
+  IndirectRef hole3 = irt.Add(cookie, obj1);
+  IndirectRef hole1 = irt.Add(cookie, obj1);
+  EXPECT_EQ(5U, irt.Capacity());
+  EXPECT_EQ(obj1, irt.Get(hole3));
+  EXPECT_EQ(obj1, irt.Get(hole1));
+  CheckDump(&irt, 5, 2);
+
+  // The stale references to the old occupants are detected.
+  EXPECT_NE(refs[3], hole3);
+  EXPECT_NE(refs[1], hole1);
+}
+
+TEST_F(IndirectReferenceTableTest, PushPopFrame) {
+  ScopedObjectAccess soa(Thread::Current());
+  IndirectReferenceTable irt(10, 100, kLocal);
+
+  mirror::Class* c = class_linker_->FindSystemClass("Ljava/lang/Object;");
+  ASSERT_TRUE(c != NULL);
+  mirror::Object* obj0 = c->AllocObject(soa.Self());
+  ASSERT_TRUE(obj0 != NULL);
+
+  IndirectRef outer = irt.Add(IRT_FIRST_SEGMENT, obj0);
+  uint32_t cookie = irt.PushFrame();
+  for (size_t i = 0; i < 70; ++i) {
+    irt.Add(cookie, obj0);
+  }
+  EXPECT_EQ(71U, irt.Capacity());
+  // Entries of outer frames can't be removed from an inner one.
+  EXPECT_FALSE(irt.Remove(cookie, outer));
+  irt.PopFrame(cookie);
+  EXPECT_EQ(1U, irt.Capacity());
+  EXPECT_EQ(obj0, irt.Get(outer));
+  ASSERT_TRUE(irt.Remove(IRT_FIRST_SEGMENT, outer));
+  EXPECT_EQ(0U, irt.Capacity());
+}
+
+TEST_F(IndirectReferenceTableTest, StripedTable) {
+  ScopedObjectAccess soa(Thread::Current());
+  Thread* self = soa.Self();
+  StripedIndirectReferenceTable irt(16, 100, kGlobal);
+
+  mirror::Class* c = class_linker_->FindSystemClass("Ljava/lang/Object;");
+  ASSERT_TRUE(c != NULL);
+  mirror::Object* obj0 = c->AllocObject(self);
+  ASSERT_TRUE(obj0 != NULL);
+  mirror::Object* obj1 = c->AllocObject(self);
+  ASSERT_TRUE(obj1 != NULL);
+
+  IndirectRef iref0 = irt.Add(self, obj0);
+  IndirectRef iref1 = irt.Add(self, obj1);
+  EXPECT_EQ(kGlobal, GetIndirectRefKind(iref0));
+  EXPECT_EQ(static_cast<uint32_t>(self->GetTid()) % StripedIndirectReferenceTable::kStripes,
+            IndirectReferenceTable::ExtractStripe(iref0));
+  EXPECT_EQ(obj0, irt.Get(self, iref0));
+  EXPECT_EQ(obj1, irt.Get(self, iref1));
+  EXPECT_EQ(2U, irt.Capacity(self));
+
+  std::ostringstream oss;
+  irt.Dump(oss);
+  EXPECT_NE(oss.str().find("2 of java.lang.Object (2 unique instances)"), std::string::npos)
+      << oss.str();
+
+  EXPECT_TRUE(irt.Remove(self, iref1));
+  EXPECT_FALSE(irt.Remove(self, iref1));
+  EXPECT_TRUE(irt.Remove(self, iref0));
+  EXPECT_EQ(0U, irt.Capacity(self));
+}
+
 }  // namespace art
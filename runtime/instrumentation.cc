@@ -93,6 +93,11 @@ bool Instrumentation::InstallStubsForClass(mirror::Class* klass) {
           new_code = GetCompiledCodeToInterpreterBridge();
         }
       }
+      if (UNLIKELY(method->IsRedispatched())) {
+        // The redispatch trampoline enters it through new_code.
+        method->SetEntryPointFromRedispatch(new_code);
+        new_code = GetQuickRedispatchTrampoline();
+      }
       method->SetEntryPointFromCompiledCode(new_code);
     }
   }
@@ -394,7 +399,8 @@ const void* Instrumentation::GetQuickCodeFor(const mirror::ArtMethod* method) co
     const void* code = method->GetEntryPointFromCompiledCode();
     DCHECK(code != NULL);
     if (LIKELY(code != GetQuickResolutionTrampoline(runtime->GetClassLinker()) &&
-               code != GetQuickToInterpreterBridge())) {
+               code != GetQuickToInterpreterBridge() &&
+               code != GetQuickRedispatchTrampoline())) {
       return code;
     }
   }
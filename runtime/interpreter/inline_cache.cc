@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "inline_cache.h"
+
+#include "base/stl_util.h"
+#include "dex_instruction.h"
+#include "thread.h"
+#include "utils.h"
+
+namespace art {
+namespace interpreter {
+
+// Counts the instructions of code_item that may use an inline cache entry.
+static size_t CountCacheableInstructions(const DexFile::CodeItem* code_item) {
+  size_t count = 0;
+  const uint16_t* insns = code_item->insns_;
+  const uint16_t* end = insns + code_item->insns_size_in_code_units_;
+  while (insns < end) {
+    const Instruction* inst = Instruction::At(insns);
+    switch (inst->Opcode()) {
+      case Instruction::IGET ... Instruction::SPUT_SHORT:
+      case Instruction::INVOKE_VIRTUAL ... Instruction::INVOKE_INTERFACE:
+      case Instruction::INVOKE_VIRTUAL_RANGE ... Instruction::INVOKE_INTERFACE_RANGE:
+        ++count;
+        break;
+      default:
+        break;
+    }
+    insns += inst->SizeInCodeUnits();
+  }
+  return count;
+}
+
+// Sizes the cache to at most half full so that probe sequences stay short.
+static size_t InlineCacheCapacity(const DexFile::CodeItem* code_item) {
+  return RoundUpToPowerOfTwo(std::max<size_t>(CountCacheableInstructions(code_item) * 2, 1));
+}
+
+InlineCache::InlineCache(const DexFile::CodeItem* code_item)
+    : mask_(InlineCacheCapacity(code_item) - 1), entries_(new Entry[mask_ + 1]) {
+  for (size_t i = 0; i <= mask_; ++i) {
+    entries_[i].tag = kEmpty;
+    entries_[i].klass = NULL;
+    entries_[i].target = NULL;
+  }
+}
+
+void InlineCache::Put(uint32_t dex_pc, const mirror::Class* klass, void* target) {
+  for (size_t i = 0, index = dex_pc & mask_; i <= mask_; ++i, index = (index + 1) & mask_) {
+    Entry* entry = &entries_[index];
+    while (true) {
+      int32_t tag = android_atomic_acquire_load(&entry->tag);
+      if (tag == static_cast<int32_t>(dex_pc)) {
+        // Already cached, entries are never replaced.
+        return;
+      } else if (tag != kEmpty) {
+        // Taken by another dex pc, or being filled in by another thread.
+        break;
+      } else if (android_atomic_cas(kEmpty, kClaimed, &entry->tag) == 0) {
+        // Fill in the entry before publishing its dex pc to readers.
+        entry->klass = klass;
+        entry->target = target;
+        android_atomic_release_store(static_cast<int32_t>(dex_pc), &entry->tag);
+        return;
+      }
+    }
+  }
+  // Every slot is taken, leave this dex pc uncached.
+}
+
+InlineCacheTable::InlineCacheTable()
+    : enabled_(true), lock_("interpreter inline cache table lock", kDefaultMutexLevel) {
+}
+
+InlineCacheTable::~InlineCacheTable() {
+  STLDeleteValues(&caches_);
+}
+
+InlineCache* InlineCacheTable::GetInlineCache(const mirror::ArtMethod* method,
+                                              const DexFile::CodeItem* code_item) {
+  if (UNLIKELY(!enabled_)) {
+    return NULL;
+  }
+  Thread* self = Thread::Current();
+  {
+    ReaderMutexLock mu(self, lock_);
+    SafeMap<const mirror::ArtMethod*, InlineCache*>::const_iterator it = caches_.find(method);
+    if (LIKELY(it != caches_.end())) {
+      return it->second;
+    }
+  }
+  WriterMutexLock mu(self, lock_);
+  SafeMap<const mirror::ArtMethod*, InlineCache*>::const_iterator it = caches_.find(method);
+  if (it != caches_.end()) {
+    // Created by another thread while we weren't holding the lock.
+    return it->second;
+  }
+  InlineCache* inline_cache = new InlineCache(code_item);
+  caches_.Put(method, inline_cache);
+  return inline_cache;
+}
+
+void InlineCacheTable::DumpForSigQuit(std::ostream& os) const {
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  size_t entries = 0;
+  for (SafeMap<const mirror::ArtMethod*, InlineCache*>::const_iterator it = caches_.begin();
+       it != caches_.end(); ++it) {
+    entries += it->second->Capacity();
+  }
+  os << "Interpreter inline caches: " << caches_.size() << " methods, " << entries
+     << " entries\n";
+}
+
+}  // namespace interpreter
+}  // namespace art
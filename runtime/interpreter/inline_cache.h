@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_INTERPRETER_INLINE_CACHE_H_
+#define ART_RUNTIME_INTERPRETER_INLINE_CACHE_H_
+
+#include <iosfwd>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "cutils/atomic.h"
+#include "cutils/atomic-inline.h"
+#include "dex_file.h"
+#include "safe_map.h"
+#include "UniquePtr.h"
+
+namespace art {
+namespace mirror {
+class ArtField;
+class ArtMethod;
+class Class;
+}  // namespace mirror
+
+namespace interpreter {
+
+// Inline caches for the invoke and field access instructions of one method, keyed by dex pc.
+// An entry is filled once, after the first successful resolution at its dex pc, and then never
+// changes, so interpreting threads read entries without locking. Virtual and interface invokes
+// remember the receiver class they were resolved for and miss for any other class. Field accesses
+// and other invokes don't depend on the receiver. Classes, methods and fields are neither moved
+// nor unloaded, so the cache holds no roots.
+class InlineCache {
+ public:
+  explicit InlineCache(const DexFile::CodeItem* code_item);
+
+  // Returns the method cached at dex_pc for receivers of class klass, or NULL.
+  mirror::ArtMethod* GetMethod(uint32_t dex_pc, const mirror::Class* klass) const {
+    const Entry* entry = Find(dex_pc);
+    if (entry == NULL || entry->klass != klass) {
+      return NULL;
+    }
+    return reinterpret_cast<mirror::ArtMethod*>(entry->target);
+  }
+
+  void PutMethod(uint32_t dex_pc, const mirror::Class* klass, mirror::ArtMethod* method) {
+    Put(dex_pc, klass, method);
+  }
+
+  // Returns the field cached at dex_pc, or NULL.
+  mirror::ArtField* GetField(uint32_t dex_pc) const {
+    const Entry* entry = Find(dex_pc);
+    return (entry == NULL) ? NULL : reinterpret_cast<mirror::ArtField*>(entry->target);
+  }
+
+  void PutField(uint32_t dex_pc, mirror::ArtField* field) {
+    Put(dex_pc, NULL, field);
+  }
+
+  size_t Capacity() const {
+    return mask_ + 1;
+  }
+
+ private:
+  // Tags of entries that hold no dex pc yet.
+  static const int32_t kEmpty = -1;
+  static const int32_t kClaimed = -2;
+
+  struct Entry {
+    // The dex pc of the entry once published, or one of kEmpty or kClaimed.
+    volatile int32_t tag;
+    const mirror::Class* klass;
+    void* target;
+  };
+
+  const Entry* Find(uint32_t dex_pc) const {
+    for (size_t i = 0, index = dex_pc & mask_; i <= mask_; ++i, index = (index + 1) & mask_) {
+      const Entry* entry = &entries_[index];
+      int32_t tag = android_atomic_acquire_load(&entry->tag);
+      if (tag == static_cast<int32_t>(dex_pc)) {
+        return entry;
+      } else if (tag == kEmpty) {
+        return NULL;
+      }
+    }
+    return NULL;
+  }
+
+  void Put(uint32_t dex_pc, const mirror::Class* klass, void* target);
+
+  // Capacity minus one, the capacity being a power of two.
+  const size_t mask_;
+  UniquePtr<Entry[]> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(InlineCache);
+};
+
+// Owns the inline caches of every interpreted method.
+class InlineCacheTable {
+ public:
+  InlineCacheTable();
+  ~InlineCacheTable();
+
+  // Returns the inline cache of method, creating it the first time the method is interpreted.
+  // Returns NULL when inline caches are disabled.
+  InlineCache* GetInlineCache(const mirror::ArtMethod* method, const DexFile::CodeItem* code_item)
+      LOCKS_EXCLUDED(lock_);
+
+  // Enables or disables the use of inline caches by the interpreter, for benchmarking.
+  void SetEnabled(bool enabled) {
+    enabled_ = enabled;
+  }
+
+  void DumpForSigQuit(std::ostream& os) const LOCKS_EXCLUDED(lock_);
+
+ private:
+  bool enabled_;
+  mutable ReaderWriterMutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  SafeMap<const mirror::ArtMethod*, InlineCache*> caches_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(InlineCacheTable);
+};
+
+}  // namespace interpreter
+}  // namespace art
+
+#endif  // ART_RUNTIME_INTERPRETER_INLINE_CACHE_H_
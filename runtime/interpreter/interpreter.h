@@ -33,6 +33,17 @@ class Thread;
 
 namespace interpreter {
 
+enum InterpreterImplKind {
+  kSwitchImpl,            // Switch-based interpreter implementation.
+  kComputedGotoImplKind   // Computed-goto-based (threaded) interpreter implementation.
+};
+std::ostream& operator<<(std::ostream& os, const InterpreterImplKind& rhs);
+
+// Selects the implementation used for subsequent interpretation, for benchmarking and tests. The
+// default is chosen at build time.
+extern void SetInterpreterImplKind(InterpreterImplKind kind);
+extern InterpreterImplKind GetInterpreterImplKind();
+
 // Called by ArtMethod::Invoke, shadow frames arguments are taken from the args array.
 extern void EnterInterpreterFromInvoke(Thread* self, mirror::ArtMethod* method,
                                        mirror::Object* receiver, uint32_t* args, JValue* result)
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interpreter.h"
+
+#include "common_test.h"
+#include "inline_cache.h"
+#include "mirror/art_method-inl.h"
+#include "mirror/class-inl.h"
+#include "sirt_ref.h"
+#include "utils.h"
+
+namespace art {
+namespace interpreter {
+
+class InterpreterTest : public CommonTest {
+ protected:
+  mirror::ArtMethod* FindLoopMethod(const char* name) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    jobject jclass_loader = LoadDex("InterpreterLoop");
+    SirtRef<mirror::ClassLoader> class_loader(Thread::Current(),
+        ScopedObjectAccessUnchecked(Thread::Current()).Decode<mirror::ClassLoader*>(jclass_loader));
+    mirror::Class* c = class_linker_->FindClass("LInterpreterLoop;", class_loader.get());
+    CHECK(c != NULL);
+    mirror::ArtMethod* method = c->FindDirectMethod(name, "(I)I");
+    CHECK(method != NULL);
+    return method;
+  }
+
+  // Interprets the InterpreterLoop method with the given implementation, returning its result and
+  // storing the elapsed time in nanoseconds in *ns.
+  int32_t RunLoop(mirror::ArtMethod* method, InterpreterImplKind kind, uint32_t n, uint64_t* ns)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    InterpreterImplKind old_kind = GetInterpreterImplKind();
+    SetInterpreterImplKind(kind);
+    uint32_t args[1] = { n };
+    JValue result;
+    uint64_t start = NanoTime();
+    EnterInterpreterFromInvoke(Thread::Current(), method, NULL, args, &result);
+    *ns = NanoTime() - start;
+    SetInterpreterImplKind(old_kind);
+    CHECK(!Thread::Current()->IsExceptionPending());
+    return result.GetI();
+  }
+};
+
+TEST_F(InterpreterTest, ImplementationsAgree) {
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::ArtMethod* method = FindLoopMethod("loop");
+  for (uint32_t n = 0; n < 40; ++n) {
+    uint64_t ns;
+    EXPECT_EQ(RunLoop(method, kSwitchImpl, n, &ns), RunLoop(method, kComputedGotoImplKind, n, &ns))
+        << n;
+  }
+}
+
+TEST_F(InterpreterTest, DISABLED_DispatchBenchmark) {
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::ArtMethod* method = FindLoopMethod("loop");
+  static const uint32_t kIterations = 1000000;
+  uint64_t switch_ns;
+  int32_t switch_result = RunLoop(method, kSwitchImpl, kIterations, &switch_ns);
+  uint64_t goto_ns;
+  int32_t goto_result = RunLoop(method, kComputedGotoImplKind, kIterations, &goto_ns);
+  EXPECT_EQ(switch_result, goto_result);
+  LOG(INFO) << "Interpreted loop of " << kIterations << " iterations: switch "
+            << PrettyDuration(switch_ns) << ", computed goto " << PrettyDuration(goto_ns);
+}
+
+TEST_F(InterpreterTest, InlineCachesAgree) {
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::ArtMethod* method = FindLoopMethod("calls");
+  InlineCacheTable* inline_cache_table = Runtime::Current()->GetInlineCacheTable();
+  for (uint32_t n = 0; n < 40; ++n) {
+    uint64_t ns;
+    inline_cache_table->SetEnabled(false);
+    int32_t uncached_result = RunLoop(method, GetInterpreterImplKind(), n, &ns);
+    inline_cache_table->SetEnabled(true);
+    // The first run fills the caches.
+    EXPECT_EQ(uncached_result, RunLoop(method, GetInterpreterImplKind(), n, &ns)) << n;
+    EXPECT_EQ(uncached_result, RunLoop(method, GetInterpreterImplKind(), n, &ns)) << n;
+  }
+}
+
+TEST_F(InterpreterTest, DISABLED_InlineCacheBenchmark) {
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::ArtMethod* method = FindLoopMethod("calls");
+  InlineCacheTable* inline_cache_table = Runtime::Current()->GetInlineCacheTable();
+  static const uint32_t kIterations = 100000;
+  uint64_t uncached_ns;
+  inline_cache_table->SetEnabled(false);
+  RunLoop(method, GetInterpreterImplKind(), kIterations, &uncached_ns);
+  inline_cache_table->SetEnabled(true);
+  // The first run fills the caches.
+  uint64_t cached_ns;
+  RunLoop(method, GetInterpreterImplKind(), kIterations, &cached_ns);
+  RunLoop(method, GetInterpreterImplKind(), kIterations, &cached_ns);
+  LOG(INFO) << "Interpreted calls and field accesses for " << kIterations
+            << " iterations: uncached " << PrettyDuration(uncached_ns)
+            << ", cached " << PrettyDuration(cached_ns);
+}
+
+}  // namespace interpreter
+}  // namespace art
@@ -837,10 +837,7 @@ class JNI {
     if (decoded_obj == nullptr) {
       return nullptr;
     }
-    JavaVMExt* vm = soa.Vm();
-    IndirectReferenceTable& globals = vm->globals;
-    WriterMutexLock mu(soa.Self(), vm->globals_lock);
-    IndirectRef ref = globals.Add(IRT_FIRST_SEGMENT, decoded_obj);
+    IndirectRef ref = soa.Vm()->globals.Add(soa.Self(), decoded_obj);
     return reinterpret_cast<jobject>(ref);
   }
 
@@ -849,11 +846,9 @@ class JNI {
       return;
     }
     JavaVMExt* vm = reinterpret_cast<JNIEnvExt*>(env)->vm;
-    IndirectReferenceTable& globals = vm->globals;
     Thread* self = reinterpret_cast<JNIEnvExt*>(env)->self;
-    WriterMutexLock mu(self, vm->globals_lock);
 
-    if (!globals.Remove(IRT_FIRST_SEGMENT, obj)) {
+    if (!vm->globals.Remove(self, obj)) {
       LOG(WARNING) << "JNI WARNING: DeleteGlobalRef(" << obj << ") "
                    << "failed to find entry";
     }
@@ -2359,9 +2354,10 @@ class JNI {
     for (jint i = 0; i < method_count; ++i) {
       const char* name = methods[i].name;
       const char* sig = methods[i].signature;
-
+      bool is_fast = false;
       if (*sig == '!') {
-        // TODO: fast jni. it's too noisy to log all these.
+        // A leading '!' asks for a fast native method, see ArtMethod::RegisterNative.
+        is_fast = true;
         ++sig;
       }
 
@@ -2382,9 +2378,10 @@ class JNI {
         return JNI_ERR;
       }
 
-      VLOG(jni) << "[Registering JNI native method " << PrettyMethod(m) << "]";
+      VLOG(jni) << "[Registering JNI " << (is_fast ? "fast " : "") << "native method "
+          << PrettyMethod(m) << "]";
 
-      m->RegisterNative(soa.Self(), methods[i].fnPtr);
+      m->RegisterNative(soa.Self(), methods[i].fnPtr, is_fast);
     }
     return JNI_OK;
   }
@@ -3000,7 +2997,6 @@ JavaVMExt::JavaVMExt(Runtime* runtime, Runtime::ParsedOptions* options)
       work_around_app_jni_bugs(false),
       pins_lock("JNI pin table lock", kPinTableLock),
       pin_table("pin table", kPinTableInitial, kPinTableMax),
-      globals_lock("JNI global reference table lock"),
       globals(gGlobalsInitial, gGlobalsMax, kGlobal),
       libraries_lock("JNI shared libraries map lock", kLoadLibraryLock),
       libraries(new Libraries),
@@ -3054,10 +3050,7 @@ void JavaVMExt::DumpForSigQuit(std::ostream& os) {
     MutexLock mu(self, pins_lock);
     os << "; pins=" << pin_table.Size();
   }
-  {
-    ReaderMutexLock mu(self, globals_lock);
-    os << "; globals=" << globals.Capacity();
-  }
+  os << "; globals=" << globals.Capacity(self);
   {
     MutexLock mu(self, weak_globals_lock_);
     if (weak_globals_.Capacity() > 0) {
@@ -3103,10 +3096,7 @@ mirror::Object* JavaVMExt::DecodeWeakGlobal(Thread* self, IndirectRef ref) {
 
 void JavaVMExt::DumpReferenceTables(std::ostream& os) {
   Thread* self = Thread::Current();
-  {
-    ReaderMutexLock mu(self, globals_lock);
-    globals.Dump(os);
-  }
+  globals.Dump(os);
   {
     MutexLock mu(self, weak_globals_lock_);
     weak_globals_.Dump(os);
@@ -3276,10 +3266,7 @@ void* JavaVMExt::FindCodeForNativeMethod(ArtMethod* m) {
 
 void JavaVMExt::VisitRoots(RootVisitor* visitor, void* arg) {
   Thread* self = Thread::Current();
-  {
-    ReaderMutexLock mu(self, globals_lock);
-    globals.VisitRoots(visitor, arg);
-  }
+  globals.VisitRoots(visitor, arg);
   {
     MutexLock mu(self, pins_lock);
     pin_table.VisitRoots(visitor, arg);
@@ -17,6 +17,7 @@
 #include "jni_internal.h"
 
 #include <limits.h>
+#include <unistd.h>
 #include <cfloat>
 #include <cmath>
 
@@ -28,6 +29,7 @@
 #include "mirror/object-inl.h"
 #include "ScopedLocalRef.h"
 #include "sirt_ref.h"
+#include "UniquePtr.h"
 
 namespace art {
 
@@ -1133,6 +1135,72 @@ TEST_F(JniInternalTest, GetArrayLength) {
   // Already tested in NewObjectArray/NewPrimitiveArray.
 }
 
+TEST_F(JniInternalTest, DISABLED_JniRoundTripBenchmark) {
+  // Every JNI call transitions the thread from Native to Runnable and back.
+  jintArray array = env_->NewIntArray(1);
+  ASSERT_TRUE(array != NULL);
+  static const size_t kIterations = 1000000;
+  size_t total_length = 0;
+  uint64_t start = NanoTime();
+  for (size_t i = 0; i < kIterations; ++i) {
+    total_length += env_->GetArrayLength(array);
+  }
+  uint64_t elapsed = NanoTime() - start;
+  EXPECT_EQ(kIterations, total_length);
+  LOG(INFO) << "JNI round trip: " << elapsed / kIterations << "ns";
+}
+
+// Attached threads making JNI calls, each of which enters and leaves Runnable.
+struct JniCallingThreads {
+  static const size_t kIterations = 100000;
+
+  JniCallingThreads(JavaVM* vm, jintArray array) : vm(vm), array(array) {}
+
+  static void* Callback(void* arg) {
+    JniCallingThreads* state = reinterpret_cast<JniCallingThreads*>(arg);
+    JNIEnv* env;
+    CHECK_EQ(JNI_OK, state->vm->AttachCurrentThread(&env, NULL));
+    for (size_t i = 0; i < kIterations; ++i) {
+      env->GetArrayLength(state->array);
+    }
+    CHECK_EQ(JNI_OK, state->vm->DetachCurrentThread());
+    return NULL;
+  }
+
+  // Runs Callback on num_threads threads, returning the elapsed time in nanoseconds.
+  uint64_t Run(size_t num_threads) {
+    UniquePtr<pthread_t[]> pthreads(new pthread_t[num_threads]);
+    uint64_t start = NanoTime();
+    for (size_t i = 0; i < num_threads; ++i) {
+      CHECK_EQ(0, pthread_create(&pthreads[i], NULL, Callback, this));
+    }
+    for (size_t i = 0; i < num_threads; ++i) {
+      CHECK_EQ(0, pthread_join(pthreads[i], NULL));
+    }
+    return NanoTime() - start;
+  }
+
+  JavaVM* const vm;
+  const jintArray array;
+};
+
+TEST_F(JniInternalTest, DISABLED_JniRoundTripScalingBenchmark) {
+  // Runnable threads hold the mutator lock implicitly through their own state word, so calls
+  // on different threads shouldn't contend with each other.
+  jintArray array = reinterpret_cast<jintArray>(env_->NewGlobalRef(env_->NewIntArray(1)));
+  ASSERT_TRUE(array != NULL);
+  JniCallingThreads state(vm_, array);
+  long num_processors = sysconf(_SC_NPROCESSORS_ONLN);  // NOLINT(runtime/int)
+  for (size_t num_threads = 1; num_threads <= static_cast<size_t>(num_processors);
+       num_threads *= 2) {
+    uint64_t elapsed = state.Run(num_threads);
+    LOG(INFO) << "JNI round trips on " << num_threads << " threads: "
+              << PrettyDuration(elapsed) << " for " << JniCallingThreads::kIterations
+              << " calls each";
+  }
+  env_->DeleteGlobalRef(array);
+}
+
 TEST_F(JniInternalTest, GetObjectClass) {
   jclass string_class = env_->FindClass("java/lang/String");
   ASSERT_TRUE(string_class != NULL);
@@ -68,15 +68,19 @@ class Locks {
   static void Init();
 
   // The mutator_lock_ is used to allow mutators to execute in a shared (reader) mode or to block
-  // mutators by having an exclusive (writer) owner. In normal execution each mutator thread holds
-  // a share on the mutator_lock_. The garbage collector may also execute with shared access but
-  // at times requires exclusive access to the heap (not to be confused with the heap meta-data
-  // guarded by the heap_lock_ below). When the garbage collector requires exclusive access it asks
-  // the mutators to suspend themselves which also involves usage of the thread_suspend_count_lock_
-  // to cover weaknesses in using ReaderWriterMutexes with ConditionVariables. We use a condition
-  // variable to wait upon in the suspension logic as releasing and then re-acquiring a share on
-  // the mutator lock doesn't necessarily allow the exclusive user (e.g the garbage collector)
-  // chance to acquire the lock.
+  // mutators by having an exclusive (writer) owner. In normal execution each mutator thread holds a
+  // share on the mutator_lock_. A Runnable thread's share is implied by its state, which lives in
+  // its own state and flags word, so going Runnable and back doesn't write any shared cache line;
+  // the per-thread words act as the lock's reader indicators and SuspendAll sweeps them, waiting
+  // for every thread to leave Runnable, before taking the lock exclusively. Only threads that
+  // aren't Runnable, such as GC threads, share the lock through its reader count. The garbage
+  // collector may also execute with shared access but at times requires exclusive access to the
+  // heap (not to be confused with the heap meta-data guarded by the heap_lock_ below). When the
+  // garbage collector requires exclusive access it asks the mutators to suspend themselves which
+  // also involves usage of the thread_suspend_count_lock_ to cover weaknesses in using
+  // ReaderWriterMutexes with ConditionVariables. We use a condition variable to wait upon in the
+  // suspension logic as releasing and then re-acquiring a share on the mutator lock doesn't
+  // necessarily allow the exclusive user (e.g the garbage collector) chance to acquire the lock.
   //
   // Thread suspension:
   // Shared users                                  | Exclusive user
@@ -127,7 +127,7 @@ inline void ArtMethod::AssertPcIsWithinCode(uintptr_t pc) const {
     return;
   }
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-  if (code == GetResolutionTrampoline(class_linker)) {
+  if (code == GetResolutionTrampoline(class_linker) || code == GetQuickRedispatchTrampoline()) {
     return;
   }
   DCHECK(IsWithinCode(pc))
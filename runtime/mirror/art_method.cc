@@ -306,10 +306,15 @@ bool ArtMethod::IsRegistered() const {
 }
 
 extern "C" void art_work_around_app_jni_bugs(JNIEnv*, jobject);
-void ArtMethod::RegisterNative(Thread* self, const void* native_method) {
+void ArtMethod::RegisterNative(Thread* self, const void* native_method, bool is_fast) {
   DCHECK(Thread::Current() == self);
   CHECK(IsNative()) << PrettyMethod(this);
   CHECK(native_method != NULL) << PrettyMethod(this);
+  if (is_fast) {
+    SetAccessFlags(GetAccessFlags() | kAccFastNative);
+  } else {
+    SetAccessFlags(GetAccessFlags() & ~kAccFastNative);
+  }
   if (!self->GetJniEnv()->vm->work_around_app_jni_bugs) {
     SetNativeMethod(native_method);
   } else {
@@ -330,7 +335,7 @@ void ArtMethod::RegisterNative(Thread* self, const void* native_method) {
 void ArtMethod::UnregisterNative(Thread* self) {
   CHECK(IsNative()) << PrettyMethod(this);
   // restore stub to lookup native pointer via dlsym
-  RegisterNative(self, GetJniDlsymLookupStub());
+  RegisterNative(self, GetJniDlsymLookupStub(), false);
 }
 
 void ArtMethod::SetNativeMethod(const void* native_method) {
@@ -112,10 +112,49 @@ class MANAGED ArtMethod : public Object {
     return (GetAccessFlags() & kAccNative) != 0;
   }
 
+  // Returns true if the native method was registered as fast, in which case its JNI stub leaves
+  // the thread Runnable for the duration of the call. See ArtMethod::RegisterNative.
+  bool IsFastNative() const {
+    return (GetAccessFlags() & kAccFastNative) != 0;
+  }
+
   bool IsAbstract() const {
     return (GetAccessFlags() & kAccAbstract) != 0;
   }
 
+  // Returns true if compiled code in the boot image calls this virtual method directly, no class
+  // loaded when compiling the image having overridden it.
+  bool IsSingleImplementation() const {
+    return (GetAccessFlags() & kAccSingleImplementation) != 0;
+  }
+
+  void SetSingleImplementation() {
+    SetAccessFlags(GetAccessFlags() | kAccSingleImplementation);
+  }
+
+  // Returns true if a class overriding this single implementation has since been loaded, so that
+  // the method is entered through the redispatch trampoline, which dispatches the calls compiled
+  // code made direct on their receiver. See ClassLinker::LinkVirtualMethods.
+  bool IsRedispatched() const {
+    return (GetAccessFlags() & kAccRedispatch) != 0;
+  }
+
+  void SetRedispatched() {
+    SetAccessFlags((GetAccessFlags() & ~kAccSingleImplementation) | kAccRedispatch);
+  }
+
+  // The code the redispatch trampoline enters a redispatched method through. Only native methods
+  // have a native method, so it's kept in its place.
+  const void* GetEntryPointFromRedispatch() const {
+    DCHECK(IsRedispatched() && !IsNative());
+    return GetNativeMethod();
+  }
+
+  void SetEntryPointFromRedispatch(const void* entry_point_from_redispatch) {
+    DCHECK(IsRedispatched() && !IsNative());
+    SetNativeMethod(entry_point_from_redispatch);
+  }
+
   bool IsSynthetic() const {
     return (GetAccessFlags() & kAccSynthetic) != 0;
   }
@@ -307,7 +346,13 @@ class MANAGED ArtMethod : public Object {
 
   bool IsRegistered() const;
 
-  void RegisterNative(Thread* self, const void* native_method)
+  // Binds the native method to native_method. A fast native method is called without leaving the
+  // Runnable state, saving the thread state transitions on either side of the call. In exchange,
+  // for as long as it runs the thread holds its share of the mutator lock, so garbage collection
+  // and thread suspension wait for it to return. A fast native method must therefore be short and
+  // must not block: no waiting on locks, monitors, I/O or other threads, and no calls back into
+  // managed code. It may still use the JNI functions that don't block and create local references.
+  void RegisterNative(Thread* self, const void* native_method, bool is_fast)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
   void UnregisterNative(Thread* self) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
@@ -330,6 +330,27 @@ bool Class::IsArtMethodClass() const {
   return this == ArtMethod::GetJavaLangReflectArtMethod();
 }
 
+bool Class::IsAssignableFromCached(Class* src) {
+  DCHECK(src != NULL);
+  Runtime* runtime = Runtime::Current();
+  if (src->GetTypeCheckCache() == this) {
+    if (UNLIKELY(runtime->HasStatsEnabled())) {
+      ++Thread::Current()->GetStats()->type_check_cache_hits;
+      ++runtime->GetStats()->type_check_cache_hits;
+    }
+    return true;
+  }
+  if (UNLIKELY(runtime->HasStatsEnabled())) {
+    ++Thread::Current()->GetStats()->type_check_cache_misses;
+    ++runtime->GetStats()->type_check_cache_misses;
+  }
+  if (!IsAssignableFrom(src)) {
+    return false;
+  }
+  src->SetTypeCheckCache(this);
+  return true;
+}
+
 void Class::SetClassLoader(ClassLoader* new_class_loader) {
   SetFieldObject(OFFSET_OF_OBJECT_MEMBER(Class, class_loader_), new_class_loader, false);
 }
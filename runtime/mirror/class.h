@@ -200,6 +200,16 @@ class MANAGED Class : public StaticStorageBase {
     SetAccessFlags(flags | kAccClassIsFinalizable);
   }
 
+  // Returns true if new instances of the class should not have biased locks.
+  bool IsBiasRevoked() const {
+    return (GetAccessFlags() & kAccClassIsBiasRevoked) != 0;
+  }
+
+  void SetBiasRevoked() {
+    uint32_t flags = GetField32(OFFSET_OF_OBJECT_MEMBER(Class, access_flags_), false);
+    SetAccessFlags(flags | kAccClassIsBiasRevoked);
+  }
+
   // Returns true if the class is abstract.
   bool IsAbstract() const {
     return (GetAccessFlags() & kAccAbstract) != 0;
@@ -463,6 +473,23 @@ class MANAGED Class : public StaticStorageBase {
     }
   }
 
+  // As IsAssignableFrom, but first checks whether this class is src's cached type check target
+  // and records this class as that target on success. Used by the compiled code slow paths, whose
+  // inline checks probe the same cache.
+  bool IsAssignableFromCached(Class* src) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  Class* GetTypeCheckCache() const SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    return GetFieldObject<Class*>(OFFSET_OF_OBJECT_MEMBER(Class, type_check_cache_), false);
+  }
+
+  void SetTypeCheckCache(Class* klass) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    SetFieldObject(OFFSET_OF_OBJECT_MEMBER(Class, type_check_cache_), klass, false);
+  }
+
+  static MemberOffset TypeCheckCacheOffset() {
+    return OFFSET_OF_OBJECT_MEMBER(Class, type_check_cache_);
+  }
+
   Class* GetSuperClass() const SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
   void SetSuperClass(Class *new_super_class) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
@@ -544,6 +571,15 @@ class MANAGED Class : public StaticStorageBase {
     return OFFSET_OF_OBJECT_MEMBER(Class, vtable_);
   }
 
+  ObjectArray<ArtMethod>* GetImTable() const;
+
+  void SetImTable(ObjectArray<ArtMethod>* new_imtable)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  static MemberOffset ImTableOffset() {
+    return OFFSET_OF_OBJECT_MEMBER(Class, imtable_);
+  }
+
   // Given a method implemented by this class but potentially from a super class, return the
   // specific implementation method for this class.
   ArtMethod* FindVirtualMethodForVirtual(ArtMethod* method) const
@@ -803,6 +839,11 @@ class MANAGED Class : public StaticStorageBase {
   // methods for the methods in the interface.
   IfTable* iftable_;
 
+  // Interface method table (imt), for quick "invoke-interface". Each of the ClassLinker::kImtSize
+  // slots holds the implementation of the one interface method whose dex method index hashes to
+  // it, or the runtime's imt conflict method when several interface methods share the slot.
+  ObjectArray<ArtMethod>* imtable_;
+
   // descriptor for the class such as "java.lang.Class" or "[C". Lazily initialized by ComputeName
   String* name_;
 
@@ -812,6 +853,11 @@ class MANAGED Class : public StaticStorageBase {
   // The superclass, or NULL if this is java.lang.Object, an interface or primitive type.
   Class* super_class_;
 
+  // The class most recently found to be assignable from this class by a non-trivial instanceof,
+  // checkcast or array store check, or NULL. Racy updates are benign as any value it holds is a
+  // valid assignable target.
+  Class* type_check_cache_;
+
   // If class verify fails, we must return same error on subsequent tries.
   Class* verify_error_class_;
 
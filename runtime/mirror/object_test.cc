@@ -77,6 +77,14 @@ TEST_F(ObjectTest, AsmConstants) {
   ASSERT_EQ(STRING_DATA_OFFSET, Array::DataOffset(sizeof(uint16_t)).Int32Value());
 
   ASSERT_EQ(METHOD_CODE_OFFSET, ArtMethod::EntryPointFromCompiledCodeOffset().Int32Value());
+  ASSERT_EQ(METHOD_DEX_CACHE_METHODS_OFFSET, ArtMethod::DexCacheResolvedMethodsOffset().Int32Value());
+  ASSERT_EQ(METHOD_INDEX_OFFSET, ArtMethod::MethodIndexOffset().Int32Value());
+  ASSERT_EQ(METHOD_NATIVE_METHOD_OFFSET, ArtMethod::NativeMethodOffset().Int32Value());
+
+  ASSERT_EQ(OBJECT_CLASS_OFFSET, Object::ClassOffset().Int32Value());
+  ASSERT_EQ(CLASS_VTABLE_OFFSET, Class::VTableOffset().Int32Value());
+
+  ASSERT_EQ(OBJECT_ARRAY_DATA_OFFSET, Array::DataOffset(sizeof(Object*)).Int32Value());
 }
 
 TEST_F(ObjectTest, IsInSamePackage) {
@@ -525,6 +533,27 @@ TEST_F(ObjectTest, IsAssignableFrom) {
   }
 }
 
+TEST_F(ObjectTest, IsAssignableFromCached) {
+  ScopedObjectAccess soa(Thread::Current());
+  Class* string = class_linker_->FindSystemClass("Ljava/lang/String;");
+  Class* charseq = class_linker_->FindSystemClass("Ljava/lang/CharSequence;");
+  Class* comparable = class_linker_->FindSystemClass("Ljava/lang/Comparable;");
+  Class* runnable = class_linker_->FindSystemClass("Ljava/lang/Runnable;");
+  string->SetTypeCheckCache(NULL);
+
+  // Failed checks leave the cache alone.
+  EXPECT_FALSE(runnable->IsAssignableFromCached(string));
+  EXPECT_TRUE(string->GetTypeCheckCache() == NULL);
+  // Successful checks record the most recent target.
+  EXPECT_TRUE(charseq->IsAssignableFromCached(string));
+  EXPECT_EQ(charseq, string->GetTypeCheckCache());
+  EXPECT_TRUE(charseq->IsAssignableFromCached(string));
+  EXPECT_TRUE(comparable->IsAssignableFromCached(string));
+  EXPECT_EQ(comparable, string->GetTypeCheckCache());
+  EXPECT_FALSE(string->IsAssignableFromCached(charseq));
+  EXPECT_EQ(comparable, string->GetTypeCheckCache());
+}
+
 TEST_F(ObjectTest, IsAssignableFromArray) {
   ScopedObjectAccess soa(Thread::Current());
   jobject jclass_loader = LoadDex("XandY");
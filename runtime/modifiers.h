@@ -46,10 +46,14 @@ static const uint32_t kAccConstructor = 0x00010000;  // method (dex only) <init>
 static const uint32_t kAccDeclaredSynchronized = 0x00020000;  // method (dex only)
 static const uint32_t kAccClassIsProxy = 0x00040000;  // class (dex only)
 static const uint32_t kAccPreverified = 0x00080000;  // method (dex only)
+static const uint32_t kAccFastNative = 0x00100000;  // method (registered with a '!' signature)
+static const uint32_t kAccSingleImplementation = 0x00200000;  // method (called directly)
+static const uint32_t kAccRedispatch = 0x00400000;  // method (called directly, then overridden)
 
 // Special runtime-only flags.
 // Note: if only kAccClassIsReference is set, we have a soft reference.
 static const uint32_t kAccClassIsFinalizable        = 0x80000000;  // class/ancestor overrides finalize()
+static const uint32_t kAccClassIsBiasRevoked        = 0x40000000;  // class instances aren't biased
 static const uint32_t kAccClassIsReference          = 0x08000000;  // class is a soft/weak/phantom ref
 static const uint32_t kAccClassIsWeakReference      = 0x04000000;  // class is a weak reference
 static const uint32_t kAccClassIsFinalizerReference = 0x02000000;  // class is a finalizer reference
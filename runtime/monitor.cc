@@ -16,6 +16,7 @@
 
 #include "monitor.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "base/mutex.h"
@@ -28,6 +29,7 @@
 #include "mirror/object-inl.h"
 #include "mirror/object_array-inl.h"
 #include "object_utils.h"
+#include "safe_map.h"
 #include "scoped_thread_state_change.h"
 #include "thread.h"
 #include "thread_list.h"
@@ -56,8 +58,19 @@ namespace art {
  * lock encodes its state.  When cleared, the lock is in the "thin"
  * state and its bits are formatted as follows:
  *
- *    [31 ---- 19] [18 ---- 3] [2 ---- 1] [0]
- *     lock count   thread id  hash state  0
+ *    [31 ---- 20] [19] [18 ---- 3] [2 ---- 1] [0]
+ *     lock count   bias  thread id  hash state  0
+ *
+ * When biased locking is enabled, new objects start out anonymously
+ * biased: the bias bit is set and the thread id is 0.  The first thread
+ * to lock the object installs its thread id with a CAS, after which the
+ * lock is reserved for that thread.  It may then acquire and release the
+ * lock by adjusting the lock count with ordinary loads and stores; for a
+ * biased lock the count is the number of holds rather than the number
+ * of recursive acquisitions.  Any other thread wishing to acquire the lock
+ * first revokes the bias with all threads suspended, turning the lock word
+ * into the equivalent ordinary thin lock.  A lock never becomes biased
+ * again once its bias has been revoked.
  *
  * When set, the lock is in the "fat" state and its bits are formatted
  * as follows:
@@ -68,6 +81,12 @@ namespace art {
  * For an in-depth description of the mechanics of thin-vs-fat locking,
  * read the paper referred to above.
  *
+ * Contending threads spin briefly before yielding a thin lock or blocking
+ * on a fat lock, since most critical sections are short.  Fat locks adapt
+ * the length of the spin to whether spinning recently paid off.  Fat locks
+ * that are idle across a GC are deflated back to thin locks while the
+ * mutators are suspended.
+ *
  * Monitors provide:
  *  - mutually exclusive access to resources
  *  - a way for multiple threads to wait for notification
@@ -93,15 +112,47 @@ namespace art {
   (reinterpret_cast<Monitor*>((x) & ~((LW_HASH_STATE_MASK << LW_HASH_STATE_SHIFT) | LW_SHAPE_MASK)))
 
 /*
- * Lock recursion count field.  Contains a count of the number of times
- * a lock has been recursively acquired.
+ * Number of times a thread contending for a thin lock checks whether it
+ * has been released before yielding.
+ */
+static const size_t kThinLockSpins = 64;
+
+/*
+ * Bounds and initial value of the number of times a thread contending
+ * for a fat lock checks whether it has been released before blocking.
+ */
+static const uint32_t kMinFatLockSpins = 16;
+static const uint32_t kMaxFatLockSpins = 4096;
+static const uint32_t kInitialFatLockSpins = 256;
+
+/*
+ * Number of times the biases of instances of a class may be revoked by
+ * contending threads before new instances of the class are no longer
+ * biased.
+ */
+static const size_t kBiasRevocationThreshold = 16;
+
+/*
+ * Per class count of bias revocations by contending threads.  Only
+ * accessed while all other threads are suspended.
  */
-#define LW_LOCK_COUNT_MASK 0x1fff
-#define LW_LOCK_COUNT_SHIFT 19
-#define LW_LOCK_COUNT(x) (((x) >> LW_LOCK_COUNT_SHIFT) & LW_LOCK_COUNT_MASK)
+static SafeMap<const mirror::Class*, size_t>* gBiasRevocationCounts = NULL;
 
 bool (*Monitor::is_sensitive_thread_hook_)() = NULL;
 uint32_t Monitor::lock_profiling_threshold_ = 0;
+bool Monitor::use_biased_locking_ = false;
+size_t Monitor::bias_revocations_ = 0;
+size_t Monitor::bias_revoked_classes_ = 0;
+volatile int32_t Monitor::own_bias_revocations_ = 0;
+
+/*
+ * Returns true if the thin lock word 'thin' is held by the thread with
+ * thin lock id 'thread_id'.  A biased lock may be reserved for a thread
+ * without being held by it.
+ */
+static bool IsThinLockHeldBy(uint32_t thin, uint32_t thread_id) {
+  return LW_LOCK_OWNER(thin) == thread_id && (LW_BIAS(thin) == 0 || LW_LOCK_COUNT(thin) != 0);
+}
 
 bool Monitor::IsSensitiveThread() {
   if (is_sensitive_thread_hook_ != NULL) {
@@ -110,9 +161,19 @@ bool Monitor::IsSensitiveThread() {
   return false;
 }
 
-void Monitor::Init(uint32_t lock_profiling_threshold, bool (*is_sensitive_thread_hook)()) {
+void Monitor::Init(uint32_t lock_profiling_threshold, bool (*is_sensitive_thread_hook)(),
+                   bool use_biased_locking) {
   lock_profiling_threshold_ = lock_profiling_threshold;
   is_sensitive_thread_hook_ = is_sensitive_thread_hook;
+  use_biased_locking_ = use_biased_locking;
+}
+
+uint32_t Monitor::GetInitialLockWord(const mirror::Class* klass) {
+  // Class objects are locked by every thread that initializes them, so don't bias them.
+  if (!use_biased_locking_ || klass->IsBiasRevoked() || klass->IsClassClass()) {
+    return 0;
+  }
+  return LW_BIAS_MASK << LW_BIAS_SHIFT;
 }
 
 Monitor::Monitor(Thread* owner, mirror::Object* obj)
@@ -122,7 +183,9 @@ Monitor::Monitor(Thread* owner, mirror::Object* obj)
       obj_(obj),
       wait_set_(NULL),
       locking_method_(NULL),
-      locking_dex_pc_(0) {
+      locking_dex_pc_(0),
+      spin_limit_(kInitialFatLockSpins),
+      recently_used_(true) {
   monitor_lock_.Lock(owner);
   // Propagate the lock state.
   uint32_t thin = *obj->GetRawLockWordAddress();
@@ -139,7 +202,9 @@ Monitor::Monitor(Thread* owner, mirror::Object* obj)
 
 Monitor::~Monitor() {
   DCHECK(obj_ != NULL);
-  DCHECK_EQ(LW_SHAPE(*obj_->GetRawLockWordAddress()), LW_SHAPE_FAT);
+  // The lock word is thin again if the monitor was deflated.
+  DCHECK(LW_SHAPE(*obj_->GetRawLockWordAddress()) == LW_SHAPE_THIN ||
+         LW_MONITOR(*obj_->GetRawLockWordAddress()) == this);
 }
 
 /*
@@ -194,6 +259,24 @@ mirror::Object* Monitor::GetObject() {
   return obj_;
 }
 
+bool Monitor::TrySpinLock(Thread* self) {
+  uint32_t spin_limit = spin_limit_;
+  for (uint32_t i = 0; i < spin_limit; ++i) {
+    // Don't hold up a suspension or checkpoint by spinning.
+    if (self->TestAllFlags()) {
+      break;
+    }
+    if (owner_ == NULL && monitor_lock_.TryLock(self)) {
+      // The lock was held briefly; spin for longer next time.
+      spin_limit_ = std::min(spin_limit * 2, kMaxFatLockSpins);
+      return true;
+    }
+    SpinPause();
+  }
+  spin_limit_ = std::max(spin_limit / 2, kMinFatLockSpins);
+  return false;
+}
+
 void Monitor::Lock(Thread* self) {
   if (owner_ == self) {
     lock_count_++;
@@ -201,6 +284,13 @@ void Monitor::Lock(Thread* self) {
   }
 
   if (!monitor_lock_.TryLock(self)) {
+    // Count ourselves as a waiter before any suspend point so that the monitor isn't deflated.
+    ++num_waiters_;
+    if (TrySpinLock(self)) {
+      --num_waiters_;
+      AcquiredLock(self);
+      return;
+    }
     uint64_t waitStart = 0;
     uint64_t waitEnd = 0;
     uint32_t wait_threshold = lock_profiling_threshold_;
@@ -236,8 +326,14 @@ void Monitor::Lock(Thread* self) {
         LogContentionEvent(self, wait_ms, sample_percent, current_locking_filename, current_locking_line_number);
       }
     }
+    --num_waiters_;
   }
+  AcquiredLock(self);
+}
+
+void Monitor::AcquiredLock(Thread* self) {
   owner_ = self;
+  recently_used_ = true;
   DCHECK_EQ(lock_count_, 0);
 
   // When debugging, save the current monitor holder for future
@@ -430,6 +526,7 @@ void Monitor::WaitWithLock(Thread* self, int64_t ms, int32_t ns,
    * not order sensitive as we hold the pthread mutex.
    */
   AppendToWaitSet(self);
+  ++num_waiters_;
   int prev_lock_count = lock_count_;
   lock_count_ = 0;
   owner_ = NULL;
@@ -506,6 +603,7 @@ void Monitor::WaitWithLock(Thread* self, int64_t ms, int32_t ns,
   locking_method_ = saved_method;
   locking_dex_pc_ = saved_dex_pc;
   RemoveFromWaitSet(self);
+  --num_waiters_;
 
   if (was_interrupted) {
     /*
@@ -582,6 +680,7 @@ void Monitor::Inflate(Thread* self, mirror::Object* obj) {
   DCHECK(self != NULL);
   DCHECK(obj != NULL);
   DCHECK_EQ(LW_SHAPE(*obj->GetRawLockWordAddress()), LW_SHAPE_THIN);
+  DCHECK_EQ(LW_BIAS(*obj->GetRawLockWordAddress()), 0);
   DCHECK_EQ(LW_LOCK_OWNER(*obj->GetRawLockWordAddress()), static_cast<int32_t>(self->GetThinLockId()));
 
   // Allocate and acquire a new monitor.
@@ -591,6 +690,68 @@ void Monitor::Inflate(Thread* self, mirror::Object* obj) {
   Runtime::Current()->GetMonitorList()->Add(m);
 }
 
+void Monitor::RevokeOwnBias(Thread* self, mirror::Object* obj) {
+  volatile int32_t* thinp = obj->GetRawLockWordAddress();
+  uint32_t thin = *thinp;
+  DCHECK_EQ(LW_SHAPE(thin), LW_SHAPE_THIN);
+  DCHECK_EQ(LW_BIAS(thin), 1U);
+  DCHECK_EQ(LW_LOCK_OWNER(thin), self->GetThinLockId());
+  uint32_t newThin = thin & (LW_HASH_STATE_MASK << LW_HASH_STATE_SHIFT);
+  uint32_t holds = LW_LOCK_COUNT(thin);
+  if (holds != 0) {
+    newThin |= (self->GetThinLockId() << LW_LOCK_OWNER_SHIFT) |
+        ((holds - 1) << LW_LOCK_COUNT_SHIFT);
+  }
+  // No other thread writes a lock word biased towards us, but once the bias is gone other threads
+  // may CAS the lock word so publish the update.
+  android_atomic_release_store(newThin, thinp);
+  android_atomic_inc(&own_bias_revocations_);
+  VLOG(monitor) << StringPrintf("monitor: thread %d revoked own bias of lock %p",
+                                self->GetThinLockId(), thinp);
+}
+
+void Monitor::RevokeBias(Thread* self, mirror::Object* obj) {
+  volatile int32_t* thinp = obj->GetRawLockWordAddress();
+  ThreadList* thread_list = Runtime::Current()->GetThreadList();
+  // Let the thread list suspend us along with everybody else.
+  self->monitor_enter_object_ = obj;
+  self->TransitionFromRunnableToSuspended(kBlocked);
+  thread_list->SuspendAll();
+  // The bias owner is suspended and can't be touching the lock word. Another contending thread may
+  // have revoked the bias while we waited for the suspension, in which case there's nothing to do.
+  uint32_t thin = *thinp;
+  if (LW_SHAPE(thin) == LW_SHAPE_THIN && LW_BIAS(thin) != 0 &&
+      LW_LOCK_OWNER(thin) != 0 && LW_LOCK_OWNER(thin) != self->GetThinLockId()) {
+    uint32_t owner = LW_LOCK_OWNER(thin);
+    uint32_t holds = LW_LOCK_COUNT(thin);
+    uint32_t newThin = thin & (LW_HASH_STATE_MASK << LW_HASH_STATE_SHIFT);
+    if (holds != 0) {
+      newThin |= (owner << LW_LOCK_OWNER_SHIFT) | ((holds - 1) << LW_LOCK_COUNT_SHIFT);
+    }
+    *thinp = newThin;
+    ++bias_revocations_;
+    // Stop biasing instances of classes whose instances keep being contended.
+    const mirror::Class* klass = obj->GetClass();
+    if (gBiasRevocationCounts == NULL) {
+      gBiasRevocationCounts = new SafeMap<const mirror::Class*, size_t>;
+    }
+    auto it = gBiasRevocationCounts->find(klass);
+    if (it == gBiasRevocationCounts->end()) {
+      gBiasRevocationCounts->Put(klass, 1);
+    } else if (++it->second == kBiasRevocationThreshold) {
+      const_cast<mirror::Class*>(klass)->SetBiasRevoked();
+      ++bias_revoked_classes_;
+      gBiasRevocationCounts->erase(it);
+      VLOG(monitor) << "monitor: no longer biasing instances of " << PrettyClass(klass);
+    }
+    VLOG(monitor) << StringPrintf("monitor: thread %d revoked bias of lock %p towards thread %d",
+                                  self->GetThinLockId(), thinp, owner);
+  }
+  thread_list->ResumeAll();
+  self->TransitionFromSuspendedToRunnable();
+  self->monitor_enter_object_ = NULL;
+}
+
 void Monitor::MonitorEnter(Thread* self, mirror::Object* obj) {
   volatile int32_t* thinp = obj->GetRawLockWordAddress();
   uint32_t sleepDelayNs;
@@ -604,6 +765,27 @@ void Monitor::MonitorEnter(Thread* self, mirror::Object* obj) {
  retry:
   thin = *thinp;
   if (LW_SHAPE(thin) == LW_SHAPE_THIN) {
+    if (UNLIKELY(LW_BIAS(thin) != 0)) {
+      if (LW_LOCK_OWNER(thin) == threadId) {
+        // The lock is reserved for us. Nobody else may write the lock word, so take another hold
+        // without an atomic operation unless the count would overflow.
+        if (LW_LOCK_COUNT(thin) < LW_LOCK_COUNT_MASK - 1) {
+          *thinp = thin + (1 << LW_LOCK_COUNT_SHIFT);
+          return;
+        }
+        RevokeOwnBias(self, obj);
+      } else if (LW_LOCK_OWNER(thin) == 0) {
+        // The lock is anonymously biased. Reserve it for us and take the first hold.
+        newThin = thin | (threadId << LW_LOCK_OWNER_SHIFT) | (1 << LW_LOCK_COUNT_SHIFT);
+        if (android_atomic_acquire_cas(thin, newThin, thinp) == 0) {
+          return;
+        }
+      } else {
+        // The lock is reserved for another thread.
+        RevokeBias(self, obj);
+      }
+      goto retry;
+    }
     /*
      * The lock is a thin lock.  The owner field is used to
      * determine the acquire method, ordered by cost.
@@ -632,6 +814,15 @@ void Monitor::MonitorEnter(Thread* self, mirror::Object* obj) {
         goto retry;
       }
     } else {
+      // The lock is owned by another thread. Spin briefly in case it is about to be released,
+      // avoiding the yield and inflation below, unless we are needed elsewhere.
+      for (size_t i = 0; i < kThinLockSpins && !self->TestAllFlags(); ++i) {
+        SpinPause();
+        uint32_t current = *thinp;
+        if (LW_SHAPE(current) != LW_SHAPE_THIN || LW_LOCK_OWNER(current) == 0) {
+          goto retry;
+        }
+      }
       VLOG(monitor) << StringPrintf("monitor: thread %d spin on lock %p (a %s) owned by %d",
                                     threadId, thinp, PrettyTypeOf(obj).c_str(), LW_LOCK_OWNER(thin));
       // The lock is owned by another thread. Notify the runtime that we are about to wait.
@@ -707,6 +898,15 @@ bool Monitor::MonitorExit(Thread* self, mirror::Object* obj) {
    */
   uint32_t thin = *thinp;
   if (LW_SHAPE(thin) == LW_SHAPE_THIN) {
+    if (UNLIKELY(LW_BIAS(thin) != 0)) {
+      if (!IsThinLockHeldBy(thin, self->GetThinLockId())) {
+        FailedUnlock(obj, self, NULL, NULL);
+        return false;
+      }
+      // Drop a hold, keeping the lock reserved for us.
+      *thinp = thin - (1 << LW_LOCK_COUNT_SHIFT);
+      return true;
+    }
     /*
      * The lock is thin.  We must ensure that the lock is owned
      * by the given thread before unlocking it.
@@ -764,10 +964,13 @@ void Monitor::Wait(Thread* self, mirror::Object *obj, int64_t ms, int32_t ns,
   uint32_t thin = *thinp;
   if (LW_SHAPE(thin) == LW_SHAPE_THIN) {
     // Make sure that 'self' holds the lock.
-    if (LW_LOCK_OWNER(thin) != self->GetThinLockId()) {
+    if (!IsThinLockHeldBy(thin, self->GetThinLockId())) {
       ThrowIllegalMonitorStateExceptionF("object not locked by thread before wait()");
       return;
     }
+    if (LW_BIAS(thin) != 0) {
+      RevokeOwnBias(self, obj);
+    }
 
     /* This thread holds the lock.  We need to fatten the lock
      * so 'self' can block on it.  Don't update the object lock
@@ -787,10 +990,13 @@ void Monitor::Notify(Thread* self, mirror::Object *obj) {
   // waiting on an object forces lock fattening.
   if (LW_SHAPE(thin) == LW_SHAPE_THIN) {
     // Make sure that 'self' holds the lock.
-    if (LW_LOCK_OWNER(thin) != self->GetThinLockId()) {
+    if (!IsThinLockHeldBy(thin, self->GetThinLockId())) {
       ThrowIllegalMonitorStateExceptionF("object not locked by thread before notify()");
       return;
     }
+    if (LW_BIAS(thin) != 0) {
+      RevokeOwnBias(self, obj);
+    }
     // no-op;  there are no waiters to notify.
     // We inflate here in case the Notify is in a tight loop. Without inflation here the waiter
     // will struggle to get in. Bug 6961405.
@@ -808,10 +1014,13 @@ void Monitor::NotifyAll(Thread* self, mirror::Object *obj) {
   // waiting on an object forces lock fattening.
   if (LW_SHAPE(thin) == LW_SHAPE_THIN) {
     // Make sure that 'self' holds the lock.
-    if (LW_LOCK_OWNER(thin) != self->GetThinLockId()) {
+    if (!IsThinLockHeldBy(thin, self->GetThinLockId())) {
       ThrowIllegalMonitorStateExceptionF("object not locked by thread before notifyAll()");
       return;
     }
+    if (LW_BIAS(thin) != 0) {
+      RevokeOwnBias(self, obj);
+    }
     // no-op;  there are no waiters to notify.
     // We inflate here in case the NotifyAll is in a tight loop. Without inflation here the waiter
     // will struggle to get in. Bug 6961405.
@@ -824,6 +1033,9 @@ void Monitor::NotifyAll(Thread* self, mirror::Object *obj) {
 
 uint32_t Monitor::GetThinLockId(uint32_t raw_lock_word) {
   if (LW_SHAPE(raw_lock_word) == LW_SHAPE_THIN) {
+    if (LW_BIAS(raw_lock_word) != 0 && LW_LOCK_COUNT(raw_lock_word) == 0) {
+      return 0;  // Reserved but not held.
+    }
     return LW_LOCK_OWNER(raw_lock_word);
   } else {
     Thread* owner = LW_MONITOR(raw_lock_word)->owner_;
@@ -973,6 +1185,34 @@ bool Monitor::IsValidLockWord(int32_t lock_word) {
   }
 }
 
+void Monitor::DumpForSigQuit(std::ostream& os) {
+  if (!use_biased_locking_) {
+    return;
+  }
+  os << "Biased locking: " << bias_revocations_ << " revocations by contending threads, "
+     << own_bias_revocations_ << " by bias owners, "
+     << bias_revoked_classes_ << " classes no longer biased\n";
+}
+
+bool Monitor::Deflate() {
+  // Monitors used since the last GC are likely to be used again soon.
+  if (recently_used_) {
+    recently_used_ = false;
+    return false;
+  }
+  // With all mutators suspended, a thread can only be using the monitor if it owns it, is
+  // waiting on it, or is trying to lock it, and the latter two are counted as waiters.
+  if (owner_ != NULL || wait_set_ != NULL || num_waiters_ != 0) {
+    return false;
+  }
+  volatile int32_t* thinp = obj_->GetRawLockWordAddress();
+  uint32_t fat = *thinp;
+  DCHECK_EQ(LW_SHAPE(fat), LW_SHAPE_FAT);
+  DCHECK_EQ(LW_MONITOR(fat), this);
+  *thinp = fat & (LW_HASH_STATE_MASK << LW_HASH_STATE_SHIFT);
+  return true;
+}
+
 void Monitor::TranslateLocation(const mirror::ArtMethod* method, uint32_t dex_pc,
                                 const char*& source_file, uint32_t& line_number) const {
   // If method is null, location is unknown
@@ -1020,6 +1260,25 @@ void MonitorList::Add(Monitor* m) {
   list_.push_front(m);
 }
 
+size_t MonitorList::DeflateMonitors() {
+  Thread* self = Thread::Current();
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  MutexLock mu(self, monitor_list_lock_);
+  size_t deflated = 0;
+  for (auto it = list_.begin(); it != list_.end(); ) {
+    Monitor* m = *it;
+    if (m->Deflate()) {
+      VLOG(monitor) << "deflated monitor " << m << " for object " << m->GetObject();
+      delete m;
+      it = list_.erase(it);
+      ++deflated;
+    } else {
+      ++it;
+    }
+  }
+  return deflated;
+}
+
 void MonitorList::SweepMonitorList(IsMarkedTester is_marked, void* arg) {
   MutexLock mu(Thread::Current(), monitor_list_lock_);
   for (auto it = list_.begin(); it != list_.end(); ) {
@@ -1037,10 +1296,11 @@ void MonitorList::SweepMonitorList(IsMarkedTester is_marked, void* arg) {
 MonitorInfo::MonitorInfo(mirror::Object* o) : owner(NULL), entry_count(0) {
   uint32_t lock_word = *o->GetRawLockWordAddress();
   if (LW_SHAPE(lock_word) == LW_SHAPE_THIN) {
-    uint32_t owner_thin_lock_id = LW_LOCK_OWNER(lock_word);
+    uint32_t owner_thin_lock_id = Monitor::GetThinLockId(lock_word);
     if (owner_thin_lock_id != 0) {
       owner = Runtime::Current()->GetThreadList()->FindThreadByThinLockId(owner_thin_lock_id);
-      entry_count = 1 + LW_LOCK_COUNT(lock_word);
+      // A biased lock counts holds rather than recursive acquisitions.
+      entry_count = (LW_BIAS(lock_word) != 0 ? 0 : 1) + LW_LOCK_COUNT(lock_word);
     }
     // Thin locks have no waiters.
   } else {
@@ -24,6 +24,7 @@
 #include <list>
 #include <vector>
 
+#include "atomic_integer.h"
 #include "base/mutex.h"
 #include "root_visitor.h"
 #include "thread_state.h"
@@ -55,8 +56,27 @@ namespace art {
 #define LW_LOCK_OWNER_SHIFT 3
 #define LW_LOCK_OWNER(x) (((x) >> LW_LOCK_OWNER_SHIFT) & LW_LOCK_OWNER_MASK)
 
+/*
+ * Lock bias field.  When set, the thin lock is biased towards the thread
+ * in the owner field, or is anonymously biased if the owner field is 0.
+ */
+#define LW_BIAS_MASK 0x1
+#define LW_BIAS_SHIFT 19
+#define LW_BIAS(x) (((x) >> LW_BIAS_SHIFT) & LW_BIAS_MASK)
+
+/*
+ * Lock recursion count field.  Contains a count of the number of times
+ * a lock has been recursively acquired.  For a biased lock it contains
+ * the number of times the bias owner holds the lock, 0 meaning that the
+ * lock is reserved but not held.
+ */
+#define LW_LOCK_COUNT_MASK 0xfff
+#define LW_LOCK_COUNT_SHIFT 20
+#define LW_LOCK_COUNT(x) (((x) >> LW_LOCK_COUNT_SHIFT) & LW_LOCK_COUNT_MASK)
+
 namespace mirror {
   class ArtMethod;
+  class Class;
   class Object;
 }  // namespace mirror
 class Thread;
@@ -67,7 +87,17 @@ class Monitor {
   ~Monitor();
 
   static bool IsSensitiveThread();
-  static void Init(uint32_t lock_profiling_threshold, bool (*is_sensitive_thread_hook)());
+  static void Init(uint32_t lock_profiling_threshold, bool (*is_sensitive_thread_hook)(),
+                   bool use_biased_locking);
+
+  static bool UseBiasedLocking() {
+    return use_biased_locking_;
+  }
+
+  // Returns the lock word for a newly allocated instance of klass: anonymously biased if biased
+  // locking is enabled and instances of klass have not had their bias revoked too often.
+  static uint32_t GetInitialLockWord(const mirror::Class* klass)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
   static uint32_t GetThinLockId(uint32_t raw_lock_word)
       NO_THREAD_SAFETY_ANALYSIS;  // Reading lock owner without holding lock is racy.
@@ -102,6 +132,9 @@ class Monitor {
 
   static bool IsValidLockWord(int32_t lock_word);
 
+  // Dumps biased locking statistics.
+  static void DumpForSigQuit(std::ostream& os);
+
   mirror::Object* GetObject();
 
  private:
@@ -114,6 +147,16 @@ class Monitor {
   static void Inflate(Thread* self, mirror::Object* obj)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
+  // Turns a lock biased towards self into an ordinary thin lock with the same hold count.
+  static void RevokeOwnBias(Thread* self, mirror::Object* obj)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Turns a lock biased towards another thread into an ordinary thin lock. Suspends all other
+  // threads so that the bias owner can't be updating the lock word while it is rewritten.
+  static void RevokeBias(Thread* self, mirror::Object* obj)
+      LOCKS_EXCLUDED(Locks::thread_list_lock_, Locks::thread_suspend_count_lock_)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
   void LogContentionEvent(Thread* self, uint32_t wait_ms, uint32_t sample_percent,
                           const char* owner_filename, uint32_t owner_line_number)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
@@ -123,6 +166,17 @@ class Monitor {
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
   void Lock(Thread* self) EXCLUSIVE_LOCK_FUNCTION(monitor_lock_);
+
+  // Spins while the lock is held, returning true if it was acquired. The number of spins adapts to
+  // how long the lock has recently been held for.
+  bool TrySpinLock(Thread* self) NO_THREAD_SAFETY_ANALYSIS;
+
+  // Records self as the owner after acquiring monitor_lock_.
+  void AcquiredLock(Thread* self) EXCLUSIVE_LOCKS_REQUIRED(monitor_lock_);
+
+  // Restores the object's thin lock word if the monitor is idle, returning true if the monitor can
+  // be deleted. Called with all mutators suspended.
+  bool Deflate() NO_THREAD_SAFETY_ANALYSIS;
   bool Unlock(Thread* thread, bool for_wait) UNLOCK_FUNCTION(monitor_lock_);
 
   void Notify(Thread* self) NO_THREAD_SAFETY_ANALYSIS;
@@ -149,6 +203,13 @@ class Monitor {
 
   static bool (*is_sensitive_thread_hook_)();
   static uint32_t lock_profiling_threshold_;
+  static bool use_biased_locking_;
+
+  // Biased locking statistics. The revocation counts requiring suspension are only updated
+  // while all other threads are suspended.
+  static size_t bias_revocations_;
+  static size_t bias_revoked_classes_;
+  static volatile int32_t own_bias_revocations_;
 
   Mutex monitor_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
@@ -170,6 +231,15 @@ class Monitor {
   const mirror::ArtMethod* locking_method_ GUARDED_BY(monitor_lock_);
   uint32_t locking_dex_pc_ GUARDED_BY(monitor_lock_);
 
+  // Number of threads trying to lock or waiting on the monitor.
+  AtomicInteger num_waiters_;
+
+  // How many times to spin before blocking on monitor_lock_. Racy, but only a heuristic.
+  volatile uint32_t spin_limit_;
+
+  // Whether the monitor was locked since deflation was last considered.
+  bool recently_used_;
+
   friend class MonitorInfo;
   friend class MonitorList;
   friend class mirror::Object;
@@ -182,6 +252,8 @@ class MonitorList {
   ~MonitorList();
 
   void Add(Monitor* m);
+  // Deflates idle monitors, returning how many were deflated.
+  size_t DeflateMonitors() EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_);
   void SweepMonitorList(IsMarkedTester is_marked, void* arg)
       SHARED_LOCKS_REQUIRED(Locks::heap_bitmap_lock_);
   void DisallowNewMonitors();
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "monitor.h"
+
+#include "common_test.h"
+#include "mirror/class-inl.h"
+#include "mirror/object-inl.h"
+#include "sirt_ref.h"
+#include "thread_list.h"
+#include "utils.h"
+
+namespace art {
+
+class MonitorTest : public CommonTest {
+ protected:
+  mirror::Object* AllocObject(Thread* self) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    return class_linker_->FindSystemClass("Ljava/lang/Object;")->AllocObject(self);
+  }
+
+  static uint32_t LockWord(mirror::Object* obj) {
+    return *obj->GetRawLockWordAddress();
+  }
+
+  // Times uncontended enter/exit pairs on obj, returning the average in nanoseconds.
+  static uint64_t TimeUncontendedLocking(Thread* self, mirror::Object* obj)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    static const size_t kIterations = 1000000;
+    uint64_t start = NanoTime();
+    for (size_t i = 0; i < kIterations; ++i) {
+      obj->MonitorEnter(self);
+      obj->MonitorExit(self);
+    }
+    return (NanoTime() - start) / kIterations;
+  }
+};
+
+TEST_F(MonitorTest, BiasedLocking) {
+  ScopedObjectAccess soa(Thread::Current());
+  Thread* self = soa.Self();
+  Monitor::Init(0, NULL, true);
+
+  // New objects start out anonymously biased.
+  SirtRef<mirror::Object> obj(self, AllocObject(self));
+  ASSERT_TRUE(obj.get() != NULL);
+  EXPECT_EQ(1U, LW_BIAS(LockWord(obj.get())));
+  EXPECT_EQ(0U, LW_LOCK_OWNER(LockWord(obj.get())));
+  EXPECT_EQ(0U, obj->GetThinLockId());
+
+  // The first lock reserves the object for us.
+  obj->MonitorEnter(self);
+  EXPECT_EQ(1U, LW_BIAS(LockWord(obj.get())));
+  EXPECT_EQ(self->GetThinLockId(), LW_LOCK_OWNER(LockWord(obj.get())));
+  EXPECT_EQ(1U, LW_LOCK_COUNT(LockWord(obj.get())));
+  EXPECT_EQ(self->GetThinLockId(), obj->GetThinLockId());
+
+  obj->MonitorEnter(self);
+  EXPECT_EQ(2U, LW_LOCK_COUNT(LockWord(obj.get())));
+  EXPECT_TRUE(obj->MonitorExit(self));
+  EXPECT_TRUE(obj->MonitorExit(self));
+
+  // Released but still reserved for us.
+  EXPECT_EQ(1U, LW_BIAS(LockWord(obj.get())));
+  EXPECT_EQ(self->GetThinLockId(), LW_LOCK_OWNER(LockWord(obj.get())));
+  EXPECT_EQ(0U, LW_LOCK_COUNT(LockWord(obj.get())));
+  EXPECT_EQ(0U, obj->GetThinLockId());
+
+  // Unlocking a reserved lock that isn't held is an error.
+  EXPECT_FALSE(obj->MonitorExit(self));
+  EXPECT_TRUE(self->IsExceptionPending());
+  self->ClearException();
+
+  // Notifying revokes our own bias before inflating the lock.
+  obj->MonitorEnter(self);
+  obj->Notify(self);
+  EXPECT_FALSE(self->IsExceptionPending());
+  EXPECT_EQ(static_cast<uint32_t>(LW_SHAPE_FAT), LockWord(obj.get()) & 1);
+  EXPECT_EQ(self->GetThinLockId(), obj->GetThinLockId());
+  EXPECT_TRUE(obj->MonitorExit(self));
+  EXPECT_EQ(0U, obj->GetThinLockId());
+
+  Monitor::Init(0, NULL, false);
+  SirtRef<mirror::Object> unbiased(self, AllocObject(self));
+  EXPECT_EQ(0U, LockWord(unbiased.get()));
+}
+
+TEST_F(MonitorTest, BiasedLockingNotForClasses) {
+  ScopedObjectAccess soa(Thread::Current());
+  Monitor::Init(0, NULL, true);
+  mirror::Class* java_lang_Class = class_linker_->FindSystemClass("Ljava/lang/Class;");
+  EXPECT_EQ(0U, Monitor::GetInitialLockWord(java_lang_Class));
+  mirror::Class* java_lang_Object = class_linker_->FindSystemClass("Ljava/lang/Object;");
+  EXPECT_NE(0U, Monitor::GetInitialLockWord(java_lang_Object));
+  Monitor::Init(0, NULL, false);
+  EXPECT_EQ(0U, Monitor::GetInitialLockWord(java_lang_Object));
+}
+
+TEST_F(MonitorTest, Deflation) {
+  ScopedObjectAccess soa(Thread::Current());
+  Thread* self = soa.Self();
+  SirtRef<mirror::Object> obj(self, AllocObject(self));
+  obj->MonitorEnter(self);
+  obj->Notify(self);  // Inflates the lock.
+  EXPECT_TRUE(obj->MonitorExit(self));
+  EXPECT_EQ(static_cast<uint32_t>(LW_SHAPE_FAT), LockWord(obj.get()) & 1);
+
+  MonitorList* monitor_list = Runtime::Current()->GetMonitorList();
+  ThreadList* thread_list = Runtime::Current()->GetThreadList();
+  self->TransitionFromRunnableToSuspended(kNative);
+  thread_list->SuspendAll();
+  // A monitor used since the last pass survives it.
+  monitor_list->DeflateMonitors();
+  EXPECT_EQ(static_cast<uint32_t>(LW_SHAPE_FAT), LockWord(obj.get()) & 1);
+  monitor_list->DeflateMonitors();
+  EXPECT_EQ(0U, LockWord(obj.get()));
+  thread_list->ResumeAll();
+  self->TransitionFromSuspendedToRunnable();
+
+  obj->MonitorEnter(self);
+  EXPECT_EQ(self->GetThinLockId(), obj->GetThinLockId());
+  EXPECT_TRUE(obj->MonitorExit(self));
+}
+
+TEST_F(MonitorTest, DISABLED_UncontendedLockBenchmark) {
+  ScopedObjectAccess soa(Thread::Current());
+  Thread* self = soa.Self();
+
+  Monitor::Init(0, NULL, false);
+  SirtRef<mirror::Object> thin(self, AllocObject(self));
+  uint64_t thin_ns = TimeUncontendedLocking(self, thin.get());
+
+  Monitor::Init(0, NULL, true);
+  SirtRef<mirror::Object> biased(self, AllocObject(self));
+  uint64_t biased_ns = TimeUncontendedLocking(self, biased.get());
+  EXPECT_EQ(1U, LW_BIAS(LockWord(biased.get())));
+  Monitor::Init(0, NULL, false);
+
+  LOG(INFO) << "Uncontended enter/exit: thin " << thin_ns << "ns, biased " << biased_ns << "ns";
+}
+
+}  // namespace art
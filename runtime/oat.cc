@@ -22,13 +22,14 @@
 namespace art {
 
 const uint8_t OatHeader::kOatMagic[] = { 'o', 'a', 't', '\n' };
-const uint8_t OatHeader::kOatVersion[] = { '0', '0', '8', '\0' };
+const uint8_t OatHeader::kOatVersion[] = { '0', '1', '0', '\0' };
 
 OatHeader::OatHeader() {
   memset(this, 0, sizeof(*this));
 }
 
 OatHeader::OatHeader(InstructionSet instruction_set,
+                     bool debuggable,
                      const std::vector<const DexFile*>* dex_files,
                      uint32_t image_file_location_oat_checksum,
                      uint32_t image_file_location_oat_data_begin,
@@ -42,6 +43,9 @@ OatHeader::OatHeader(InstructionSet instruction_set,
   instruction_set_ = instruction_set;
   UpdateChecksum(&instruction_set_, sizeof(instruction_set_));
 
+  debuggable_ = debuggable ? 1 : 0;
+  UpdateChecksum(&debuggable_, sizeof(debuggable_));
+
   dex_file_count_ = dex_files->size();
   UpdateChecksum(&dex_file_count_, sizeof(dex_file_count_));
 
@@ -63,6 +67,7 @@ OatHeader::OatHeader(InstructionSet instruction_set,
   portable_resolution_trampoline_offset_ = 0;
   portable_to_interpreter_bridge_offset_ = 0;
   quick_resolution_trampoline_offset_ = 0;
+  quick_imt_conflict_trampoline_offset_ = 0;
   quick_to_interpreter_bridge_offset_ = 0;
 }
 
@@ -97,6 +102,11 @@ InstructionSet OatHeader::GetInstructionSet() const {
   return instruction_set_;
 }
 
+bool OatHeader::IsDebuggable() const {
+  CHECK(IsValid());
+  return debuggable_ != 0;
+}
+
 uint32_t OatHeader::GetExecutableOffset() const {
   DCHECK(IsValid());
   DCHECK_ALIGNED(executable_offset_, kPageSize);
@@ -228,18 +238,37 @@ void OatHeader::SetQuickResolutionTrampolineOffset(uint32_t offset) {
   UpdateChecksum(&quick_resolution_trampoline_offset_, sizeof(offset));
 }
 
+const void* OatHeader::GetQuickImtConflictTrampoline() const {
+  return reinterpret_cast<const uint8_t*>(this) + GetQuickImtConflictTrampolineOffset();
+}
+
+uint32_t OatHeader::GetQuickImtConflictTrampolineOffset() const {
+  DCHECK(IsValid());
+  CHECK_GE(quick_imt_conflict_trampoline_offset_, quick_resolution_trampoline_offset_);
+  return quick_imt_conflict_trampoline_offset_;
+}
+
+void OatHeader::SetQuickImtConflictTrampolineOffset(uint32_t offset) {
+  CHECK(offset == 0 || offset >= quick_resolution_trampoline_offset_);
+  DCHECK(IsValid());
+  DCHECK_EQ(quick_imt_conflict_trampoline_offset_, 0U) << offset;
+
+  quick_imt_conflict_trampoline_offset_ = offset;
+  UpdateChecksum(&quick_imt_conflict_trampoline_offset_, sizeof(offset));
+}
+
 const void* OatHeader::GetQuickToInterpreterBridge() const {
   return reinterpret_cast<const uint8_t*>(this) + GetQuickToInterpreterBridgeOffset();
 }
 
 uint32_t OatHeader::GetQuickToInterpreterBridgeOffset() const {
   DCHECK(IsValid());
-  CHECK_GE(quick_to_interpreter_bridge_offset_, quick_resolution_trampoline_offset_);
+  CHECK_GE(quick_to_interpreter_bridge_offset_, quick_imt_conflict_trampoline_offset_);
   return quick_to_interpreter_bridge_offset_;
 }
 
 void OatHeader::SetQuickToInterpreterBridgeOffset(uint32_t offset) {
-  CHECK(offset == 0 || offset >= quick_resolution_trampoline_offset_);
+  CHECK(offset == 0 || offset >= quick_imt_conflict_trampoline_offset_);
   DCHECK(IsValid());
   DCHECK_EQ(quick_to_interpreter_bridge_offset_, 0U) << offset;
 
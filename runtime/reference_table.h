@@ -54,6 +54,7 @@ class ReferenceTable {
   static void Dump(std::ostream& os, const Table& entries)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
   friend class IndirectReferenceTable;  // For Dump.
+  friend class StripedIndirectReferenceTable;  // For Dump.
 
   std::string name_;
   Table entries_;
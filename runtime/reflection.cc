@@ -16,6 +16,7 @@
 
 #include "reflection.h"
 
+#include "base/stl_util.h"
 #include "class_linker.h"
 #include "common_throws.h"
 #include "dex_file-inl.h"
@@ -28,6 +29,7 @@
 #include "mirror/object_array.h"
 #include "mirror/object_array-inl.h"
 #include "object_utils.h"
+#include "runtime.h"
 #include "scoped_thread_state_change.h"
 #include "well_known_classes.h"
 
@@ -43,6 +45,11 @@ jobject InvokeMethod(const ScopedObjectAccess& soa, jobject javaMethod, jobject
     return NULL;
   }
 
+  const InvokeAdapter* adapter = Runtime::Current()->GetInvokeAdapterTable()->GetInvokeAdapter(m);
+  if (adapter == NULL) {
+    return NULL;
+  }
+
   mirror::Object* receiver = NULL;
   if (!m->IsStatic()) {
     // Check that the receiver is non-null and an instance of the field's declaring class.
@@ -53,53 +60,138 @@ jobject InvokeMethod(const ScopedObjectAccess& soa, jobject javaMethod, jobject
 
     // Find the actual implementation of the virtual method.
     m = receiver->GetClass()->FindVirtualMethodForVirtualOrInterface(m);
-    mid = soa.EncodeMethod(m);
   }
 
-  // Get our arrays of arguments and their types, and check they're the same size.
+  // Check and unbox the arguments, and invoke the method.
   mirror::ObjectArray<mirror::Object>* objects =
       soa.Decode<mirror::ObjectArray<mirror::Object>*>(javaArgs);
+  JValue value;
+  if (!adapter->Invoke(soa, m, receiver, objects, &value)) {
+    return NULL;
+  }
+
+  // Wrap any exception with "Ljava/lang/reflect/InvocationTargetException;" and return early.
+  if (soa.Self()->IsExceptionPending()) {
+    jthrowable th = soa.Env()->ExceptionOccurred();
+    soa.Env()->ExceptionClear();
+    jclass exception_class = soa.Env()->FindClass("java/lang/reflect/InvocationTargetException");
+    jmethodID mid = soa.Env()->GetMethodID(exception_class, "<init>", "(Ljava/lang/Throwable;)V");
+    jobject exception_instance = soa.Env()->NewObject(exception_class, mid, th);
+    soa.Env()->Throw(reinterpret_cast<jthrowable>(exception_instance));
+    return NULL;
+  }
+
+  // Box if necessary and return.
+  return soa.AddLocalReference<jobject>(BoxPrimitive(adapter->GetReturnType(), value));
+}
+
+InvokeAdapter::InvokeAdapter(const char* shorty, uint32_t shorty_len)
+    : shorty_(shorty), shorty_len_(shorty_len), parameter_types_(new mirror::Class*[shorty_len]) {
+}
+
+InvokeAdapter* InvokeAdapter::Create(mirror::ArtMethod* m) {
   MethodHelper mh(m);
+  UniquePtr<InvokeAdapter> adapter(new InvokeAdapter(mh.GetShorty(), mh.GetShortyLength()));
   const DexFile::TypeList* classes = mh.GetParameterTypeList();
   uint32_t classes_size = classes == NULL ? 0 : classes->Size();
-  uint32_t arg_count = (objects != NULL) ? objects->GetLength() : 0;
-  if (arg_count != classes_size) {
+  DCHECK_EQ(classes_size + 1, adapter->shorty_len_);
+  for (uint32_t i = 0; i < classes_size; ++i) {
+    mirror::Class* parameter_type = mh.GetClassFromTypeIdx(classes->GetTypeItem(i).type_idx_);
+    if (parameter_type == NULL) {
+      DCHECK(Thread::Current()->IsExceptionPending());
+      return NULL;
+    }
+    adapter->parameter_types_[i] = parameter_type;
+  }
+  return adapter.release();
+}
+
+bool InvokeAdapter::Invoke(const ScopedObjectAccess& soa, mirror::ArtMethod* m,
+                           mirror::Object* receiver, mirror::ObjectArray<mirror::Object>* args,
+                           JValue* result) const {
+  uint32_t num_parameters = shorty_len_ - 1;
+  uint32_t arg_count = (args != NULL) ? args->GetLength() : 0;
+  if (UNLIKELY(arg_count != num_parameters)) {
     ThrowIllegalArgumentException(NULL,
                                   StringPrintf("Wrong number of arguments; expected %d, got %d",
-                                               classes_size, arg_count).c_str());
-    return NULL;
+                                               num_parameters, arg_count).c_str());
+    return false;
   }
 
-  // Translate javaArgs to a jvalue[].
-  UniquePtr<jvalue[]> args(new jvalue[arg_count]);
-  JValue* decoded_args = reinterpret_cast<JValue*>(args.get());
+  ArgArray arg_array(shorty_, shorty_len_);
+  if (receiver != NULL) {
+    arg_array.Append(reinterpret_cast<int32_t>(receiver));
+  }
   for (uint32_t i = 0; i < arg_count; ++i) {
-    mirror::Object* arg = objects->Get(i);
-    mirror::Class* dst_class = mh.GetClassFromTypeIdx(classes->GetTypeItem(i).type_idx_);
-    if (!UnboxPrimitiveForArgument(arg, dst_class, decoded_args[i], m, i)) {
-      return NULL;
+    JValue value;
+    if (!UnboxPrimitiveForArgument(args->Get(i), parameter_types_[i], value, m, i)) {
+      return false;
     }
-    if (!dst_class->IsPrimitive()) {
-      args[i].l = soa.AddLocalReference<jobject>(arg);
+    switch (shorty_[i + 1]) {
+      case 'Z':
+        arg_array.Append(value.GetZ());
+        break;
+      case 'B':
+        arg_array.Append(value.GetB());
+        break;
+      case 'C':
+        arg_array.Append(value.GetC());
+        break;
+      case 'S':
+        arg_array.Append(value.GetS());
+        break;
+      case 'I':
+      case 'F':
+        arg_array.Append(value.GetI());
+        break;
+      case 'L':
+        arg_array.Append(reinterpret_cast<int32_t>(value.GetL()));
+        break;
+      case 'D':
+      case 'J':
+        arg_array.AppendWide(value.GetJ());
+        break;
     }
   }
+  InvokeWithArgArray(soa, m, &arg_array, result, shorty_[0]);
+  return true;
+}
 
-  // Invoke the method.
-  JValue value(InvokeWithJValues(soa, javaReceiver, mid, args.get()));
+InvokeAdapterTable::InvokeAdapterTable()
+    : lock_("reflective invoke adapter table lock", kDefaultMutexLevel) {
+}
 
-  // Wrap any exception with "Ljava/lang/reflect/InvocationTargetException;" and return early.
-  if (soa.Self()->IsExceptionPending()) {
-    jthrowable th = soa.Env()->ExceptionOccurred();
-    soa.Env()->ExceptionClear();
-    jclass exception_class = soa.Env()->FindClass("java/lang/reflect/InvocationTargetException");
-    jmethodID mid = soa.Env()->GetMethodID(exception_class, "<init>", "(Ljava/lang/Throwable;)V");
-    jobject exception_instance = soa.Env()->NewObject(exception_class, mid, th);
-    soa.Env()->Throw(reinterpret_cast<jthrowable>(exception_instance));
+InvokeAdapterTable::~InvokeAdapterTable() {
+  STLDeleteValues(&adapters_);
+}
+
+const InvokeAdapter* InvokeAdapterTable::GetInvokeAdapter(mirror::ArtMethod* m) {
+  Thread* self = Thread::Current();
+  {
+    ReaderMutexLock mu(self, lock_);
+    SafeMap<const mirror::ArtMethod*, InvokeAdapter*>::const_iterator it = adapters_.find(m);
+    if (LIKELY(it != adapters_.end())) {
+      return it->second;
+    }
+  }
+  // Resolving the parameter types may run class loaders, so build the adapter unlocked.
+  UniquePtr<InvokeAdapter> adapter(InvokeAdapter::Create(m));
+  if (adapter.get() == NULL) {
     return NULL;
   }
+  WriterMutexLock mu(self, lock_);
+  SafeMap<const mirror::ArtMethod*, InvokeAdapter*>::const_iterator it = adapters_.find(m);
+  if (it != adapters_.end()) {
+    // Created by another thread while we weren't holding the lock.
+    return it->second;
+  }
+  adapters_.Put(m, adapter.get());
+  return adapter.release();
+}
 
-  // Box if necessary and return.
-  return soa.AddLocalReference<jobject>(BoxPrimitive(mh.GetReturnType()->GetPrimitiveType(), value));
+void InvokeAdapterTable::DumpForSigQuit(std::ostream& os) const {
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  os << "Reflective invoke adapters: " << adapters_.size() << " methods\n";
 }
 
 bool VerifyObjectInClass(mirror::Object* o, mirror::Class* c) {
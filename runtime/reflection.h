@@ -17,8 +17,14 @@
 #ifndef ART_RUNTIME_REFLECTION_H_
 #define ART_RUNTIME_REFLECTION_H_
 
+#include <iosfwd>
+
+#include "base/macros.h"
+#include "base/mutex.h"
 #include "jni.h"
 #include "primitive.h"
+#include "safe_map.h"
+#include "UniquePtr.h"
 
 namespace art {
 namespace mirror {
@@ -26,6 +32,7 @@ namespace mirror {
   class ArtMethod;
   class Class;
   class Object;
+  template<class T> class ObjectArray;
 }  // namespace mirror
 union JValue;
 class ScopedObjectAccess;
@@ -54,6 +61,58 @@ jobject InvokeMethod(const ScopedObjectAccess& soa, jobject method, jobject rece
 bool VerifyObjectInClass(mirror::Object* o, mirror::Class* c)
     SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
+// Calls a method on behalf of Method.invoke and Constructor.newInstance. An adapter is built from
+// the method's shorty and parameter types on the first reflective call of the method, so later
+// calls check and unbox their arguments straight into an argument array without parsing the
+// signature or resolving types again. Classes are neither moved nor unloaded, so the adapter
+// holds no roots.
+class InvokeAdapter {
+ public:
+  // Returns NULL with an exception pending if a parameter type can't be resolved.
+  static InvokeAdapter* Create(mirror::ArtMethod* m) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Checks and unboxes args and invokes m, which must have the signature the adapter was built
+  // for. Returns false with an exception pending if the arguments don't match, otherwise the
+  // result is in result and any exception thrown by m is pending.
+  bool Invoke(const ScopedObjectAccess& soa, mirror::ArtMethod* m, mirror::Object* receiver,
+              mirror::ObjectArray<mirror::Object>* args, JValue* result) const
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  Primitive::Type GetReturnType() const {
+    return Primitive::GetType(shorty_[0]);
+  }
+
+ private:
+  InvokeAdapter(const char* shorty, uint32_t shorty_len);
+
+  // The shorty lives in the dex file, which outlives the adapter.
+  const char* const shorty_;
+  const uint32_t shorty_len_;
+  UniquePtr<mirror::Class*[]> parameter_types_;
+
+  DISALLOW_COPY_AND_ASSIGN(InvokeAdapter);
+};
+
+// Owns the invoke adapters of every reflectively called method.
+class InvokeAdapterTable {
+ public:
+  InvokeAdapterTable();
+  ~InvokeAdapterTable();
+
+  // Returns the adapter of m, creating it on first use. Returns NULL with an exception pending if
+  // it can't be created.
+  const InvokeAdapter* GetInvokeAdapter(mirror::ArtMethod* m)
+      LOCKS_EXCLUDED(lock_) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  void DumpForSigQuit(std::ostream& os) const LOCKS_EXCLUDED(lock_);
+
+ private:
+  mutable ReaderWriterMutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  SafeMap<const mirror::ArtMethod*, InvokeAdapter*> adapters_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(InvokeAdapterTable);
+};
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_REFLECTION_H_
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "reflection.h"
+
+#include "common_test.h"
+#include "jvalue.h"
+#include "mirror/art_field-inl.h"
+#include "mirror/art_method-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/object_array-inl.h"
+#include "sirt_ref.h"
+#include "utils.h"
+#include "well_known_classes.h"
+
+namespace art {
+
+class ReflectionTest : public CommonTest {
+ protected:
+  // Compiles the methods of the Reflection test class and starts the runtime so they can run.
+  mirror::Class* SetUpReflectionClass() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    Thread* self = Thread::Current();
+    jobject jclass_loader = LoadDex("Reflection");
+    SirtRef<mirror::ClassLoader> class_loader(self,
+        ScopedObjectAccessUnchecked(self).Decode<mirror::ClassLoader*>(jclass_loader));
+    CompileDirectMethod(class_loader.get(), "Reflection", "add", "(IJLjava/lang/Object;)V");
+    CompileDirectMethod(class_loader.get(), "Reflection", "identity",
+                        "(Ljava/lang/Object;)Ljava/lang/Object;");
+    mirror::Class* c = class_linker_->FindClass("LReflection;", class_loader.get());
+    CHECK(c != NULL);
+    bool started = runtime_->Start();
+    CHECK(started);
+    self->TransitionFromSuspendedToRunnable();
+    return c;
+  }
+
+  // Boxes value the way Integer.valueOf and Long.valueOf would, without running managed code.
+  mirror::Object* Box(const char* descriptor, const char* type, int64_t value)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    mirror::Class* c = class_linker_->FindSystemClass(descriptor);
+    mirror::Object* box = c->AllocObject(Thread::Current());
+    mirror::ArtField* field = c->FindDeclaredInstanceField("value", type);
+    if (type[0] == 'J') {
+      field->SetLong(box, value);
+    } else {
+      field->SetInt(box, static_cast<int32_t>(value));
+    }
+    return box;
+  }
+
+  jobject ToReflectedMethod(const ScopedObjectAccess& soa, mirror::Class* c, const char* name,
+                            const char* signature) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    mirror::ArtMethod* m = c->FindDirectMethod(name, signature);
+    CHECK(m != NULL);
+    return soa.Env()->ToReflectedMethod(soa.AddLocalReference<jclass>(c), soa.EncodeMethod(m),
+                                        JNI_TRUE);
+  }
+
+  jlong GetTotal(mirror::Class* c) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    return c->FindDeclaredStaticField("total", "J")->GetLong(c);
+  }
+};
+
+TEST_F(ReflectionTest, InvokeAdapter) {
+  TEST_DISABLED_FOR_PORTABLE();
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::Class* c = SetUpReflectionClass();
+  jobject add = ToReflectedMethod(soa, c, "add", "(IJLjava/lang/Object;)V");
+  ASSERT_TRUE(add != NULL);
+
+  jobjectArray args = soa.Env()->NewObjectArray(3, WellKnownClasses::java_lang_Object, NULL);
+  mirror::ObjectArray<mirror::Object>* array =
+      soa.Decode<mirror::ObjectArray<mirror::Object>*>(args);
+  array->Set(0, Box("Ljava/lang/Integer;", "I", 40));
+  array->Set(1, Box("Ljava/lang/Long;", "J", 1));
+  array->Set(2, c);
+  EXPECT_TRUE(InvokeMethod(soa, add, NULL, args) == NULL);
+  ASSERT_FALSE(soa.Self()->IsExceptionPending());
+  EXPECT_EQ(42, GetTotal(c));
+
+  // The adapter built by the first call is reused by the next ones.
+  InvokeAdapterTable* table = Runtime::Current()->GetInvokeAdapterTable();
+  mirror::ArtMethod* m = c->FindDirectMethod("add", "(IJLjava/lang/Object;)V");
+  const InvokeAdapter* adapter = table->GetInvokeAdapter(m);
+  ASSERT_TRUE(adapter != NULL);
+  EXPECT_EQ(Primitive::kPrimVoid, adapter->GetReturnType());
+  array->Set(2, NULL);
+  InvokeMethod(soa, add, NULL, args);
+  ASSERT_FALSE(soa.Self()->IsExceptionPending());
+  EXPECT_EQ(83, GetTotal(c));
+  EXPECT_EQ(adapter, table->GetInvokeAdapter(m));
+
+  // References are returned as they are.
+  jobject identity = ToReflectedMethod(soa, c, "identity",
+                                       "(Ljava/lang/Object;)Ljava/lang/Object;");
+  ASSERT_TRUE(identity != NULL);
+  jobjectArray identity_args = soa.Env()->NewObjectArray(1, WellKnownClasses::java_lang_Object,
+                                                         args);
+  jobject result = InvokeMethod(soa, identity, NULL, identity_args);
+  ASSERT_FALSE(soa.Self()->IsExceptionPending());
+  EXPECT_TRUE(soa.Env()->IsSameObject(args, result));
+}
+
+TEST_F(ReflectionTest, DISABLED_InvokeBenchmark) {
+  TEST_DISABLED_FOR_PORTABLE();
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::Class* c = SetUpReflectionClass();
+  jobject add = ToReflectedMethod(soa, c, "add", "(IJLjava/lang/Object;)V");
+  ASSERT_TRUE(add != NULL);
+  jclass jklass = soa.AddLocalReference<jclass>(c);
+  jmethodID mid = soa.Env()->FromReflectedMethod(add);
+  jobjectArray args = soa.Env()->NewObjectArray(3, WellKnownClasses::java_lang_Object, NULL);
+  mirror::ObjectArray<mirror::Object>* array =
+      soa.Decode<mirror::ObjectArray<mirror::Object>*>(args);
+  array->Set(0, Box("Ljava/lang/Integer;", "I", 1));
+  array->Set(1, Box("Ljava/lang/Long;", "J", 2));
+
+  static const size_t kIterations = 100000;
+  uint64_t start = NanoTime();
+  for (size_t i = 0; i < kIterations; ++i) {
+    soa.Env()->CallStaticVoidMethod(jklass, mid, 1, static_cast<jlong>(2), NULL);
+  }
+  uint64_t direct_ns = (NanoTime() - start) / kIterations;
+
+  start = NanoTime();
+  for (size_t i = 0; i < kIterations; ++i) {
+    InvokeMethod(soa, add, NULL, args);
+  }
+  uint64_t reflective_ns = (NanoTime() - start) / kIterations;
+  ASSERT_FALSE(soa.Self()->IsExceptionPending());
+  EXPECT_EQ(static_cast<jlong>(6 * kIterations), GetTotal(c));
+
+  LOG(INFO) << "Static call of (IJLjava/lang/Object;)V: direct " << direct_ns
+            << "ns, reflective " << reflective_ns << "ns";
+}
+
+}  // namespace art
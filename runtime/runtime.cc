@@ -40,6 +40,7 @@
 #include "image.h"
 #include "instrumentation.h"
 #include "intern_table.h"
+#include "interpreter/inline_cache.h"
 #include "invoke_arg_array_builder.h"
 #include "jni_internal.h"
 #include "mirror/art_field-inl.h"
@@ -50,6 +51,7 @@
 #include "mirror/throwable.h"
 #include "monitor.h"
 #include "oat_file.h"
+#include "reflection.h"
 #include "ScopedLocalRef.h"
 #include "scoped_thread_state_change.h"
 #include "signal_catcher.h"
@@ -78,11 +80,15 @@ Runtime::Runtime()
       monitor_list_(NULL),
       thread_list_(NULL),
       intern_table_(NULL),
+      inline_cache_table_(NULL),
+      invoke_adapter_table_(NULL),
       class_linker_(NULL),
       signal_catcher_(NULL),
       java_vm_(NULL),
       pre_allocated_OutOfMemoryError_(NULL),
       resolution_method_(NULL),
+      imt_conflict_method_(NULL),
+      default_imt_(NULL),
       threads_being_born_(0),
       shutdown_cond_(new ConditionVariable("Runtime shutdown", *Locks::runtime_shutdown_lock_)),
       shutting_down_(false),
@@ -131,6 +137,8 @@ Runtime::~Runtime() {
   delete class_linker_;
   delete heap_;
   delete intern_table_;
+  delete inline_cache_table_;
+  delete invoke_adapter_table_;
   delete java_vm_;
   Thread::Shutdown();
   QuasiAtomic::Shutdown();
@@ -356,6 +364,8 @@ Runtime::ParsedOptions* Runtime::ParsedOptions::Create(const Options& options, b
   parsed->ignore_max_footprint_ = false;
 
   parsed->lock_profiling_threshold_ = 0;
+  parsed->safepoint_log_threshold_ = ThreadList::kDefaultSafepointLogThreshold;
+  parsed->use_biased_locking_ = false;
   parsed->hook_is_sensitive_thread_ = NULL;
 
   parsed->hook_vfprintf_ = vfprintf;
@@ -537,6 +547,10 @@ Runtime::ParsedOptions* Runtime::ParsedOptions::Create(const Options& options, b
       }
     } else if (option == "-XX:+DisableExplicitGC") {
       parsed->is_explicit_gc_disabled_ = true;
+    } else if (option == "-XX:+UseBiasedLocking") {
+      parsed->use_biased_locking_ = true;
+    } else if (option == "-XX:-UseBiasedLocking") {
+      parsed->use_biased_locking_ = false;
     } else if (StartsWith(option, "-verbose:")) {
       std::vector<std::string> verbose_options;
       Split(option.substr(strlen("-verbose:")), ',', verbose_options);
@@ -571,6 +585,8 @@ Runtime::ParsedOptions* Runtime::ParsedOptions::Create(const Options& options, b
       // Silently ignored for backwards compatibility.
     } else if (StartsWith(option, "-Xlockprofthreshold:")) {
       parsed->lock_profiling_threshold_ = ParseIntegerOrDie(option);
+    } else if (StartsWith(option, "-Xsafepointlogthreshold:")) {
+      parsed->safepoint_log_threshold_ = MsToNs(ParseIntegerOrDie(option));
     } else if (StartsWith(option, "-Xstacktracefile:")) {
       parsed->stack_trace_file_ = option.substr(strlen("-Xstacktracefile:"));
     } else if (option == "sensitiveThread") {
@@ -838,7 +854,8 @@ bool Runtime::Init(const Options& raw_options, bool ignore_unrecognized) {
 
   QuasiAtomic::Startup();
 
-  Monitor::Init(options->lock_profiling_threshold_, options->hook_is_sensitive_thread_);
+  Monitor::Init(options->lock_profiling_threshold_, options->hook_is_sensitive_thread_,
+                options->use_biased_locking_);
 
   host_prefix_ = options->host_prefix_;
   boot_class_path_string_ = options->boot_class_path_string_;
@@ -866,8 +883,10 @@ bool Runtime::Init(const Options& raw_options, bool ignore_unrecognized) {
   stack_trace_file_ = options->stack_trace_file_;
 
   monitor_list_ = new MonitorList;
-  thread_list_ = new ThreadList;
+  thread_list_ = new ThreadList(options->safepoint_log_threshold_);
   intern_table_ = new InternTable;
+  inline_cache_table_ = new interpreter::InlineCacheTable;
+  invoke_adapter_table_ = new InvokeAdapterTable;
 
 
   if (options->interpreter_only_) {
@@ -1036,6 +1055,9 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
   GetInternTable()->DumpForSigQuit(os);
   GetJavaVM()->DumpForSigQuit(os);
   GetHeap()->DumpForSigQuit(os);
+  Monitor::DumpForSigQuit(os);
+  inline_cache_table_->DumpForSigQuit(os);
+  invoke_adapter_table_->DumpForSigQuit(os);
   os << "\n";
 
   thread_list_->DumpForSigQuit(os);
@@ -1094,6 +1116,10 @@ int32_t Runtime::GetStat(int kind) {
   case KIND_CLASS_INIT_TIME:
     // Convert ns to us, reduce to 32 bits.
     return static_cast<int>(stats->class_init_time_ns / 1000);
+  case KIND_TYPE_CHECK_CACHE_HITS:
+    return stats->type_check_cache_hits;
+  case KIND_TYPE_CHECK_CACHE_MISSES:
+    return stats->type_check_cache_misses;
   case KIND_EXT_ALLOCATED_OBJECTS:
   case KIND_EXT_ALLOCATED_BYTES:
   case KIND_EXT_FREED_OBJECTS:
@@ -1154,6 +1180,12 @@ void Runtime::VisitNonThreadRoots(RootVisitor* visitor, void* arg) {
     visitor(pre_allocated_OutOfMemoryError_, arg);
   }
   visitor(resolution_method_, arg);
+  if (imt_conflict_method_ != NULL) {
+    visitor(imt_conflict_method_, arg);
+  }
+  if (default_imt_ != NULL) {
+    visitor(default_imt_, arg);
+  }
   for (int i = 0; i < Runtime::kLastCalleeSaveType; i++) {
     visitor(callee_save_methods_[i], arg);
   }
@@ -1184,6 +1216,31 @@ mirror::ArtMethod* Runtime::CreateResolutionMethod() {
   return method.get();
 }
 
+mirror::ArtMethod* Runtime::CreateImtConflictMethod() {
+  mirror::Class* method_class = mirror::ArtMethod::GetJavaLangReflectArtMethod();
+  Thread* self = Thread::Current();
+  SirtRef<mirror::ArtMethod>
+      method(self, down_cast<mirror::ArtMethod*>(method_class->AllocObject(self)));
+  method->SetDeclaringClass(method_class);
+  method->SetDexMethodIndex(DexFile::kDexNoIndex);
+  // When compiling, the code pointer will get set later when the image is loaded.
+  Runtime* r = Runtime::Current();
+  ClassLinker* cl = r->GetClassLinker();
+  method->SetEntryPointFromCompiledCode(r->IsCompiler() ? NULL : GetImtConflictTrampoline(cl));
+  return method.get();
+}
+
+mirror::ObjectArray<mirror::ArtMethod>* Runtime::CreateDefaultImt(ClassLinker* cl) {
+  Thread* self = Thread::Current();
+  SirtRef<mirror::ObjectArray<mirror::ArtMethod> >
+      imtable(self, cl->AllocArtMethodArray(self, ClassLinker::kImtSize));
+  mirror::ArtMethod* imt_conflict_method = GetImtConflictMethod();
+  for (size_t i = 0; i < ClassLinker::kImtSize; ++i) {
+    imtable->Set(i, imt_conflict_method);
+  }
+  return imtable.get();
+}
+
 mirror::ArtMethod* Runtime::CreateCalleeSaveMethod(InstructionSet instruction_set,
                                                         CalleeSaveType type) {
   mirror::Class* method_class = mirror::ArtMethod::GetJavaLangReflectArtMethod();
@@ -42,9 +42,13 @@ namespace art {
 namespace gc {
   class Heap;
 }
+namespace interpreter {
+  class InlineCacheTable;
+}
 namespace mirror {
   class ArtMethod;
   class ClassLoader;
+  template<class T> class ObjectArray;
   template<class T> class PrimitiveArray;
   typedef PrimitiveArray<int8_t> ByteArray;
   class String;
@@ -53,6 +57,7 @@ namespace mirror {
 class ClassLinker;
 class DexFile;
 class InternTable;
+class InvokeAdapterTable;
 struct JavaVMExt;
 class MonitorList;
 class SignalCatcher;
@@ -114,6 +119,8 @@ class Runtime {
     size_t stack_size_;
     bool low_memory_mode_;
     size_t lock_profiling_threshold_;
+    uint64_t safepoint_log_threshold_;
+    bool use_biased_locking_;
     std::string stack_trace_file_;
     bool method_trace_;
     std::string method_trace_file_;
@@ -282,6 +289,14 @@ class Runtime {
     return intern_table_;
   }
 
+  interpreter::InlineCacheTable* GetInlineCacheTable() const {
+    return inline_cache_table_;
+  }
+
+  InvokeAdapterTable* GetInvokeAdapterTable() const {
+    return invoke_adapter_table_;
+  }
+
   JavaVMExt* GetJavaVM() const {
     return java_vm_;
   }
@@ -339,6 +354,40 @@ class Runtime {
 
   mirror::ArtMethod* CreateResolutionMethod() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
+  // Returns a special method that calls into a trampoline for resolving imt conflicts
+  mirror::ArtMethod* GetImtConflictMethod() const {
+    CHECK(HasImtConflictMethod());
+    return imt_conflict_method_;
+  }
+
+  bool HasImtConflictMethod() const {
+    return imt_conflict_method_ != NULL;
+  }
+
+  void SetImtConflictMethod(mirror::ArtMethod* method) {
+    imt_conflict_method_ = method;
+  }
+
+  mirror::ArtMethod* CreateImtConflictMethod() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Returns an imt with every entry set to the imt conflict method, shared by all classes that
+  // implement no (non-marker) interfaces
+  mirror::ObjectArray<mirror::ArtMethod>* GetDefaultImt() const {
+    CHECK(HasDefaultImt());
+    return default_imt_;
+  }
+
+  bool HasDefaultImt() const {
+    return default_imt_ != NULL;
+  }
+
+  void SetDefaultImt(mirror::ObjectArray<mirror::ArtMethod>* imt) {
+    default_imt_ = imt;
+  }
+
+  mirror::ObjectArray<mirror::ArtMethod>* CreateDefaultImt(ClassLinker* cl)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
   // Returns a special method that describes all callee saves being spilled to the stack.
   enum CalleeSaveType {
     kSaveAll,
@@ -457,6 +506,10 @@ class Runtime {
 
   InternTable* intern_table_;
 
+  interpreter::InlineCacheTable* inline_cache_table_;
+
+  InvokeAdapterTable* invoke_adapter_table_;
+
   ClassLinker* class_linker_;
 
   SignalCatcher* signal_catcher_;
@@ -470,6 +523,10 @@ class Runtime {
 
   mirror::ArtMethod* resolution_method_;
 
+  mirror::ArtMethod* imt_conflict_method_;
+
+  mirror::ObjectArray<mirror::ArtMethod>* default_imt_;
+
   // A non-zero value indicates that a thread has been created but not yet initialized. Guarded by
   // the shutdown lock so that threads aren't born while we're shutting down.
   size_t threads_being_born_ GUARDED_BY(Locks::runtime_shutdown_lock_);
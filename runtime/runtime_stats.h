@@ -30,6 +30,8 @@ enum StatKinds {
   KIND_GC_INVOCATIONS         = 1<<4,
   KIND_CLASS_INIT_COUNT       = 1<<5,
   KIND_CLASS_INIT_TIME        = 1<<6,
+  KIND_TYPE_CHECK_CACHE_HITS  = 1<<7,
+  KIND_TYPE_CHECK_CACHE_MISSES = 1<<8,
 
   // These values exist for backward compatibility.
   KIND_EXT_ALLOCATED_OBJECTS = 1<<12,
@@ -44,6 +46,8 @@ enum StatKinds {
   KIND_GLOBAL_GC_INVOCATIONS      = KIND_GC_INVOCATIONS,
   KIND_GLOBAL_CLASS_INIT_COUNT    = KIND_CLASS_INIT_COUNT,
   KIND_GLOBAL_CLASS_INIT_TIME     = KIND_CLASS_INIT_TIME,
+  KIND_GLOBAL_TYPE_CHECK_CACHE_HITS = KIND_TYPE_CHECK_CACHE_HITS,
+  KIND_GLOBAL_TYPE_CHECK_CACHE_MISSES = KIND_TYPE_CHECK_CACHE_MISSES,
 
   KIND_THREAD_ALLOCATED_OBJECTS   = KIND_ALLOCATED_OBJECTS << 16,
   KIND_THREAD_ALLOCATED_BYTES     = KIND_ALLOCATED_BYTES << 16,
@@ -51,6 +55,8 @@ enum StatKinds {
   KIND_THREAD_FREED_BYTES         = KIND_FREED_BYTES << 16,
 
   KIND_THREAD_GC_INVOCATIONS      = KIND_GC_INVOCATIONS << 16,
+  KIND_THREAD_TYPE_CHECK_CACHE_HITS = KIND_TYPE_CHECK_CACHE_HITS << 16,
+  KIND_THREAD_TYPE_CHECK_CACHE_MISSES = KIND_TYPE_CHECK_CACHE_MISSES << 16,
 
   // TODO: failedAllocCount, failedAllocSize
 };
@@ -86,6 +92,12 @@ struct PACKED(4) RuntimeStats {
     if ((flags & KIND_CLASS_INIT_TIME) != 0) {
       class_init_time_ns = 0;
     }
+    if ((flags & KIND_TYPE_CHECK_CACHE_HITS) != 0) {
+      type_check_cache_hits = 0;
+    }
+    if ((flags & KIND_TYPE_CHECK_CACHE_MISSES) != 0) {
+      type_check_cache_misses = 0;
+    }
   }
 
   // Number of objects allocated.
@@ -106,6 +118,12 @@ struct PACKED(4) RuntimeStats {
   // Cumulative time spent in class initialization.
   uint64_t class_init_time_ns;
 
+  // Number of runtime type checks answered by a class's type check cache. Hits on the probe
+  // inlined into compiled code are not counted.
+  int type_check_cache_hits;
+  // Number of runtime type checks that had to walk the class hierarchy.
+  int type_check_cache_misses;
+
   DISALLOW_COPY_AND_ASSIGN(RuntimeStats);
 };
 
@@ -146,8 +146,7 @@ void SignalCatcher::HandleSigQuit() {
   os << "----- end " << getpid() << " -----\n";
   CHECK_EQ(self->SetStateUnsafe(old_state), kRunnable);
   if (self->ReadFlag(kCheckpointRequest)) {
-    self->RunCheckpointFunction();
-    self->AtomicClearFlag(kCheckpointRequest);
+    self->RunCheckpointAtSafepoint();
   }
   self->EndAssertNoThreadSuspension(old_cause);
   thread_list->ResumeAll();
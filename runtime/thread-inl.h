@@ -65,21 +65,32 @@ inline void Thread::TransitionFromRunnableToSuspended(ThreadState new_state) {
   DCHECK_EQ(GetState(), kRunnable);
   union StateAndFlags old_state_and_flags;
   union StateAndFlags new_state_and_flags;
-  do {
+  while (true) {
     old_state_and_flags = state_and_flags_;
-    // Copy over flags and try to clear the checkpoint bit if it is set.
-    new_state_and_flags.as_struct.flags = old_state_and_flags.as_struct.flags & ~kCheckpointRequest;
+    if (UNLIKELY((old_state_and_flags.as_struct.flags & kCheckpointRequest) != 0)) {
+      // Run the checkpoint while still Runnable so that a suspender can't see us suspended before
+      // it completes. Checkpoints are only requested of Runnable threads.
+      RunCheckpointAtSafepoint();
+      continue;
+    }
+    if (UNLIKELY((old_state_and_flags.as_struct.flags & kSuspendRequest) != 0)) {
+      // Note where we were when the suspender caught up with us, while our stack is still ours.
+      RecordSafepoint(suspend_request_ns_, &last_safepoint_);
+    }
+    new_state_and_flags.as_struct.flags = old_state_and_flags.as_struct.flags;
     new_state_and_flags.as_struct.state = new_state;
-    // CAS the value without a memory barrier, that will occur in the unlock below.
-  } while (UNLIKELY(android_atomic_cas(old_state_and_flags.as_int, new_state_and_flags.as_int,
-                                       &state_and_flags_.as_int) != 0));
-  // If we toggled the checkpoint flag we must have cleared it.
-  uint16_t flag_change = new_state_and_flags.as_struct.flags ^ old_state_and_flags.as_struct.flags;
-  if (UNLIKELY((flag_change & kCheckpointRequest) != 0)) {
-    RunCheckpointFunction();
+    // Release so that our writes are visible to whoever sees us suspended.
+    if (LIKELY(android_atomic_release_cas(old_state_and_flags.as_int, new_state_and_flags.as_int,
+                                          &state_and_flags_.as_int) == 0)) {
+      break;
+    }
   }
   // Release share on mutator_lock_.
-  Locks::mutator_lock_->SharedUnlock(this);
+  Locks::mutator_lock_->TransitionFromRunnableToSuspended(this);
+  if (UNLIKELY((new_state_and_flags.as_struct.flags & kSuspendRequest) != 0)) {
+    // A suspender may be waiting for us to leave Runnable.
+    NotifySuspendRequesters();
+  }
 }
 
 inline ThreadState Thread::TransitionFromSuspendedToRunnable() {
@@ -91,7 +102,14 @@ inline ThreadState Thread::TransitionFromSuspendedToRunnable() {
     Locks::mutator_lock_->AssertNotHeld(this);  // Otherwise we starve GC..
     old_state_and_flags = state_and_flags_;
     DCHECK_EQ(old_state_and_flags.as_struct.state, old_state);
-    if (UNLIKELY((old_state_and_flags.as_struct.flags & kSuspendRequest) != 0)) {
+    if (LIKELY((old_state_and_flags.as_struct.flags & kSuspendRequest) == 0)) {
+      // Atomically change from suspended to runnable if no suspend request pending. Acquire so
+      // that writes made while we were suspended, such as by the GC, are visible to us.
+      union StateAndFlags new_state_and_flags = old_state_and_flags;
+      new_state_and_flags.as_struct.state = kRunnable;
+      done = android_atomic_acquire_cas(old_state_and_flags.as_int, new_state_and_flags.as_int,
+                                        &state_and_flags_.as_int) == 0;
+    } else {
       // Wait while our suspend count is non-zero.
       MutexLock mu(this, *Locks::thread_suspend_count_lock_);
       old_state_and_flags = state_and_flags_;
@@ -104,23 +122,9 @@ inline ThreadState Thread::TransitionFromSuspendedToRunnable() {
       }
       DCHECK_EQ(GetSuspendCount(), 0);
     }
-    // Re-acquire shared mutator_lock_ access.
-    Locks::mutator_lock_->SharedLock(this);
-    // Atomically change from suspended to runnable if no suspend request pending.
-    old_state_and_flags = state_and_flags_;
-    DCHECK_EQ(old_state_and_flags.as_struct.state, old_state);
-    if (LIKELY((old_state_and_flags.as_struct.flags & kSuspendRequest) == 0)) {
-      union StateAndFlags new_state_and_flags = old_state_and_flags;
-      new_state_and_flags.as_struct.state = kRunnable;
-      // CAS the value without a memory barrier, that occurred in the lock above.
-      done = android_atomic_cas(old_state_and_flags.as_int, new_state_and_flags.as_int,
-                                &state_and_flags_.as_int) == 0;
-    }
-    if (UNLIKELY(!done)) {
-      // Failed to transition to Runnable. Release shared mutator_lock_ access and try again.
-      Locks::mutator_lock_->SharedUnlock(this);
-    }
   } while (UNLIKELY(!done));
+  // Acquire share on mutator_lock_, implied by being Runnable.
+  Locks::mutator_lock_->TransitionFromSuspendedToRunnable(this);
   return static_cast<ThreadState>(old_state);
 }
 
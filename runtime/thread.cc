@@ -74,6 +74,7 @@ namespace art {
 bool Thread::is_started_ = false;
 pthread_key_t Thread::pthread_key_self_;
 ConditionVariable* Thread::resume_cond_ = NULL;
+ConditionVariable* Thread::suspension_cond_ = NULL;
 
 static const char* kThreadNameDuringStartup = "<native thread without managed peer>";
 
@@ -559,10 +560,18 @@ void Thread::ModifySuspendCount(Thread* self, int delta, bool for_debugger) {
   if (suspend_count_ == 0) {
     AtomicClearFlag(kSuspendRequest);
   } else {
+    if (!ReadFlag(kSuspendRequest)) {
+      suspend_request_ns_ = NanoTime();
+    }
     AtomicSetFlag(kSuspendRequest);
   }
 }
 
+void Thread::NotifySuspendRequesters() {
+  MutexLock mu(this, *Locks::thread_suspend_count_lock_);
+  suspension_cond_->Broadcast(this);
+}
+
 void Thread::RunCheckpointFunction() {
   CHECK(checkpoint_function_ != NULL);
   ATRACE_BEGIN("Checkpoint function");
@@ -570,9 +579,25 @@ void Thread::RunCheckpointFunction() {
   ATRACE_END();
 }
 
+void Thread::RunCheckpointAtSafepoint() {
+  DCHECK_EQ(this, Thread::Current());
+  SafepointRecord record;
+  RecordSafepoint(checkpoint_request_ns_, &record);
+  RunCheckpointFunction();
+  AtomicClearFlag(kCheckpointRequest);
+  Runtime::Current()->GetThreadList()->RecordTimeToCheckpoint(this, record);
+}
+
+void Thread::RecordSafepoint(uint64_t request_ns, SafepointRecord* record) const {
+  record->request_ns = request_ns;
+  record->reached_ns = NanoTime();
+  record->method = GetCurrentMethod(&record->dex_pc);
+}
+
 bool Thread::RequestCheckpoint(Closure* function) {
   CHECK(!ReadFlag(kCheckpointRequest)) << "Already have a pending checkpoint request";
   checkpoint_function_ = function;
+  checkpoint_request_ns_ = NanoTime();
   union StateAndFlags old_state_and_flags = state_and_flags_;
   // We must be runnable to request a checkpoint.
   old_state_and_flags.as_struct.state = kRunnable;
@@ -917,6 +942,8 @@ void Thread::Startup() {
     MutexLock mu(NULL, *Locks::thread_suspend_count_lock_);
     resume_cond_ = new ConditionVariable("Thread resumption condition variable",
                                          *Locks::thread_suspend_count_lock_);
+    suspension_cond_ = new ConditionVariable("Thread suspension condition variable",
+                                             *Locks::thread_suspend_count_lock_);
   }
 
   // Allocate a TLS slot.
@@ -948,6 +975,10 @@ void Thread::Shutdown() {
     delete resume_cond_;
     resume_cond_ = NULL;
   }
+  if (suspension_cond_ != NULL) {
+    delete suspension_cond_;
+    suspension_cond_ = NULL;
+  }
 }
 
 Thread::Thread(bool daemon)
@@ -987,11 +1018,14 @@ Thread::Thread(bool daemon)
       no_thread_suspension_(0),
       last_no_thread_suspension_cause_(NULL),
       checkpoint_function_(0),
-      thread_exit_check_count_(0) {
+      thread_exit_check_count_(0),
+      suspend_request_ns_(0),
+      checkpoint_request_ns_(0) {
   CHECK_EQ((sizeof(Thread) % 4), 0U) << sizeof(Thread);
   state_and_flags_.as_struct.flags = 0;
   state_and_flags_.as_struct.state = kNative;
   memset(&held_mutexes_[0], 0, sizeof(held_mutexes_));
+  memset(&last_safepoint_, 0, sizeof(last_safepoint_));
 }
 
 bool Thread::IsStillStarting() const {
@@ -1183,9 +1217,7 @@ mirror::Object* Thread::DecodeJObject(jobject obj) const {
     }
   } else if (kind == kGlobal) {
     JavaVMExt* vm = Runtime::Current()->GetJavaVM();
-    IndirectReferenceTable& globals = vm->globals;
-    ReaderMutexLock mu(const_cast<Thread*>(this), vm->globals_lock);
-    result = const_cast<mirror::Object*>(globals.Get(ref));
+    result = const_cast<mirror::Object*>(vm->globals.Get(const_cast<Thread*>(this), ref));
   } else {
     DCHECK_EQ(kind, kWeakGlobal);
     result = Runtime::Current()->GetJavaVM()->DecodeWeakGlobal(const_cast<Thread*>(this), ref);
@@ -1683,6 +1715,7 @@ static const EntryPointInfo gThreadEntryPointInfo[] = {
   QUICK_ENTRY_POINT_INFO(pStringCompareTo),
   QUICK_ENTRY_POINT_INFO(pMemcpy),
   QUICK_ENTRY_POINT_INFO(pQuickResolutionTrampoline),
+  QUICK_ENTRY_POINT_INFO(pQuickImtConflictTrampoline),
   QUICK_ENTRY_POINT_INFO(pQuickToInterpreterBridge),
   QUICK_ENTRY_POINT_INFO(pInvokeDirectTrampolineWithAccessCheck),
   QUICK_ENTRY_POINT_INFO(pInvokeInterfaceTrampoline),
@@ -87,6 +87,16 @@ enum ThreadFlag {
   kCheckpointRequest = 2  // Request that the thread do some checkpoint work and then continue.
 };
 
+// Where, and how long after a suspend or checkpoint request, a thread reached a safepoint.
+struct SafepointRecord {
+  // NanoTime of the request and of the thread noticing it.
+  uint64_t request_ns;
+  uint64_t reached_ns;
+  // The method, or NULL when there is no managed frame, and dex pc the thread was executing.
+  mirror::ArtMethod* method;
+  uint32_t dex_pc;
+};
+
 class PACKED(4) Thread {
  public:
   // Space to throw a StackOverflowError in.
@@ -173,14 +183,16 @@ class PACKED(4) Thread {
       LOCKS_EXCLUDED(Locks::thread_suspend_count_lock_)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
-  // Transition from non-runnable to runnable state acquiring share on mutator_lock_.
+  // Transition from non-runnable to runnable state acquiring share on mutator_lock_. The share is
+  // implied by the Runnable state so, unless a suspension is pending, this is a single CAS of the
+  // state and flags.
   ThreadState TransitionFromSuspendedToRunnable()
       LOCKS_EXCLUDED(Locks::thread_suspend_count_lock_)
       SHARED_LOCK_FUNCTION(Locks::mutator_lock_)
       ALWAYS_INLINE;
 
   // Transition from runnable into a state where mutator privileges are denied. Releases share of
-  // mutator lock.
+  // mutator lock, notifying a pending suspend request that the thread has left Runnable.
   void TransitionFromRunnableToSuspended(ThreadState new_state)
       LOCKS_EXCLUDED(Locks::thread_suspend_count_lock_)
       UNLOCK_FUNCTION(Locks::mutator_lock_)
@@ -578,6 +590,10 @@ class PACKED(4) Thread {
 
   void RunCheckpointFunction();
 
+  // Runs the pending checkpoint on the current thread, noting how long the request took to reach
+  // it, and clears the request.
+  void RunCheckpointAtSafepoint() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
   bool ReadFlag(ThreadFlag flag) const {
     return (state_and_flags_.as_struct.flags & flag) != 0;
   }
@@ -645,6 +661,15 @@ class PACKED(4) Thread {
 
   void NotifyLocked(Thread* self) EXCLUSIVE_LOCKS_REQUIRED(wait_mutex_);
 
+  // Fills in record for this thread, the current thread, reaching a safepoint for the request made
+  // at request_ns. Only called when a request is pending, so the stack walk is off the fast path.
+  void RecordSafepoint(uint64_t request_ns, SafepointRecord* record) const
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) __attribute__((noinline));
+
+  // Wakes threads in ThreadList waiting for this thread to leave the Runnable state.
+  void NotifySuspendRequesters() LOCKS_EXCLUDED(Locks::thread_suspend_count_lock_)
+      __attribute__((noinline));
+
   static void ThreadExitCallback(void* arg);
 
   // Has Thread::Startup been called?
@@ -657,6 +682,10 @@ class PACKED(4) Thread {
   // their suspend count is > 0.
   static ConditionVariable* resume_cond_ GUARDED_BY(Locks::thread_suspend_count_lock_);
 
+  // Used to notify threads requesting suspension that a thread with a pending suspend request has
+  // left the Runnable state.
+  static ConditionVariable* suspension_cond_ GUARDED_BY(Locks::thread_suspend_count_lock_);
+
   // --- Frequently accessed fields first for short offsets ---
 
   // 32 bits of atomically changed state and flags. Keeping as 32 bits allows and atomic CAS to
@@ -812,6 +841,14 @@ class PACKED(4) Thread {
   // How many times has our pthread key's destructor been called?
   uint32_t thread_exit_check_count_;
 
+  // NanoTime of the latest suspend and checkpoint requests, written by the requester before it
+  // raises the corresponding flag.
+  uint64_t suspend_request_ns_;
+  uint64_t checkpoint_request_ns_;
+
+  // Where this thread last left Runnable with a suspend request pending.
+  SafepointRecord last_safepoint_;
+
   friend class ScopedThreadStateChange;
 
   DISALLOW_COPY_AND_ASSIGN(Thread);
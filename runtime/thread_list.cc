@@ -20,6 +20,9 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+
+#include "base/histogram-inl.h"
 #include "base/mutex.h"
 #include "base/timing_logger.h"
 #include "debugger.h"
@@ -28,10 +31,15 @@
 
 namespace art {
 
-ThreadList::ThreadList()
+ThreadList::ThreadList(uint64_t safepoint_log_threshold)
     : allocated_ids_lock_("allocated thread ids lock"),
       suspend_all_count_(0), debug_suspend_all_count_(0),
-      thread_exit_cond_("thread exit condition variable", *Locks::thread_list_lock_) {
+      thread_exit_cond_("thread exit condition variable", *Locks::thread_list_lock_),
+      safepoint_stats_lock_("safepoint statistics lock"),
+      suspend_all_time_("Time to suspend all threads", 10),
+      thread_suspend_time_("Thread time to suspend", 10),
+      thread_checkpoint_time_("Thread time to checkpoint", 10),
+      safepoint_log_threshold_(safepoint_log_threshold) {
 }
 
 ThreadList::~ThreadList() {
@@ -66,6 +74,7 @@ pid_t ThreadList::GetLockOwner() {
 }
 
 void ThreadList::DumpForSigQuit(std::ostream& os) {
+  DumpTimeToSafepoint(os);
   {
     MutexLock mu(Thread::Current(), *Locks::thread_list_lock_);
     DumpLocked(os);
@@ -73,6 +82,90 @@ void ThreadList::DumpForSigQuit(std::ostream& os) {
   DumpUnattachedThreads(os);
 }
 
+static void DumpTimeToSafepointHistogram(std::ostream& os, Histogram<uint64_t>& histogram) {
+  if (histogram.SampleSize() == 0) {
+    return;
+  }
+  Histogram<uint64_t>::CumulativeData cumulative_data;
+  histogram.CreateHistogram(cumulative_data);
+  os << histogram.SampleSize() << " samples, ";
+  histogram.PrintConfidenceIntervals(os, 0.99, cumulative_data);
+}
+
+void ThreadList::DumpTimeToSafepoint(std::ostream& os) {
+  MutexLock mu(Thread::Current(), safepoint_stats_lock_);
+  DumpTimeToSafepointHistogram(os, suspend_all_time_);
+  DumpTimeToSafepointHistogram(os, thread_suspend_time_);
+  DumpTimeToSafepointHistogram(os, thread_checkpoint_time_);
+}
+
+// How long one thread took to reach a safepoint, and where it was when it did.
+struct TimeToSafepoint {
+  Thread* thread;
+  uint64_t time_ns;
+  mirror::ArtMethod* method;
+  uint32_t dex_pc;
+};
+
+static bool IsSlower(const TimeToSafepoint& lhs, const TimeToSafepoint& rhs) {
+  return lhs.time_ns > rhs.time_ns;
+}
+
+static std::ostream& operator<<(std::ostream& os, const TimeToSafepoint& time)
+    SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+  os << *time.thread << " took " << PrettyDuration(time.time_ns) << ", reaching a safepoint in "
+     << PrettyMethod(time.method) << " at dex pc 0x" << std::hex << time.dex_pc << std::dec;
+  return os;
+}
+
+void ThreadList::RecordTimeToSuspend(Thread* self, uint64_t start_ns, uint64_t total_ns) {
+  std::vector<TimeToSafepoint> times;
+  {
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
+    for (const auto& thread : list_) {
+      // Threads that weren't Runnable when the request was made have no record for it. Threads
+      // already asked to suspend, e.g. by the debugger, kept their earlier request.
+      const SafepointRecord& record = thread->last_safepoint_;
+      if (thread != self && record.request_ns >= start_ns &&
+          record.request_ns == thread->suspend_request_ns_) {
+        TimeToSafepoint time = { thread, record.reached_ns - record.request_ns, record.method,
+                                 record.dex_pc };
+        times.push_back(time);
+      }
+    }
+  }
+  {
+    MutexLock mu(self, safepoint_stats_lock_);
+    suspend_all_time_.AddValue(total_ns / 1000);
+    for (const auto& time : times) {
+      thread_suspend_time_.AddValue(time.time_ns / 1000);
+    }
+  }
+  if (UNLIKELY(total_ns > safepoint_log_threshold_)) {
+    static const size_t kSlowThreadsToLog = 3;
+    std::sort(times.begin(), times.end(), IsSlower);
+    std::ostringstream oss;
+    oss << "Suspending all threads took " << PrettyDuration(total_ns);
+    for (size_t i = 0; i < times.size() && i < kSlowThreadsToLog; ++i) {
+      oss << "\n  " << times[i];
+    }
+    LOG(WARNING) << oss.str();
+  }
+}
+
+void ThreadList::RecordTimeToCheckpoint(Thread* self, const SafepointRecord& record) {
+  uint64_t time_ns = record.reached_ns - record.request_ns;
+  {
+    MutexLock mu(self, safepoint_stats_lock_);
+    thread_checkpoint_time_.AddValue(time_ns / 1000);
+  }
+  if (UNLIKELY(time_ns > safepoint_log_threshold_)) {
+    TimeToSafepoint time = { self, time_ns, record.method, record.dex_pc };
+    LOG(WARNING) << "Slow checkpoint: " << time;
+  }
+}
+
 static void DumpUnattachedThread(std::ostream& os, pid_t tid) NO_THREAD_SAFETY_ANALYSIS {
   // TODO: No thread safety analysis as DumpState with a NULL thread won't access fields, should
   // refactor DumpState to avoid skipping analysis.
@@ -131,7 +224,6 @@ void ThreadList::AssertThreadsAreSuspended(Thread* self, Thread* ignore1, Thread
   }
 }
 
-#if HAVE_TIMED_RWLOCK
 // Attempt to rectify locks so that we dump thread list with required locks before exiting.
 static void UnsafeLogFatalForThreadSuspendAllTimeout(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
   Runtime* runtime = Runtime::Current();
@@ -142,7 +234,27 @@ static void UnsafeLogFatalForThreadSuspendAllTimeout(Thread* self) NO_THREAD_SAF
   runtime->GetThreadList()->DumpLocked(ss);
   LOG(FATAL) << ss.str();
 }
-#endif
+
+void ThreadList::WaitForThreadsToLeaveRunnable(Thread* self, const std::vector<Thread*>& threads) {
+  // Timeout if we wait more than 30 seconds.
+  static const uint64_t kTimeoutMs = 30 * 1000;
+  uint64_t start_ms = MilliTime();
+  bool timed_out = false;
+  {
+    // The threads have a pending suspend request and so can't unregister before being resumed.
+    MutexLock mu(self, *Locks::thread_suspend_count_lock_);
+    for (const auto& thread : threads) {
+      while (!timed_out && thread->GetState() == kRunnable) {
+        // Notified by Thread::TransitionFromRunnableToSuspended.
+        Thread::suspension_cond_->TimedWait(self, kTimeoutMs, 0);
+        timed_out = thread->GetState() == kRunnable && MilliTime() - start_ms > kTimeoutMs;
+      }
+    }
+  }
+  if (UNLIKELY(timed_out)) {
+    UnsafeLogFatalForThreadSuspendAllTimeout(self);
+  }
+}
 
 size_t ThreadList::RunCheckpoint(Closure* checkpoint_function) {
   Thread* self = Thread::Current();
@@ -226,12 +338,15 @@ void ThreadList::SuspendAll() {
 
   VLOG(threads) << *self << " SuspendAll starting...";
 
+  uint64_t start_ns = NanoTime();
+
   if (kIsDebugBuild) {
     Locks::mutator_lock_->AssertNotHeld(self);
     Locks::thread_list_lock_->AssertNotHeld(self);
     Locks::thread_suspend_count_lock_->AssertNotHeld(self);
     CHECK_NE(self->GetState(), kRunnable);
   }
+  std::vector<Thread*> threads;
   {
     MutexLock mu(self, *Locks::thread_list_lock_);
     {
@@ -245,11 +360,16 @@ void ThreadList::SuspendAll() {
         }
         VLOG(threads) << "requesting thread suspend: " << *thread;
         thread->ModifySuspendCount(self, +1, false);
+        threads.push_back(thread);
       }
     }
   }
 
-  // Block on the mutator lock until all Runnable threads release their share of access.
+  // Runnable threads implicitly share the mutator lock, wait for them to notice the request.
+  WaitForThreadsToLeaveRunnable(self, threads);
+  uint64_t time_to_suspend_ns = NanoTime() - start_ns;
+
+  // Block on the mutator lock until threads explicitly holding a share, such as the GC, release it.
 #if HAVE_TIMED_RWLOCK
   // Timeout if we wait more than 30 seconds.
   if (UNLIKELY(!Locks::mutator_lock_->ExclusiveLockWithTimeout(self, 30 * 1000, 0))) {
@@ -262,6 +382,8 @@ void ThreadList::SuspendAll() {
   // Debug check that all threads are suspended.
   AssertThreadsAreSuspended(self, self);
 
+  RecordTimeToSuspend(self, start_ns, time_to_suspend_ns);
+
   VLOG(threads) << *self << " SuspendAll complete";
 }
 
@@ -327,6 +449,7 @@ void ThreadList::SuspendAllForDebugger() {
 
   VLOG(threads) << *self << " SuspendAllForDebugger starting...";
 
+  std::vector<Thread*> threads;
   {
     MutexLock mu(self, *Locks::thread_list_lock_);
     {
@@ -341,11 +464,14 @@ void ThreadList::SuspendAllForDebugger() {
         }
         VLOG(threads) << "requesting thread suspend: " << *thread;
         thread->ModifySuspendCount(self, +1, true);
+        threads.push_back(thread);
       }
     }
   }
 
-  // Block on the mutator lock until all Runnable threads release their share of access then
+  WaitForThreadsToLeaveRunnable(self, threads);
+
+  // Block on the mutator lock until threads explicitly holding a share release it then
   // immediately unlock again.
 #if HAVE_TIMED_RWLOCK
   // Timeout if we wait more than 30 seconds.
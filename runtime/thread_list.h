@@ -17,24 +17,31 @@
 #ifndef ART_RUNTIME_THREAD_LIST_H_
 #define ART_RUNTIME_THREAD_LIST_H_
 
+#include "base/histogram.h"
 #include "base/mutex.h"
 #include "root_visitor.h"
+#include "utils.h"
 
 #include <bitset>
 #include <list>
+#include <vector>
 
 namespace art {
 class Closure;
 class Thread;
 class TimingLogger;
+struct SafepointRecord;
 
 class ThreadList {
  public:
   static const uint32_t kMaxThreadId = 0xFFFF;
   static const uint32_t kInvalidId = 0;
   static const uint32_t kMainId = 1;
+  static constexpr uint64_t kDefaultSafepointLogThreshold = MsToNs(5);
 
-  explicit ThreadList();
+  // Suspend requests taking longer than safepoint_log_threshold nanoseconds for all threads to
+  // reach a safepoint, and checkpoints taking that long to reach a thread, are logged.
+  explicit ThreadList(uint64_t safepoint_log_threshold);
   ~ThreadList();
 
   void DumpForSigQuit(std::ostream& os)
@@ -45,6 +52,14 @@ class ThreadList {
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
   pid_t GetLockOwner();  // For SignalCatcher.
 
+  // Dumps histograms of how long threads take to reach a safepoint.
+  void DumpTimeToSafepoint(std::ostream& os) LOCKS_EXCLUDED(safepoint_stats_lock_);
+
+  // Called by a thread that ran a checkpoint it was asked to run, see Thread::RequestCheckpoint.
+  void RecordTimeToCheckpoint(Thread* self, const SafepointRecord& record)
+      LOCKS_EXCLUDED(safepoint_stats_lock_)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
   // Thread suspension support.
   void ResumeAll()
       UNLOCK_FUNCTION(Locks::mutator_lock_)
@@ -122,6 +137,20 @@ class ThreadList {
       LOCKS_EXCLUDED(Locks::thread_list_lock_,
                      Locks::thread_suspend_count_lock_);
 
+  // Waits until none of the given threads, all with a pending suspend request, is Runnable.
+  void WaitForThreadsToLeaveRunnable(Thread* self, const std::vector<Thread*>& threads)
+      LOCKS_EXCLUDED(Locks::thread_list_lock_,
+                     Locks::thread_suspend_count_lock_);
+
+  // Records how long the threads suspended by the SuspendAll started at start_ns took to leave
+  // Runnable, logging the slowest of them if all threads took longer than
+  // safepoint_log_threshold_ nanoseconds.
+  void RecordTimeToSuspend(Thread* self, uint64_t start_ns, uint64_t total_ns)
+      LOCKS_EXCLUDED(Locks::thread_list_lock_,
+                     Locks::thread_suspend_count_lock_,
+                     safepoint_stats_lock_)
+      EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_);
+
   mutable Mutex allocated_ids_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   std::bitset<kMaxThreadId> allocated_ids_ GUARDED_BY(allocated_ids_lock_);
 
@@ -135,6 +164,15 @@ class ThreadList {
   // Signaled when threads terminate. Used to determine when all non-daemons have terminated.
   ConditionVariable thread_exit_cond_ GUARDED_BY(Locks::thread_list_lock_);
 
+  // Time to safepoint statistics, in microseconds: for all threads to leave Runnable in
+  // SuspendAll, for each thread that was Runnable to notice the suspend request, and for threads
+  // to run their checkpoints.
+  Mutex safepoint_stats_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  Histogram<uint64_t> suspend_all_time_ GUARDED_BY(safepoint_stats_lock_);
+  Histogram<uint64_t> thread_suspend_time_ GUARDED_BY(safepoint_stats_lock_);
+  Histogram<uint64_t> thread_checkpoint_time_ GUARDED_BY(safepoint_stats_lock_);
+  const uint64_t safepoint_log_threshold_;
+
   friend class Thread;
 
   DISALLOW_COPY_AND_ASSIGN(ThreadList);
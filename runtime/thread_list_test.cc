@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thread_list.h"
+
+#include <sstream>
+
+#include "closure.h"
+#include "common_test.h"
+#include "thread-inl.h"
+
+namespace art {
+
+class CountingClosure : public Closure {
+ public:
+  CountingClosure() : count_(0) {}
+
+  virtual void Run(Thread* self) {
+    ++count_;
+  }
+
+  size_t count_;
+};
+
+class ThreadListTest : public CommonTest {
+ protected:
+  static std::string DumpTimeToSafepoint() {
+    std::ostringstream oss;
+    Runtime::Current()->GetThreadList()->DumpTimeToSafepoint(oss);
+    return oss.str();
+  }
+};
+
+TEST_F(ThreadListTest, TimeToCheckpoint) {
+  ScopedObjectAccess soa(Thread::Current());
+  Thread* self = soa.Self();
+  EXPECT_EQ(std::string::npos, DumpTimeToSafepoint().find("Thread time to checkpoint"));
+
+  // Leaving Runnable runs the pending checkpoint, which records how long it was pending.
+  CountingClosure closure;
+  ASSERT_TRUE(self->RequestCheckpoint(&closure));
+  self->TransitionFromRunnableToSuspended(kNative);
+  self->TransitionFromSuspendedToRunnable();
+  EXPECT_EQ(1U, closure.count_);
+  EXPECT_FALSE(self->ReadFlag(kCheckpointRequest));
+  EXPECT_NE(std::string::npos, DumpTimeToSafepoint().find("1 samples, Thread time to checkpoint"));
+}
+
+TEST_F(ThreadListTest, TimeToSuspendAll) {
+  ThreadList* thread_list = Runtime::Current()->GetThreadList();
+  thread_list->SuspendAll();
+  thread_list->ResumeAll();
+  EXPECT_NE(std::string::npos, DumpTimeToSafepoint().find("Time to suspend all threads"));
+}
+
+}  // namespace art
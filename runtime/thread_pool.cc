@@ -16,8 +16,12 @@
 
 #include "thread_pool.h"
 
+#include <sched.h>
+
 #include "base/casts.h"
 #include "base/stl_util.h"
+#include "cutils/atomic.h"
+#include "cutils/atomic-inline.h"
 #include "runtime.h"
 #include "thread.h"
 
@@ -25,11 +29,102 @@ namespace art {
 
 static constexpr bool kMeasureWaitTime = false;
 
+// Deque indices wrap around, so step and compare them with unsigned arithmetic.
+static inline int32_t NextIndex(int32_t index) {
+  return static_cast<int32_t>(static_cast<uint32_t>(index) + 1);
+}
+
+static inline int32_t PrevIndex(int32_t index) {
+  return static_cast<int32_t>(static_cast<uint32_t>(index) - 1);
+}
+
+// The number of tasks between top and bottom, negative if bottom is below top.
+static inline int32_t IndexDistance(int32_t top, int32_t bottom) {
+  return static_cast<int32_t>(static_cast<uint32_t>(bottom) - static_cast<uint32_t>(top));
+}
+
+TaskDeque::TaskDeque() : top_(0), bottom_(0), array_(new Array(kInitialCapacity)) {
+}
+
+TaskDeque::~TaskDeque() {
+  delete array_;
+  STLDeleteElements(&retired_arrays_);
+}
+
+void TaskDeque::Push(Task* task) {
+  int32_t bottom = bottom_;
+  int32_t top = android_atomic_acquire_load(&top_);
+  Array* array = array_;
+  if (IndexDistance(top, bottom) >= static_cast<int32_t>(array->Capacity())) {
+    array = Grow(array, top, bottom);
+  }
+  array->Put(bottom, task);
+  // Publish the task before the bottom that makes it visible to thieves.
+  android_atomic_release_store(NextIndex(bottom), &bottom_);
+}
+
+Task* TaskDeque::Pop() {
+  int32_t bottom = PrevIndex(bottom_);
+  Array* array = array_;
+  bottom_ = bottom;
+  // Order the claim on the bottom task before reading top, so that a thief and we can't both take
+  // the last task.
+  ANDROID_MEMBAR_FULL();
+  int32_t top = top_;
+  int32_t size = IndexDistance(top, bottom);
+  if (size < 0) {
+    bottom_ = top;
+    return NULL;
+  }
+  Task* task = array->Get(bottom);
+  if (size == 0) {
+    // The last task, race thieves for it.
+    if (android_atomic_release_cas(top, NextIndex(top), &top_) != 0) {
+      task = NULL;
+    }
+    bottom_ = NextIndex(top);
+  }
+  return task;
+}
+
+Task* TaskDeque::Steal() {
+  int32_t top = android_atomic_acquire_load(&top_);
+  // Read top before bottom, pairs with the barrier in Pop.
+  ANDROID_MEMBAR_FULL();
+  int32_t bottom = android_atomic_acquire_load(&bottom_);
+  if (IndexDistance(top, bottom) <= 0) {
+    return NULL;
+  }
+  Task* task = array_->Get(top);
+  if (android_atomic_release_cas(top, NextIndex(top), &top_) != 0) {
+    return NULL;
+  }
+  return task;
+}
+
+bool TaskDeque::IsEmpty() const {
+  return IndexDistance(top_, bottom_) <= 0;
+}
+
+TaskDeque::Array* TaskDeque::Grow(Array* array, int32_t top, int32_t bottom) {
+  Array* new_array = new Array(array->Capacity() * 2);
+  for (int32_t i = top; i != bottom; i = NextIndex(i)) {
+    new_array->Put(i, array->Get(i));
+  }
+  retired_arrays_.push_back(array);
+  // Publish the copied tasks before the array.
+  ANDROID_MEMBAR_STORE();
+  array_ = new_array;
+  return new_array;
+}
+
 ThreadPoolWorker::ThreadPoolWorker(ThreadPool* thread_pool, const std::string& name,
                                    size_t stack_size)
     : thread_pool_(thread_pool),
       name_(name),
-      stack_size_(stack_size) {
+      stack_size_(stack_size),
+      thread_(NULL),
+      steal_seed_(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(this) >> 4) | 1) {
   const char* reason = "new thread pool worker thread";
   pthread_attr_t attr;
   CHECK_PTHREAD_CALL(pthread_attr_init, (&attr), reason);
@@ -52,10 +147,19 @@ void ThreadPoolWorker::Run() {
   }
 }
 
+size_t ThreadPoolWorker::NextStealIndex(size_t thread_count) {
+  // Xorshift, randomizing victims so that idle workers don't all pile onto the same one.
+  steal_seed_ ^= steal_seed_ << 13;
+  steal_seed_ ^= steal_seed_ >> 17;
+  steal_seed_ ^= steal_seed_ << 5;
+  return steal_seed_ % thread_count;
+}
+
 void* ThreadPoolWorker::Callback(void* arg) {
   ThreadPoolWorker* worker = reinterpret_cast<ThreadPoolWorker*>(arg);
   Runtime* runtime = Runtime::Current();
   CHECK(runtime->AttachCurrentThread(worker->name_.c_str(), true, NULL, false));
+  worker->thread_ = Thread::Current();
   // Do work until its time to shut down.
   worker->Run();
   runtime->DetachCurrentThread();
@@ -63,6 +167,19 @@ void* ThreadPoolWorker::Callback(void* arg) {
 }
 
 void ThreadPool::AddTask(Thread* self, Task* task) {
+  ThreadPoolWorker* worker = GetWorker(self);
+  if (worker != NULL) {
+    worker->tasks_.Push(task);
+    // Order the push before reading waiting_count_, pairs with the barrier in GetTask.
+    ANDROID_MEMBAR_FULL();
+    if (GetWaitingCountUnlocked() != 0) {
+      MutexLock mu(self, task_queue_lock_);
+      if (started_ && waiting_count_ != 0) {
+        task_queue_condition_.Signal(self);
+      }
+    }
+    return;
+  }
   MutexLock mu(self, task_queue_lock_);
   tasks_.push_back(task);
   // If we have any waiters, signal one.
@@ -126,13 +243,27 @@ void ThreadPool::StopWorkers(Thread* self) {
 }
 
 Task* ThreadPool::GetTask(Thread* self) {
-  MutexLock mu(self, task_queue_lock_);
-  while (!IsShuttingDown()) {
+  ThreadPoolWorker* worker = GetWorker(self);
+  // Throttled pools only hand out tasks once the lock confirms we're within max_active_workers_.
+  bool may_steal = !IsThrottledUnlocked();
+  while (true) {
+    if (may_steal) {
+      Task* task = TryGetTaskFromDeques(worker);
+      if (task != NULL) {
+        return task;
+      }
+    }
+    MutexLock mu(self, task_queue_lock_);
+    if (IsShuttingDown()) {
+      // We are shutting down, return NULL to tell the worker thread to stop looping.
+      return NULL;
+    }
     const size_t thread_count = GetThreadCount();
     // Ensure that we don't use more threads than the maximum active workers.
     const size_t active_threads = thread_count - waiting_count_;
     // <= since self is considered an active worker.
-    if (active_threads <= max_active_workers_) {
+    may_steal = active_threads <= max_active_workers_;
+    if (may_steal) {
       Task* task = TryGetTaskLocked(self);
       if (task != NULL) {
         return task;
@@ -140,24 +271,30 @@ Task* ThreadPool::GetTask(Thread* self) {
     }
 
     ++waiting_count_;
-    if (waiting_count_ == GetThreadCount() && tasks_.empty()) {
-      // We may be done, lets broadcast to the completion condition.
-      completion_condition_.Broadcast(self);
-    }
-    const uint64_t wait_start = kMeasureWaitTime ? NanoTime() : 0;
-    task_queue_condition_.Wait(self);
-    if (kMeasureWaitTime) {
-      const uint64_t wait_end = NanoTime();
-      total_wait_time_ += wait_end - std::max(wait_start, start_time_);
+    // Order our waiting before looking at the deques, pairs with the barrier in AddTask.
+    ANDROID_MEMBAR_FULL();
+    bool has_deque_tasks = started_ && HasDequeTasks();
+    if (!may_steal || !has_deque_tasks) {
+      if (waiting_count_ == thread_count && tasks_.empty() && !has_deque_tasks) {
+        // We may be done, lets broadcast to the completion condition.
+        completion_condition_.Broadcast(self);
+      }
+      const uint64_t wait_start = kMeasureWaitTime ? NanoTime() : 0;
+      task_queue_condition_.Wait(self);
+      if (kMeasureWaitTime) {
+        const uint64_t wait_end = NanoTime();
+        total_wait_time_ += wait_end - std::max(wait_start, start_time_);
+      }
     }
     --waiting_count_;
   }
-
-  // We are shutting down, return NULL to tell the worker thread to stop looping.
-  return NULL;
 }
 
 Task* ThreadPool::TryGetTask(Thread* self) {
+  Task* task = TryGetTaskFromDeques(GetWorker(self));
+  if (task != NULL) {
+    return task;
+  }
   MutexLock mu(self, task_queue_lock_);
   return TryGetTaskLocked(self);
 }
@@ -171,6 +308,58 @@ Task* ThreadPool::TryGetTaskLocked(Thread* self) {
   return NULL;
 }
 
+Task* ThreadPool::TryGetTaskFromDeques(ThreadPoolWorker* worker) NO_THREAD_SAFETY_ANALYSIS {
+  // Reading started_ without the lock is fine, workers are started and stopped between phases.
+  if (!started_) {
+    return NULL;
+  }
+  if (worker != NULL) {
+    Task* task = worker->tasks_.Pop();
+    if (task != NULL) {
+      return task;
+    }
+  }
+  const size_t thread_count = GetThreadCount();
+  const size_t start = (worker != NULL) ? worker->NextStealIndex(thread_count) : 0;
+  for (size_t i = 0; i < thread_count; ++i) {
+    ThreadPoolWorker* victim = threads_[(start + i) % thread_count];
+    if (victim != worker) {
+      Task* task = victim->tasks_.Steal();
+      if (task != NULL) {
+        return task;
+      }
+    }
+  }
+  return NULL;
+}
+
+size_t ThreadPool::GetWaitingCountUnlocked() const NO_THREAD_SAFETY_ANALYSIS {
+  return waiting_count_;
+}
+
+bool ThreadPool::IsThrottledUnlocked() const NO_THREAD_SAFETY_ANALYSIS {
+  // Like started_, the limit only changes between phases.
+  return max_active_workers_ < GetThreadCount();
+}
+
+ThreadPoolWorker* ThreadPool::GetWorker(Thread* self) const {
+  for (ThreadPoolWorker* worker : threads_) {
+    if (worker->thread_ == self) {
+      return worker;
+    }
+  }
+  return NULL;
+}
+
+bool ThreadPool::HasDequeTasks() const {
+  for (ThreadPoolWorker* worker : threads_) {
+    if (!worker->tasks_.IsEmpty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void ThreadPool::Wait(Thread* self, bool do_work, bool may_hold_locks) {
   if (do_work) {
     Task* task = NULL;
@@ -181,7 +370,8 @@ void ThreadPool::Wait(Thread* self, bool do_work, bool may_hold_locks) {
   }
   // Wait until each thread is waiting and the task list is empty.
   MutexLock mu(self, task_queue_lock_);
-  while (!shutting_down_ && (waiting_count_ != GetThreadCount() || !tasks_.empty())) {
+  while (!shutting_down_ &&
+         (waiting_count_ != GetThreadCount() || !tasks_.empty() || HasDequeTasks())) {
     if (!may_hold_locks) {
       completion_condition_.Wait(self);
     } else {
@@ -195,6 +385,48 @@ size_t ThreadPool::GetTaskCount(Thread* self) {
   return tasks_.size();
 }
 
+// Finalizes the forked task and then tells its group, which may be destroyed as soon as it knows.
+class TaskGroup::ForkedTask : public Task {
+ public:
+  ForkedTask(TaskGroup* group, Task* task) : group_(group), task_(task) {}
+
+  virtual void Run(Thread* self) {
+    task_->Run(self);
+  }
+
+  virtual void Finalize() {
+    task_->Finalize();
+    --group_->pending_;
+    delete this;
+  }
+
+ private:
+  TaskGroup* const group_;
+  Task* const task_;
+};
+
+TaskGroup::~TaskGroup() {
+  CHECK_EQ(pending_.load(), 0) << "Task group destroyed before being joined";
+}
+
+void TaskGroup::Fork(Thread* self, Task* task) {
+  ++pending_;
+  thread_pool_->AddTask(self, new ForkedTask(this, task));
+}
+
+void TaskGroup::Join(Thread* self) {
+  while (pending_.load() != 0) {
+    Task* task = thread_pool_->TryGetTask(self);
+    if (task != NULL) {
+      task->Run(self);
+      task->Finalize();
+    } else {
+      // The remaining tasks are running on other threads.
+      sched_yield();
+    }
+  }
+}
+
 WorkStealingWorker::WorkStealingWorker(ThreadPool* thread_pool, const std::string& name,
                                        size_t stack_size)
     : ThreadPoolWorker(thread_pool, name, stack_size), task_(NULL) {}
@@ -274,6 +506,7 @@ WorkStealingThreadPool::WorkStealingThreadPool(size_t num_threads)
     : ThreadPool(0),
       work_steal_lock_("work stealing lock"),
       steal_index_(0) {
+  threads_.reserve(num_threads);
   while (GetThreadCount() < num_threads) {
     const std::string name = StringPrintf("Work stealing worker %zu", GetThreadCount());
     threads_.push_back(new WorkStealingWorker(this, name, ThreadPoolWorker::kDefaultStackSize));
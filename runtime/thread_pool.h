@@ -20,10 +20,12 @@
 #include <deque>
 #include <vector>
 
+#include "atomic_integer.h"
 #include "barrier.h"
 #include "base/mutex.h"
 #include "closure.h"
 #include "locks.h"
+#include "UniquePtr.h"
 
 namespace art {
 
@@ -35,6 +37,59 @@ class Task : public Closure {
   virtual void Finalize() { }
 };
 
+// A Chase-Lev work-stealing deque of tasks. Its owner pushes and pops tasks at the bottom without
+// locking while any other thread may steal from the top, racing for it with a CAS. Indices wrap
+// around, only their differences matter. The array grows when full and retired arrays are kept
+// until the deque is destroyed, since thieves may still be reading them.
+class TaskDeque {
+ public:
+  TaskDeque();
+  ~TaskDeque();
+
+  // Only called by the owner.
+  void Push(Task* task);
+  Task* Pop();
+
+  // Returns NULL if the deque is empty or another thread won the race for the top task.
+  Task* Steal();
+
+  // Racy, for deciding whether it is worth trying to steal.
+  bool IsEmpty() const;
+
+ private:
+  static const size_t kInitialCapacity = 64;
+
+  class Array {
+   public:
+    explicit Array(size_t capacity) : mask_(capacity - 1), tasks_(new Task*[capacity]) {}
+
+    size_t Capacity() const {
+      return mask_ + 1;
+    }
+
+    Task* Get(int32_t index) const {
+      return tasks_[index & mask_];
+    }
+
+    void Put(int32_t index, Task* task) {
+      tasks_[index & mask_] = task;
+    }
+
+   private:
+    const size_t mask_;
+    UniquePtr<Task*[]> tasks_;
+  };
+
+  Array* Grow(Array* array, int32_t top, int32_t bottom);
+
+  volatile int32_t top_;
+  volatile int32_t bottom_;
+  Array* volatile array_;
+  std::vector<Array*> retired_arrays_;
+
+  DISALLOW_COPY_AND_ASSIGN(TaskDeque);
+};
+
 class ThreadPoolWorker {
  public:
   static const size_t kDefaultStackSize = 1 * MB;
@@ -54,8 +109,18 @@ class ThreadPoolWorker {
   const std::string name_;
   const size_t stack_size_;
   pthread_t pthread_;
+  // The attached runtime thread of the worker.
+  Thread* thread_;
 
  private:
+  // Picks the worker to try stealing from first.
+  size_t NextStealIndex(size_t thread_count);
+
+  // Tasks added by this worker, see ThreadPool::AddTask.
+  TaskDeque tasks_;
+  // Random number generator state for NextStealIndex.
+  uint32_t steal_seed_;
+
   friend class ThreadPool;
   DISALLOW_COPY_AND_ASSIGN(ThreadPoolWorker);
 };
@@ -74,7 +139,8 @@ class ThreadPool {
   void StopWorkers(Thread* self);
 
   // Add a new task, the first available started worker will process it. Does not delete the task
-  // after running it, it is the caller's responsibility.
+  // after running it, it is the caller's responsibility. Tasks added by one of the pool's workers
+  // go on that worker's own deque, from which idle workers steal.
   void AddTask(Thread* self, Task* task);
 
   explicit ThreadPool(size_t num_threads);
@@ -102,6 +168,22 @@ class ThreadPool {
   Task* TryGetTask(Thread* self);
   Task* TryGetTaskLocked(Thread* self) EXCLUSIVE_LOCKS_REQUIRED(task_queue_lock_);
 
+  // Without locking, pops a task from worker's deque or steals one from another worker's deque.
+  // Worker is NULL when the caller isn't one of our workers.
+  Task* TryGetTaskFromDeques(ThreadPoolWorker* worker);
+
+  // Returns the worker running on self, or NULL.
+  ThreadPoolWorker* GetWorker(Thread* self) const;
+
+  // Racy, true if some worker's deque has tasks to steal.
+  bool HasDequeTasks() const;
+
+  // Racy, how many workers are waiting for tasks. Callers recheck under task_queue_lock_.
+  size_t GetWaitingCountUnlocked() const;
+
+  // Racy, true if SetMaxActiveWorkers limited the pool to fewer workers than it has threads.
+  bool IsThrottledUnlocked() const;
+
   // Are we shutting down?
   bool IsShuttingDown() const EXCLUSIVE_LOCKS_REQUIRED(task_queue_lock_) {
     return shutting_down_;
@@ -124,11 +206,35 @@ class ThreadPool {
   size_t max_active_workers_ GUARDED_BY(task_queue_lock_);
 
  private:
+  friend class TaskGroup;
   friend class ThreadPoolWorker;
   friend class WorkStealingWorker;
   DISALLOW_COPY_AND_ASSIGN(ThreadPool);
 };
 
+// Forks tasks onto a started thread pool and joins them, for recursive divide and conquer. Tasks
+// forked by a worker go on its own deque, and joining runs pool tasks, the most recently forked
+// first, rather than blocking the worker.
+class TaskGroup {
+ public:
+  explicit TaskGroup(ThreadPool* thread_pool) : thread_pool_(thread_pool), pending_(0) {}
+  ~TaskGroup();
+
+  // Runs task on the pool, finalizing it after it has run.
+  void Fork(Thread* self, Task* task);
+
+  // Runs pool tasks until every forked task has been finalized.
+  void Join(Thread* self);
+
+ private:
+  class ForkedTask;
+
+  ThreadPool* const thread_pool_;
+  AtomicInteger pending_;
+
+  DISALLOW_COPY_AND_ASSIGN(TaskGroup);
+};
+
 class WorkStealingTask : public Task {
  public:
   WorkStealingTask() : ref_count_(0) {}
@@ -17,9 +17,12 @@
 
 #include <string>
 
+#include <unistd.h>
+
 #include "atomic_integer.h"
 #include "common_test.h"
 #include "thread_pool.h"
+#include "utils.h"
 
 namespace art {
 
@@ -138,4 +141,135 @@ TEST_F(ThreadPoolTest, RecursiveTest) {
   EXPECT_EQ((1 << depth) - 1, count);
 }
 
+TEST_F(ThreadPoolTest, TaskDeque) {
+  TaskDeque deque;
+  EXPECT_TRUE(deque.IsEmpty());
+  EXPECT_TRUE(deque.Pop() == NULL);
+  EXPECT_TRUE(deque.Steal() == NULL);
+
+  // Enough tasks to grow the deque a few times.
+  static const size_t kTaskCount = 1000;
+  UniquePtr<CountTask*[]> tasks(new CountTask*[kTaskCount]);
+  AtomicInteger count(0);
+  for (size_t i = 0; i < kTaskCount; ++i) {
+    tasks[i] = new CountTask(&count);
+    deque.Push(tasks[i]);
+  }
+  EXPECT_FALSE(deque.IsEmpty());
+  // The owner pops the newest task, thieves steal the oldest.
+  EXPECT_EQ(tasks[kTaskCount - 1], deque.Pop());
+  EXPECT_EQ(tasks[0], deque.Steal());
+  for (size_t i = 1; i < kTaskCount - 1; ++i) {
+    EXPECT_EQ(tasks[kTaskCount - 1 - i], deque.Pop());
+  }
+  EXPECT_TRUE(deque.IsEmpty());
+  EXPECT_TRUE(deque.Pop() == NULL);
+  for (size_t i = 0; i < kTaskCount; ++i) {
+    delete tasks[i];
+  }
+}
+
+// Forks two subtrees and joins them, doing work_ iterations of busy work per node.
+class ForkJoinTreeTask : public Task {
+ public:
+  ForkJoinTreeTask(ThreadPool* const thread_pool, AtomicInteger* count, int depth, size_t work)
+      : thread_pool_(thread_pool),
+        count_(count),
+        depth_(depth),
+        work_(work) {}
+
+  void Run(Thread* self) {
+    if (depth_ > 1) {
+      TaskGroup group(thread_pool_);
+      group.Fork(self, new ForkJoinTreeTask(thread_pool_, count_, depth_ - 1, work_));
+      group.Fork(self, new ForkJoinTreeTask(thread_pool_, count_, depth_ - 1, work_));
+      group.Join(self);
+    }
+    DoWork(work_);
+    // Increment the counter which keeps track of work completed.
+    ++*count_;
+  }
+
+  void Finalize() {
+    delete this;
+  }
+
+  static void DoWork(size_t work) {
+    volatile size_t sink = 0;
+    for (size_t i = 0; i < work; ++i) {
+      sink += i;
+    }
+  }
+
+ private:
+  ThreadPool* const thread_pool_;
+  AtomicInteger* const count_;
+  const int depth_;
+  const size_t work_;
+};
+
+// Test that forked tasks are all run and joined.
+TEST_F(ThreadPoolTest, ForkJoin) {
+  Thread* self = Thread::Current();
+  ThreadPool thread_pool(num_threads);
+  AtomicInteger count(0);
+  static const int depth = 10;
+  thread_pool.AddTask(self, new ForkJoinTreeTask(&thread_pool, &count, depth, 0));
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, true, false);
+  EXPECT_EQ((1 << depth) - 1, count);
+}
+
+class BusyTask : public Task {
+ public:
+  BusyTask(AtomicInteger* count, size_t work) : count_(count), work_(work) {}
+
+  void Run(Thread* self) {
+    ForkJoinTreeTask::DoWork(work_);
+    ++*count_;
+  }
+
+  void Finalize() {
+    delete this;
+  }
+
+ private:
+  AtomicInteger* const count_;
+  const size_t work_;
+};
+
+// Compares how many threads help with many small independent tasks queued by one thread, like
+// dex2oat's per-class work, and with recursively forked tasks, like parallel marking.
+TEST_F(ThreadPoolTest, DISABLED_ScalingBenchmark) {
+  static const int32_t kFlatTasks = 20000;
+  static const int kTreeDepth = 14;
+  static const size_t kWork = 2000;
+  Thread* self = Thread::Current();
+  const int32_t max_threads = std::max(static_cast<int32_t>(sysconf(_SC_NPROCESSORS_ONLN)),
+                                       num_threads);
+  for (int32_t threads = 1; threads <= max_threads; threads *= 2) {
+    ThreadPool thread_pool(threads);
+    AtomicInteger flat_count(0);
+    uint64_t start = NanoTime();
+    for (int32_t i = 0; i < kFlatTasks; ++i) {
+      thread_pool.AddTask(self, new BusyTask(&flat_count, kWork));
+    }
+    thread_pool.StartWorkers(self);
+    thread_pool.Wait(self, true, false);
+    uint64_t flat_ns = NanoTime() - start;
+    EXPECT_EQ(kFlatTasks, flat_count);
+
+    AtomicInteger tree_count(0);
+    start = NanoTime();
+    thread_pool.AddTask(self, new ForkJoinTreeTask(&thread_pool, &tree_count, kTreeDepth, kWork));
+    thread_pool.Wait(self, true, false);
+    uint64_t tree_ns = NanoTime() - start;
+    EXPECT_EQ((1 << kTreeDepth) - 1, tree_count);
+    thread_pool.StopWorkers(self);
+
+    LOG(INFO) << threads << " workers: queued " << PrettyDuration(flat_ns)
+              << ", forked " << PrettyDuration(tree_ns);
+  }
+}
+
 }  // namespace art
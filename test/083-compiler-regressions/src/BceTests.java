@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Tests array accesses in loops whose range checks must stay.
+ */
+public class BceTests {
+    public static void throwTest() {
+        int[] array = new int[] { 1, 2, 3 };
+        int res = 0;
+        try {
+            otherArrayLength(array, new int[5]);
+        } catch (ArrayIndexOutOfBoundsException expected) {
+            res += 1;
+        }
+        try {
+            nextElement(array);
+        } catch (ArrayIndexOutOfBoundsException expected) {
+            res += 10;
+        }
+        try {
+            upToLength(array);
+        } catch (ArrayIndexOutOfBoundsException expected) {
+            res += 100;
+        }
+        try {
+            fromMinusOne(array);
+        } catch (ArrayIndexOutOfBoundsException expected) {
+            res += 1000;
+        }
+        try {
+            fromStart(array, -2);
+        } catch (ArrayIndexOutOfBoundsException expected) {
+            res += 10000;
+        }
+        // upToLength stored up to the last element before throwing.
+        res += sum(array) * 100000;
+        res += fromStart(array, 1) * 10000000;
+        if (res == 30311111) {
+            System.out.println("bceThrowTest passes");
+        } else {
+            System.out.println("bceThrowTest fails: " + res + " (expecting 30311111)");
+        }
+    }
+
+    // i is below b.length, which says nothing about a.
+    private static int otherArrayLength(int[] a, int[] b) {
+        int sum = 0;
+        for (int i = 0; i < b.length; i++) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    private static int nextElement(int[] a) {
+        int sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            sum += a[i + 1];
+        }
+        return sum;
+    }
+
+    // i reaches a.length, the increment being guarded by i <= a.length only.
+    private static void upToLength(int[] a) {
+        for (int i = 0; i <= a.length; i++) {
+            a[i] = i;
+        }
+    }
+
+    private static int fromMinusOne(int[] a) {
+        int sum = 0;
+        for (int i = -1; i < a.length; i++) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    private static int fromStart(int[] a, int start) {
+        int sum = 0;
+        for (int i = start; i < a.length; i++) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    private static int sum(int[] a) {
+        int sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            sum += a[i];
+        }
+        return sum;
+    }
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Tests loads that global value numbering must not replace with an earlier
+ * load or store of the same location.
+ */
+public class GvnTests {
+    static int staticValue;
+
+    public static void joinTest() {
+        Holder h = new Holder();
+        h.value = 5;
+        int res = loadAfterJoin(h, true);
+        h.value = 5;
+        res += loadAfterJoin(h, false) * 10;
+        if (res == 56) {
+            System.out.println("gvnJoinTest passes");
+        } else {
+            System.out.println("gvnJoinTest fails: " + res + " (expecting 56)");
+        }
+    }
+
+    private static int loadAfterJoin(Holder h, boolean store) {
+        int x = h.value;
+        if (store) {
+            h.value = x + 1;
+        }
+        return h.value;
+    }
+
+    public static void loopTest() {
+        Holder h = new Holder();
+        h.value = 1;
+        int res = loadInLoop(h, 3);
+        if (res == 1022) {
+            System.out.println("gvnLoopTest passes");
+        } else {
+            System.out.println("gvnLoopTest fails: " + res + " (expecting 1022)");
+        }
+    }
+
+    private static int loadInLoop(Holder h, int n) {
+        int first = h.value;
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += h.value;
+            h.value = i + 10;
+        }
+        return sum + first * 1000;
+    }
+
+    public static void aliasTest() {
+        Holder a = new Holder();
+        Holder b = new Holder();
+        a.value = 1;
+        int res = aliasedLoad(a, a);
+        a.value = 1;
+        res += aliasedLoad(a, b) * 1000;
+        int[] array = new int[] { 2 };
+        res += aliasedArrayLoad(array, array) * 10000;
+        array[0] = 2;
+        res += aliasedArrayLoad(array, new int[1]) * 10000000;
+        if (res == 21021101) {
+            System.out.println("gvnAliasTest passes");
+        } else {
+            System.out.println("gvnAliasTest fails: " + res + " (expecting 21021101)");
+        }
+    }
+
+    private static int aliasedLoad(Holder a, Holder b) {
+        int x = a.value;
+        b.value = x + 100;
+        return a.value;
+    }
+
+    private static int aliasedArrayLoad(int[] a, int[] b) {
+        int x = a[0];
+        b[0] = x + 100;
+        return a[0];
+    }
+
+    public static void catchTest() {
+        Holder h = new Holder();
+        h.value = 1;
+        int res = loadInHandler(h, new int[1]);
+        h.value = 1;
+        res += loadInHandler(h, new int[10]) * 10;
+        if (res == 32) {
+            System.out.println("gvnCatchTest passes");
+        } else {
+            System.out.println("gvnCatchTest fails: " + res + " (expecting 32)");
+        }
+    }
+
+    private static int loadInHandler(Holder h, int[] array) {
+        int x = h.value;
+        try {
+            h.value = x + 1;
+            array[5] = 1;
+            h.value = x + 2;
+        } catch (ArrayIndexOutOfBoundsException expected) {
+            return h.value;
+        }
+        return h.value;
+    }
+
+    public static void volatileTest() throws Exception {
+        final Holder h = new Holder();
+        Thread writer = new Thread() {
+            public void run() {
+                try {
+                    // Let the load before the loop see the old value.
+                    Thread.sleep(100);
+                } catch (InterruptedException ignored) {
+                }
+                h.value = 42;
+                h.done = true;
+            }
+        };
+        writer.start();
+        int res = loadAfterVolatile(h);
+        writer.join();
+        if (res == 42) {
+            System.out.println("gvnVolatileTest passes");
+        } else {
+            System.out.println("gvnVolatileTest fails: " + res + " (expecting 42)");
+        }
+    }
+
+    private static int loadAfterVolatile(Holder h) {
+        int before = h.value;
+        while (!h.done) {
+        }
+        int after = h.value;
+        return (before == 0 || before == 42) ? after : -1;
+    }
+
+    public static void staticTest() {
+        staticValue = 7;
+        int res = loadAroundInit();
+        if (res == 2) {
+            System.out.println("gvnStaticTest passes");
+        } else {
+            System.out.println("gvnStaticTest fails: " + res + " (expecting 2)");
+        }
+    }
+
+    // Reading GvnInit.x first runs its <clinit>, which writes staticValue.
+    private static int loadAroundInit() {
+        int before = staticValue;
+        int x = GvnInit.x;
+        return staticValue - before + x;
+    }
+
+    public static void redefinitionTest() {
+        Holder h = new Holder();
+        h.value = 5;
+        int res = loadAfterRedefinition(h);
+        if (res == 15) {
+            System.out.println("gvnRedefinitionTest passes");
+        } else {
+            System.out.println("gvnRedefinitionTest fails: " + res + " (expecting 15)");
+        }
+    }
+
+    private static int loadAfterRedefinition(Holder h) {
+        int x = h.value;
+        x = x * 2;
+        int y = h.value;
+        return x + y;
+    }
+}
+
+class Holder {
+    int value;
+    volatile boolean done;
+}
+
+class GvnInit {
+    static int x;
+
+    static {
+        GvnTests.staticValue++;
+        x = 1;
+    }
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Tests calls the compiler replaces with the body of the callee: getters,
+ * setters, empty methods and static methods returning a constant or an
+ * argument.
+ */
+public class InlineTests {
+    private int value = 64;
+
+    public static void nullReceiverTest() {
+        Inlinee inlinee = new Inlinee();
+        Inlinee nullInlinee = null;
+        int res = 0;
+        // Each of these reaches its handler with progress at 2.
+        res += getValueProgress(nullInlinee);
+        res += setValueProgress(nullInlinee) * 10;
+        res += getWideValueProgress(nullInlinee) * 100;
+        res += nopProgress(nullInlinee) * 1000;
+        res += getOwnValueProgress(null) * 10000;
+        // And these run to the end.
+        inlinee.setValue(5);
+        res += getValueProgress(inlinee) * 100000;
+        res += setValueProgress(inlinee) * 1000000;
+        res += inlinee.getValue() * 10000000;
+        if (res == 23322222 && getWideValueProgress(inlinee) == 3 + 123 &&
+            nopProgress(inlinee) == 3 && getOwnValueProgress(new InlineTests()) == 3 + 64) {
+            System.out.println("inlineNullReceiverTest passes");
+        } else {
+            System.out.println("inlineNullReceiverTest fails: " + res + " (expecting 23322222)");
+        }
+    }
+
+    private static int getValueProgress(Inlinee inlinee) {
+        int progress = 1;
+        try {
+            progress = 2;
+            int value = inlinee.getValue();
+            progress = 3 + value - 5;
+        } catch (NullPointerException expected) {
+            return progress;
+        }
+        return progress;
+    }
+
+    private static int setValueProgress(Inlinee inlinee) {
+        int progress = 1;
+        try {
+            progress = 2;
+            inlinee.setValue(progress);
+            progress = 3;
+        } catch (NullPointerException expected) {
+            return progress;
+        }
+        return progress;
+    }
+
+    private static int getWideValueProgress(Inlinee inlinee) {
+        int progress = 1;
+        try {
+            progress = 2;
+            long value = inlinee.getWideValue();
+            progress = 3 + (int) value;
+        } catch (NullPointerException expected) {
+            return progress;
+        }
+        return progress;
+    }
+
+    private static int nopProgress(Inlinee inlinee) {
+        int progress = 1;
+        try {
+            progress = 2;
+            inlinee.nop();
+            progress = 3;
+        } catch (NullPointerException expected) {
+            return progress;
+        }
+        return progress;
+    }
+
+    private static int getOwnValueProgress(InlineTests tests) {
+        int progress = 1;
+        try {
+            progress = 2;
+            int value = tests.getOwnValue();
+            progress = 3 + value;
+        } catch (NullPointerException expected) {
+            return progress;
+        }
+        return progress;
+    }
+
+    // Called with invoke-direct.
+    private int getOwnValue() {
+        return value;
+    }
+
+    public static void staticReturnTest() {
+        long res = ident(3);
+        res += const7();
+        res += constMinus1000();
+        res += const0x12345678();
+        res += rangeIdent(1, 2, 3, 4, 5, 6);
+        res += wideIdent(0x100000000L);
+        res += wideRangeIdent(1L, 0x200000000L, 3L);
+        res += wideConst();
+        // Results that aren't used.
+        ident(11);
+        const7();
+        wideIdent(13L);
+        Object object = new Object();
+        long expected = 3 + 7 - 1000 + 0x12345678 + 5 + 0x100000000L + 0x200000000L +
+                        0x123456789abcdefL;
+        if (res == expected && objectIdent(object) == object && objectIdent(null) == null) {
+            System.out.println("inlineStaticReturnTest passes");
+        } else {
+            System.out.println("inlineStaticReturnTest fails: " + res +
+                               " (expecting " + expected + ")");
+        }
+    }
+
+    private static int ident(int a1) {
+        return a1;
+    }
+
+    private static long wideIdent(long a1) {
+        return a1;
+    }
+
+    private static Object objectIdent(Object a1) {
+        return a1;
+    }
+
+    // Called with invoke-static/range.
+    private static int rangeIdent(int a1, int a2, int a3, int a4, int a5, int a6) {
+        return a5;
+    }
+
+    private static long wideRangeIdent(long a1, long a2, long a3) {
+        return a2;
+    }
+
+    private static int const7() {
+        return 7;
+    }
+
+    private static int constMinus1000() {
+        return -1000;
+    }
+
+    private static int const0x12345678() {
+        return 0x12345678;
+    }
+
+    private static long wideConst() {
+        return 0x123456789abcdefL;
+    }
+}
+
+// Final, so that its virtual calls are made direct.
+final class Inlinee {
+    private int value;
+    private long wideValue = 123;
+
+    public int getValue() {
+        return value;
+    }
+
+    public void setValue(int value) {
+        this.value = value;
+    }
+
+    public long getWideValue() {
+        return wideValue;
+    }
+
+    public void nop() {
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Tests loop invariant code that must stay in its loop.
+ */
+public class LicmTests {
+    public static void zeroTripTest() {
+        int res = 0;
+        try {
+            res += loadInZeroTripLoop(null, 0);
+            res += lengthInZeroTripLoop(null, 0);
+            res += divideInZeroTripLoop(1, 0, 0);
+        } catch (RuntimeException e) {
+            res = -1;
+        }
+        Holder h = new Holder();
+        h.value = 3;
+        res += loadInZeroTripLoop(h, 2);
+        res += lengthInZeroTripLoop(new int[5], 2) * 10;
+        res += divideInZeroTripLoop(20, 2, 2) * 100;
+        if (res == 2106) {
+            System.out.println("licmZeroTripTest passes");
+        } else {
+            System.out.println("licmZeroTripTest fails: " + res + " (expecting 2106)");
+        }
+    }
+
+    private static int loadInZeroTripLoop(Holder h, int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += h.value;
+        }
+        return sum;
+    }
+
+    private static int lengthInZeroTripLoop(int[] array, int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += array.length;
+        }
+        return sum;
+    }
+
+    private static int divideInZeroTripLoop(int a, int b, int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += a / b;
+        }
+        return sum;
+    }
+
+    public static void storeInLoopTest() {
+        Holder h = new Holder();
+        h.value = 5;
+        int res = countDown(h);
+        h.value = 5;
+        res += countDownAliased(h, h) * 10;
+        int[] array = new int[] { 5 };
+        res += countDownArray(array, array) * 100;
+        if (res == 555) {
+            System.out.println("licmStoreInLoopTest passes");
+        } else {
+            System.out.println("licmStoreInLoopTest fails: " + res + " (expecting 555)");
+        }
+    }
+
+    // The loads in the loop condition are the first thing the loop runs, but the loop writes
+    // what they read. The count bounds the loop should they be hoisted.
+    private static int countDown(Holder h) {
+        int n = 0;
+        while (h.value > 0 && n < 100) {
+            h.value = h.value - 1;
+            n++;
+        }
+        return n;
+    }
+
+    private static int countDownAliased(Holder a, Holder b) {
+        int n = 0;
+        while (a.value > 0 && n < 100) {
+            b.value = b.value - 1;
+            n++;
+        }
+        return n;
+    }
+
+    private static int countDownArray(int[] a, int[] b) {
+        int n = 0;
+        while (a[0] > 0 && n < 100) {
+            b[0] = b[0] - 1;
+            n++;
+        }
+        return n;
+    }
+
+    public static void exitLivenessTest() {
+        int res = lastProduct(5, 0);
+        res += lastProduct(5, 2) * 10;
+        res += productAfterUse(5, 2) * 1000;
+        res += productAfterUse(5, 0) * 100000;
+        if (res == 16150) {
+            System.out.println("licmExitLivenessTest passes");
+        } else {
+            System.out.println("licmExitLivenessTest fails: " + res + " (expecting 16150)");
+        }
+    }
+
+    // x keeps its value from before the loop when the loop doesn't run.
+    private static int lastProduct(int a, int n) {
+        int x = 0;
+        for (int i = 0; i < n; i++) {
+            x = a * 3;
+        }
+        return x;
+    }
+
+    // The loop reads x before it redefines it.
+    private static int productAfterUse(int a, int n) {
+        int x = 1;
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += x;
+            x = a * 3;
+        }
+        return sum;
+    }
+}
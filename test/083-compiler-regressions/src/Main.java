@@ -42,6 +42,19 @@ public class Main {
         returnConstantTest();
         ZeroTests.longDivTest();
         ZeroTests.longModTest();
+        InlineTests.nullReceiverTest();
+        InlineTests.staticReturnTest();
+        GvnTests.joinTest();
+        GvnTests.loopTest();
+        GvnTests.aliasTest();
+        GvnTests.catchTest();
+        GvnTests.volatileTest();
+        GvnTests.staticTest();
+        GvnTests.redefinitionTest();
+        LicmTests.zeroTripTest();
+        LicmTests.storeInLoopTest();
+        LicmTests.exitLivenessTest();
+        BceTests.throwTest();
     }
 
     public static void returnConstantTest() {
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+
+/**
+ * Tests objects that don't escape the method allocating them, whose
+ * constructors the compiler inlines and whose allocations it removes.
+ */
+public class Main {
+    // From dalvik.system.VMDebug.
+    private static final int KIND_THREAD_ALLOCATED_OBJECTS = 1 << 16;
+
+    static Object escaped;
+    static volatile boolean finalized;
+
+    public static void main(String[] args) throws Exception {
+        fieldTest();
+        chainTest();
+        narrowTest();
+        arrayTest();
+        finalizerTest();
+        allocationTest();
+    }
+
+    static void fieldTest() {
+        int res = sumPoint(3, 4);
+        res += secondOfPair(5) * 10;
+        res += sumEscapingPoint(6, 7) * 100;
+        if (res == 1307 && ((Point) escaped).y == 7) {
+            System.out.println("fieldTest passes");
+        } else {
+            System.out.println("fieldTest fails: " + res + " (expecting 1307)");
+        }
+    }
+
+    static int sumPoint(int x, int y) {
+        Point p = new Point(x, y);
+        return p.x + p.y;
+    }
+
+    // The constructor leaves b zero.
+    static int secondOfPair(int a) {
+        Pair p = new Pair(a);
+        return p.b;
+    }
+
+    static int sumEscapingPoint(int x, int y) {
+        Point p = new Point(x, y);
+        escaped = p;
+        return p.x + p.y;
+    }
+
+    static void chainTest() {
+        long res = sumPoint3(1, 2, 3);
+        res += scaledPoint(5, 2);
+        Point3 p = new Point3(7, 8, 9);
+        res += p.x * 100 + p.y * 1000 + p.z * 10000;
+        if (res == 98726) {
+            System.out.println("chainTest passes");
+        } else {
+            System.out.println("chainTest fails: " + res + " (expecting 98726)");
+        }
+    }
+
+    // Point3's constructor runs Point's, which runs Object's.
+    static int sumPoint3(int x, int y, int z) {
+        Point3 p = new Point3(x, y, z);
+        return p.x + p.y + p.z;
+    }
+
+    static long scaledPoint(long scale, int x) {
+        ScaledPoint p = new ScaledPoint(x, scale);
+        p.x = p.x * 2;
+        return p.x * p.scale;
+    }
+
+    static void narrowTest() {
+        int res = narrow(300, 40000, -40000, true);
+        if (res == 44 + 40000 + 25536 + 1) {
+            System.out.println("narrowTest passes");
+        } else {
+            System.out.println("narrowTest fails: " + res + " (expecting " +
+                               (44 + 40000 + 25536 + 1) + ")");
+        }
+    }
+
+    static int narrow(int b, int c, int s, boolean z) {
+        Narrow n = new Narrow((byte) b, (char) c, (short) s, z);
+        return n.b + n.c + n.s + (n.z ? 1 : 0);
+    }
+
+    static void arrayTest() {
+        long res = sumArray(3, 4);
+        res += wideArray(5) * 100;
+        res += byteArray(300) * 1000;
+        if (res == 7 + 3 * 10 + 2 * 100 + 5 * 100 + 44 * 1000) {
+            System.out.println("arrayTest passes");
+        } else {
+            System.out.println("arrayTest fails: " + res + " (expecting " +
+                               (7 + 3 * 10 + 2 * 100 + 5 * 100 + 44 * 1000) + ")");
+        }
+    }
+
+    // array[2] is never written, so it reads zero.
+    static int sumArray(int a, int b) {
+        int[] array = new int[3];
+        array[0] = a;
+        array[1] = b;
+        array[0] = array[0] + 0;
+        int[] other = new int[1];
+        other[0] = 2;
+        return array[0] + array[1] + array[2] + array.length * 10 + other[0] * 100;
+    }
+
+    static long wideArray(long a) {
+        long[] array = new long[2];
+        array[1] = a;
+        return array[0] + array[1];
+    }
+
+    static int byteArray(int b) {
+        byte[] array = new byte[1];
+        array[0] = (byte) b;
+        return array[0];
+    }
+
+    // Object.<init> registers the finalizers of objects, so their constructors must run.
+    static void finalizerTest() throws Exception {
+        allocateFinalizable();
+        for (int i = 0; i < 10 && !finalized; i++) {
+            System.gc();
+            System.runFinalization();
+        }
+        if (finalized) {
+            System.out.println("finalizerTest passes");
+        } else {
+            System.out.println("finalizerTest fails: finalizer didn't run");
+        }
+    }
+
+    static int allocateFinalizable() {
+        Finalizable f = new Finalizable(1);
+        return f.value;
+    }
+
+    static void allocationTest() throws Exception {
+        Class<?> vmDebug = Class.forName("dalvik.system.VMDebug");
+        Method startAllocCounting = vmDebug.getMethod("startAllocCounting");
+        Method stopAllocCounting = vmDebug.getMethod("stopAllocCounting");
+        Method resetAllocCount = vmDebug.getMethod("resetAllocCount", int.class);
+        Method getAllocCount = vmDebug.getMethod("getAllocCount", int.class);
+        // Boxed ahead, so that calling VMDebug allocates nothing while counting.
+        Object[] kindArgs = new Object[] { KIND_THREAD_ALLOCATED_OBJECTS };
+        Object[] noArgs = new Object[0];
+
+        startAllocCounting.invoke(null, noArgs);
+        resetAllocCount.invoke(null, kindArgs);
+        int sum = 0;
+        for (int i = 0; i < 100; i++) {
+            sum += sumPoint(i, 1);
+        }
+        int removed = (Integer) getAllocCount.invoke(null, kindArgs);
+        resetAllocCount.invoke(null, kindArgs);
+        for (int i = 0; i < 100; i++) {
+            sum += sumEscapingPoint(i, 1);
+        }
+        int escaping = (Integer) getAllocCount.invoke(null, kindArgs);
+        stopAllocCounting.invoke(null, noArgs);
+
+        if (sum == 2 * (4950 + 100) && removed == 0 && escaping == 100) {
+            System.out.println("allocationTest passes");
+        } else {
+            System.out.println("allocationTest fails: sum " + sum + ", " + removed +
+                               " and " + escaping + " allocations (expecting 10100, 0 and 100)");
+        }
+    }
+}
+
+class Point {
+    int x;
+    int y;
+
+    Point(int x, int y) {
+        this.x = x;
+        this.y = y;
+    }
+}
+
+class Point3 extends Point {
+    int z;
+
+    Point3(int x, int y, int z) {
+        super(x, y);
+        this.z = z;
+    }
+}
+
+class ScaledPoint {
+    int x;
+    long scale;
+
+    ScaledPoint(int x, long scale) {
+        this.x = x;
+        this.scale = scale;
+    }
+}
+
+class Pair {
+    int a;
+    int b;
+
+    Pair(int a) {
+        this.a = a;
+    }
+}
+
+class Narrow {
+    byte b;
+    char c;
+    short s;
+    boolean z;
+
+    Narrow(byte b, char c, short s, boolean z) {
+        this.b = b;
+        this.c = c;
+        this.s = s;
+        this.z = z;
+    }
+}
+
+class Finalizable {
+    int value;
+
+    Finalizable(int value) {
+        this.value = value;
+    }
+
+    protected void finalize() {
+        Main.finalized = true;
+    }
+}
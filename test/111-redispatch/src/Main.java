@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.List;
+import java.util.Random;
+
+/**
+ * Tests calls of Random.nextInt(int), which no boot class overrides, once
+ * FixedRandom overrides it.
+ */
+public class Main {
+    private static final long SEED = 7;
+
+    public static void main(String[] args) throws Exception {
+        // Boot code calls nextInt before any class overrides it.
+        List<Integer> list = makeList();
+        Collections.shuffle(list, new Random(SEED));
+        Class.forName("FixedRandom");
+
+        runTests("");
+
+        Class<?> vmDebug = Class.forName("dalvik.system.VMDebug");
+        Method startMethodTracingDdms = vmDebug.getMethod("startMethodTracingDdms",
+                int.class, int.class, boolean.class, int.class);
+        Method stopMethodTracing = vmDebug.getMethod("stopMethodTracing");
+        startMethodTracingDdms.invoke(null, 1024 * 1024, 0, false, 0);
+        try {
+            runTests("traced ");
+        } finally {
+            stopMethodTracing.invoke(null);
+        }
+    }
+
+    static void runTests(String prefix) throws Exception {
+        check(prefix + "imageTest", imageTest());
+        check(prefix + "vtableTest", vtableTest());
+        check(prefix + "interfaceTest", interfaceTest());
+        check(prefix + "superTest", superTest());
+        check(prefix + "reflectionTest", reflectionTest());
+    }
+
+    static void check(String name, boolean passes) {
+        System.out.println(name + (passes ? " passes" : " fails"));
+    }
+
+    static List<Integer> makeList() {
+        List<Integer> list = new ArrayList<Integer>();
+        for (int i = 0; i < 4; i++) {
+            list.add(i);
+        }
+        return list;
+    }
+
+    // The first value of nextInt(10) for a Random seeded with SEED.
+    static int expectedNextInt() {
+        return new Random(SEED).nextInt(10);
+    }
+
+    // Collections.shuffle calls nextInt from the boot image.
+    static boolean imageTest() {
+        List<Integer> fixed = makeList();
+        Collections.shuffle(fixed, new FixedRandom(SEED));
+        // Swapping each element from the last to the second with the first.
+        boolean passes = fixed.toString().equals("[1, 2, 3, 0]");
+
+        List<Integer> plain = makeList();
+        Collections.shuffle(plain, new PlainRandom(SEED));
+        List<Integer> random = makeList();
+        Collections.shuffle(random, new Random(SEED));
+        return passes && plain.equals(random);
+    }
+
+    static boolean vtableTest() {
+        Random fixed = new FixedRandom(SEED);
+        Random plain = new PlainRandom(SEED);
+        Random random = new Random(SEED);
+        return fixed.nextInt(10) == 0 && plain.nextInt(10) == expectedNextInt() &&
+               random.nextInt(10) == expectedNextInt();
+    }
+
+    static boolean interfaceTest() {
+        IntSource fixed = new FixedRandom(SEED);
+        IntSource plain = new PlainRandom(SEED);
+        return fixed.nextInt(10) == 0 && plain.nextInt(10) == expectedNextInt();
+    }
+
+    static boolean superTest() {
+        return new FixedRandom(SEED).superNextInt(10) == expectedNextInt();
+    }
+
+    static boolean reflectionTest() throws Exception {
+        Method nextInt = Random.class.getMethod("nextInt", int.class);
+        return (Integer) nextInt.invoke(new FixedRandom(SEED), 10) == 0 &&
+               (Integer) nextInt.invoke(new PlainRandom(SEED), 10) == expectedNextInt() &&
+               (Integer) nextInt.invoke(new Random(SEED), 10) == expectedNextInt();
+    }
+}
+
+interface IntSource {
+    int nextInt(int n);
+}
+
+// Overrides Random.nextInt(int).
+class FixedRandom extends Random implements IntSource {
+    FixedRandom(long seed) {
+        super(seed);
+    }
+
+    public int nextInt(int n) {
+        return 0;
+    }
+
+    int superNextInt(int n) {
+        return super.nextInt(n);
+    }
+}
+
+// Inherits Random.nextInt(int), which its vtable holds.
+class PlainRandom extends Random implements IntSource {
+    PlainRandom(long seed) {
+        super(seed);
+    }
+}
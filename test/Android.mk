@@ -25,7 +25,9 @@ TEST_DEX_DIRECTORIES := \
 	AllFields \
 	CreateMethodSignature \
 	ExceptionHandle \
+	Getters \
 	Interfaces \
+	InterpreterLoop \
 	Main \
 	MyClass \
 	MyClassNatives \
@@ -33,9 +35,11 @@ TEST_DEX_DIRECTORIES := \
 	NonStaticLeafMethods \
 	ProtoCompare \
 	ProtoCompare2 \
+	Reflection \
 	StaticLeafMethods \
 	Statics \
 	StaticsFromCode \
+	ValueNumbering \
 	XandY
 
 # subdirectories of which are used with test-art-target-oat
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class InterpreterLoop {
+    int count;
+    static int total;
+
+    int increment(int i) {
+        count += i;
+        return count;
+    }
+
+    static int loop(int n) {
+        int[] values = new int[16];
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            values[i & 15] += i;
+            if ((i & 1) == 0) {
+                sum += values[(i + 3) & 15] ^ i;
+            } else {
+                sum -= i >> 2;
+            }
+        }
+        return sum;
+    }
+
+    static int calls(int n) {
+        InterpreterLoop loop = new InterpreterLoop();
+        total = 0;
+        for (int i = 0; i < n; i++) {
+            total += loop.increment(i & 7);
+        }
+        return total + loop.count;
+    }
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class ValueNumbering {
+    int count;
+    int[] values;
+
+    // Reads each element and count twice, and writes the element back.
+    int incrementAll() {
+        int[] values = this.values;
+        int sum = 0;
+        for (int i = 0; i < values.length; i++) {
+            int value = values[i];
+            int c = count;
+            sum += values[i] * count + value - c;
+            values[i] = value + 1;
+        }
+        return sum;
+    }
+}